@@ -55,7 +55,8 @@ int main() {
 
         // Read data from RINEX file
         try {
-            obsData = parseRinexObs(rinexFileStream);
+            // 读取时只解析选择的观测值类型
+            obsData = parseRinexObs(rinexFileStream, sysTypes);
 
         }
         catch (...) {
@@ -66,9 +67,6 @@ int main() {
         if (obsData.epoch > stopEpoch)
             break;
 
-        // choose obs types
-        chooseObs(obsData, sysTypes);
-
         cout << "chooseObs:" << endl;
         cout << obsData << endl;
 
@@ -77,7 +75,7 @@ int main() {
         cout << obsData << endl;
 
         // Detect cycle slips using MW combination
-        std::map<Variable, int> csFlagData;
+        VariableIntMap csFlagData;
         detectCSMW(obsData,
                    csFlagData,
                    satEpochMWData,
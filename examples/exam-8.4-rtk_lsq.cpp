@@ -11,7 +11,8 @@
 #include "TimeConvert.h"
 #include "GnssFunc.h"
 #include "RinexNavStore.hpp"
-#include "RinexObsReader.h"
+#include "RinexObsPrefetchReader.h"
+#include "ObsEpochMerger.h"
 #include "SPPUCCodePhase.h"
 #include "ARLambda.hpp"
 
@@ -54,6 +55,8 @@ int main() {
     RinexNavStore navStore;//已经加入北斗系统
     //todo:这里加载北斗星历数据时没有问题的，是卫星位置计算有问题
     navStore.loadFile(navFile);//直接加载整个导航电文文件，已经加入北斗系统
+    // 流动站和基准站共享卫星状态，同一历元每颗卫星的轨道只计算一次
+    SatStateCache satCache(&navStore);
 
     std::map<string, std::set<string>> selectedTypes;//已经加入北斗系统
     selectedTypes["G"].insert("C1C");
@@ -79,7 +82,8 @@ int main() {
     // 定义数据处理的对象
     //-------------------
     //>>> classes for rover
-    RinexObsReader readObsRover;//这里观测值文件读取包含了北斗系统和gps系统
+    // 后台线程预读观测值，解算与文件解析同时进行
+    RinexObsPrefetchReader readObsRover;//这里观测值文件读取包含了北斗系统和gps系统
     readObsRover.setFileStream(&roverObsStream);
     readObsRover.setSelectedTypes(selectedTypes);
 
@@ -91,15 +95,26 @@ int main() {
 
     SPPUCCodePhase sppUCCodePhaseRover;
     sppUCCodePhaseRover.setRinexNavStore(&navStore);
+    sppUCCodePhaseRover.setSatStateCache(&satCache);
     sppUCCodePhaseRover.setDualCodeTypes(dualCodeTypes);
 
     //>>> classes for base
-    RinexObsReader readObsBase;//这里观测值文件读取包含了北斗系统和gps系统
+    // 基准站按顺序同步，早于流动站的历元直接丢弃
+    RinexObsPrefetchReader readObsBase;//这里观测值文件读取包含了北斗系统和gps系统
     readObsBase.setFileStream(&baseObsStream);
     readObsBase.setSelectedTypes(selectedTypes);
+
+    // 流动站与基准站按历元归并同步，以流动站为准，基准站缺失的历元 isPresent[1] 为 false
+    ObsEpochMerger merger;
+    merger.addReader(&readObsRover);
+    merger.addReader(&readObsBase);
+    merger.setMissingPolicy(ObsEpochMerger::RequireReference);
+    merger.setReferenceStation(0);
+    ObsEpochGroup epochGroup;
     
     SPPUCCodePhase sppUCCodePhaseBase;
     sppUCCodePhaseBase.setRinexNavStore(&navStore);//同流动站
+    sppUCCodePhaseBase.setSatStateCache(&satCache);
     sppUCCodePhaseBase.setStationAsBase();//isRover = false;
     sppUCCodePhaseBase.setDualCodeTypes(dualCodeTypes);//同流动站
 
@@ -142,15 +157,18 @@ int main() {
     }
 
 
+    // 每个历元的中间结果（观测值、方程、卫星位置等）都分配在 epochArena 中，历元开始时整体回收
+    EpochArena epochArena;
     while (true) {
 
+        // 上一个历元的容器都已析构；读取在 Scope 之外，epochGroup 等跨历元的数据使用节点池
+        epochArena.reset();
+        if (!merger.next(epochGroup)) break;
+        EpochArena::Scope epochScope(epochArena);
+
         // solve spp for rover，流动站的单点定位
         ObsData roverData;
-
-        try {
-            roverData = readObsRover.parseRinexObs();//读取一个历元
-        }
-        catch (EndOfFile &e) { break; }
+        roverData = std::move(epochGroup.stations[0]);//读取一个历元
 
        /* if(debug)
         {
@@ -178,14 +196,11 @@ int main() {
         Vector3d xyzRover = sppUCCodePhaseRover.getXYZ();//这个函数就是用来获取solve()函数得到的xyz值，是单点定位的坐标值，精度不够高。
 
         // solve spp for base
-        ObsData baseObsData;
-        try {
-            baseObsData = readObsBase.parseRinexObs(epoch);
-        }
-        // 同步出现错误，跳过基准站处理，读取下一个流动站历元
-        catch (SyncException &e) {
+        // 基准站在该历元没有观测值，跳过基准站处理，读取下一个流动站历元
+        if (!epochGroup.isPresent[1]) {
             continue;
-        };
+        }
+        ObsData baseObsData = std::move(epochGroup.stations[1]);
 
         /*if(debug)
         {
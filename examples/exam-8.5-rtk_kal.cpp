@@ -11,7 +11,8 @@
 #include "TimeConvert.h"
 #include "GnssFunc.h"
 #include "RinexNavStore.hpp"
-#include "RinexObsReader.h"
+#include "RinexObsPrefetchReader.h"
+#include "ObsEpochMerger.h"
 #include "SPPUCCodePhase.h"
 #include "CSDetector.h"
 #include "SolverKalman.h"
@@ -52,6 +53,8 @@ int main() {
     // read nav file data before rtk
     RinexNavStore navStore;
     navStore.loadFile(navFile);
+    // 流动站和基准站共享卫星状态，同一历元每颗卫星的轨道只计算一次
+    SatStateCache satCache(&navStore);
 
     std::map<string, std::set<string>> selectedTypes;
     selectedTypes["G"].insert("C1C");
@@ -74,7 +77,8 @@ int main() {
     // 定义数据处理的对象
     //-------------------
     //>>> classes for rover
-    RinexObsReader readObsRover;
+    // 后台线程预读观测值，解算与文件解析同时进行
+    RinexObsPrefetchReader readObsRover;
     readObsRover.setFileStream(&roverObsStream);
     readObsRover.setSelectedTypes(selectedTypes);
 
@@ -86,18 +90,29 @@ int main() {
 
     SPPUCCodePhase sppUCCodePhaseRover;
     sppUCCodePhaseRover.setRinexNavStore(&navStore);
+    sppUCCodePhaseRover.setSatStateCache(&satCache);
     sppUCCodePhaseRover.setDualCodeTypes(dualCodeTypes);
 
     //周跳探测
     CSDetector detectCSRover;
 
     //>>> classes for base
-    RinexObsReader readObsBase;
+    // 基准站按顺序同步，早于流动站的历元直接丢弃
+    RinexObsPrefetchReader readObsBase;
     readObsBase.setFileStream(&baseObsStream);
     readObsBase.setSelectedTypes(selectedTypes);
 
+    // 流动站与基准站按历元归并同步，以流动站为准，基准站缺失的历元 isPresent[1] 为 false
+    ObsEpochMerger merger;
+    merger.addReader(&readObsRover);
+    merger.addReader(&readObsBase);
+    merger.setMissingPolicy(ObsEpochMerger::RequireReference);
+    merger.setReferenceStation(0);
+    ObsEpochGroup epochGroup;
+
     SPPUCCodePhase sppUCCodePhaseBase;
     sppUCCodePhaseBase.setRinexNavStore(&navStore);
+    sppUCCodePhaseBase.setSatStateCache(&satCache);
     sppUCCodePhaseBase.setStationAsBase();
     sppUCCodePhaseBase.setDualCodeTypes(dualCodeTypes);
 
@@ -129,15 +144,18 @@ int main() {
     SatID datumSat;
     bool firstEpoch(true);
 
+    // 每个历元的中间结果（观测值、方程、卫星位置等）都分配在 epochArena 中，历元开始时整体回收
+    EpochArena epochArena;
     while (true) {
 
+        // 上一个历元的容器都已析构；读取在 Scope 之外，epochGroup 等跨历元的数据使用节点池
+        epochArena.reset();
+        if (!merger.next(epochGroup)) break;
+        EpochArena::Scope epochScope(epochArena);
+
         // solve spp for rover
         ObsData roverData;
-
-        try {
-            roverData = readObsRover.parseRinexObs();
-        }
-        catch (EndOfFile &e) { break; }
+        roverData = std::move(epochGroup.stations[0]);
 
        /* if(debug)
         {
@@ -160,14 +178,11 @@ int main() {
         VariableDataMap csFlagRover = detectCSRover.detect(roverData);
 
         // solve spp for base
-        ObsData baseObsData;
-        try {
-            baseObsData = readObsBase.parseRinexObs(epoch);
-        }
-            // 同步出现错误，跳过基准站处理，读取下一个流动站历元
-        catch (SyncException &e) {
+        // 基准站在该历元没有观测值，跳过基准站处理，读取下一个流动站历元
+        if (!epochGroup.isPresent[1]) {
             continue;
-        };
+        }
+        ObsData baseObsData = std::move(epochGroup.stations[1]);
 
        /* if(debug)
         {
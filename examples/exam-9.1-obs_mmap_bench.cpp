@@ -0,0 +1,141 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// RINEX 3 观测值读取吞吐量测试：fstream 读取器 RinexObsReader 与内存映射读取器
+// RinexObsMMapReader 对同一文件各完整读取若干遍，输出 MB/s 和 epochs/s，
+// 并逐历元比较两者的输出是否完全一致。
+//
+// 用法：obs_mmap_bench <RINEX 3.04 观测值文件> [重复次数]
+// 注意：data/ABMF00GLP_R_20210010000_01D_MN.rnx 是导航电文文件，不能用于本测试。
+//
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#include "RinexObsReader.h"
+#include "RinexObsMMapReader.h"
+
+using namespace std;
+
+static std::map<string, std::set<string>> exampleTypes() {
+    std::map<string, std::set<string>> selectedTypes;
+    selectedTypes["G"].insert("C1C");
+    selectedTypes["G"].insert("C2W");
+    selectedTypes["G"].insert("L1C");
+    selectedTypes["G"].insert("L2W");
+    selectedTypes["C"].insert("C2I");
+    selectedTypes["C"].insert("C7I");
+    selectedTypes["C"].insert("L2I");
+    selectedTypes["C"].insert("L7I");
+    return selectedTypes;
+}
+
+static bool sameObsData(const ObsData &a, const ObsData &b) {
+    if (a.station != b.station || a.epoch != b.epoch) return false;
+    if (a.satTypeValueData.size() != b.satTypeValueData.size()) return false;
+    auto ia = a.satTypeValueData.begin();
+    auto ib = b.satTypeValueData.begin();
+    for (; ia != a.satTypeValueData.end(); ++ia, ++ib) {
+        if (ia->first != ib->first) return false;
+        // 要求逐位相同
+        if (ia->second != ib->second) return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <rinex 3.04 obs file> [repeat]" << endl;
+        exit(-1);
+    }
+    string obsFile = argv[1];
+    int repeat = (argc > 2) ? atoi(argv[2]) : 3;
+    if (repeat < 1) repeat = 1;
+
+    std::map<string, std::set<string>> selectedTypes = exampleTypes();
+
+    // 一致性检查
+    std::vector<ObsData> fstreamEpochs;
+    {
+        std::fstream obsStream(obsFile);
+        if (!obsStream) {
+            cerr << "obs file open error!" << strerror(errno) << endl;
+            exit(-1);
+        }
+        RinexObsReader reader;
+        reader.setFileStream(&obsStream);
+        reader.setSelectedTypes(selectedTypes);
+        while (true) {
+            try {
+                fstreamEpochs.push_back(reader.parseRinexObs());
+            } catch (EndOfFile &e) { break; }
+        }
+    }
+
+    size_t numMismatch = 0;
+    size_t numEpochs = 0;
+    size_t fileSize = 0;
+    {
+        RinexObsMMapReader reader(obsFile);
+        reader.setSelectedTypes(selectedTypes);
+        fileSize = reader.getFileSize();
+        while (true) {
+            ObsData obsData;
+            try {
+                obsData = reader.parseRinexObs();
+            } catch (EndOfFile &e) { break; }
+            if (numEpochs >= fstreamEpochs.size() || !sameObsData(obsData, fstreamEpochs[numEpochs]))
+                numMismatch++;
+            numEpochs++;
+        }
+    }
+    if (numEpochs != fstreamEpochs.size()) numMismatch++;
+
+    cout << "file: " << obsFile << " (" << fileSize << " bytes)" << endl;
+    cout << "epochs: fstream " << fstreamEpochs.size() << ", mmap " << numEpochs
+         << ", mismatched " << numMismatch << endl;
+    fstreamEpochs.clear();
+
+    // 吞吐量
+    typedef std::chrono::steady_clock Clock;
+    double fstreamSec = 0.0, mmapSec = 0.0;
+    for (int r = 0; r < repeat; r++) {
+        Clock::time_point t0 = Clock::now();
+        {
+            std::fstream obsStream(obsFile);
+            RinexObsReader reader;
+            reader.setFileStream(&obsStream);
+            reader.setSelectedTypes(selectedTypes);
+            while (true) {
+                try { reader.parseRinexObs(); }
+                catch (EndOfFile &e) { break; }
+            }
+        }
+        Clock::time_point t1 = Clock::now();
+        {
+            RinexObsMMapReader reader(obsFile);
+            reader.setSelectedTypes(selectedTypes);
+            while (true) {
+                try { reader.parseRinexObs(); }
+                catch (EndOfFile &e) { break; }
+            }
+        }
+        Clock::time_point t2 = Clock::now();
+        fstreamSec += std::chrono::duration<double>(t1 - t0).count();
+        mmapSec += std::chrono::duration<double>(t2 - t1).count();
+    }
+    fstreamSec /= repeat;
+    mmapSec /= repeat;
+
+    double mb = fileSize / 1.0e6;
+    cout << fixed << setprecision(1);
+    cout << "fstream : " << setw(8) << mb / fstreamSec << " MB/s  "
+         << setw(10) << numEpochs / fstreamSec << " epochs/s" << endl;
+    cout << "mmap    : " << setw(8) << mb / mmapSec << " MB/s  "
+         << setw(10) << numEpochs / mmapSec << " epochs/s" << endl;
+    cout << setprecision(2) << "speedup : " << fstreamSec / mmapSec << "x" << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
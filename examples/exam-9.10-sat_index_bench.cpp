@@ -0,0 +1,118 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 紧凑卫星标识测试：
+//  1. 检查所有系统、所有 PRN 的 SatID <-> PackedSat 转换可以还原，PackedSat 的顺序与 SatID 相同，
+//     SatTable 的遍历顺序与 std::map<SatID, T> 相同；
+//  2. 模拟周跳探测的访问方式（每历元每颗卫星查找、更新一次滤波数据），
+//     比较 std::map<SatID, T> 和 SatTable<T> 的耗时。
+//
+// 用法：sat_index_bench [历元数，默认 86400] [卫星数，默认 40]
+//
+#include <iostream>
+#include <chrono>
+#include <vector>
+
+#include "SatIndex.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+struct FilterData {
+    FilterData() : windowSize(0), mean(0.0) {};
+
+    int windowSize;
+    double mean;
+};
+
+int main(int argc, char *argv[]) {
+    int numEpochs = (argc > 1) ? atoi(argv[1]) : 86400;
+    int numVisible = (argc > 2) ? atoi(argv[2]) : 40;
+
+    //-------------------
+    // 1. 转换和顺序
+    //-------------------
+    size_t numErrors = 0;
+    std::vector<SatID> allSats;
+    for (const char *p = PackedSat::sysChars(); *p; ++p) {
+        for (int prn = 1; prn <= PackedSat::maxPrn; prn++) {
+            SatID sat;
+            sat.system = string(1, *p);
+            sat.id = prn;
+            allSats.push_back(sat);
+        }
+    }
+    std::map<SatID, int> satMap;
+    SatTable<int> satTable;
+    for (size_t i = 0; i < allSats.size(); i++) {
+        PackedSat packed(allSats[i]);
+        if (packed.toSatID() != allSats[i] || PackedSat::fromOrdinal(packed.ordinal()) != packed ||
+            packed.ordinal() >= PackedSat::numSats) {
+            numErrors++;
+        }
+        for (size_t j = 0; j < allSats.size(); j++) {
+            if ((allSats[i] < allSats[j]) != (packed < PackedSat(allSats[j]))) numErrors++;
+        }
+        // 隔一颗插入一颗
+        if (i % 2 == 0) {
+            satMap[allSats[i]] = int(i);
+            satTable[allSats[i]] = int(i);
+        }
+    }
+    auto itMap = satMap.begin();
+    for (auto it = satTable.begin(); it != satTable.end(); ++it, ++itMap) {
+        if (itMap == satMap.end() || it.sat().toSatID() != itMap->first || *it != itMap->second) {
+            numErrors++;
+        }
+    }
+    if (satTable.size() != satMap.size()) numErrors++;
+
+    //-------------------
+    // 2. 查找和更新
+    //-------------------
+    std::vector<SatID> visible;
+    for (int i = 0; i < numVisible; i++) {
+        visible.push_back(allSats[(i * 7) % allSats.size()]);
+    }
+
+    Clock::time_point t0 = Clock::now();
+    std::map<SatID, FilterData> mapData;
+    for (int k = 0; k < numEpochs; k++) {
+        for (const auto &sat: visible) {
+            // 原来的写法：每次访问都查找一次
+            mapData[sat].windowSize++;
+            mapData[sat].mean += (k - mapData[sat].mean) / mapData[sat].windowSize;
+        }
+    }
+    double mapSec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    t0 = Clock::now();
+    SatTable<FilterData> tableData;
+    for (int k = 0; k < numEpochs; k++) {
+        for (const auto &sat: visible) {
+            FilterData &data = tableData[sat];
+            data.windowSize++;
+            data.mean += (k - data.mean) / data.windowSize;
+        }
+    }
+    double tableSec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    for (const auto &sat: visible) {
+        if (mapData[sat].windowSize != tableData[sat].windowSize ||
+            mapData[sat].mean != tableData[sat].mean) {
+            numErrors++;
+        }
+    }
+
+    double numAccess = double(numEpochs) * numVisible;
+    cout << "satellites: " << allSats.size() << " (" << PackedSat::numSats << " slots), "
+         << "sizeof(SatID) " << sizeof(SatID) << ", sizeof(PackedSat) " << sizeof(PackedSat) << endl;
+    cout << fixed << setprecision(1);
+    cout << "std::map<SatID, T>: " << mapSec * 1.0e9 / numAccess << " ns/update" << endl;
+    cout << "SatTable<T>:        " << tableSec * 1.0e9 / numAccess << " ns/update" << endl;
+    cout << setprecision(2) << "speedup: " << mapSec / tableSec << endl;
+    cout << "errors: " << numErrors << endl;
+
+    return numErrors == 0 ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 按列存放的历元观测值测试：
+//  1. RinexObsMMapReader 分别读出 ObsData（嵌套 map）和 ObsEpoch（按列存放），
+//     统计两种做法每历元的内存分配次数和耗时，并逐历元检查 ObsEpoch::toObsData 与 ObsData 完全一致；
+//  2. 对每个历元的 GPS 卫星计算 MW 组合（周跳探测中的主要循环），
+//     比较按类型名查 map 与直接访问列的耗时，并逐颗卫星检查结果一致。
+//
+// 用法：obs_epoch_bench <RINEX 3.04 观测值文件>
+// 注意：data/ABMF00GLP_R_20210010000_01D_MN.rnx 是导航电文文件，不能用于本测试。
+//
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "RinexObsMMapReader.h"
+#include "ObsEpoch.h"
+#include "SatIndex.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+// 统计内存分配次数
+static std::atomic<size_t> numAllocs(0);
+
+void *operator new(size_t size) {
+    numAllocs++;
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+static std::map<string, std::set<string>> exampleTypes() {
+    std::map<string, std::set<string>> selectedTypes;
+    selectedTypes["G"].insert("C1C");
+    selectedTypes["G"].insert("C2W");
+    selectedTypes["G"].insert("L1C");
+    selectedTypes["G"].insert("L2W");
+    selectedTypes["C"].insert("C2I");
+    selectedTypes["C"].insert("C7I");
+    selectedTypes["C"].insert("L2I");
+    selectedTypes["C"].insert("L7I");
+    return selectedTypes;
+}
+
+static bool sameObsData(const ObsData &a, const ObsData &b) {
+    return a.station == b.station && a.epoch == b.epoch &&
+           a.satTypeValueData == b.satTypeValueData;
+}
+
+// MW 组合，观测值均以米为单位
+static double mwCombination(double f1, double f2, double L1, double L2, double C1, double C2) {
+    return (f1 * L1 - f2 * L2) / (f1 - f2) - (f1 * C1 + f2 * C2) / (f1 + f2);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <rinex 3.04 obs file>" << endl;
+        exit(-1);
+    }
+    string obsFile = argv[1];
+    std::map<string, std::set<string>> selectedTypes = exampleTypes();
+    double f1 = getFreq("G", "L1"), f2 = getFreq("G", "L2");
+
+    //-------------------
+    // 1. ObsData
+    //-------------------
+    std::vector<ObsData> mapEpochs;
+    SatTable<double> mapMW;
+    size_t mapAllocs, numMW = 0;
+    double mapReadSec = 0.0, mapMWSec = 0.0;
+    {
+        RinexObsMMapReader reader(obsFile);
+        reader.setSelectedTypes(selectedTypes);
+        reader.parseRinexHeader();
+        size_t allocs0 = numAllocs;
+        while (true) {
+            Clock::time_point t0 = Clock::now();
+            ObsData obsData;
+            try {
+                obsData = reader.parseRinexObs();
+            } catch (EndOfFile &e) { break; }
+            Clock::time_point t1 = Clock::now();
+            for (const auto &stv: obsData.satTypeValueData) {
+                if (stv.first.system != "G") continue;
+                try {
+                    double mw = mwCombination(f1, f2,
+                                              stv.second.at("L1C"), stv.second.at("L2W"),
+                                              stv.second.at("C1C"), stv.second.at("C2W"));
+                    mapMW[stv.first] += mw;
+                    numMW++;
+                } catch (std::out_of_range &e) {
+                    continue;
+                }
+            }
+            Clock::time_point t2 = Clock::now();
+            mapReadSec += std::chrono::duration<double>(t1 - t0).count();
+            mapMWSec += std::chrono::duration<double>(t2 - t1).count();
+            mapEpochs.push_back(std::move(obsData));
+        }
+        // 不计保存结果所用的分配
+        mapAllocs = numAllocs - allocs0 - mapEpochs.size();
+    }
+
+    //-------------------
+    // 2. ObsEpoch
+    //-------------------
+    size_t numMismatch = 0, numEpochs = 0;
+    SatTable<double> colMW;
+    size_t colAllocs;
+    double colReadSec = 0.0, colMWSec = 0.0;
+    {
+        RinexObsMMapReader reader(obsFile);
+        reader.setSelectedTypes(selectedTypes);
+        reader.parseRinexHeader();
+        int codeL1 = ObsCodeTable::find("L1C"), codeL2 = ObsCodeTable::find("L2W");
+        int codeC1 = ObsCodeTable::find("C1C"), codeC2 = ObsCodeTable::find("C2W");
+        uint64_t mwMask = (uint64_t(1) << codeL1) | (uint64_t(1) << codeL2) |
+                          (uint64_t(1) << codeC1) | (uint64_t(1) << codeC2);
+
+        ObsEpoch obsEpoch;
+        ObsData obsData;
+        size_t checkAllocs = 0;
+        size_t allocs0 = numAllocs;
+        while (true) {
+            Clock::time_point t0 = Clock::now();
+            try {
+                reader.parseRinexObs(obsEpoch);
+            } catch (EndOfFile &e) { break; }
+            Clock::time_point t1 = Clock::now();
+            const double *L1 = obsEpoch.column(codeL1), *L2 = obsEpoch.column(codeL2);
+            const double *C1 = obsEpoch.column(codeC1), *C2 = obsEpoch.column(codeC2);
+            for (size_t row = 0; row < obsEpoch.numSats(); row++) {
+                if (obsEpoch.sat(int(row)).sys() != PackedSat::GPS) continue;
+                if ((obsEpoch.obsMask(int(row)) & mwMask) != mwMask) continue;
+                colMW[obsEpoch.sat(int(row))] += mwCombination(f1, f2, L1[row], L2[row], C1[row], C2[row]);
+            }
+            Clock::time_point t2 = Clock::now();
+            colReadSec += std::chrono::duration<double>(t1 - t0).count();
+            colMWSec += std::chrono::duration<double>(t2 - t1).count();
+
+            // 检查一致性，不计其中的分配
+            size_t a0 = numAllocs;
+            obsEpoch.toObsData(obsData);
+            if (numEpochs >= mapEpochs.size() || !sameObsData(obsData, mapEpochs[numEpochs])) {
+                numMismatch++;
+            }
+            numEpochs++;
+            checkAllocs += numAllocs - a0;
+        }
+        colAllocs = numAllocs - allocs0 - checkAllocs;
+    }
+    if (numEpochs != mapEpochs.size()) numMismatch++;
+
+    auto itCol = colMW.begin();
+    for (auto it = mapMW.begin(); it != mapMW.end(); ++it, ++itCol) {
+        if (itCol == colMW.end() || it.sat() != itCol.sat() || *it != *itCol) numMismatch++;
+    }
+    if (mapMW.size() != colMW.size()) numMismatch++;
+
+    double n = double(std::max<size_t>(numEpochs, 1));
+    cout << "file: " << obsFile << " (" << numEpochs << " epochs, " << numMW << " MW values)" << endl;
+    cout << fixed << setprecision(1);
+    cout << "ObsData:  read " << mapReadSec * 1.0e6 / n << " us/epoch, "
+         << mapAllocs / n << " allocs/epoch, MW " << mapMWSec * 1.0e6 / n << " us/epoch" << endl;
+    cout << "ObsEpoch: read " << colReadSec * 1.0e6 / n << " us/epoch, "
+         << colAllocs / n << " allocs/epoch, MW " << colMWSec * 1.0e6 / n << " us/epoch" << endl;
+    cout << setprecision(2) << "speedup: read " << mapReadSec / colReadSec
+         << ", MW " << mapMWSec / colMWSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
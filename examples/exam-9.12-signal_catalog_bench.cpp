@@ -0,0 +1,172 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 编译期信号表测试：
+//  1. 检查 GPS/BDS 各频点的频率、波长和 gamma 与 Const.h 中按字符串查找的结果逐位相同，
+//     MW/IF 组合系数的结果与原来的公式一致（相对差小于 1e-14）；
+//     给出观测值文件时，还检查文件头中 G/C 的每个类型都在表中，ObsCodeTable 编号给出的频点与类型名一致，
+//     并逐历元比较 CSDetector 按类型名（ObsData）和按编号（ObsEpoch）探测的周跳标志和 MW 值；
+//  2. 模拟周跳探测中的 MW 组合计算，比较 getFreq 按字符串查频率再套公式与按频点编号查系数的耗时。
+//
+// 用法：signal_catalog_bench [RINEX 3.04 观测值文件] [循环次数，默认 1000000]
+//
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "Const.h"
+#include "SignalCatalog.h"
+#include "RinexObsMMapReader.h"
+#include "ObsEpoch.h"
+#include "CSDetector.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+// 编号在编译期确定
+static_assert(SignalCatalog::bandId('G', '1') >= 0, "GPS L1 missing");
+static_assert(SignalCatalog::isObsType('C', 'L', '7', 'I'), "BDS L7I missing");
+static_assert(!SignalCatalog::isObsType('G', 'L', '1', 'Q'), "GPS L1Q is not a RINEX type");
+
+// Variable 只有 operator<，逐项查找比较
+static bool sameFlags(const VariableDataMap &a, const VariableDataMap &b) {
+    if (a.size() != b.size()) return false;
+    for (const auto &entry: a) {
+        auto it = b.find(entry.first);
+        if (it == b.end() || it->second != entry.second) return false;
+    }
+    return true;
+}
+
+static bool closeTo(double a, double b) {
+    return std::abs(a - b) <= 1.0e-14 * std::max(std::abs(a), std::abs(b));
+}
+
+int main(int argc, char *argv[]) {
+    string obsFile = (argc > 1) ? argv[1] : "";
+    long numLoops = (argc > 2) ? atol(argv[2]) : 1000000;
+
+    //-------------------
+    // 1. 与原来的函数比较
+    //-------------------
+    size_t numMismatch = 0;
+    const char *sysList[] = {"G", "C"};
+    for (const char *sys: sysList) {
+        for (char n = '1'; n <= '9'; n++) {
+            int b = SignalCatalog::bandId(sys[0], n);
+            if (b < 0) continue;
+            string type = string("L") + n;
+            if (SignalCatalog::freq(b) != getFreq(sys, type) ||
+                SignalCatalog::wavelength(b) != getWavelength(sys, n - '0')) {
+                cout << "band mismatch: " << sys << n << endl;
+                numMismatch++;
+            }
+            for (char m = '1'; m <= '9'; m++) {
+                int b2 = SignalCatalog::bandId(sys[0], m);
+                if (b2 < 0 || b2 == b) continue;
+                const SignalPair &p = SignalCatalog::pair(b, b2);
+                string type2 = string("L") + m;
+                double f1 = getFreq(sys, type), f2 = getFreq(sys, type2);
+                double L1 = 2.1e7 + 0.123, L2 = 2.1e7 - 3.456, P1 = 2.1e7 + 1.5, P2 = 2.1e7 + 4.25;
+                double mw = (f1 * L1 - f2 * L2) / (f1 - f2) - (f1 * P1 + f2 * P2) / (f1 + f2);
+                double ifc = (f1 * f1 * P1 - f2 * f2 * P2) / (f1 * f1 - f2 * f2);
+                if (!p.isValid || p.gamma != getGamma(sys, type, type2) ||
+                    std::abs(p.mwPhase1 * L1 + p.mwPhase2 * L2 + p.mwCode1 * P1 + p.mwCode2 * P2 - mw) > 1.0e-6 ||
+                    !closeTo(p.ifCoef1 * P1 + p.ifCoef2 * P2, ifc) ||
+                    !closeTo(p.mwWavelength, C_MPS / (f1 - f2))) {
+                    cout << "pair mismatch: " << sys << n << "/" << m << endl;
+                    numMismatch++;
+                }
+            }
+        }
+    }
+
+    if (!obsFile.empty()) {
+        RinexObsMMapReader reader(obsFile);
+        const RinexHeader &header = reader.getHeader();
+        std::map<string, std::set<string>> selectedTypes;
+        for (const auto &sysEntry: header.mapObsTypes) {
+            if (sysEntry.first != "G" && sysEntry.first != "C") continue;
+            char sys = sysEntry.first[0];
+            for (const string &type: sysEntry.second) {
+                int code = ObsCodeTable::intern(type);
+                if (!SignalCatalog::isObsType(sys, type) || code < 0 ||
+                    ObsCodeTable::band(code, sys) != SignalCatalog::bandId(sys, type[1])) {
+                    cout << "header type not in catalog: " << sysEntry.first << " " << type << endl;
+                    numMismatch++;
+                }
+                selectedTypes[sysEntry.first].insert(type);
+            }
+        }
+
+        // 同一组观测值分别按类型名和按编号探测周跳，结果应完全相同
+        reader.setSelectedTypes(selectedTypes);
+        CSDetector byName, byCode;
+        ObsEpoch obsEpoch;
+        size_t numEpochs = 0, numFlags = 0;
+        while (true) {
+            ObsData obsData;
+            try { obsData = reader.parseRinexObs(); }
+            catch (EndOfFile &e) { break; }
+            convertObsType(obsData);
+            obsEpoch.fromObsData(obsData);
+
+            VariableDataMap nameFlags = byName.detect(obsData);
+            VariableDataMap codeFlags = byCode.detect(obsEpoch);
+            if (!sameFlags(nameFlags, codeFlags) || obsEpoch.numSats() != obsData.satTypeValueData.size()) {
+                cout << "cycle slip flags differ at " << obsData.epoch << endl;
+                numMismatch++;
+            }
+            numEpochs++;
+            numFlags += nameFlags.size();
+        }
+        if (byName.satEpochMWData != byCode.satEpochMWData ||
+            byName.satEpochMeanMWData != byCode.satEpochMeanMWData) {
+            cout << "MW values differ" << endl;
+            numMismatch++;
+        }
+        cout << "cycle slip detection: " << numEpochs << " epochs, " << numFlags << " flags" << endl;
+    }
+
+    //-------------------
+    // 2. MW 组合
+    //-------------------
+    std::vector<double> obs(4 * 64);
+    for (size_t i = 0; i < obs.size(); i++) {
+        obs[i] = 2.0e7 + 1.0e3 * i;
+    }
+
+    double sumString = 0.0, sumTable = 0.0;
+    Clock::time_point t0 = Clock::now();
+    for (long k = 0; k < numLoops; k++) {
+        const double *o = &obs[4 * (k & 63)];
+        string sys = (k & 1) ? "G" : "C";
+        double f1 = getFreq(sys, (k & 1) ? "L1" : "L2");
+        double f2 = getFreq(sys, (k & 1) ? "L2" : "L7");
+        sumString += (f1 * o[0] - f2 * o[1]) / (f1 - f2) - (f1 * o[2] + f2 * o[3]) / (f1 + f2);
+    }
+    double stringSec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    const SignalPair &pairGPS = SignalCatalog::pair(SignalCatalog::bandId('G', '1'), SignalCatalog::bandId('G', '2'));
+    const SignalPair &pairBDS = SignalCatalog::pair(SignalCatalog::bandId('C', '2'), SignalCatalog::bandId('C', '7'));
+    t0 = Clock::now();
+    for (long k = 0; k < numLoops; k++) {
+        const double *o = &obs[4 * (k & 63)];
+        const SignalPair &p = (k & 1) ? pairGPS : pairBDS;
+        sumTable += p.mwPhase1 * o[0] + p.mwPhase2 * o[1] + p.mwCode1 * o[2] + p.mwCode2 * o[3];
+    }
+    double tableSec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    if (std::abs(sumString - sumTable) > 1.0e-6 * numLoops) numMismatch++;
+
+    cout << "bands: " << SignalCatalog::numBands() << ", observation codes: " << ObsCodeTable::size() << endl;
+    cout << fixed << setprecision(1);
+    cout << "getFreq + formula: " << stringSec * 1.0e9 / numLoops << " ns/MW" << endl;
+    cout << "SignalCatalog:     " << tableSec * 1.0e9 / numLoops << " ns/MW" << endl;
+    cout << setprecision(2) << "speedup: " << stringSec / tableSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 变量句柄测试：
+//  1. 逐历元生成流动站和基准站的非差观测方程（GPS C1/C2/L1/L2，坐标、钟差、电离层和模糊度参数），
+//     卫星按历元升降，并随机给出周跳标志；
+//  2. 分别用 Variable 版本和句柄版本完成站间差分、星间差分、模糊度基准、Kalman 滤波和模糊度固定，
+//     逐历元检查双差方程、状态向量、协方差、坐标改正数和固定的模糊度完全相同；
+//     流动站非差方程另外用 SolverLSQ 两个版本求解并比较；
+//  3. 比较两种做法的耗时，句柄版本另计登记变量（indexEquSys）所用的时间。
+//
+// 用法：variable_registry_bench [历元数，默认 500] [卫星数，默认 12]
+//
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include "GnssStruct.h"
+#include "GnssFunc.h"
+#include "SolverLSQ.h"
+#include "SolverKalman.h"
+#include "VariableRegistry.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 可重复的伪随机数，范围 [-1, 1)
+static double noise(unsigned long &seed) {
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    return double((seed >> 11) & 0xFFFFF) / double(0x80000) - 1.0;
+}
+
+static bool sameVar(const Variable &a, const Variable &b) {
+    return !(a < b) && !(b < a);
+}
+
+static bool sameVarData(const VariableDataMap &a, const VariableDataMap &b) {
+    if (a.size() != b.size()) return false;
+    auto ib = b.begin();
+    for (auto ia = a.begin(); ia != a.end(); ++ia, ++ib) {
+        if (!sameVar(ia->first, ib->first) || ia->second != ib->second) return false;
+    }
+    return true;
+}
+
+static bool sameEquSys(const EquSys &a, const EquSys &b) {
+    if (a.obsEquData.size() != b.obsEquData.size() || a.varSet.size() != b.varSet.size()) return false;
+    auto ib = b.obsEquData.begin();
+    for (auto ia = a.obsEquData.begin(); ia != a.obsEquData.end(); ++ia, ++ib) {
+        if (!(ia->first == ib->first) || ia->second.prefit != ib->second.prefit ||
+            ia->second.weight != ib->second.weight ||
+            !sameVarData(ia->second.varCoeffData, ib->second.varCoeffData)) {
+            return false;
+        }
+    }
+    auto vb = b.varSet.begin();
+    for (auto va = a.varSet.begin(); va != a.varSet.end(); ++va, ++vb) {
+        if (!sameVar(*va, *vb)) return false;
+    }
+    return true;
+}
+
+// 模拟一个测站一个历元的非差观测方程，与 SPPUCCodePhase 的参数设置相同
+static void simulateEquSys(const string &station, int epoch, int numSats, unsigned long seed,
+                           EquSys &equSys, VariableDataMap &csFlag) {
+    equSys.station = station;
+    equSys.obsEquData.clear();
+    equSys.varSet.clear();
+    csFlag.clear();
+
+    Variable dx(station, Parameter::dX);
+    Variable dy(station, Parameter::dY);
+    Variable dz(station, Parameter::dZ);
+    Variable cdt(station, Parameter::cdt);
+    double gamma = 1.6469444444444444;
+    const char *types[] = {"C1", "C2", "L1", "L2"};
+
+    for (int i = 1; i <= numSats; i++) {
+        // 卫星轮流升降，保证协方差需要重排
+        if ((epoch / 40 + i) % 5 == 0) continue;
+
+        std::ostringstream ss;
+        ss << "G" << setw(2) << setfill('0') << i;
+        SatID sat(ss.str());
+
+        double az = 2.0 * M_PI * i / numSats + 1.0e-3 * epoch;
+        double el = 0.3 + 0.9 * (i % 4) / 4.0;
+        double cosines[3] = {-cos(el) * sin(az), -cos(el) * cos(az), -sin(el)};
+        double weight = 1.0 / (0.3 * 0.3) * std::pow(std::sin(el), 2);
+
+        Variable iono(station, sat, Parameter::iono, ObsID(sat.system, "C1"));
+        equSys.varSet.insert(dx);
+        equSys.varSet.insert(dy);
+        equSys.varSet.insert(dz);
+        equSys.varSet.insert(cdt);
+        equSys.varSet.insert(iono);
+
+        for (const char *type: types) {
+            EquID equID(sat, type);
+            EquData &equData = equSys.obsEquData[equID];
+            bool isPhase = (type[0] == 'L');
+            double ionoCoeff = (type[1] == '1') ? 1.0 : gamma;
+            equData.prefit = (isPhase ? 0.01 : 1.0) * noise(seed);
+            equData.varCoeffData[dx] = cosines[0];
+            equData.varCoeffData[dy] = cosines[1];
+            equData.varCoeffData[dz] = cosines[2];
+            equData.varCoeffData[cdt] = 1.0;
+            equData.varCoeffData[iono] = isPhase ? -ionoCoeff : ionoCoeff;
+            equData.weight = isPhase ? weight * 1.0e4 : weight;
+            if (isPhase) {
+                Variable amb(station, sat, Parameter::ambiguity, ObsID(sat.system, type));
+                equData.varCoeffData[amb] = 1.0;
+                equSys.varSet.insert(amb);
+                csFlag[amb] = (noise(seed) > 0.98) ? 1.0 : 0.0;
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int numEpochs = (argc > 1) ? atoi(argv[1]) : 500;
+    int numSats = (argc > 2) ? atoi(argv[2]) : 12;
+
+    // 原来的差分函数会向 cout 输出，计时时关闭
+    std::ostringstream nullStream;
+    std::streambuf *coutBuf = cout.rdbuf();
+
+    SolverKalman kalVar, kalHandle;
+    VariableDataMap fixedAmbVar;
+    VariableTable<double> fixedAmbHandle;
+    VariableRegistry registry;
+    bool firstEpoch = true;
+
+    size_t numMismatch = 0, numEqus = 0;
+    double varSec = 0.0, handleSec = 0.0, indexSec = 0.0;
+    double lsqVarSec = 0.0, lsqHandleSec = 0.0;
+
+    for (int epoch = 0; epoch < numEpochs; epoch++) {
+        EquSys equSysRover, equSysBase;
+        VariableDataMap csFlagRover, csFlagBase;
+        simulateEquSys("ROVR", epoch, numSats, 1000UL + epoch, equSysRover, csFlagRover);
+        simulateEquSys("BASE", epoch, numSats, 5000UL + epoch, equSysBase, csFlagBase);
+
+        SatID datumSat;
+        for (const auto &ed: equSysRover.obsEquData) {
+            datumSat = ed.first.sat;
+            break;
+        }
+
+        //-------------------
+        // Variable 版本
+        //-------------------
+        Clock::time_point t0 = Clock::now();
+        cout.rdbuf(nullStream.rdbuf());
+        EquSys equSysSD, equSysDD;
+        VariableDataMap csFlagSD, csFlagDD;
+        differenceStation(equSysRover, csFlagRover, equSysBase, csFlagBase, equSysSD, csFlagSD);
+        differenceSat(datumSat, equSysSD, csFlagSD, equSysDD, csFlagDD);
+        ambiguityDatum(firstEpoch, datumSat, fixedAmbVar, equSysDD);
+        kalVar.solve(equSysDD, csFlagDD);
+        VectorXd stateVar = kalVar.getState();
+        MatrixXd covVar = kalVar.getCovMatrix();
+        double ratioVar;
+        Vector3d dxyzFixedVar;
+        fixSolution(stateVar, covVar, equSysDD.varSet, ratioVar, dxyzFixedVar, fixedAmbVar);
+        cout.rdbuf(coutBuf);
+        nullStream.str("");
+        varSec += seconds(t0);
+
+        //-------------------
+        // 句柄版本
+        //-------------------
+        t0 = Clock::now();
+        IndexedEquSys indexedRover, indexedBase;
+        VariableTable<double> csHandleRover, csHandleBase;
+        indexEquSys(equSysRover, registry, indexedRover);
+        indexEquSys(equSysBase, registry, indexedBase);
+        indexVariableData(csFlagRover, registry, csHandleRover);
+        indexVariableData(csFlagBase, registry, csHandleBase);
+        indexSec += seconds(t0);
+
+        t0 = Clock::now();
+        IndexedEquSys indexedSD, indexedDD;
+        VariableTable<double> csHandleSD, csHandleDD;
+        differenceStation(indexedRover, csHandleRover, indexedBase, csHandleBase, indexedSD, csHandleSD);
+        differenceSat(datumSat, indexedSD, csHandleSD, indexedDD, csHandleDD);
+        ambiguityDatum(firstEpoch, datumSat, fixedAmbHandle, indexedDD);
+        kalHandle.solve(indexedDD, csHandleDD);
+        VectorXd stateHandle = kalHandle.getState();
+        MatrixXd covHandle = kalHandle.getCovMatrix();
+        double ratioHandle;
+        Vector3d dxyzFixedHandle;
+        fixSolution(stateHandle, covHandle, indexedDD, ratioHandle, dxyzFixedHandle, fixedAmbHandle);
+        handleSec += seconds(t0);
+
+        // 检查结果
+        EquSys restoredDD;
+        restoreEquSys(indexedDD, restoredDD);
+        VariableDataMap restoredAmb;
+        restoreVariableData(fixedAmbHandle, registry, restoredAmb);
+        if (!sameEquSys(equSysDD, restoredDD) ||
+            stateVar != stateHandle || covVar != covHandle ||
+            kalVar.getdxyz() != kalHandle.getdxyz() ||
+            ratioVar != ratioHandle || dxyzFixedVar != dxyzFixedHandle ||
+            !sameVarData(fixedAmbVar, restoredAmb)) {
+            cout << "epoch " << epoch << " mismatched" << endl;
+            numMismatch++;
+        }
+        numEqus += equSysDD.obsEquData.size();
+
+        //-------------------
+        // 最小二乘
+        //-------------------
+        SolverLSQ lsqVar, lsqHandle;
+        t0 = Clock::now();
+        lsqVar.solve(equSysRover);
+        lsqVarSec += seconds(t0);
+        t0 = Clock::now();
+        lsqHandle.solve(indexedRover);
+        lsqHandleSec += seconds(t0);
+        if (lsqVar.getState() != lsqHandle.getState() || lsqVar.getdxyz() != lsqHandle.getdxyz()) {
+            cout << "epoch " << epoch << " lsq mismatched" << endl;
+            numMismatch++;
+        }
+
+        firstEpoch = false;
+    }
+
+    double n = double(std::max(numEpochs, 1));
+    cout << "epochs: " << numEpochs << ", sats: " << numSats
+         << ", DD equations/epoch: " << numEqus / n
+         << ", registered variables: " << registry.size() << endl;
+    cout << fixed << setprecision(1);
+    cout << "Variable: RTK " << varSec * 1.0e6 / n << " us/epoch, LSQ " << lsqVarSec * 1.0e6 / n << " us/epoch" << endl;
+    cout << "handle:   RTK " << handleSec * 1.0e6 / n << " us/epoch, LSQ " << lsqHandleSec * 1.0e6 / n
+         << " us/epoch, index " << indexSec * 1.0e6 / n << " us/epoch" << endl;
+    cout << setprecision(2) << "speedup: RTK " << varSec / handleSec
+         << ", LSQ " << lsqVarSec / lsqHandleSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
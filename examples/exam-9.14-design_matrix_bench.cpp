@@ -0,0 +1,189 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 按行压缩的设计矩阵测试：
+//  1. 模拟不同卫星数的流动站和基准站双频伪距和相位观测值，SPPUCCodePhase::linearize 直接写入 DesignMatrix；
+//  2. 流动站非差方程分别转换成 EquSys 用原来的 SolverLSQ 求解，和直接用 DesignMatrix 求解；
+//     两站的方程经站间、星间差分后，分别用 EquSys 和 DesignMatrix 做 Kalman 滤波；
+//     检查参数顺序相同、状态向量和坐标改正数一致（法方程的累加顺序不同，只要求相对差很小）；
+//  3. 统计两种做法每历元的求解耗时，EquSys 的耗时不含 toEquSys 的转换。
+//
+// 用法：design_matrix_bench [历元数，默认 20]
+//
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include "GnssStruct.h"
+#include "SPPUCCodePhase.h"
+#include "SolverLSQ.h"
+#include "SolverKalman.h"
+#include "DesignMatrix.h"
+#include "GnssFunc.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 可重复的伪随机数，范围 [-1, 1)
+static double noise(unsigned long &seed) {
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    return double((seed >> 11) & 0xFFFFF) / double(0x80000) - 1.0;
+}
+
+static bool closeTo(const VectorXd &a, const VectorXd &b, double tol) {
+    if (a.size() != b.size()) return false;
+    return (a - b).norm() <= tol * std::max(1.0, a.norm());
+}
+
+// 线性化只需要公开的 linearize，不需要导航电文
+class SPPLinearizer : public SPPUCCodePhase {
+public:
+    SPPLinearizer() { cutOffElev = 10.0; };
+};
+
+// 模拟一个历元的观测值、卫星位置和高度角
+static void simulateEpoch(const string &station, int epoch, int numSats, const Vector3d &xyz,
+                          ObsData &obsData, SatXvtMap &satXvt, SatValueMap &satElev) {
+    obsData.station = station;
+    obsData.satTypeValueData.clear();
+    satXvt.clear();
+    satElev.clear();
+
+    Vector3d up = xyz.normalized();
+    Vector3d east = Vector3d(0, 0, 1).cross(up).normalized();
+    Vector3d north = up.cross(east);
+
+    unsigned long seed = 7919UL * epoch + station.size() * 131UL + station[0];
+    for (int i = 1; i <= numSats; i++) {
+        // 卫星轮流升降，保证 Kalman 滤波需要重排协方差
+        if ((epoch / 10 + i) % 7 == 0) continue;
+
+        std::ostringstream ss;
+        ss << "G" << setw(2) << setfill('0') << i;
+        SatID sat(ss.str());
+
+        double az = 2.0 * M_PI * i / numSats + 1.0e-2 * epoch;
+        double el = (15.0 + 70.0 * ((i * 37) % numSats) / double(numSats)) * M_PI / 180.0;
+        Vector3d los = up * sin(el) + (east * cos(az) + north * sin(az)) * cos(el);
+
+        Xvt xvt;
+        xvt.x = xyz + 2.0e7 * los;
+        xvt.clkbias = 1.0e-5 * noise(seed);
+        xvt.relcorr = 1.0e-9 * noise(seed);
+        satXvt[sat] = xvt;
+        satElev[sat] = el * 180.0 / M_PI;
+
+        double rho = 2.0e7 - xvt.clkbias * C_MPS - xvt.relcorr * C_MPS;
+        TypeValueMap &tv = obsData.satTypeValueData[sat];
+        tv["C1"] = rho + 3.0 + 0.3 * noise(seed);
+        tv["C2"] = rho + 5.0 + 0.3 * noise(seed);
+        tv["L1"] = rho - 3.0 + 0.003 * noise(seed);
+        tv["L2"] = rho - 5.0 + 0.003 * noise(seed);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int numEpochs = (argc > 1) ? atoi(argv[1]) : 20;
+    const int satCounts[] = {8, 16, 32, 64};
+
+    Vector3d xyz(-2267750.0, 5009154.0, 3221290.0);
+    size_t numMismatch = 0;
+
+    cout << "sats  rows  cols   LSQ EquSys  LSQ design  speedup   KAL EquSys  KAL design  speedup" << endl;
+    for (int numSats: satCounts) {
+        SPPLinearizer linearizer;
+        VariableRegistry registry;
+        DesignMatrix design, designBase, designDD;
+        design.setVariableRegistry(&registry);
+        designBase.setVariableRegistry(&registry);
+
+        SolverKalman kalEquSys, kalDesign;
+        VariableDataMap csFlag;
+        VariableTable<double> csTable;
+
+        double lsqEquSec = 0.0, lsqDesignSec = 0.0, kalEquSec = 0.0, kalDesignSec = 0.0;
+        double numRows = 0.0, numCols = 0.0;
+        for (int epoch = 0; epoch < numEpochs; epoch++) {
+            ObsData obsData, obsDataBase;
+            SatXvtMap satXvt, satXvtBase;
+            SatValueMap satElev, satElevBase;
+            Vector3d xyzBase = xyz + Vector3d(100.0, 50.0, 20.0);
+            simulateEpoch("ROVR", epoch, numSats, xyz, obsData, satXvt, satElev);
+            simulateEpoch("BASE", epoch, numSats, xyzBase, obsDataBase, satXvtBase, satElevBase);
+
+            Vector3d xyzApprox = xyz + Vector3d(10.0, -20.0, 5.0);
+            linearizer.linearize(xyzApprox, satXvt, satElev, obsData, design);
+            linearizer.linearize(xyzBase, satXvtBase, satElevBase, obsDataBase, designBase);
+            numRows += design.numRows();
+            numCols += design.numCols();
+
+            EquSys equSys;
+            design.toEquSys(equSys);
+
+            // 参数的顺序必须与 VariableSet 相同
+            int col = 0;
+            for (const auto &var: equSys.varSet) {
+                if (registry.find(var) != design.columns()[col++]) numMismatch++;
+            }
+
+            SolverLSQ lsqEquSys, lsqDesign;
+            Clock::time_point t0 = Clock::now();
+            lsqEquSys.solve(equSys);
+            lsqEquSec += seconds(t0);
+            t0 = Clock::now();
+            lsqDesign.solve(design);
+            lsqDesignSec += seconds(t0);
+            if (!closeTo(lsqEquSys.getState(), lsqDesign.getState(), 1.0e-6) ||
+                (lsqEquSys.getdxyz() - lsqDesign.getdxyz()).norm() > 1.0e-6) {
+                cout << "sats " << numSats << " epoch " << epoch << " LSQ mismatched: "
+                     << scientific << (lsqEquSys.getState() - lsqDesign.getState()).norm() << fixed << endl;
+                numMismatch++;
+            }
+
+            // 双差方程（模糊度基准固定为零）
+            EquSys equSysBase, equSysDD;
+            designBase.toEquSys(equSysBase);
+            IndexedEquSys indexedRover, indexedBase, indexedSD, indexedDD;
+            indexEquSys(equSys, registry, indexedRover);
+            indexEquSys(equSysBase, registry, indexedBase);
+            differenceStation(indexedRover, indexedBase, indexedSD);
+            SatID datumSat = indexedSD.obsEquData.begin()->first.sat;
+            differenceSat(datumSat, indexedSD, indexedDD);
+            bool firstEpoch = true;
+            VariableTable<double> fixedAmb;
+            ambiguityDatum(firstEpoch, datumSat, fixedAmb, indexedDD);
+            restoreEquSys(indexedDD, equSysDD);
+            designDD.assign(indexedDD);
+
+            t0 = Clock::now();
+            kalEquSys.solve(equSysDD, csFlag);
+            kalEquSec += seconds(t0);
+            t0 = Clock::now();
+            kalDesign.solve(designDD, csTable);
+            kalDesignSec += seconds(t0);
+            if (!closeTo(kalEquSys.getState(), kalDesign.getState(), 1.0e-6) ||
+                (kalEquSys.getdxyz() - kalDesign.getdxyz()).norm() > 1.0e-4) {
+                cout << "sats " << numSats << " epoch " << epoch << " Kalman mismatched: "
+                     << scientific << (kalEquSys.getState() - kalDesign.getState()).norm() << fixed << endl;
+                numMismatch++;
+            }
+        }
+
+        double n = double(std::max(numEpochs, 1));
+        cout << fixed << setprecision(0) << setw(4) << numSats << setw(6) << numRows / n << setw(6) << numCols / n
+             << setprecision(1) << setw(11) << lsqEquSec * 1.0e6 / n << "us" << setw(10) << lsqDesignSec * 1.0e6 / n
+             << "us" << setprecision(2) << setw(9) << lsqEquSec / lsqDesignSec
+             << setprecision(1) << setw(11) << kalEquSec * 1.0e6 / n << "us" << setw(10) << kalDesignSec * 1.0e6 / n
+             << "us" << setprecision(2) << setw(9) << kalEquSec / kalDesignSec << endl;
+    }
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
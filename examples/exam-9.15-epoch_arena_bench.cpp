@@ -0,0 +1,336 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 历元内存区测试：
+//  1. 模拟流动站和基准站的双频伪距和相位观测值，每个历元按 exam-8.5 的流程处理：
+//     线性化、站间差分、星间差分、模糊度基准、Kalman 滤波和模糊度固定；
+//  2. 同样的数据分别在节点池（不使用 EpochArena::Scope）和历元内存区中处理，检查两种做法的滤波结果相同；
+//  3. 卫星的升降以 70 个历元为周期，预热一个周期后统计每个历元容器的分配次数、调用全局 operator new 的次数和耗时；
+//  4. 给出 RINEX 观测值文件时，再按实际的流程逐历元读取（RinexObsReader）、转换观测值类型并探测周跳（CSDetector），
+//     同样统计两种做法每个历元的分配次数和调用 operator new 的次数。
+//
+// 模拟的数据中观测值类型名和测站名都很短，std::string 不申请内存，也不经过文件读取，
+// 所以第 3 步中历元内存区调用 operator new 的次数接近零；第 4 步的次数才反映实际的数据处理，
+// 读行的缓冲、较长的字符串等都不在内存区中。两步都只报告次数，不作为检查的条件。
+// Eigen 的矩阵使用 malloc，不经过 operator new，不在统计范围内。
+//
+// 用法：epoch_arena_bench [卫星数，默认 32] [统计的历元数，默认 200] [RINEX 3.04 观测值文件，可选]
+//
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#include "GnssStruct.h"
+#include "EpochArena.h"
+#include "SPPUCCodePhase.h"
+#include "SolverKalman.h"
+#include "DesignMatrix.h"
+#include "GnssFunc.h"
+#include "RinexObsReader.h"
+#include "CSDetector.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+// 统计全局 operator new 的调用次数
+static size_t numOperatorNew = 0;
+
+void *operator new(size_t size) {
+    numOperatorNew++;
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+// 丢弃输出，重定向 cout 时不再分配内存
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+// 可重复的伪随机数，范围 [-1, 1)
+static double noise(unsigned long &seed) {
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    return double((seed >> 11) & 0xFFFFF) / double(0x80000) - 1.0;
+}
+
+// 线性化只需要公开的 linearize，不需要导航电文
+class SPPLinearizer : public SPPUCCodePhase {
+public:
+    SPPLinearizer() { cutOffElev = 10.0; };
+};
+
+// 模拟一个历元的观测值、卫星位置和高度角
+static void simulateEpoch(const string &station, int epoch, int numSats, const Vector3d &xyz,
+                          ObsData &obsData, SatXvtMap &satXvt, SatValueMap &satElev) {
+    obsData.station = station;
+    obsData.satTypeValueData.clear();
+    satXvt.clear();
+    satElev.clear();
+
+    Vector3d up = xyz.normalized();
+    Vector3d east = Vector3d(0, 0, 1).cross(up).normalized();
+    Vector3d north = up.cross(east);
+
+    unsigned long seed = 7919UL * epoch + station.size() * 131UL + station[0];
+    for (int i = 1; i <= numSats; i++) {
+        if ((epoch / 10 + i) % 7 == 0) continue;
+
+        SatID sat;
+        sat.system = "G";
+        sat.id = i;
+
+        double az = 2.0 * M_PI * i / numSats + 1.0e-2 * epoch;
+        double el = (15.0 + 70.0 * ((i * 37) % numSats) / double(numSats)) * M_PI / 180.0;
+        Vector3d los = up * sin(el) + (east * cos(az) + north * sin(az)) * cos(el);
+
+        Xvt &xvt = satXvt[sat];
+        xvt.x = xyz + 2.0e7 * los;
+        xvt.clkbias = 1.0e-5 * noise(seed);
+        xvt.relcorr = 1.0e-9 * noise(seed);
+        satElev[sat] = el * 180.0 / M_PI;
+
+        double rho = 2.0e7 - xvt.clkbias * C_MPS - xvt.relcorr * C_MPS;
+        TypeValueMap &tv = obsData.satTypeValueData[sat];
+        tv["C1"] = rho + 3.0 + 0.3 * noise(seed);
+        tv["C2"] = rho + 5.0 + 0.3 * noise(seed);
+        tv["L1"] = rho - 3.0 + 0.003 * noise(seed);
+        tv["L2"] = rho - 5.0 + 0.003 * noise(seed);
+    }
+}
+
+// 跨历元保存的数据，在 Scope 之外构造
+struct RTKPipeline {
+    RTKPipeline() : firstEpoch(true) {
+        designRover.setVariableRegistry(&registry);
+        designBase.setVariableRegistry(&registry);
+    };
+
+    SPPLinearizer rover, base;
+    VariableRegistry registry;
+    DesignMatrix designRover, designBase;
+    SolverKalman kalRTK;
+    VariableDataMap fixedAmbData;
+    SatID datumSat;
+    bool firstEpoch;
+};
+
+// 一个历元的处理，与 exam-8.5 相同；容器都在这里构造和析构
+static void processEpoch(RTKPipeline &rtk, int epoch, int numSats, VectorXd &state, Vector3d &dxyzFixed) {
+    Vector3d xyz(-2267750.0, 5009154.0, 3221290.0);
+    Vector3d xyzBase = xyz + Vector3d(100.0, 50.0, 20.0);
+
+    ObsData roverData, baseData;
+    SatXvtMap satXvt, satXvtBase;
+    SatValueMap satElevData, satElevBase;
+    simulateEpoch("ROVR", epoch, numSats, xyz, roverData, satXvt, satElevData);
+    simulateEpoch("BASE", epoch, numSats, xyzBase, baseData, satXvtBase, satElevBase);
+
+    Vector3d xyzRover = xyz + Vector3d(10.0, -20.0, 5.0);
+    rtk.rover.linearize(xyzRover, satXvt, satElevData, roverData, rtk.designRover);
+    rtk.base.linearize(xyzBase, satXvtBase, satElevBase, baseData, rtk.designBase);
+
+    EquSys equSysRover, equSysBase;
+    rtk.designRover.toEquSys(equSysRover);
+    rtk.designBase.toEquSys(equSysBase);
+    VariableDataMap csFlagRover, csFlagBase;
+
+    EquSys equSysSD;
+    VariableDataMap csFlagSD;
+    differenceStation(equSysRover, csFlagRover, equSysBase, csFlagBase, equSysSD, csFlagSD);
+    rtk.datumSat = findDatumSat(rtk.firstEpoch, satElevData);
+
+    EquSys equSysDD;
+    VariableDataMap csFlagDD;
+    differenceSat(rtk.datumSat, equSysSD, csFlagSD, equSysDD, csFlagDD);
+    ambiguityDatum(rtk.firstEpoch, rtk.datumSat, rtk.fixedAmbData, equSysDD);
+
+    rtk.kalRTK.solve(equSysDD, csFlagDD);
+
+    state = rtk.kalRTK.getState();
+    MatrixXd covMatrix = rtk.kalRTK.getCovMatrix();
+    double ratio;
+    fixSolution(state, covMatrix, equSysDD.varSet, ratio, dxyzFixed, rtk.fixedAmbData);
+
+    rtk.firstEpoch = false;
+}
+
+struct RunStats {
+    double nodeAllocs = 0.0;
+    double heapCalls = 0.0;
+    double operatorNew = 0.0;
+    double seconds = 0.0;
+};
+
+static RunStats run(bool useArena, int numSats, int warmup, int numEpochs,
+                    std::vector<VectorXd> &states, std::vector<Vector3d> &dxyz) {
+    RTKPipeline rtk;
+    EpochArena epochArena;
+    RunStats stats;
+
+    size_t allocs0 = 0, heap0 = 0, new0 = 0;
+    Clock::time_point t0;
+    for (int epoch = 0; epoch < warmup + numEpochs; epoch++) {
+        if (epoch == warmup) {
+            allocs0 = NodePool::numAllocations() + epochArena.numAllocations();
+            heap0 = NodePool::numHeapCalls() + epochArena.numHeapCalls();
+            new0 = numOperatorNew;
+            t0 = Clock::now();
+        }
+        if (useArena) {
+            epochArena.reset();
+            EpochArena::Scope epochScope(epochArena);
+            processEpoch(rtk, epoch, numSats, states[epoch], dxyz[epoch]);
+        } else {
+            processEpoch(rtk, epoch, numSats, states[epoch], dxyz[epoch]);
+        }
+    }
+
+    double n = double(std::max(numEpochs, 1));
+    stats.seconds = std::chrono::duration<double>(Clock::now() - t0).count() / n;
+    stats.nodeAllocs = (NodePool::numAllocations() + epochArena.numAllocations() - allocs0) / n;
+    stats.heapCalls = (NodePool::numHeapCalls() + epochArena.numHeapCalls() - heap0) / n;
+    stats.operatorNew = (numOperatorNew - new0) / n;
+    return stats;
+}
+
+// 读取并处理一个历元，文件读完时返回 false；容器都在这里构造和析构
+static bool processRinexEpoch(RinexObsReader &reader, CSDetector &csDetector, size_t &numFlags) {
+    ObsData obsData;
+    try {
+        obsData = reader.parseRinexObs();
+    } catch (EndOfFile &e) {
+        return false;
+    }
+    convertObsType(obsData);
+    VariableDataMap csFlags = csDetector.detect(obsData);
+    numFlags += csFlags.size();
+    return true;
+}
+
+// 按实际的流程处理 RINEX 文件：读取、转换观测值类型、探测周跳；前 warmup 个历元不统计。
+// numFlags 返回所有历元周跳标志的个数
+static RunStats runRinex(bool useArena, const string &obsFile, int warmup, size_t &numEpochs, size_t &numFlags) {
+    std::map<string, std::set<string>> selectedTypes;
+    selectedTypes["G"].insert("C1C");
+    selectedTypes["G"].insert("C2W");
+    selectedTypes["G"].insert("L1C");
+    selectedTypes["G"].insert("L2W");
+
+    std::fstream obsStream(obsFile);
+    if (!obsStream) {
+        cerr << "obs file open error!" << endl;
+        exit(-1);
+    }
+    RinexObsReader reader;
+    reader.setFileStream(&obsStream);
+    reader.setSelectedTypes(selectedTypes);
+
+    CSDetector csDetector;
+    EpochArena epochArena;
+    RunStats stats;
+
+    size_t allocs0 = 0, heap0 = 0, new0 = 0;
+    Clock::time_point t0 = Clock::now();
+    numEpochs = 0;
+    numFlags = 0;
+    for (int epoch = 0;; epoch++) {
+        if (epoch == warmup) {
+            allocs0 = NodePool::numAllocations() + epochArena.numAllocations();
+            heap0 = NodePool::numHeapCalls() + epochArena.numHeapCalls();
+            new0 = numOperatorNew;
+            t0 = Clock::now();
+        }
+        bool isRead;
+        if (useArena) {
+            epochArena.reset();
+            EpochArena::Scope epochScope(epochArena);
+            isRead = processRinexEpoch(reader, csDetector, numFlags);
+        } else {
+            isRead = processRinexEpoch(reader, csDetector, numFlags);
+        }
+        if (!isRead) break;
+        numEpochs++;
+    }
+
+    double n = double(std::max(int(numEpochs) - warmup, 1));
+    stats.seconds = std::chrono::duration<double>(Clock::now() - t0).count() / n;
+    stats.nodeAllocs = (NodePool::numAllocations() + epochArena.numAllocations() - allocs0) / n;
+    stats.heapCalls = (NodePool::numHeapCalls() + epochArena.numHeapCalls() - heap0) / n;
+    stats.operatorNew = (numOperatorNew - new0) / n;
+    return stats;
+}
+
+static void printStats(const RunStats &pool, const RunStats &arena) {
+    cout << "           node allocs  pool/arena heap  operator new    time" << endl;
+    cout << fixed << setprecision(1)
+         << "node pool " << setw(13) << pool.nodeAllocs << setw(17) << pool.heapCalls
+         << setw(14) << pool.operatorNew << setw(9) << pool.seconds * 1.0e6 << "us" << endl;
+    cout << "arena     " << setw(13) << arena.nodeAllocs << setw(17) << arena.heapCalls
+         << setw(14) << arena.operatorNew << setw(9) << arena.seconds * 1.0e6 << "us" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    int numSats = (argc > 1) ? atoi(argv[1]) : 32;
+    int numEpochs = (argc > 2) ? atoi(argv[2]) : 200;
+    string obsFile = (argc > 3) ? argv[3] : "";
+    const int warmup = 70;
+
+    std::vector<VectorXd> statesPool(warmup + numEpochs), statesArena(warmup + numEpochs);
+    std::vector<Vector3d> dxyzPool(warmup + numEpochs), dxyzArena(warmup + numEpochs);
+
+    // 差分、模糊度固定和读取文件头时的调试输出全部丢弃
+    NullBuffer nullBuffer;
+    std::streambuf *coutBuffer = cout.rdbuf(&nullBuffer);
+    RunStats pool = run(false, numSats, warmup, numEpochs, statesPool, dxyzPool);
+    RunStats arena = run(true, numSats, warmup, numEpochs, statesArena, dxyzArena);
+    RunStats rinexPool, rinexArena;
+    size_t poolEpochs = 0, arenaEpochs = 0, poolFlags = 0, arenaFlags = 0;
+    if (!obsFile.empty()) {
+        rinexPool = runRinex(false, obsFile, warmup, poolEpochs, poolFlags);
+        rinexArena = runRinex(true, obsFile, warmup, arenaEpochs, arenaFlags);
+    }
+    cout.rdbuf(coutBuffer);
+    cout << setfill(' ');
+
+    size_t numMismatch = 0;
+    for (int i = 0; i < warmup + numEpochs; i++) {
+        if (statesPool[i].size() != statesArena[i].size() ||
+            (statesPool[i] - statesArena[i]).norm() > 1.0e-9 * std::max(1.0, statesPool[i].norm()) ||
+            (dxyzPool[i] - dxyzArena[i]).norm() > 1.0e-9) {
+            cout << "epoch " << i << " mismatched" << endl;
+            numMismatch++;
+        }
+    }
+
+    cout << "simulated RTK, sats: " << numSats << ", epochs: " << numEpochs
+         << " (after " << warmup << " warm-up epochs, short type names, no file reading)" << endl;
+    printStats(pool, arena);
+
+    if (!obsFile.empty()) {
+        if (poolEpochs != arenaEpochs || poolFlags != arenaFlags) {
+            cout << "RINEX runs differ: epochs " << poolEpochs << "/" << arenaEpochs
+                 << ", flags " << poolFlags << "/" << arenaFlags << endl;
+            numMismatch++;
+        }
+        cout << "RINEX read + convertObsType + CSDetector, " << obsFile << ", epochs: " << poolEpochs
+             << " (after " << warmup << " warm-up epochs)" << endl;
+        printStats(rinexPool, rinexArena);
+    }
+    cout << "(before EpochAllocator every node alloc was a global heap call)" << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
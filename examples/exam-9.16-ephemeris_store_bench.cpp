@@ -0,0 +1,197 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 多组广播星历查找测试：
+//  1. 读入导航文件，每隔 step 秒对每颗 GPS 卫星查找星历，
+//     与逐组扫描的结果比较（健康、在有效期内、toe 最近，相同距离取较早的一组）；
+//  2. 把所有星历平移一天后先加入、原来的星历后加入，构造乱序加入的两天星历，同样逐历元检查；
+//  3. 检查查到的星历计算的卫星位置在 GPS 轨道高度上；
+//  4. 比较 EphemerisStore::find 和按 map<CommonTime, NavEphGPS> 逐组扫描并复制星历的耗时。
+//
+// 用法：ephemeris_store_bench [导航文件，默认 data/ABMF00GLP_R_20210010000_01D_MN.rnx] [step 秒，默认 30]
+//
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <map>
+
+#include "RinexNavStore.hpp"
+#include "EphemerisStore.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 逐组扫描：可用的星历中 toe 最近的一组，相同距离取较早的一组
+static const NavEphGPS *scanEph(const std::map<CommonTime, NavEphGPS> &ephs, const CommonTime &t) {
+    const NavEphGPS *pBest = NULL;
+    double bestDt = 0.0;
+    for (const auto &it: ephs) {
+        const NavEphGPS &eph = it.second;
+        if (eph.SV_health != 0 || !eph.isValid(t)) continue;
+        double dt = std::fabs(t - eph.ctToe);
+        if (pBest == NULL || dt < bestDt) {
+            pBest = &eph;
+            bestDt = dt;
+        }
+    }
+    return pBest;
+}
+
+// 原来按卫星保存的 map，查找时复制星历
+static bool scanEphCopy(const std::map<CommonTime, NavEphGPS> &ephs, const CommonTime &t, NavEphGPS &eph) {
+    const NavEphGPS *pEph = scanEph(ephs, t);
+    if (pEph == NULL) return false;
+    eph = *pEph;
+    return true;
+}
+
+// 逐历元比较，返回不一致的次数
+static size_t checkStore(const EphemerisStore<NavEphGPS> &store,
+                         std::map<SatID, std::map<CommonTime, NavEphGPS>> &ephMap,
+                         const CommonTime &t0, double span, double step,
+                         size_t &numLookups, size_t &numMissing, size_t &numBadOrbit) {
+    size_t numMismatch = 0;
+    EphemerisStore<NavEphGPS>::Hint hint;
+    for (double dt = 0.0; dt < span; dt += step) {
+        CommonTime t = t0 + dt;
+        for (auto &se: ephMap) {
+            const NavEphGPS *pRef = scanEph(se.second, t);
+            const NavEphGPS *pEph = store.search(PackedSat(se.first), t, &hint);
+            numLookups++;
+            if (pRef == NULL || pEph == NULL) {
+                if (pRef != pEph) {
+                    cout << se.first << " " << CommonTime2CivilTime(t) << " mismatched: "
+                         << (pRef == NULL ? "no reference" : "not found") << endl;
+                    numMismatch++;
+                }
+                numMissing++;
+                continue;
+            }
+            if (pRef->ctToe != pEph->ctToe || pRef->IODE != pEph->IODE || pRef->M0 != pEph->M0) {
+                cout << se.first << " " << CommonTime2CivilTime(t) << " mismatched toe" << endl;
+                numMismatch++;
+            }
+            double r = pEph->svXvt(t).x.norm();
+            if (r < 2.5e7 || r > 2.8e7) numBadOrbit++;
+        }
+    }
+    return numMismatch;
+}
+
+int main(int argc, char *argv[]) {
+    string navFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_MN.rnx";
+    double step = (argc > 2) ? atof(argv[2]) : 30.0;
+
+    RinexNavStore navStore;
+    navStore.loadFile(navFile);
+
+    // 文件中的所有 GPS 星历
+    std::map<SatID, std::map<CommonTime, NavEphGPS>> ephMap;
+    CommonTime firstToe, lastToe;
+    bool isFirst = true;
+    for (int prn = 1; prn <= MAXGPSPRN; prn++) {
+        const std::vector<NavEphGPS> *pEphs = navStore.gpsEphData.ephemerides(PackedSat('G', prn));
+        if (pEphs == NULL) continue;
+        SatID sat = PackedSat('G', prn).toSatID();
+        for (const NavEphGPS &eph: *pEphs) {
+            ephMap[sat][eph.ctToe] = eph;
+            if (isFirst || eph.ctToe < firstToe) firstToe = eph.ctToe;
+            if (isFirst || eph.ctToe > lastToe) lastToe = eph.ctToe;
+            isFirst = false;
+        }
+    }
+    if (ephMap.empty()) {
+        cout << "no GPS ephemeris in " << navFile << endl;
+        return 1;
+    }
+
+    size_t numEph = 0;
+    for (auto &se: ephMap) numEph += se.second.size();
+    cout << "file: " << navFile << endl;
+    cout << "GPS sats: " << ephMap.size() << ", ephemerides: " << numEph << endl;
+
+    //-------------------
+    // 1. 单天
+    //-------------------
+    CommonTime t0 = firstToe - 7200.0;
+    double span = (lastToe - firstToe) + 4.0 * 3600.0;
+    size_t numLookups = 0, numMissing = 0, numBadOrbit = 0;
+    size_t numMismatch = checkStore(navStore.gpsEphData, ephMap, t0, span, step,
+                                    numLookups, numMissing, numBadOrbit);
+    cout << "one day : lookups " << numLookups << ", without ephemeris " << numMissing << endl;
+
+    //-------------------
+    // 2. 乱序加入的两天
+    //-------------------
+    EphemerisStore<NavEphGPS> twoDays;
+    std::map<SatID, std::map<CommonTime, NavEphGPS>> ephMap2 = ephMap;
+    for (auto &se: ephMap) {
+        for (auto &te: se.second) {
+            NavEphGPS eph = te.second;
+            eph.ctToe += 86400.0;
+            eph.ctToc += 86400.0;
+            eph.beginValid += 86400.0;
+            eph.endValid += 86400.0;
+            twoDays.add(se.first, eph);
+            ephMap2[se.first][eph.ctToe] = eph;
+        }
+    }
+    for (auto &se: ephMap) {
+        for (auto &te: se.second) {
+            twoDays.add(se.first, te.second);
+        }
+    }
+    size_t numLookups2 = 0, numMissing2 = 0;
+    numMismatch += checkStore(twoDays, ephMap2, t0, span + 86400.0, step,
+                              numLookups2, numMissing2, numBadOrbit);
+    cout << "two days: lookups " << numLookups2 << ", without ephemeris " << numMissing2 << endl;
+    if (numBadOrbit > 0) {
+        cout << "satellite radius out of range: " << numBadOrbit << endl;
+        numMismatch++;
+    }
+
+    //-------------------
+    // 3. 耗时
+    //-------------------
+    double checksumScan = 0.0, checksumStore = 0.0;
+    size_t numTimed = 0;
+    Clock::time_point tStart = Clock::now();
+    for (double dt = 0.0; dt < span + 86400.0; dt += step) {
+        CommonTime t = t0 + dt;
+        for (auto &se: ephMap2) {
+            NavEphGPS eph;
+            if (scanEphCopy(se.second, t, eph)) checksumScan += eph.M0;
+            numTimed++;
+        }
+    }
+    double scanSec = seconds(tStart);
+
+    EphemerisStore<NavEphGPS>::Hint hint;
+    tStart = Clock::now();
+    for (double dt = 0.0; dt < span + 86400.0; dt += step) {
+        CommonTime t = t0 + dt;
+        for (auto &se: ephMap2) {
+            const NavEphGPS *pEph = twoDays.search(PackedSat(se.first), t, &hint);
+            if (pEph != NULL) checksumStore += pEph->M0;
+        }
+    }
+    double storeSec = seconds(tStart);
+    if (checksumScan != checksumStore) {
+        cout << "checksum mismatched" << endl;
+        numMismatch++;
+    }
+
+    cout << "map scan + copy: " << scanSec * 1.0e9 / numTimed << " ns/lookup" << endl;
+    cout << "EphemerisStore : " << storeSec * 1.0e9 / numTimed << " ns/lookup" << endl;
+    cout << "speedup: " << scanSec / storeSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 卫星状态缓存测试：
+//  1. 读入导航文件，模拟多个测站每隔 step 秒观测所有 GPS 卫星，
+//     各测站的伪距和接收机钟差不同，信号发射时刻相差不到一毫秒到几毫秒；
+//  2. 每个测站用 SPPIFCode::computeAtTransmitTime 计算发射时刻的卫星状态，
+//     分别不使用缓存和共享同一个 SatStateCache，比较位置、钟差的差异（外推误差）；
+//  3. 统计缓存的命中率和两种做法的耗时。
+//
+// 用法：sat_state_cache_bench [导航文件，默认 data/ABMF00GLP_R_20210010000_01D_MN.rnx] [测站数，默认 8] [step 秒，默认 30]
+//
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "RinexNavStore.hpp"
+#include "SatStateCache.h"
+#include "SPPIFCode.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+struct Observation {
+    int station;
+    CommonTime time;
+    SatID sat;
+    double pr;
+};
+
+int main(int argc, char *argv[]) {
+    string navFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_MN.rnx";
+    int numStations = (argc > 2) ? atoi(argv[2]) : 8;
+    double step = (argc > 3) ? atof(argv[3]) : 30.0;
+
+    RinexNavStore navStore;
+    navStore.loadFile(navFile);
+
+    std::vector<SatID> sats;
+    for (int prn = 1; prn <= MAXGPSPRN; prn++) {
+        if (navStore.gpsEphData.contains(PackedSat('G', prn))) {
+            sats.push_back(PackedSat('G', prn).toSatID());
+        }
+    }
+    if (sats.empty()) {
+        cout << "no GPS ephemeris in " << navFile << endl;
+        return 1;
+    }
+
+    // 各测站同一历元的观测：伪距相差最多约 300 公里，接收机钟差在 ±0.5 毫秒内
+    CommonTime t0 = CivilTime2CommonTime(CivilTime(2021, 1, 1, 0, 0, 0.0));
+    t0.setTimeSystem(TimeSystem::GPS);
+    std::vector<Observation> observations;
+    for (double dt = 0.0; dt < 86400.0; dt += step) {
+        for (int s = 0; s < numStations; s++) {
+            double rxClock = 5.0e-4 * std::sin(0.7 * s + dt / 3600.0);
+            for (size_t i = 0; i < sats.size(); i++) {
+                Observation obs;
+                obs.station = s;
+                obs.time = t0 + (dt + rxClock);
+                obs.sat = sats[i];
+                obs.pr = 2.2e7 + 1.0e6 * std::sin(0.3 * i + dt / 7200.0) + 4.0e4 * s;
+                observations.push_back(obs);
+            }
+        }
+    }
+
+    std::vector<SPPIFCode> sppDirect(numStations), sppCached(numStations);
+    SatStateCache satCache(&navStore);
+    for (int s = 0; s < numStations; s++) {
+        sppDirect[s].setRinexNavStore(&navStore);
+        sppCached[s].setRinexNavStore(&navStore);
+        sppCached[s].setSatStateCache(&satCache);
+    }
+
+    // 没有可用星历的卫星会抛出异常，先去掉这些观测，只比较可以计算卫星状态的部分
+    {
+        std::vector<Observation> valid;
+        for (const Observation &obs: observations) {
+            try {
+                sppDirect[obs.station].computeAtTransmitTime(obs.time, obs.pr, obs.sat);
+                valid.push_back(obs);
+            }
+            catch (InvalidRequest &e) {
+                continue;
+            }
+        }
+        observations.swap(valid);
+    }
+
+    // 不使用缓存
+    std::vector<Xvt> xvtDirect(observations.size());
+    Clock::time_point tStart = Clock::now();
+    for (size_t k = 0; k < observations.size(); k++) {
+        const Observation &obs = observations[k];
+        xvtDirect[k] = sppDirect[obs.station].computeAtTransmitTime(obs.time, obs.pr, obs.sat);
+    }
+    double directSec = seconds(tStart);
+
+    // 共享缓存
+    std::vector<Xvt> xvtCached(observations.size());
+    size_t numMismatch = 0;
+    tStart = Clock::now();
+    for (size_t k = 0; k < observations.size(); k++) {
+        const Observation &obs = observations[k];
+        xvtCached[k] = sppCached[obs.station].computeAtTransmitTime(obs.time, obs.pr, obs.sat);
+    }
+    double cachedSec = seconds(tStart);
+
+    double maxPosDiff = 0.0, maxClkDiff = 0.0;
+    for (size_t k = 0; k < observations.size(); k++) {
+        maxPosDiff = std::max(maxPosDiff, (xvtDirect[k].x - xvtCached[k].x).norm());
+        maxClkDiff = std::max(maxClkDiff, std::fabs(xvtDirect[k].clkbias - xvtCached[k].clkbias) * C_MPS);
+    }
+    if (maxPosDiff > 1.0e-3 || maxClkDiff > 1.0e-3) {
+        cout << "extrapolation error too large" << endl;
+        numMismatch++;
+    }
+
+    size_t numCalls = satCache.numHits() + satCache.numMisses();
+    cout << "stations: " << numStations << ", sats: " << sats.size()
+         << ", observations with ephemeris: " << observations.size() << endl;
+    cout << "cache hits: " << satCache.numHits() << ", misses: " << satCache.numMisses()
+         << ", hit rate: " << fixed << setprecision(3) << double(satCache.numHits()) / std::max<size_t>(numCalls, 1)
+         << endl;
+    cout << scientific << setprecision(2) << "max position diff: " << maxPosDiff << " m, max clock diff: "
+         << maxClkDiff << " m" << endl;
+    cout << fixed << setprecision(1)
+         << "direct: " << directSec * 1.0e9 / observations.size() << " ns/obs, "
+         << "cached: " << cachedSec * 1.0e9 / observations.size() << " ns/obs, "
+         << "speedup: " << setprecision(2) << directSec / cachedSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
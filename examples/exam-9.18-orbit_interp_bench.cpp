@@ -0,0 +1,149 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 广播星历轨道插值测试：
+//  1. 读入导航文件，每隔 step 秒对每颗 GPS 卫星分别用 RinexNavStore::getXvt 和 OrbitInterpolator 计算卫星状态，
+//     统计不同弧段长度、阶数下位置、速度、钟差的最大差异，没有可用星历时两者都应抛出异常；
+//  2. 按 rate Hz 模拟 10 分钟的高采样率处理，比较两种做法每秒能计算的卫星状态数。
+//
+// 默认设置（10 分钟弧段、6 阶）位置差异超过 1 毫米、速度差异超过 1e-5 m/s 或钟差差异超过 1 毫米时算作不一致。
+//
+// 用法：orbit_interp_bench [导航文件，默认 data/ABMF00GLP_R_20210010000_01D_MN.rnx] [step 秒，默认 3.7] [rate Hz，默认 50]
+//
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "RinexNavStore.hpp"
+#include "OrbitInterpolator.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+struct Config {
+    double arcLength;
+    int degree;
+};
+
+int main(int argc, char *argv[]) {
+    string navFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_MN.rnx";
+    double step = (argc > 2) ? atof(argv[2]) : 3.7;
+    double rate = (argc > 3) ? atof(argv[3]) : 50.0;
+
+    RinexNavStore navStore;
+    navStore.loadFile(navFile);
+
+    std::vector<SatID> sats;
+    for (int prn = 1; prn <= MAXGPSPRN; prn++) {
+        if (navStore.gpsEphData.contains(PackedSat('G', prn))) {
+            sats.push_back(PackedSat('G', prn).toSatID());
+        }
+    }
+    if (sats.empty()) {
+        cout << "no GPS ephemeris in " << navFile << endl;
+        return 1;
+    }
+    cout << "file: " << navFile << ", GPS sats: " << sats.size() << endl;
+
+    CommonTime t0 = CivilTime2CommonTime(CivilTime(2021, 1, 1, 0, 0, 0.0));
+    t0.setTimeSystem(TimeSystem::GPS);
+
+    //-------------------
+    // 1. 与直接计算的差异
+    //-------------------
+    const Config configs[] = {{600.0, 6}, {900.0, 8}, {900.0, 6}, {600.0, 4}, {300.0, 4}};
+    size_t numMismatch = 0;
+    for (const Config &config: configs) {
+        OrbitInterpolator orbitInterp(&navStore);
+        orbitInterp.setArcLength(config.arcLength);
+        orbitInterp.setDegree(config.degree);
+
+        double maxPosDiff = 0.0, maxVelDiff = 0.0, maxClkDiff = 0.0;
+        size_t numCompared = 0, numThrowMismatch = 0;
+        for (double dt = 0.0; dt < 86400.0; dt += step) {
+            CommonTime t = t0 + dt;
+            for (const SatID &sat: sats) {
+                Xvt direct, interp;
+                bool directOk = true, interpOk = true;
+                try { direct = navStore.getXvt(sat, t); }
+                catch (InvalidRequest &e) { directOk = false; }
+                try { interp = orbitInterp.getXvt(sat, t); }
+                catch (InvalidRequest &e) { interpOk = false; }
+                if (directOk != interpOk) {
+                    numThrowMismatch++;
+                    continue;
+                }
+                if (!directOk) continue;
+
+                numCompared++;
+                maxPosDiff = std::max(maxPosDiff, (direct.x - interp.x).norm());
+                maxVelDiff = std::max(maxVelDiff, (direct.v - interp.v).norm());
+                maxClkDiff = std::max(maxClkDiff,
+                                      std::fabs(direct.clkbias + direct.relcorr - interp.clkbias - interp.relcorr));
+            }
+        }
+
+        cout << "arc " << fixed << setprecision(0) << config.arcLength << " s, degree " << config.degree
+             << ": compared " << numCompared << ", fits " << orbitInterp.getNumFits()
+             << scientific << setprecision(2)
+             << ", max diff pos " << maxPosDiff << " m, vel " << maxVelDiff
+             << " m/s, clk " << maxClkDiff << " s" << endl;
+
+        numMismatch += numThrowMismatch;
+        if (config.arcLength == 600.0 && config.degree == 6 &&
+            (maxPosDiff > 1.0e-3 || maxVelDiff > 1.0e-5 || maxClkDiff * C_MPS > 1.0e-3)) {
+            cout << "default interpolation error too large" << endl;
+            numMismatch++;
+        }
+    }
+
+    //-------------------
+    // 2. 高采样率的耗时
+    //-------------------
+    // 12 时起 10 分钟内各卫星可以计算的时刻
+    std::vector<std::pair<CommonTime, SatID>> requests;
+    CommonTime tHigh = t0 + 12.0 * 3600.0;
+    for (double dt = 0.0; dt < 600.0; dt += 1.0 / rate) {
+        CommonTime t = tHigh + dt;
+        for (const SatID &sat: sats) {
+            try { navStore.getXvt(sat, t); }
+            catch (InvalidRequest &e) { continue; }
+            requests.push_back(std::make_pair(t, sat));
+        }
+    }
+
+    double checksumDirect = 0.0, checksumInterp = 0.0;
+    Clock::time_point tStart = Clock::now();
+    for (const auto &req: requests) {
+        checksumDirect += navStore.getXvt(req.second, req.first).x[0];
+    }
+    double directSec = seconds(tStart);
+
+    OrbitInterpolator orbitInterp(&navStore);
+    tStart = Clock::now();
+    for (const auto &req: requests) {
+        checksumInterp += orbitInterp.getXvt(req.second, req.first).x[0];
+    }
+    double interpSec = seconds(tStart);
+
+    if (std::fabs(checksumDirect - checksumInterp) > 1.0e-3 * requests.size()) {
+        cout << "checksum mismatched" << endl;
+        numMismatch++;
+    }
+
+    cout << fixed << setprecision(0)
+         << rate << " Hz, requests " << requests.size() << ", fits " << orbitInterp.getNumFits() << endl;
+    cout << "direct svXvt : " << requests.size() / directSec << " evaluations/s" << endl;
+    cout << "interpolation: " << requests.size() / interpSec << " evaluations/s" << endl;
+    cout << setprecision(2) << "speedup: " << directSec / interpSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 批量计算广播星历测试：
+//  1. 读入导航文件中所有 GPS 和北斗星历，另外由一组北斗星历构造倾角为 1 度（GEO）和 40 度的星历，
+//     整理成 BroadcastOrbitBatch；
+//  2. 在每组星历 toe 前后的多个时刻，分别用 svXvt 逐个计算和 BroadcastOrbitBatch 批量计算，
+//     按轨道类型统计位置、速度、钟差的最大差异；
+//  3. 当前 CPU 支持的各个向量内核（SSE2、AVX2）与标量的批量计算比较；
+//  4. 比较 svXvt 和各个指令集的批量计算计算所有星历的耗时。
+//
+// 与 svXvt 相比，位置或钟差（含相对论改正）的差异超过 0.1 毫米、速度差异超过 1e-6 m/s 时算作不一致；
+// 向量内核与标量的批量计算相比，位置差异超过 1e-6 米、速度差异超过 1e-9 m/s、相对论改正差异超过 1e-9 米时算作不一致。
+//
+// 用法：orbit_batch_bench [导航文件，默认 data/ABMF00GLP_R_20210010000_01D_MN.rnx] [重复次数，默认 200]
+//
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "RinexNavStore.hpp"
+#include "BroadcastOrbitBatch.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// RinexNavStore::loadFile 只读入 SYS 对应的系统，北斗星历在这里逐条读入
+static void loadBDSEphs(RinexNavStore &navStore, string &navFile) {
+    fstream navFileStream(navFile.c_str(), ios::in);
+    string line;
+    while (getline(navFileStream, line)) {
+        if (line.find("END OF HEADER") != string::npos) break;
+    }
+    while (getline(navFileStream, line)) {
+        if (!line.empty() && line[0] == 'C') {
+            NavEphBDS bdsEph;
+            navStore.loadBDSEph(bdsEph, line, navFileStream);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    string navFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_MN.rnx";
+    int numRepeats = (argc > 2) ? atoi(argv[2]) : 200;
+
+    RinexNavStore navStore;
+    navStore.loadFile(navFile);
+    loadBDSEphs(navStore, navFile);
+
+    std::vector<NavEphGPS> gpsEphs;
+    std::vector<NavEphBDS> bdsEphs;
+    for (int prn = 1; prn <= MAXGPSPRN; prn++) {
+        const std::vector<NavEphGPS> *pEphs = navStore.gpsEphData.ephemerides(PackedSat('G', prn));
+        if (pEphs != NULL) gpsEphs.insert(gpsEphs.end(), pEphs->begin(), pEphs->end());
+    }
+    for (int prn = 1; prn <= MAXBDSPRN; prn++) {
+        const std::vector<NavEphBDS> *pEphs = navStore.bdsEphData.ephemerides(PackedSat('C', prn));
+        if (pEphs != NULL) bdsEphs.insert(bdsEphs.end(), pEphs->begin(), pEphs->end());
+    }
+
+    // 文件中没有 GEO 卫星时，把一组北斗星历的倾角改为 1 度和 40 度，检查 GEO 和其他倾角的分支
+    if (!bdsEphs.empty()) {
+        NavEphBDS geoEph = bdsEphs.front();
+        geoEph.i0 = 1.0 * DEG_TO_RAD;
+        bdsEphs.push_back(geoEph);
+        NavEphBDS otherEph = bdsEphs.front();
+        otherEph.i0 = 40.0 * DEG_TO_RAD;
+        bdsEphs.push_back(otherEph);
+    }
+
+    BroadcastOrbitBatch batch;
+    batch.reserve(gpsEphs.size() + bdsEphs.size());
+    for (const NavEphGPS &eph: gpsEphs) batch.add(eph);
+    for (const NavEphBDS &eph: bdsEphs) batch.add(eph);
+    if (batch.size() == 0) {
+        cout << "no GPS or BDS ephemeris in " << navFile << endl;
+        return 1;
+    }
+
+    // 第 k 组星历的 toe
+    std::vector<CommonTime> toes;
+    for (const NavEphGPS &eph: gpsEphs) toes.push_back(eph.ctToe);
+    for (const NavEphBDS &eph: bdsEphs) toes.push_back(eph.ctToe);
+
+    size_t numType[3] = {0, 0, 0};
+    for (size_t k = 0; k < batch.size(); k++) numType[batch.getOrbitType(k)]++;
+    cout << "GPS ephemerides: " << gpsEphs.size() << ", BDS ephemerides: " << bdsEphs.size()
+         << " (Kepler " << numType[BroadcastOrbitBatch::KEPLER] - gpsEphs.size()
+         << ", GEO " << numType[BroadcastOrbitBatch::BDS_GEO]
+         << ", other " << numType[BroadcastOrbitBatch::NO_ORBIT] << ")" << endl;
+
+    //-------------------
+    // 1. 与逐个计算的差异
+    //-------------------
+    const char *typeNames[3] = {"GPS/BDS Kepler", "BDS GEO", "BDS other"};
+    double maxPosDiff[3] = {0.0}, maxVelDiff[3] = {0.0}, maxClkDiff[3] = {0.0};
+    const double offsets[] = {-7199.5, -3600.0, -61.25, 0.0, 0.125, 1234.5, 3600.0, 7199.5};
+    OrbitBatchResult result;
+    std::vector<CommonTime> epochs(batch.size());
+    for (double offset: offsets) {
+        for (size_t k = 0; k < batch.size(); k++) epochs[k] = toes[k] + offset;
+        batch.compute(epochs, result);
+
+        for (size_t k = 0; k < batch.size(); k++) {
+            Xvt ref = (k < gpsEphs.size()) ? gpsEphs[k].svXvt(epochs[k])
+                                           : bdsEphs[k - gpsEphs.size()].svXvt(epochs[k]);
+            Xvt xvt = result.getXvt(k);
+            int type = batch.getOrbitType(k);
+            maxPosDiff[type] = std::max(maxPosDiff[type], (ref.x - xvt.x).norm());
+            maxVelDiff[type] = std::max(maxVelDiff[type], (ref.v - xvt.v).norm());
+            maxClkDiff[type] = std::max(maxClkDiff[type],
+                                        std::fabs(ref.clkbias + ref.relcorr - xvt.clkbias - xvt.relcorr) * C_MPS);
+        }
+    }
+
+    size_t numMismatch = 0;
+    for (int type = 0; type < 3; type++) {
+        if (numType[type] == 0) continue;
+        cout << scientific << setprecision(2) << typeNames[type]
+             << ": max diff pos " << maxPosDiff[type] << " m, vel " << maxVelDiff[type]
+             << " m/s, clk " << maxClkDiff[type] << " m" << endl;
+        if (maxPosDiff[type] > 1.0e-4 || maxVelDiff[type] > 1.0e-6 || maxClkDiff[type] > 1.0e-4) {
+            cout << typeNames[type] << " mismatched" << endl;
+            numMismatch++;
+        }
+    }
+
+    //-------------------
+    // 2. 向量内核与标量计算
+    //-------------------
+    const char *levelNames[3] = {"scalar", "SSE2", "AVX2"};
+    int maxLevel = BroadcastOrbitBatch::supportedSimdLevel();
+    for (int level = BroadcastOrbitBatch::SIMD_SSE2; level <= maxLevel; level++) {
+        double maxPos = 0.0, maxVel = 0.0, maxRel = 0.0;
+        OrbitBatchResult reference;
+        for (double offset: offsets) {
+            for (size_t k = 0; k < batch.size(); k++) epochs[k] = toes[k] + offset;
+            batch.setSimdLevel(BroadcastOrbitBatch::SIMD_SCALAR);
+            batch.compute(epochs, reference);
+            batch.setSimdLevel(BroadcastOrbitBatch::SimdLevel(level));
+            batch.compute(epochs, result);
+            for (size_t k = 0; k < batch.size(); k++) {
+                Xvt ref = reference.getXvt(k), xvt = result.getXvt(k);
+                maxPos = std::max(maxPos, (ref.x - xvt.x).norm());
+                maxVel = std::max(maxVel, (ref.v - xvt.v).norm());
+                maxRel = std::max(maxRel, std::fabs(ref.relcorr - xvt.relcorr) * C_MPS);
+            }
+        }
+        cout << scientific << setprecision(2) << levelNames[level]
+             << " kernel vs scalar batch: max diff pos " << maxPos << " m, vel " << maxVel
+             << " m/s, relcorr " << maxRel << " m" << endl;
+        if (maxPos > 1.0e-6 || maxVel > 1.0e-9 || maxRel > 1.0e-9) {
+            cout << levelNames[level] << " kernel mismatched" << endl;
+            numMismatch++;
+        }
+    }
+
+    //-------------------
+    // 3. 耗时
+    //-------------------
+    double checksumScalar = 0.0, checksumBatch = 0.0;
+    Clock::time_point tStart = Clock::now();
+    for (int r = 0; r < numRepeats; r++) {
+        double offset = -3600.0 + 7200.0 * r / numRepeats;
+        for (size_t k = 0; k < gpsEphs.size(); k++) {
+            checksumScalar += gpsEphs[k].svXvt(toes[k] + offset).x[0];
+        }
+        for (size_t k = 0; k < bdsEphs.size(); k++) {
+            checksumScalar += bdsEphs[k].svXvt(toes[k + gpsEphs.size()] + offset).x[0];
+        }
+    }
+    double scalarSec = seconds(tStart);
+
+    double numEvaluations = double(numRepeats) * batch.size();
+    cout << fixed << setprecision(1)
+         << "scalar svXvt: " << scalarSec * 1.0e9 / numEvaluations << " ns/sat" << endl;
+    double batchSec[3] = {0.0, 0.0, 0.0};
+    for (int level = BroadcastOrbitBatch::SIMD_SCALAR; level <= maxLevel; level++) {
+        batch.setSimdLevel(BroadcastOrbitBatch::SimdLevel(level));
+        checksumBatch = 0.0;
+        tStart = Clock::now();
+        for (int r = 0; r < numRepeats; r++) {
+            double offset = -3600.0 + 7200.0 * r / numRepeats;
+            for (size_t k = 0; k < batch.size(); k++) epochs[k] = toes[k] + offset;
+            batch.compute(epochs, result);
+            for (size_t k = 0; k < batch.size(); k++) checksumBatch += result.x[k];
+        }
+        batchSec[level] = seconds(tStart);
+
+        if (std::fabs(checksumScalar - checksumBatch) > 1.0e-4 * numRepeats * batch.size()) {
+            cout << "checksum mismatched (" << levelNames[level] << ")" << endl;
+            numMismatch++;
+        }
+        cout << "batch " << std::left << setw(6) << levelNames[level] << std::right << ": "
+             << batchSec[level] * 1.0e9 / numEvaluations << " ns/sat" << endl;
+    }
+    cout << setprecision(2) << "speedup: " << scalarSec / batchSec[maxLevel]
+         << " (" << levelNames[maxLevel] << "), vector kernel over scalar batch "
+         << batchSec[BroadcastOrbitBatch::SIMD_SCALAR] / batchSec[maxLevel] << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
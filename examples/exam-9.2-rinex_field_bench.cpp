@@ -0,0 +1,168 @@
+//
+// Created by shjzh on 2026/10/18.
+//
+// RINEX 定宽字段解析：rinexStod/rinexStoi 与原来 substr + safeStod/safeStoi 的
+// 逐位一致性检查和速度对比。
+//  1. 随机生成 F14.3、D19.12/E19.12、I 型字段以及各种边界写法，逐个比较二进制位；
+//  2. 对导航电文文件（默认 data/ABMF00GLP_R_20210010000_01D_MN.rnx）中所有 D19.12 字段，
+//     按原来 RinexNavStore 的做法（整行 'D'->'e' 后 safeStod）比较；
+//  3. 统计两种方法每秒解析的字段数。
+//
+// 用法：rinex_field_bench [导航电文文件]
+//
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+#include "StringUtils.h"
+#include "RinexField.h"
+
+using namespace std;
+
+static bool sameBits(double a, double b) {
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// 原来的解析方法
+static double oldStod(string field) {
+    replace(field.begin(), field.end(), 'D', 'e');
+    return safeStod(field);
+}
+
+int main(int argc, char *argv[]) {
+    string navFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_MN.rnx";
+
+    std::mt19937_64 rng(20260418);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+
+    std::vector<string> floatFields;
+    std::vector<string> intFields;
+    char buf[64];
+
+    for (int i = 0; i < 200000; i++) {
+        // F14.3 观测值
+        double obs = (uni(rng) - 0.2) * 1.5e8;
+        snprintf(buf, sizeof(buf), "%14.3f", obs);
+        floatFields.push_back(buf);
+
+        // D19.12 导航电文，指数随机
+        double mant = (uni(rng) - 0.5) * 20.0;
+        int e = int(uni(rng) * 40) - 20;
+        snprintf(buf, sizeof(buf), "%19.12E", mant * pow(10.0, e));
+        string s = buf;
+        if (i % 2) replace(s.begin(), s.end(), 'E', 'D');
+        floatFields.push_back(s);
+
+        // F11.7 历元秒
+        snprintf(buf, sizeof(buf), "%11.7f", uni(rng) * 60.0);
+        floatFields.push_back(buf);
+
+        snprintf(buf, sizeof(buf), "%6d", int((uni(rng) - 0.5) * 2.0e5));
+        intFields.push_back(buf);
+    }
+
+    // 边界写法
+    const char *specialFloats[] = {
+            "", "              ", "         0.000", "        -0.000", "0", "-0.0D+00",
+            "  .5", "1.", "+1.5", "1.5E", "1.5D+", "12.5abc", "1.5 2", "-", ".", "abc",
+            "1.234567890123456789012E+05", "9007199254740993", "1e-320", "1e+400",
+            " 1.000000000000D-300", " 4.319990000000E+05", "-9.094947017729E-12",
+            "123456789012345678901234", "0.000000000000000000001234"
+    };
+    for (const char *s: specialFloats) floatFields.push_back(s);
+
+    const char *specialInts[] = {
+            "", "   ", "  12", " -7 ", "+5", "- 5", "12a", "12 34", "2147483647",
+            "2147483648", "-2147483648", "99999999999", "abc"
+    };
+    for (const char *s: specialInts) intFields.push_back(s);
+
+    size_t numFloatMismatch = 0, numIntMismatch = 0;
+    for (const auto &s: floatFields) {
+        double a = rinexStod(s.data(), s.data() + s.size());
+        double b = oldStod(s);
+        if (!sameBits(a, b)) {
+            if (numFloatMismatch < 10)
+                cout << "float mismatch: >" << s << "< " << setprecision(17) << a << " " << b << endl;
+            numFloatMismatch++;
+        }
+    }
+    for (const auto &s: intFields) {
+        int a = rinexStoi(s.data(), s.data() + s.size());
+        int b = safeStoi(s);
+        if (a != b) {
+            if (numIntMismatch < 10)
+                cout << "int mismatch: >" << s << "< " << a << " " << b << endl;
+            numIntMismatch++;
+        }
+    }
+    cout << "synthetic float fields: " << floatFields.size() << ", mismatched " << numFloatMismatch << endl;
+    cout << "synthetic int fields  : " << intFields.size() << ", mismatched " << numIntMismatch << endl;
+
+    // 导航电文文件中的全部 19 列字段
+    std::vector<string> navFields;
+    std::ifstream navStream(navFile);
+    if (navStream) {
+        string line;
+        bool inHeader = true;
+        while (getline(navStream, line)) {
+            stripTrailing(line);
+            if (inHeader) {
+                if (line.find("END OF HEADER") != string::npos) inHeader = false;
+                continue;
+            }
+            size_t first = (line.size() > 0 && line[0] != ' ') ? 23 : 4;
+            for (size_t pos = first; pos < line.size(); pos += 19) {
+                navFields.push_back(line.substr(pos, 19));
+            }
+        }
+        size_t numNavMismatch = 0;
+        for (const auto &s: navFields) {
+            if (!sameBits(rinexStod(s, 0, 19), oldStod(s))) numNavMismatch++;
+        }
+        cout << "nav file fields       : " << navFields.size() << ", mismatched " << numNavMismatch << endl;
+        numFloatMismatch += numNavMismatch;
+    } else {
+        cout << "nav file " << navFile << " not found, skipped" << endl;
+    }
+
+    // 速度
+    const std::vector<string> &benchFields = navFields.empty() ? floatFields : navFields;
+    typedef std::chrono::steady_clock Clock;
+    const int repeat = 5;
+    double sum = 0.0;
+
+    Clock::time_point t0 = Clock::now();
+    for (int r = 0; r < repeat; r++) {
+        for (const auto &s: benchFields) {
+            string line = s;
+            replace(line.begin(), line.end(), 'D', 'e');
+            sum += safeStod(line.substr(0, 19));
+        }
+    }
+    Clock::time_point t1 = Clock::now();
+    for (int r = 0; r < repeat; r++) {
+        for (const auto &s: benchFields) {
+            sum += rinexStod(s, 0, 19);
+        }
+    }
+    Clock::time_point t2 = Clock::now();
+
+    double n = double(benchFields.size()) * repeat;
+    double oldSec = std::chrono::duration<double>(t1 - t0).count();
+    double newSec = std::chrono::duration<double>(t2 - t1).count();
+    cout << fixed << setprecision(1);
+    cout << "substr + safeStod : " << setw(8) << n / oldSec / 1.0e6 << " Mfields/s" << endl;
+    cout << "rinexStod         : " << setw(8) << n / newSec / 1.0e6 << " Mfields/s" << endl;
+    cout << setprecision(2) << "speedup           : " << oldSec / newSec << "x"
+         << "   (checksum " << setprecision(3) << sum << ")" << endl;
+
+    return (numFloatMismatch == 0 && numIntMismatch == 0) ? 0 : 1;
+}
@@ -0,0 +1,268 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 多个导航文件加载测试：
+//  1. 把一个导航文件中所有记录的历元平移 0..numDays-1 天，生成连续 numDays 天的日文件，
+//     每天的文件还带有前一天最后 2 小时的记录（与实际合并的日文件一样，相邻文件有重复的星历）；
+//  2. 分别用 RinexNavStore::loadFile 逐个加载和 RinexNavStore::loadFiles 一次加载，
+//     比较每颗卫星的星历（toe、IODE、M0、钟差参数）和 satTable，检查 loadFiles 去掉的重复星历组数；
+//  3. 比较逐个加载、loadFiles 单线程和多线程加载所有文件的耗时（单核时 loadFiles 不开线程，
+//     只能看到合并去重的开销）。
+//
+// 生成的文件放在临时目录中，测试结束后删除。
+//
+// 用法：nav_multi_load_bench [导航文件，默认 data/ABMF00GLP_R_20210010000_01D_MN.rnx] [天数，默认 30]
+//                            [临时目录，默认 /tmp] [重复次数，默认 5]
+//
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "RinexNavStore.hpp"
+#include "TimeConvert.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 导航文件中的一条记录：历元行和续行
+struct NavRecord {
+    vector<string> lines;
+    CommonTime epoch;
+};
+
+// 读入头记录和所有记录
+static bool readNavFile(const string &navFile, vector<string> &header, vector<NavRecord> &records) {
+    ifstream in(navFile.c_str());
+    if (!in) return false;
+    string line;
+    while (getline(in, line)) {
+        header.push_back(line);
+        if (line.find("END OF HEADER") != string::npos) break;
+    }
+    while (getline(in, line)) {
+        if (line.empty()) continue;
+        if (line[0] != ' ') {
+            NavRecord record;
+            CivilTime cvt(atoi(line.substr(4, 4).c_str()), atoi(line.substr(9, 2).c_str()),
+                          atoi(line.substr(12, 2).c_str()), atoi(line.substr(15, 2).c_str()),
+                          atoi(line.substr(18, 2).c_str()), atof(line.substr(21, 2).c_str()));
+            record.epoch = CivilTime2CommonTime(cvt);
+            records.push_back(record);
+        }
+        if (!records.empty()) records.back().lines.push_back(line);
+    }
+    return true;
+}
+
+// 把记录的历元平移 days 天后写出
+static void writeRecord(ofstream &out, const NavRecord &record, int days) {
+    CivilTime cvt = CommonTime2CivilTime(record.epoch + days * 86400.0);
+    char epochStr[32];
+    snprintf(epochStr, sizeof(epochStr), "%04d %02d %02d %02d %02d %02d",
+             cvt.year, cvt.month, cvt.day, cvt.hour, cvt.minute, int(cvt.second + 0.5));
+    string first = record.lines[0];
+    first.replace(4, 19, epochStr);
+    out << first << "\n";
+    for (size_t i = 1; i < record.lines.size(); i++) {
+        out << record.lines[i] << "\n";
+    }
+}
+
+// 两个 store 中 GPS、北斗和 GLONASS 的星历是否相同，不同时输出第一处差异
+static bool sameEphs(RinexNavStore &a, RinexNavStore &b) {
+    if (a.satTable.size() != b.satTable.size()) {
+        cout << "satTable size " << a.satTable.size() << " vs " << b.satTable.size() << endl;
+        return false;
+    }
+    for (int prn = 1; prn <= MAXGPSPRN; prn++) {
+        const vector<NavEphGPS> *pa = a.gpsEphData.ephemerides(PackedSat('G', prn));
+        const vector<NavEphGPS> *pb = b.gpsEphData.ephemerides(PackedSat('G', prn));
+        if ((pa == NULL) != (pb == NULL)) return false;
+        if (pa == NULL) continue;
+        if (pa->size() != pb->size()) {
+            cout << "G" << prn << ": " << pa->size() << " vs " << pb->size() << " ephemerides" << endl;
+            return false;
+        }
+        for (size_t k = 0; k < pa->size(); k++) {
+            const NavEphGPS &ea = (*pa)[k], &eb = (*pb)[k];
+            if (ea.ctToe - eb.ctToe != 0.0 || ea.IODE != eb.IODE || ea.M0 != eb.M0 || ea.af0 != eb.af0) {
+                cout << "G" << prn << ": ephemeris " << k << " differs at " << ea.ctToe << endl;
+                return false;
+            }
+        }
+    }
+    for (int prn = 1; prn <= MAXBDSPRN; prn++) {
+        const vector<NavEphBDS> *pa = a.bdsEphData.ephemerides(PackedSat('C', prn));
+        const vector<NavEphBDS> *pb = b.bdsEphData.ephemerides(PackedSat('C', prn));
+        if ((pa == NULL) != (pb == NULL)) return false;
+        if (pa == NULL) continue;
+        if (pa->size() != pb->size()) return false;
+        for (size_t k = 0; k < pa->size(); k++) {
+            const NavEphBDS &ea = (*pa)[k], &eb = (*pb)[k];
+            if (ea.ctToe - eb.ctToe != 0.0 || ea.AODE != eb.AODE || ea.M0 != eb.M0 || ea.af0 != eb.af0) {
+                return false;
+            }
+        }
+    }
+    for (int prn = 1; prn <= PackedSat::maxPrn; prn++) {
+        const vector<NavEphGLO> *pa = a.gloEphData.ephemerides(PackedSat('R', prn));
+        const vector<NavEphGLO> *pb = b.gloEphData.ephemerides(PackedSat('R', prn));
+        if ((pa == NULL) != (pb == NULL)) return false;
+        if (pa == NULL) continue;
+        if (pa->size() != pb->size()) return false;
+        for (size_t k = 0; k < pa->size(); k++) {
+            const NavEphGLO &ea = (*pa)[k], &eb = (*pb)[k];
+            if (ea.ctToe - eb.ctToe != 0.0 || ea.pos[0] != eb.pos[0] || ea.TauN != eb.TauN) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    string navFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_MN.rnx";
+    int numDays = (argc > 2) ? atoi(argv[2]) : 30;
+    string tmpDir = (argc > 3) ? argv[3] : "/tmp";
+    int numRepeats = (argc > 4) ? atoi(argv[4]) : 5;
+
+    vector<string> header;
+    vector<NavRecord> records;
+    if (!readNavFile(navFile, header, records) || records.empty()) {
+        cout << "can't read " << navFile << endl;
+        return 1;
+    }
+
+    // 文件中最后一个历元，前一天的记录从它之前 2 小时起重复
+    CommonTime lastEpoch = records.front().epoch;
+    for (const NavRecord &record: records) {
+        if (record.epoch - lastEpoch > 0.0) lastEpoch = record.epoch;
+    }
+
+    //-------------------
+    // 1. 生成日文件
+    //-------------------
+    vector<string> files;
+    for (int d = 0; d < numDays; d++) {
+        char name[64];
+        snprintf(name, sizeof(name), "/nav_multi_load_%03d.rnx", d);
+        string file = tmpDir + name;
+        ofstream out(file.c_str());
+        for (const string &line: header) out << line << "\n";
+        if (d > 0) {
+            for (const NavRecord &record: records) {
+                if (lastEpoch - record.epoch <= 7200.0) writeRecord(out, record, d - 1);
+            }
+        }
+        for (const NavRecord &record: records) writeRecord(out, record, d);
+        if (!out) {
+            cout << "can't write " << file << endl;
+            return 1;
+        }
+        files.push_back(file);
+    }
+
+    //-------------------
+    // 2. 比较两种加载方式
+    //-------------------
+    size_t numMismatch = 0;
+
+    RinexNavStore seqStore;
+    for (string file: files) seqStore.loadFile(file);
+
+    RinexNavStore bulkStore;
+    size_t numDuplicates = bulkStore.loadFiles(files);
+
+    RinexNavStore singleStore;
+    size_t numDuplicatesSingle = singleStore.loadFiles(files, 1);
+
+    // 每组重复的记录都有完全相同的一组，加载后的星历应与逐个加载相同
+    if (!sameEphs(seqStore, bulkStore) || !sameEphs(seqStore, singleStore)) {
+        cout << "loadFiles mismatched with loadFile" << endl;
+        numMismatch++;
+    }
+    if (numDuplicates != numDuplicatesSingle) {
+        cout << "duplicates mismatched: " << numDuplicates << " vs " << numDuplicatesSingle << endl;
+        numMismatch++;
+    }
+    // 相邻文件重复的星历都应被去掉，EphemerisStore 中不再有 toe 相同的星历
+    size_t numBulk = bulkStore.gpsEphData.size() + bulkStore.bdsEphData.size() + bulkStore.gloEphData.size();
+    size_t numSeq = seqStore.gpsEphData.size() + seqStore.bdsEphData.size() + seqStore.gloEphData.size();
+    if (numBulk + numDuplicates != numSeq) {
+        cout << "ephemerides added: " << numBulk << " + " << numDuplicates << " duplicates, loadFile added "
+             << numSeq << endl;
+        numMismatch++;
+    }
+    if (numDays > 1 && numDuplicates == 0) {
+        cout << "no duplicates removed" << endl;
+        numMismatch++;
+    }
+
+    // 缺少文件时抛出异常，不修改已有的数据
+    vector<string> badFiles = files;
+    badFiles.push_back(tmpDir + "/nav_multi_load_missing.rnx");
+    size_t numBefore = bulkStore.gpsEphData.size();
+    try {
+        bulkStore.loadFiles(badFiles);
+        cout << "missing file not reported" << endl;
+        numMismatch++;
+    }
+    catch (FileMissingException &e) {
+        if (bulkStore.gpsEphData.size() != numBefore) {
+            cout << "store modified after a failed load" << endl;
+            numMismatch++;
+        }
+    }
+
+    cout << "files: " << files.size() << ", GPS ephemerides: " << bulkStore.gpsEphData.size()
+         << ", BDS ephemerides: " << bulkStore.bdsEphData.size()
+         << ", GLONASS ephemerides: " << bulkStore.gloEphData.size()
+         << ", duplicates removed: " << numDuplicates << endl;
+
+    //-------------------
+    // 3. 耗时
+    //-------------------
+    Clock::time_point tStart = Clock::now();
+    for (int r = 0; r < numRepeats; r++) {
+        RinexNavStore navStore;
+        for (string file: files) navStore.loadFile(file);
+    }
+    double seqSec = seconds(tStart) / numRepeats;
+
+    tStart = Clock::now();
+    for (int r = 0; r < numRepeats; r++) {
+        RinexNavStore navStore;
+        navStore.loadFiles(files, 1);
+    }
+    double singleSec = seconds(tStart) / numRepeats;
+
+    tStart = Clock::now();
+    for (int r = 0; r < numRepeats; r++) {
+        RinexNavStore navStore;
+        navStore.loadFiles(files);
+    }
+    double bulkSec = seconds(tStart) / numRepeats;
+
+    cout << fixed << setprecision(1)
+         << "loadFile one by one  : " << seqSec * 1.0e3 << " ms" << endl;
+    cout << "loadFiles, 1 thread  : " << singleSec * 1.0e3 << " ms" << endl;
+    int numThreads = RinexNavStore::loadThreadCount(0, files.size());
+    cout << "loadFiles, " << numThreads << " threads : " << bulkSec * 1.0e3 << " ms" << endl;
+    // 单核时 loadFiles 退化为逐个解析，比 loadFile 多出的是合并去重的开销，测不出多线程的加速
+    if (numThreads == 1) {
+        cout << "single core: multi-threaded speedup not measured" << endl;
+    }
+    cout << "mismatched: " << numMismatch << endl;
+
+    for (const string &file: files) std::remove(file.c_str());
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// SP3 精密星历插值测试：
+//  1. 每颗 GPS 卫星取导航文件中 12 时的一组星历，按 interval 秒的间隔生成连续两天的 SP3-d 日文件，
+//     用 SP3Store::loadFiles 读入，检查历元数、卫星数和跨天的网格；
+//  2. 每隔 step 秒比较 SP3Store::getXvt 与该组星历直接计算（NavEphGPS::svXvt）的位置、钟差，
+//     速度与 svXvt 位置的中心差分比较（svXvt 的速度本身有 0.1~0.2 m/s 的误差），
+//     分别统计数据中部和首尾 degree/2 个间隔内（窗口不能居中）不同插值阶数下的最大差异，
+//     数据范围以外的查询应抛出异常；
+//  3. 按 30 秒的历元、两个测站、每个测站迭代两次模拟 SPP，比较 SP3Store 与 RinexNavStore::getXvt
+//     每秒能计算的卫星状态数。
+//
+// SP3 中的位置只保留到毫米，钟差保留到 1e-12 秒。默认 9 阶插值在数据中部的位置差异超过 1 厘米、
+// 速度差异超过 1e-4 m/s 或钟差差异超过 1 毫米时算作不一致。
+// 相对论改正 -2 r·v / c^2 与广播星历用的开普勒根数公式本身相差几厘米，超过 5 厘米时算作不一致。生成的文件放在临时目录中，测试结束后删除。
+//
+// 用法：sp3_store_bench [导航文件，默认 data/ABMF00GLP_R_20210010000_01D_MN.rnx] [采样间隔秒，默认 900]
+//                       [step 秒，默认 7.3] [临时目录，默认 /tmp]
+//
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "RinexNavStore.hpp"
+#include "SP3Store.h"
+#include "TimeConvert.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 写出 [start, start + 1 天) 的 SP3-d 文件
+static void writeSP3(const string &file, const CommonTime &start, double interval,
+                     const vector<SatID> &sats, const vector<NavEphGPS> &ephs) {
+    int numEpochs = int(86400.0 / interval + 0.5);
+    CivilTime cvt = CommonTime2CivilTime(start);
+    GPSWeekSecond ws;
+    CommonTime2WeekSecond(start, ws);
+
+    FILE *fp = fopen(file.c_str(), "w");
+    fprintf(fp, "#dP%4d %2d %2d %2d %2d %11.8f %7d ORBIT IGS14 BCT  BENCH\n",
+            cvt.year, cvt.month, cvt.day, cvt.hour, cvt.minute, cvt.second, numEpochs);
+    fprintf(fp, "## %4d %15.8f %14.8f %5ld %15.13f\n", int(ws.week), ws.sow, interval, start.m_day, 0.0);
+    fprintf(fp, "+  %3d   ", int(sats.size()));
+    for (size_t i = 0; i < sats.size(); i++) {
+        if (i > 0 && i % 17 == 0) fprintf(fp, "\n+        ");
+        fprintf(fp, "G%02d", sats[i].id);
+    }
+    fprintf(fp, "\n%%c G  cc GPS ccc cccc cccc cccc cccc ccccc ccccc ccccc ccccc\n");
+    fprintf(fp, "/* generated by sp3_store_bench from broadcast ephemerides\n");
+    for (int i = 0; i < numEpochs; i++) {
+        CommonTime t = start + i * interval;
+        CivilTime ct = CommonTime2CivilTime(t);
+        fprintf(fp, "*  %4d %2d %2d %2d %2d %11.8f\n", ct.year, ct.month, ct.day, ct.hour, ct.minute, ct.second);
+        for (size_t s = 0; s < sats.size(); s++) {
+            Xvt xvt = ephs[s].svXvt(t);
+            fprintf(fp, "PG%02d%14.6f%14.6f%14.6f%14.6f\n", sats[s].id,
+                    xvt.x[0] / 1000.0, xvt.x[1] / 1000.0, xvt.x[2] / 1000.0, xvt.clkbias * 1.0e6);
+        }
+    }
+    fprintf(fp, "EOF\n");
+    fclose(fp);
+}
+
+int main(int argc, char *argv[]) {
+    string navFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_MN.rnx";
+    double interval = (argc > 2) ? atof(argv[2]) : 900.0;
+    double step = (argc > 3) ? atof(argv[3]) : 7.3;
+    string tmpDir = (argc > 4) ? argv[4] : "/tmp";
+
+    RinexNavStore navStore;
+    navStore.loadFile(navFile);
+
+    CommonTime t0 = CivilTime2CommonTime(CivilTime(2021, 1, 1, 0, 0, 0.0));
+    t0.setTimeSystem(TimeSystem::GPS);
+
+    vector<SatID> sats;
+    vector<NavEphGPS> ephs;
+    for (int prn = 1; prn <= MAXGPSPRN; prn++) {
+        SatID sat = PackedSat('G', prn).toSatID();
+        if (!navStore.gpsEphData.contains(PackedSat(sat))) continue;
+        try {
+            ephs.push_back(navStore.findGPSEph(sat, t0 + 43200.0));
+        }
+        catch (InvalidRequest &e) { continue; }
+        sats.push_back(sat);
+    }
+    if (sats.empty()) {
+        cout << "no GPS ephemeris in " << navFile << endl;
+        return 1;
+    }
+
+    //-------------------
+    // 1. 生成并读入两天的文件
+    //-------------------
+    vector<string> files;
+    files.push_back(tmpDir + "/sp3_bench_day1.sp3");
+    files.push_back(tmpDir + "/sp3_bench_day2.sp3");
+    writeSP3(files[0], t0, interval, sats, ephs);
+    writeSP3(files[1], t0 + 86400.0, interval, sats, ephs);
+
+    size_t numMismatch = 0;
+    SP3Store sp3Store;
+    Clock::time_point tStart = Clock::now();
+    sp3Store.loadFiles(files);
+    double loadSec = seconds(tStart);
+
+    size_t expectedEpochs = size_t(2 * 86400.0 / interval + 0.5);
+    cout << "file: " << navFile << ", GPS sats: " << sats.size() << ", interval " << interval << " s" << endl;
+    cout << "loaded " << sp3Store.getNumEpochs() << " epochs, " << sp3Store.getSatList().size()
+         << " sats in " << fixed << setprecision(1) << loadSec * 1000.0 << " ms" << endl;
+    if (sp3Store.getNumEpochs() != expectedEpochs || sp3Store.getSatList().size() != sats.size() ||
+        sp3Store.getFirstEpoch() != t0) {
+        cout << "unexpected grid" << endl;
+        numMismatch++;
+    }
+
+    //-------------------
+    // 2. 与直接计算的差异
+    //-------------------
+    const int degrees[] = {9, 7, 11, 5};
+    CommonTime tLast = sp3Store.getLastEpoch();
+    for (int degree: degrees) {
+        sp3Store.setDegree(degree);
+        double edge = (degree / 2) * interval;
+        double maxPosDiff[2] = {0.0, 0.0}, maxVelDiff[2] = {0.0, 0.0}, maxClkDiff[2] = {0.0, 0.0},
+               maxRelDiff[2] = {0.0, 0.0};
+        size_t numCompared = 0;
+        for (double dt = 0.0; t0 + dt <= tLast; dt += step) {
+            CommonTime t = t0 + dt;
+            int k = (dt < edge || tLast - t < edge) ? 1 : 0;
+            for (size_t s = 0; s < sats.size(); s++) {
+                Xvt direct = ephs[s].svXvt(t);
+                Eigen::Vector3d vel = ephs[s].svXvt(t + 0.5).x - ephs[s].svXvt(t - 0.5).x;
+                Xvt interp = sp3Store.getXvt(sats[s], t);
+                numCompared++;
+                maxPosDiff[k] = std::max(maxPosDiff[k], (direct.x - interp.x).norm());
+                maxVelDiff[k] = std::max(maxVelDiff[k], (vel - interp.v).norm());
+                maxClkDiff[k] = std::max(maxClkDiff[k], std::fabs(direct.clkbias - interp.clkbias));
+                maxRelDiff[k] = std::max(maxRelDiff[k], std::fabs(direct.relcorr - interp.relcorr));
+            }
+        }
+        cout << "degree " << degree << ": compared " << numCompared << scientific << setprecision(2)
+             << ", max diff pos " << maxPosDiff[0] << " m, vel " << maxVelDiff[0]
+             << " m/s, clk " << maxClkDiff[0] << " s, relcorr " << maxRelDiff[0]
+             << " s; near the ends pos " << maxPosDiff[1]
+             << " m, vel " << maxVelDiff[1] << " m/s" << fixed << endl;
+        if (degree == 9 && (maxPosDiff[0] > 1.0e-2 || maxVelDiff[0] > 1.0e-4 ||
+                            maxClkDiff[0] * C_MPS > 1.0e-3 || maxRelDiff[0] * C_MPS > 0.05)) {
+            cout << "default interpolation error too large" << endl;
+            numMismatch++;
+        }
+    }
+    sp3Store.setDegree(9);
+
+    // 数据范围以外
+    const double outside[] = {-1.0, 2 * 86400.0};
+    for (double dt: outside) {
+        try {
+            sp3Store.getXvt(sats[0], t0 + dt);
+            cout << "no exception outside the data span" << endl;
+            numMismatch++;
+        }
+        catch (InvalidRequest &e) {}
+    }
+
+    //-------------------
+    // 3. SPP 的耗时
+    //-------------------
+    // 每个历元两个测站、每个测站迭代两次，发射时刻相差几十微秒到几毫秒；只取有广播星历的时刻
+    vector<std::pair<CommonTime, SatID>> requests;
+    for (double dt = 3600.0; dt < 86400.0 - 3600.0; dt += 30.0) {
+        for (size_t s = 0; s < sats.size(); s++) {
+            try { navStore.getXvt(sats[s], t0 + dt - 0.075); }
+            catch (InvalidRequest &e) { continue; }
+            for (int station = 0; station < 2; station++) {
+                CommonTime tr = t0 + dt - 0.075 - station * 1.0e-3 - s * 1.0e-4;
+                requests.push_back(std::make_pair(tr, sats[s]));
+                requests.push_back(std::make_pair(tr + 2.0e-5, sats[s]));
+            }
+        }
+    }
+
+    double checksumBroadcast = 0.0, checksumSP3 = 0.0;
+    tStart = Clock::now();
+    for (const auto &req: requests) {
+        checksumBroadcast += navStore.getXvt(req.second, req.first).x[0];
+    }
+    double broadcastSec = seconds(tStart);
+
+    sp3Store.clearCache();
+    size_t windowUpdates = sp3Store.getNumWindowUpdates();
+    size_t weightUpdates = sp3Store.getNumWeightUpdates();
+    tStart = Clock::now();
+    for (const auto &req: requests) {
+        checksumSP3 += sp3Store.getXvt(req.second, req.first).x[0];
+    }
+    double sp3Sec = seconds(tStart);
+
+    // 广播星历换用不同的星历组，两者只在 10 米量级内一致
+    if (std::fabs(checksumBroadcast - checksumSP3) > 10.0 * requests.size()) {
+        cout << "checksum mismatched" << endl;
+        numMismatch++;
+    }
+
+    cout << setprecision(0) << "SPP requests " << requests.size()
+         << ", window updates " << sp3Store.getNumWindowUpdates() - windowUpdates
+         << ", weight updates " << sp3Store.getNumWeightUpdates() - weightUpdates << endl;
+    cout << "broadcast getXvt: " << requests.size() / broadcastSec << " evaluations/s" << endl;
+    cout << "SP3Store getXvt : " << requests.size() / sp3Sec << " evaluations/s" << endl;
+    cout << setprecision(2) << "speedup: " << broadcastSec / sp3Sec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    for (const string &file: files) {
+        remove(file.c_str());
+    }
+
+    return numMismatch == 0 ? 0 : 1;
+}
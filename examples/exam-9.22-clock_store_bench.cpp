@@ -0,0 +1,270 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// RINEX 钟差文件存储测试：
+//  1. 每颗 GPS 卫星取导航文件中 12 时的一组星历，按 interval 秒的采样间隔生成一天的 RINEX 3.00 钟差文件，
+//     文件中加入接收机钟差（AR）记录，并去掉一颗卫星 1 小时的记录；
+//  2. 比较读入文本（loadFile）、第一次 openOrConvert（读入文本并写出缓存）和第二次 openOrConvert（直接映射缓存）的耗时；
+//  3. 每隔 step 秒比较文本和缓存两种方式查询的钟差（应完全相同），以及与星历直接计算（NavEphGPS::svClockBias）的差异，
+//     缺少记录的时段和数据范围以外的查询应抛出异常，正好在缺记录前一个历元上的查询返回该历元的钟差；
+//  4. 比较 RinexClockStore::getClock 与按卫星存放的 std::map<CommonTime, double> 上 lower_bound 查找再线性插值
+//     每秒能完成的查询数。
+//
+// 文件中的钟差保留 12 位有效数字，线性插值的差异超过 1 毫米时算作不一致。生成的文件放在临时目录中，测试结束后删除。
+//
+// 用法：clock_store_bench [导航文件，默认 data/ABMF00GLP_R_20210010000_01D_MN.rnx] [采样间隔秒，默认 30]
+//                         [step 秒，默认 7.3] [临时目录，默认 /tmp]
+//
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include "RinexNavStore.hpp"
+#include "RinexClockStore.h"
+#include "TimeConvert.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 写出 [start, start + 1 天) 的钟差文件，gapSat 在 [gapBegin, gapEnd) 内没有记录
+static void writeClock(const string &file, const CommonTime &start, double interval,
+                       const vector<SatID> &sats, const vector<NavEphGPS> &ephs,
+                       size_t gapSat, double gapBegin, double gapEnd) {
+    int numEpochs = int(86400.0 / interval + 0.5);
+
+    FILE *fp = fopen(file.c_str(), "w");
+    fprintf(fp, "%9.2f           %-20s%-20sRINEX VERSION / TYPE\n", 3.0, "C", "G");
+    fprintf(fp, "%-60sPGM / RUN BY / DATE\n", "clock_store_bench");
+    fprintf(fp, "   GPS%54sTIME SYSTEM ID\n", "");
+    fprintf(fp, "%6d    %2s    %2s%42sTYPES OF DATA\n", 2, "AR", "AS", "");
+    fprintf(fp, "%6d%54s# OF SOLN STA / TRF\n", 1, "");
+    fprintf(fp, "%6d%54s# OF SOLN SATS\n", int(sats.size()), "");
+    fprintf(fp, "%60sEND OF HEADER\n", "");
+    for (int i = 0; i < numEpochs; i++) {
+        double dt = i * interval;
+        CommonTime t = start + dt;
+        CivilTime ct = CommonTime2CivilTime(t);
+        fprintf(fp, "AR ABMF %4d %02d %02d %02d %02d %9.6f  1   %19.12E\n",
+                ct.year, ct.month, ct.day, ct.hour, ct.minute, ct.second, 1.0e-7 * std::sin(dt / 3600.0));
+        for (size_t s = 0; s < sats.size(); s++) {
+            if (s == gapSat && dt >= gapBegin && dt < gapEnd) continue;
+            fprintf(fp, "AS G%02d  %4d %02d %02d %02d %02d %9.6f  2   %19.12E %19.12E\n", sats[s].id,
+                    ct.year, ct.month, ct.day, ct.hour, ct.minute, ct.second, ephs[s].svClockBias(t), 1.0e-11);
+        }
+    }
+    fclose(fp);
+}
+
+int main(int argc, char *argv[]) {
+    string navFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_MN.rnx";
+    double interval = (argc > 2) ? atof(argv[2]) : 30.0;
+    double step = (argc > 3) ? atof(argv[3]) : 7.3;
+    string tmpDir = (argc > 4) ? argv[4] : "/tmp";
+
+    RinexNavStore navStore;
+    navStore.loadFile(navFile);
+
+    CommonTime t0 = CivilTime2CommonTime(CivilTime(2021, 1, 1, 0, 0, 0.0));
+    t0.setTimeSystem(TimeSystem::GPS);
+
+    vector<SatID> sats;
+    vector<NavEphGPS> ephs;
+    for (int prn = 1; prn <= MAXGPSPRN; prn++) {
+        SatID sat = PackedSat('G', prn).toSatID();
+        if (!navStore.gpsEphData.contains(PackedSat(sat))) continue;
+        try {
+            ephs.push_back(navStore.findGPSEph(sat, t0 + 43200.0));
+        }
+        catch (InvalidRequest &e) { continue; }
+        sats.push_back(sat);
+    }
+    if (sats.empty()) {
+        cout << "no GPS ephemeris in " << navFile << endl;
+        return 1;
+    }
+
+    //-------------------
+    // 1. 生成文件
+    //-------------------
+    string clkFile = tmpDir + "/clock_bench.clk";
+    string cacheFile = RinexClockStore::cacheName(clkFile);
+    const size_t gapSat = 0;
+    const double gapBegin = 36000.0, gapEnd = 39600.0;
+    writeClock(clkFile, t0, interval, sats, ephs, gapSat, gapBegin, gapEnd);
+    remove(cacheFile.c_str());
+
+    //-------------------
+    // 2. 读入的耗时
+    //-------------------
+    size_t numMismatch = 0;
+    RinexClockStore textStore;
+    Clock::time_point tStart = Clock::now();
+    textStore.loadFile(clkFile);
+    double textSec = seconds(tStart);
+
+    RinexClockStore cacheStore;
+    tStart = Clock::now();
+    cacheStore.openOrConvert(clkFile);
+    double convertSec = seconds(tStart);
+
+    tStart = Clock::now();
+    cacheStore.openOrConvert(clkFile);
+    double openSec = seconds(tStart);
+
+    size_t expectedEpochs = size_t(86400.0 / interval + 0.5);
+    cout << "file: " << navFile << ", GPS sats: " << sats.size() << ", interval " << interval << " s" << endl;
+    cout << "grid: " << textStore.getNumEpochs() << " epochs, " << textStore.getSatList().size() << " sats" << endl;
+    cout << fixed << setprecision(2) << "load text        : " << textSec * 1000.0 << " ms" << endl;
+    cout << "convert to cache : " << convertSec * 1000.0 << " ms" << endl;
+    cout << "open cache       : " << openSec * 1000.0 << " ms" << endl;
+    if (textStore.getNumEpochs() != expectedEpochs || textStore.getSatList().size() != sats.size() ||
+        textStore.getFirstEpoch() != t0 || std::fabs(textStore.getInterval() - interval) > 1.0e-9 ||
+        cacheStore.getNumEpochs() != expectedEpochs || cacheStore.getSatList() != textStore.getSatList() ||
+        cacheStore.getFirstEpoch() != t0) {
+        cout << "unexpected grid" << endl;
+        numMismatch++;
+    }
+
+    //-------------------
+    // 3. 查询结果
+    //-------------------
+    double maxBiasDiff = 0.0, maxDriftDiff = 0.0;
+    size_t numCompared = 0, numGapRejected = 0, numCacheDiff = 0;
+    double tEnd = (expectedEpochs - 1) * interval;
+    for (double dt = 0.0; dt <= tEnd; dt += step) {
+        CommonTime t = t0 + dt;
+        for (size_t s = 0; s < sats.size(); s++) {
+            double bias, drift, cacheBias, cacheDrift;
+            bool inGap = (s == gapSat && dt > gapBegin - interval && dt < gapEnd);
+            try {
+                textStore.getClock(sats[s], t, bias, drift);
+            }
+            catch (InvalidRequest &e) {
+                if (inGap) {
+                    numGapRejected++;
+                } else {
+                    cout << "unexpected exception: " << e.what() << endl;
+                    numMismatch++;
+                }
+                continue;
+            }
+            if (inGap) {
+                cout << "no exception in the gap of " << sats[s] << endl;
+                numMismatch++;
+            }
+            cacheStore.getClock(sats[s], t, cacheBias, cacheDrift);
+            if (cacheBias != bias || cacheDrift != drift) numCacheDiff++;
+            numCompared++;
+            maxBiasDiff = std::max(maxBiasDiff, std::fabs(bias - ephs[s].svClockBias(t)));
+            maxDriftDiff = std::max(maxDriftDiff, std::fabs(drift - ephs[s].svClockDrift(t)));
+        }
+    }
+    cout << "compared " << numCompared << ", rejected in gap " << numGapRejected << ", text/cache differences "
+         << numCacheDiff << scientific << setprecision(2) << ", max diff bias " << maxBiasDiff
+         << " s, drift " << maxDriftDiff << " s/s" << fixed << endl;
+    if (numCacheDiff > 0 || numGapRejected == 0 || maxBiasDiff * C_MPS > 1.0e-3) {
+        cout << "clock error too large" << endl;
+        numMismatch++;
+    }
+
+    // 数据范围以外
+    const double outside[] = {-1.0, tEnd + 1.0};
+    for (double dt: outside) {
+        try {
+            double bias, drift;
+            cacheStore.getClock(sats[1 % sats.size()], t0 + dt, bias, drift);
+            cout << "no exception outside the data span" << endl;
+            numMismatch++;
+        }
+        catch (InvalidRequest &e) {}
+    }
+
+    // 正好在缺记录前的最后一个历元和整个文件最后一个历元上，应返回该历元的钟差
+    const double onEpoch[] = {gapBegin - interval, tEnd};
+    for (double dt: onEpoch) {
+        CommonTime t = t0 + dt;
+        double bias, drift, cacheBias, cacheDrift;
+        try {
+            textStore.getClock(sats[gapSat], t, bias, drift);
+            cacheStore.getClock(sats[gapSat], t, cacheBias, cacheDrift);
+        }
+        catch (InvalidRequest &e) {
+            cout << "no clock exactly on the epoch " << dt << ": " << e.what() << endl;
+            numMismatch++;
+            continue;
+        }
+        if (cacheBias != bias || std::fabs(bias - ephs[gapSat].svClockBias(t)) * C_MPS > 1.0e-3) {
+            cout << "wrong clock exactly on the epoch " << dt << endl;
+            numMismatch++;
+        }
+    }
+
+    //-------------------
+    // 4. 查询的耗时
+    //-------------------
+    typedef std::map<CommonTime, double> ClockMap;
+    std::map<SatID, ClockMap> mapStore;
+    for (size_t s = 0; s < sats.size(); s++) {
+        ClockMap &clocks = mapStore[sats[s]];
+        for (size_t i = 0; i < expectedEpochs; i++) {
+            double bias, drift;
+            CommonTime t = t0 + i * interval;
+            try { textStore.getClock(sats[s], t, bias, drift); }
+            catch (InvalidRequest &e) { continue; }
+            clocks[t] = bias;
+        }
+    }
+
+    vector<std::pair<CommonTime, SatID>> requests;
+    for (double dt = 3600.0; dt < 86400.0 - 3600.0; dt += 1.0) {
+        for (size_t s = 1; s < sats.size(); s++) {
+            requests.push_back(std::make_pair(t0 + dt - 0.075 - s * 1.0e-4, sats[s]));
+        }
+    }
+
+    double checksumMap = 0.0, checksumStore = 0.0;
+    tStart = Clock::now();
+    for (const auto &req: requests) {
+        const ClockMap &clocks = mapStore.find(req.second)->second;
+        ClockMap::const_iterator it1 = clocks.upper_bound(req.first);
+        ClockMap::const_iterator it0 = it1;
+        --it0;
+        double dt = req.first - it0->first;
+        checksumMap += it0->second + dt * (it1->second - it0->second) / (it1->first - it0->first);
+    }
+    double mapSec = seconds(tStart);
+
+    tStart = Clock::now();
+    for (const auto &req: requests) {
+        double bias, drift;
+        cacheStore.getClock(req.second, req.first, bias, drift);
+        checksumStore += bias;
+    }
+    double storeSec = seconds(tStart);
+
+    if (std::fabs(checksumMap - checksumStore) > 1.0e-12 * requests.size()) {
+        cout << "checksum mismatched" << endl;
+        numMismatch++;
+    }
+
+    cout << setprecision(0) << "queries " << requests.size() << endl;
+    cout << "std::map lookup  : " << requests.size() / mapSec << " queries/s" << endl;
+    cout << "RinexClockStore  : " << requests.size() / storeSec << " queries/s" << endl;
+    cout << setprecision(2) << "speedup: " << mapSec / storeSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    cacheStore.clear();
+    remove(clkFile.c_str());
+    remove(cacheFile.c_str());
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// GLONASS 星历积分测试：
+//  1. 读入导航文件中的 GLONASS 星历，每组星历从 toe 积分 30 分钟，与同一颗卫星下一组星历在其 toe 的位置比较，
+//     检查运动方程和单位（两组星历独立拟合，差异在几米到十几米）；
+//  2. 按 1 Hz 的历元、两个测站、每个测站迭代两次模拟 SPP 的查询，先顺序、再倒序各查一遍，
+//     比较 GLOOrbitIntegrator::getXvt 与 NavEphGLO::svXvt（每次从 toe 积分）的结果，两者应完全相同；
+//  3. 比较两种方式每秒能计算的卫星状态数和走过的 RK4 整步数。
+//
+// 用法：glo_integrator_bench [导航文件，默认 data/ABMF00GLP_R_20210010000_01D_MN.rnx] [处理时长秒，默认 86400]
+//
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "RinexNavStore.hpp"
+#include "GLOOrbitIntegrator.h"
+#include "TimeConvert.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int main(int argc, char *argv[]) {
+    string navFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_MN.rnx";
+    double span = (argc > 2) ? atof(argv[2]) : 86400.0;
+
+    RinexNavStore navStore;
+    navStore.loadFile(navFile);
+
+    vector<SatID> sats;
+    for (int prn = 1; prn <= PackedSat::maxPrn; prn++) {
+        SatID sat = PackedSat('R', prn).toSatID();
+        if (navStore.gloEphData.contains(PackedSat(sat))) sats.push_back(sat);
+    }
+    if (sats.empty()) {
+        cout << "no GLONASS ephemeris in " << navFile << endl;
+        return 1;
+    }
+    cout << "file: " << navFile << ", GLONASS sats: " << sats.size()
+         << ", ephemerides: " << navStore.gloEphData.size() << endl;
+
+    size_t numMismatch = 0;
+
+    //-------------------
+    // 1. 与下一组星历的一致性
+    //-------------------
+    double maxArcDiff = 0.0;
+    size_t numArcs = 0;
+    for (const SatID &sat: sats) {
+        const vector<NavEphGLO> &ephs = *navStore.gloEphData.ephemerides(PackedSat(sat));
+        for (size_t i = 0; i + 1 < ephs.size(); i++) {
+            if (ephs[i + 1].ctToe - ephs[i].ctToe != 1800.0 || ephs[i].SV_health != 0) continue;
+            Xvt xvt = ephs[i].svXvt(ephs[i + 1].ctToe);
+            Eigen::Vector3d next(ephs[i + 1].pos[0], ephs[i + 1].pos[1], ephs[i + 1].pos[2]);
+            maxArcDiff = std::max(maxArcDiff, (xvt.x - next).norm());
+            numArcs++;
+        }
+    }
+    cout << fixed << setprecision(2) << "30 min arcs: " << numArcs
+         << ", max diff to the next ephemeris: " << maxArcDiff << " m" << endl;
+    if (numArcs == 0 || maxArcDiff > 50.0) {
+        cout << "integrated orbit does not match the next ephemeris" << endl;
+        numMismatch++;
+    }
+
+    //-------------------
+    // 2. 查询
+    //-------------------
+    CommonTime t0 = navStore.gloEphData.ephemerides(PackedSat(sats[0]))->front().ctToe;
+    for (const SatID &sat: sats) {
+        const CommonTime &toe = navStore.gloEphData.ephemerides(PackedSat(sat))->front().ctToe;
+        if (toe < t0) t0 = toe;
+    }
+
+    // 每个历元两个测站、每个测站迭代两次，发射时刻相差几十微秒到几毫秒；只取有可用星历的时刻
+    vector<std::pair<CommonTime, const NavEphGLO *>> requests;
+    for (double dt = 0.0; dt < span; dt += 1.0) {
+        for (size_t s = 0; s < sats.size(); s++) {
+            CommonTime t = t0 + dt - 0.075;
+            const NavEphGLO *pEph = navStore.gloEphData.search(PackedSat(sats[s]), t);
+            if (pEph == NULL) continue;
+            for (int station = 0; station < 2; station++) {
+                CommonTime tr = t - station * 1.0e-3 - s * 1.0e-4;
+                requests.push_back(std::make_pair(tr, pEph));
+                requests.push_back(std::make_pair(tr + 2.0e-5, pEph));
+            }
+        }
+    }
+
+    // 顺序查询后再倒序查询一遍
+    size_t numRequests = requests.size();
+    for (size_t i = numRequests; i > 0; i--) {
+        requests.push_back(requests[i - 1]);
+    }
+
+    vector<Eigen::Vector3d> naivePos(requests.size());
+    Clock::time_point tStart = Clock::now();
+    for (size_t i = 0; i < requests.size(); i++) {
+        naivePos[i] = requests[i].second->svXvt(requests[i].first).x;
+    }
+    double naiveSec = seconds(tStart);
+
+    size_t naiveSteps = 0;
+    for (const auto &req: requests) {
+        naiveSteps += size_t(std::fabs(req.first - req.second->ctToe) / NavEphGLO::STEP_SIZE);
+    }
+
+    GLOOrbitIntegrator integrator;
+    vector<Eigen::Vector3d> incPos(requests.size());
+    tStart = Clock::now();
+    for (size_t i = 0; i < requests.size(); i++) {
+        incPos[i] = integrator.getXvt(*requests[i].second, requests[i].first).x;
+    }
+    double incSec = seconds(tStart);
+
+    size_t numDiff = 0;
+    for (size_t i = 0; i < requests.size(); i++) {
+        if (naivePos[i] != incPos[i]) numDiff++;
+    }
+    if (numDiff > 0) {
+        cout << "results differ from svXvt: " << numDiff << endl;
+        numMismatch++;
+    }
+
+    // RinexNavStore::getXvt 中的 GLONASS 也走积分器
+    try {
+        SatID sat = PackedSat('R', requests[0].second->prn).toSatID();
+        CommonTime gpsTime = convertTimeSystem(requests[0].first, TimeSystem::GPS);
+        gpsTime.setTimeSystem(TimeSystem::GPS);
+        Xvt xvt = navStore.getXvt(sat, gpsTime);
+        if ((xvt.x - requests[0].second->svXvt(requests[0].first).x).norm() > 1.0e-6) {
+            cout << "RinexNavStore::getXvt mismatched" << endl;
+            numMismatch++;
+        }
+    }
+    catch (InvalidRequest &e) {
+        cout << "RinexNavStore::getXvt: " << e.what() << endl;
+        numMismatch++;
+    }
+
+    cout << setprecision(0) << "requests " << requests.size() << " (forward and backward)" << endl;
+    cout << "RK4 steps: svXvt " << naiveSteps << ", integrator " << integrator.getNumSteps()
+         << " (" << integrator.getNumResets() << " ephemeris changes)" << endl;
+    cout << "svXvt from toe     : " << requests.size() / naiveSec << " evaluations/s" << endl;
+    cout << "GLOOrbitIntegrator : " << requests.size() / incSec << " evaluations/s" << endl;
+    cout << setprecision(2) << "speedup: " << naiveSec / incSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
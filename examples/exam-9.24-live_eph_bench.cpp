@@ -0,0 +1,231 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 实时星历快照测试：
+//  1. 把导航文件中的 GPS 星历按 toe 排序，作为解码线程依次收到的星历，重复 rounds 遍；
+//  2. 一个解码线程用 LiveEphStore::publishGPS 逐组发布，numReaders 个求解线程同时循环：
+//     每个历元取一个快照，检查快照中每颗卫星的星历正好是该版本应有的一组（没有读到一半更新的快照），
+//     版本号不后退，再用快照计算所有卫星的位置；
+//  3. 同样的流程用一把 std::mutex 保护共享的 gpsNav 数组（求解时整个历元持锁），比较两者的历元数和发布速度；
+//  4. SPPIFCode 设置 LiveEphStore 后计算的卫星状态应与设置 RinexNavStore（星历在 gpsNav 中）的相同。
+//
+// 用法：live_eph_bench [导航文件，默认 data/ABMF00GLP_R_20210010000_01D_MN.rnx] [读线程数，默认 4] [rounds，默认 5]
+//
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+#include "RinexNavStore.hpp"
+#include "LiveEphStore.h"
+#include "SPPIFCode.h"
+#include "TimeConvert.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 快照中的星历是否正好是版本 version 应有的：expected[version][prn - 1] 为应有星历的序号，-1 表示没有
+static bool isConsistent(const NavEphGPS gpsNav[MAXGPSPRN], uint64_t version,
+                         const vector<vector<int>> &expected, const vector<NavEphGPS> &ephs) {
+    const vector<int> &idx = expected[version];
+    for (int i = 0; i < MAXGPSPRN; i++) {
+        if (idx[i] < 0) {
+            if (gpsNav[i].prn != 0) return false;
+            continue;
+        }
+        const NavEphGPS &eph = ephs[idx[i]];
+        if (gpsNav[i].prn != eph.prn || gpsNav[i].ctToe - eph.ctToe != 0.0 ||
+            gpsNav[i].M0 != eph.M0 || gpsNav[i].af0 != eph.af0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 一个历元的计算：所有有星历的卫星在 toe 后 60 秒的位置
+static double solveEpoch(const NavEphGPS gpsNav[MAXGPSPRN]) {
+    double sum = 0.0;
+    for (int i = 0; i < MAXGPSPRN; i++) {
+        if (gpsNav[i].prn == 0) continue;
+        sum += gpsNav[i].svXvt(gpsNav[i].ctToe + 60.0).x[0];
+    }
+    return sum;
+}
+
+int main(int argc, char *argv[]) {
+    string navFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_MN.rnx";
+    int numReaders = (argc > 2) ? atoi(argv[2]) : 4;
+    int rounds = (argc > 3) ? atoi(argv[3]) : 5;
+
+    RinexNavStore navStore;
+    navStore.loadFile(navFile);
+
+    vector<NavEphGPS> ephs;
+    for (int prn = 1; prn <= MAXGPSPRN; prn++) {
+        const vector<NavEphGPS> *pEphs = navStore.gpsEphData.ephemerides(PackedSat('G', prn));
+        if (pEphs != NULL) ephs.insert(ephs.end(), pEphs->begin(), pEphs->end());
+    }
+    std::stable_sort(ephs.begin(), ephs.end(),
+                     [](const NavEphGPS &a, const NavEphGPS &b) { return a.ctToe - b.ctToe < 0.0; });
+    if (ephs.empty()) {
+        cout << "no GPS ephemeris in " << navFile << endl;
+        return 1;
+    }
+
+    //-------------------
+    // 1. 每个版本应有的星历
+    //-------------------
+    size_t numUpdates = ephs.size() * rounds;
+    vector<vector<int>> expected(numUpdates + 1, vector<int>(MAXGPSPRN, -1));
+    for (size_t k = 0; k < numUpdates; k++) {
+        expected[k + 1] = expected[k];
+        int i = int(k % ephs.size());
+        expected[k + 1][ephs[i].prn - 1] = i;
+    }
+
+    cout << "file: " << navFile << ", GPS ephemerides: " << ephs.size() << ", updates: " << numUpdates
+         << ", reader threads: " << numReaders << endl;
+
+    size_t numMismatch = 0;
+
+    //-------------------
+    // 2. LiveEphStore
+    //-------------------
+    LiveEphStore liveStore;
+    std::atomic<bool> done(false);
+    std::atomic<size_t> liveEpochs(0), liveBad(0), liveBackward(0);
+    std::atomic<uint64_t> liveVersionsSeen(0);
+
+    auto liveReader = [&]() {
+        LiveEphStore::ReaderSlot slot;
+        slot.reset(&liveStore);
+        int reader = slot.id();
+        uint64_t lastVersion = 0;
+        size_t epochs = 0, versions = 0;
+        double sum = 0.0;
+        while (!done.load()) {
+            LiveEphStore::ReadGuard guard(liveStore, reader);
+            const LiveEphStore::Snapshot &snap = guard.get();
+            if (snap.version < lastVersion) liveBackward++;
+            if (snap.version != lastVersion) versions++;
+            lastVersion = snap.version;
+            if (!isConsistent(snap.gpsNav, snap.version, expected, ephs)) liveBad++;
+            sum += solveEpoch(snap.gpsNav);
+            epochs++;
+        }
+        liveEpochs += epochs;
+        liveVersionsSeen += versions;
+        if (sum == 1.0) cout << sum << endl;
+    };
+
+    vector<std::thread> readers;
+    for (int i = 0; i < numReaders; i++) {
+        readers.push_back(std::thread(liveReader));
+    }
+    Clock::time_point tStart = Clock::now();
+    for (size_t k = 0; k < numUpdates; k++) {
+        liveStore.publishGPS(ephs[k % ephs.size()]);
+        std::this_thread::yield();
+    }
+    double liveSec = seconds(tStart);
+    done = true;
+    for (size_t i = 0; i < readers.size(); i++) readers[i].join();
+    readers.clear();
+
+    if (liveStore.getVersion() != numUpdates || liveBad > 0 || liveBackward > 0) {
+        cout << "LiveEphStore: version " << liveStore.getVersion() << ", inconsistent snapshots " << liveBad
+             << ", version went backward " << liveBackward << endl;
+        numMismatch++;
+    }
+
+    //-------------------
+    // 3. std::mutex
+    //-------------------
+    NavEphGPS sharedNav[MAXGPSPRN];
+    uint64_t sharedVersion = 0;
+    std::mutex navMutex;
+    std::atomic<size_t> lockEpochs(0), lockBad(0);
+    done = false;
+
+    auto lockReader = [&]() {
+        size_t epochs = 0;
+        double sum = 0.0;
+        while (!done.load()) {
+            std::lock_guard<std::mutex> guard(navMutex);
+            if (!isConsistent(sharedNav, sharedVersion, expected, ephs)) lockBad++;
+            sum += solveEpoch(sharedNav);
+            epochs++;
+        }
+        lockEpochs += epochs;
+        if (sum == 1.0) cout << sum << endl;
+    };
+
+    for (int i = 0; i < numReaders; i++) {
+        readers.push_back(std::thread(lockReader));
+    }
+    tStart = Clock::now();
+    for (size_t k = 0; k < numUpdates; k++) {
+        {
+            std::lock_guard<std::mutex> guard(navMutex);
+            const NavEphGPS &eph = ephs[k % ephs.size()];
+            sharedNav[eph.prn - 1] = eph;
+            sharedVersion++;
+        }
+        std::this_thread::yield();
+    }
+    double lockSec = seconds(tStart);
+    done = true;
+    for (size_t i = 0; i < readers.size(); i++) readers[i].join();
+
+    if (lockBad > 0) {
+        cout << "std::mutex: inconsistent " << lockBad << endl;
+        numMismatch++;
+    }
+
+    //-------------------
+    // 4. SPPIFCode
+    //-------------------
+    RinexNavStore liveNav;
+    LiveEphStore sppStore;
+    for (const NavEphGPS &eph: ephs) {
+        liveNav.gpsNav[eph.prn - 1] = eph;
+        sppStore.publishGPS(eph);
+    }
+    SPPIFCode sppNav, sppLive;
+    sppNav.setRinexNavStore(&liveNav);
+    sppLive.setLiveEphStore(&sppStore);
+    size_t numCompared = 0;
+    for (int i = 0; i < MAXGPSPRN; i++) {
+        if (liveNav.gpsNav[i].prn == 0) continue;
+        SatID sat = PackedSat('G', i + 1).toSatID();
+        CommonTime tr = liveNav.gpsNav[i].ctToe + 600.0;
+        Xvt a = sppNav.computeAtTransmitTime(tr, 2.2e7, sat);
+        Xvt b = sppLive.computeAtTransmitTime(tr, 2.2e7, sat);
+        numCompared++;
+        if (a.x != b.x || a.clkbias != b.clkbias) {
+            cout << sat << ": SPPIFCode with LiveEphStore mismatched" << endl;
+            numMismatch++;
+        }
+    }
+
+    cout << fixed << setprecision(0);
+    cout << "LiveEphStore: " << liveEpochs / liveSec << " epochs/s, " << numUpdates / liveSec
+         << " updates/s, versions seen per reader " << liveVersionsSeen / std::max(numReaders, 1)
+         << ", retired snapshots left " << liveStore.getNumRetired() << endl;
+    cout << "std::mutex  : " << lockEpochs / lockSec << " epochs/s, " << numUpdates / lockSec
+         << " updates/s" << endl;
+    cout << "SPPIFCode compared: " << numCompared << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 跳秒表与时间系统转换测试：
+//  1. data/Leap_Second.dat 读入的跳秒表应与内置的表相同，再读入全局的表；1972 年以前的时刻应抛出 InvalidRequest；
+//  2. 从 1972 年到 2024 年每天取几个时刻，比较 LeapSecondTable 与原来每次新建 std::map 的实现，跳秒应完全相同；
+//  3. 模拟 RinexNavStore::getXvt 的调用：1 Hz 的 GPS 历元，每个历元对 numSats 颗卫星分别转换到 UTC 和 BDT，
+//     比较原来的实现、现在的 convertTimeSystem 和批量转换每秒能转换的历元数，结果应完全相同。
+//
+// 用法：time_convert_bench [跳秒文件，默认 data/Leap_Second.dat] [历元数，默认 21600] [卫星数，默认 30]
+//
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include "LeapSecondTable.h"
+#include "TimeConvert.h"
+#include "Exception.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 原来的实现：每次新建跳秒表，遍历所有记录
+static double mapLeapSeconds(const CommonTime &ct) {
+    std::map<double, double> leapData;
+    leapData[41317.0] = 10;
+    leapData[41499.0] = 11;
+    leapData[41683.0] = 12;
+    leapData[42048.0] = 13;
+    leapData[42413.0] = 14;
+    leapData[42778.0] = 15;
+    leapData[43144.0] = 16;
+    leapData[43509.0] = 17;
+    leapData[43874.0] = 18;
+    leapData[44239.0] = 19;
+    leapData[44786.0] = 20;
+    leapData[45151.0] = 21;
+    leapData[45516.0] = 22;
+    leapData[46247.0] = 23;
+    leapData[47161.0] = 24;
+    leapData[47892.0] = 25;
+    leapData[48257.0] = 26;
+    leapData[48804.0] = 27;
+    leapData[49169.0] = 28;
+    leapData[49534.0] = 29;
+    leapData[50083.0] = 30;
+    leapData[50630.0] = 31;
+    leapData[51179.0] = 32;
+    leapData[53736.0] = 33;
+    leapData[54832.0] = 34;
+    leapData[56109.0] = 35;
+    leapData[57204.0] = 36;
+    leapData[57754.0] = 37;
+
+    double mjd_ct = ct.m_day;
+    if (mjd_ct < 41317.0) {
+        InvalidRequest e("Time MUST be greater than 1972 for leapSec!");
+        throw (e);
+    }
+
+    double leapSec = 0.0;
+    for (auto ld: leapData) {
+        if (ld.first <= mjd_ct)
+            leapSec = ld.second;
+    }
+    return leapSec;
+}
+
+static CommonTime mapConvertTimeSystem(const CommonTime &ct, const TimeSystem &outTS) {
+    TimeSystem inTS = ct.m_timeSystem;
+    if (inTS == outTS) return ct;
+
+    double dt(0.0);
+    if (inTS == TimeSystem::GPS) dt = 19.;
+    else if (inTS == TimeSystem::UTC) dt = mapLeapSeconds(ct);
+    else if (inTS == TimeSystem::BDT) dt = 33.;
+
+    if (outTS == TimeSystem::GPS) dt -= 19.;
+    else if (outTS == TimeSystem::UTC) dt -= mapLeapSeconds(ct);
+    else if (outTS == TimeSystem::BDT) dt -= 33.;
+
+    return ct + dt;
+}
+
+static bool sameTime(const CommonTime &a, const CommonTime &b) {
+    return a.m_day == b.m_day && a.m_sod == b.m_sod && a.m_timeSystem == b.m_timeSystem;
+}
+
+int main(int argc, char *argv[]) {
+    string leapFile = (argc > 1) ? argv[1] : LeapSecondTable::DEFAULT_FILE;
+    int numEpochs = (argc > 2) ? atoi(argv[2]) : 21600;
+    int numSats = (argc > 3) ? atoi(argv[3]) : 30;
+
+    size_t numMismatch = 0;
+
+    //-------------------
+    // 1. 跳秒文件
+    //-------------------
+    LeapSecondTable builtIn, fromFile;
+    fromFile.loadFile(leapFile);
+    LeapSecondTable::instance().loadFile(leapFile);
+    cout << "leap second file: " << leapFile << ", records: " << fromFile.size()
+         << ", global table from: " << LeapSecondTable::instance().getSource() << endl;
+    if (fromFile.size() != builtIn.size()) {
+        cout << "the file has " << fromFile.size() << " records, built-in " << builtIn.size() << endl;
+        numMismatch++;
+    }
+    try {
+        getLeapSeconds(CommonTime(41316, 0.0, TimeSystem::UTC));
+        cout << "no exception before 1972" << endl;
+        numMismatch++;
+    }
+    catch (InvalidRequest &e) {
+    }
+
+    //-------------------
+    // 2. 逐日比较跳秒
+    //-------------------
+    size_t numDays = 0;
+    for (long mjd = 41317; mjd <= 60676; mjd++) {
+        for (double sod = 0.0; sod < SEC_PER_DAY; sod += 21600.0) {
+            CommonTime ct(mjd, sod, TimeSystem::UTC);
+            double expected = mapLeapSeconds(ct);
+            if (getLeapSeconds(ct) != expected || fromFile.getLeapSeconds(mjd) != expected ||
+                builtIn.getLeapSeconds(mjd) != expected) {
+                cout << "leap seconds mismatched at MJD " << mjd << endl;
+                numMismatch++;
+                break;
+            }
+        }
+        numDays++;
+    }
+    cout << "days compared: " << numDays << endl;
+
+    //-------------------
+    // 3. 转换速度
+    //-------------------
+    // 2021.1.1 GPS 时，每个历元 numSats 颗卫星，发射时刻相差几十毫秒
+    vector<CommonTime> epochs;
+    epochs.reserve(size_t(numEpochs) * numSats);
+    for (int i = 0; i < numEpochs; i++) {
+        for (int s = 0; s < numSats; s++) {
+            epochs.push_back(CommonTime(59215, 0.0, TimeSystem::GPS) + (i - 0.07 - s * 1.0e-3));
+        }
+    }
+
+    TimeSystem targets[2] = {TimeSystem::UTC, TimeSystem::BDT};
+    double mapSec = 0.0, newSec = 0.0, batchSec = 0.0;
+    double checksum = 0.0;
+    for (int k = 0; k < 2; k++) {
+        vector<CommonTime> mapOut(epochs.size()), newOut(epochs.size()), batchOut(epochs.size());
+
+        Clock::time_point tStart = Clock::now();
+        for (size_t i = 0; i < epochs.size(); i++) {
+            mapOut[i] = mapConvertTimeSystem(epochs[i], targets[k]);
+        }
+        mapSec += seconds(tStart);
+
+        tStart = Clock::now();
+        for (size_t i = 0; i < epochs.size(); i++) {
+            newOut[i] = convertTimeSystem(epochs[i], targets[k]);
+        }
+        newSec += seconds(tStart);
+
+        tStart = Clock::now();
+        convertTimeSystem(epochs, targets[k], batchOut);
+        batchSec += seconds(tStart);
+
+        size_t numDiff = 0;
+        for (size_t i = 0; i < epochs.size(); i++) {
+            if (!sameTime(mapOut[i], newOut[i]) || !sameTime(mapOut[i], batchOut[i])) numDiff++;
+        }
+        if (numDiff > 0) {
+            cout << "conversions to " << targets[k] << " differ: " << numDiff << endl;
+            numMismatch++;
+        }
+        checksum += newOut.back().m_sod;
+    }
+    if (checksum == 1.0) cout << checksum << endl;
+
+    double numConv = 2.0 * epochs.size();
+    cout << fixed << setprecision(0) << "conversions: " << numConv << " (GPS -> UTC, GPS -> BDT)" << endl;
+    cout << "std::map every call : " << numConv / mapSec << " conversions/s" << endl;
+    cout << "LeapSecondTable     : " << numConv / newSec << " conversions/s" << endl;
+    cout << "batch conversion    : " << numConv / batchSec << " conversions/s" << endl;
+    cout << setprecision(2) << "speedup: " << mapSec / newSec << ", batch " << mapSec / batchSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 历元索引测试：
+//  1. 扫描建立索引、写 sidecar、再从 sidecar 读回的耗时；
+//  2. 模仿 RTK 基准站同步：目标历元一半与文件历元对齐、一半落在两个历元之间（同步失败），
+//     比较逐历元解析 + seekg 回退的同步方式与基于索引的同步方式；
+//  3. 读取文件末尾一个时间窗口 [t0, t1)：从头顺序解析 vs 索引定位后只解析窗口内的历元。
+// 两种方式的输出逐历元比较，必须完全一致。
+//
+// 用法：obs_index_seek <RINEX 3.04 观测值文件> [窗口长度(秒)]
+//
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#include "RinexObsReader.h"
+#include "RinexObsIndex.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(const Clock::time_point &t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+static std::map<string, std::set<string>> exampleTypes() {
+    std::map<string, std::set<string>> selectedTypes;
+    selectedTypes["G"].insert("C1C");
+    selectedTypes["G"].insert("C2W");
+    selectedTypes["G"].insert("L1C");
+    selectedTypes["G"].insert("L2W");
+    selectedTypes["C"].insert("C2I");
+    selectedTypes["C"].insert("C7I");
+    selectedTypes["C"].insert("L2I");
+    selectedTypes["C"].insert("L7I");
+    return selectedTypes;
+}
+
+static bool sameObsData(const ObsData &a, const ObsData &b) {
+    return a.station == b.station && a.epoch == b.epoch &&
+           a.satTypeValueData == b.satTypeValueData;
+}
+
+// 按目标历元逐个同步，返回同步成功的历元
+static std::vector<ObsData> syncAll(const string &obsFile,
+                                    const std::vector<CommonTime> &targets,
+                                    const RinexObsIndex *pIndex) {
+    std::fstream obsStream(obsFile);
+    RinexObsReader reader;
+    reader.setFileStream(&obsStream);
+    std::map<string, std::set<string>> selectedTypes = exampleTypes();
+    reader.setSelectedTypes(selectedTypes);
+    reader.setEpochIndex(pIndex);
+
+    std::vector<ObsData> synced;
+    for (size_t i = 0; i < targets.size(); i++) {
+        CommonTime epoch = targets[i];
+        try {
+            synced.push_back(reader.parseRinexObs(epoch));
+        }
+        catch (SyncException &e) { continue; }
+        catch (EndOfFile &e) { break; }
+    }
+    return synced;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <rinex 3.04 obs file> [window seconds]" << endl;
+        exit(-1);
+    }
+    string obsFile = argv[1];
+    double window = (argc > 2) ? atof(argv[2]) : 600.0;
+
+    //-------------------
+    // 1. 建立/读取索引
+    //-------------------
+    RinexObsIndex index;
+    Clock::time_point t0 = Clock::now();
+    index.build(obsFile);
+    double buildSec = secondsSince(t0);
+
+    index.save(obsFile);
+
+    RinexObsIndex loaded;
+    t0 = Clock::now();
+    bool isLoaded = loaded.load(obsFile);
+    double loadSec = secondsSince(t0);
+
+    if (!isLoaded || loaded.size() != index.size() || index.empty()) {
+        cerr << "sidecar index reload failed!" << endl;
+        exit(-1);
+    }
+
+    cout << fixed << setprecision(3);
+    cout << "epochs indexed : " << index.size() << endl;
+    cout << "build          : " << buildSec * 1e3 << " ms" << endl;
+    cout << "sidecar load   : " << loadSec * 1e3 << " ms ("
+         << RinexObsIndex::sidecarName(obsFile) << ")" << endl;
+
+    size_t numMismatch = 0;
+
+    //-------------------
+    // 2. 同步
+    //-------------------
+    // 最后一个历元之后没有可同步的数据，顺序方式在文件末尾返回的是空历元，不参与比较
+    std::vector<CommonTime> targets;
+    for (size_t i = 0; i + 1 < index.size(); i++) {
+        targets.push_back((i % 2 == 0) ? index[i].epoch : index[i].epoch + 0.5);
+    }
+
+    t0 = Clock::now();
+    std::vector<ObsData> seqSynced = syncAll(obsFile, targets, NULL);
+    double seqSyncSec = secondsSince(t0);
+
+    t0 = Clock::now();
+    std::vector<ObsData> idxSynced = syncAll(obsFile, targets, &loaded);
+    double idxSyncSec = secondsSince(t0);
+
+    if (seqSynced.size() != idxSynced.size()) numMismatch++;
+    for (size_t i = 0; i < seqSynced.size() && i < idxSynced.size(); i++) {
+        if (!sameObsData(seqSynced[i], idxSynced[i])) numMismatch++;
+    }
+
+    cout << "sync " << targets.size() << " targets, " << seqSynced.size() << " hits" << endl;
+    cout << "  sequential   : " << seqSyncSec * 1e3 << " ms" << endl;
+    cout << "  indexed      : " << idxSyncSec * 1e3 << " ms" << endl;
+
+    //-------------------
+    // 3. 时间窗口
+    //-------------------
+    CommonTime winEnd = index[index.size() - 1].epoch + 0.001;
+    CommonTime winBegin = winEnd - window;
+    std::map<string, std::set<string>> selectedTypes = exampleTypes();
+
+    std::vector<ObsData> seqWindow;
+    t0 = Clock::now();
+    {
+        std::fstream obsStream(obsFile);
+        RinexObsReader reader;
+        reader.setFileStream(&obsStream);
+        reader.setSelectedTypes(selectedTypes);
+        while (true) {
+            ObsData obsData;
+            try { obsData = reader.parseRinexObs(); }
+            catch (EndOfFile &e) { break; }
+            if (obsData.epoch >= winBegin && obsData.epoch < winEnd)
+                seqWindow.push_back(obsData);
+        }
+    }
+    double seqWinSec = secondsSince(t0);
+
+    std::vector<ObsData> idxWindow;
+    t0 = Clock::now();
+    {
+        std::fstream obsStream(obsFile);
+        RinexObsReader reader;
+        reader.setFileStream(&obsStream);
+        reader.setSelectedTypes(selectedTypes);
+        reader.setEpochIndex(&loaded);
+        idxWindow = reader.parseRinexObsRange(winBegin, winEnd);
+    }
+    double idxWinSec = secondsSince(t0);
+
+    if (seqWindow.size() != idxWindow.size()) numMismatch++;
+    for (size_t i = 0; i < seqWindow.size() && i < idxWindow.size(); i++) {
+        if (!sameObsData(seqWindow[i], idxWindow[i])) numMismatch++;
+    }
+
+    cout << "window " << window << " s, " << idxWindow.size() << " epochs" << endl;
+    cout << "  sequential   : " << seqWinSec * 1e3 << " ms" << endl;
+    cout << "  indexed      : " << idxWinSec * 1e3 << " ms" << endl;
+    cout << "mismatched     : " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 多线程分块解析的扩展性测试：顺序的内存映射读取器 RinexObsMMapReader 作为基准，
+// RinexObsParallelReader 分别用 1、2、4 和 N（硬件线程数）个工作线程按字节切块读取同一文件，
+// 最后用 N 个线程、按预先建立的历元索引切块再读一遍；输出 MB/s、epochs/s、相对基准的加速比
+// 和取到第一个历元的时间，并逐历元检查输出与基准完全一致（包括顺序）。
+//
+// 用法：obs_parallel_bench <RINEX 3.04 观测值文件> [N，默认为硬件线程数] [重复次数]
+// 注意：data/ABMF00GLP_R_20210010000_01D_MN.rnx 是导航电文文件，不能用于本测试。
+//
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "RinexObsMMapReader.h"
+#include "RinexObsParallelReader.h"
+#include "RinexObsIndex.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static std::map<string, std::set<string>> exampleTypes() {
+    std::map<string, std::set<string>> selectedTypes;
+    selectedTypes["G"].insert("C1C");
+    selectedTypes["G"].insert("C2W");
+    selectedTypes["G"].insert("L1C");
+    selectedTypes["G"].insert("L2W");
+    selectedTypes["C"].insert("C2I");
+    selectedTypes["C"].insert("C7I");
+    selectedTypes["C"].insert("L2I");
+    selectedTypes["C"].insert("L7I");
+    return selectedTypes;
+}
+
+static bool sameObsData(const ObsData &a, const ObsData &b) {
+    return a.station == b.station && a.epoch == b.epoch &&
+           a.satTypeValueData == b.satTypeValueData;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <rinex 3.04 obs file> [N threads] [repeat]" << endl;
+        exit(-1);
+    }
+    string obsFile = argv[1];
+    int maxThreads = (argc > 2) ? atoi(argv[2]) : int(std::thread::hardware_concurrency());
+    int repeat = (argc > 3) ? atoi(argv[3]) : 3;
+    if (maxThreads < 1) maxThreads = 1;
+    if (repeat < 1) repeat = 1;
+
+    std::map<string, std::set<string>> selectedTypes = exampleTypes();
+
+    // 顺序读取的基准结果和耗时
+    std::vector<ObsData> reference;
+    size_t fileSize = 0;
+    double seqSec = 0.0;
+    for (int r = 0; r < repeat; r++) {
+        std::vector<ObsData> epochs;
+        Clock::time_point t0 = Clock::now();
+        RinexObsMMapReader reader(obsFile);
+        reader.setSelectedTypes(selectedTypes);
+        while (true) {
+            try { epochs.push_back(reader.parseRinexObs()); }
+            catch (EndOfFile &e) { break; }
+        }
+        seqSec += std::chrono::duration<double>(Clock::now() - t0).count();
+        fileSize = reader.getFileSize();
+        reference.swap(epochs);
+    }
+    seqSec /= repeat;
+
+    double mb = fileSize / 1.0e6;
+    size_t numEpochs = reference.size();
+    size_t numMismatch = 0;
+
+    cout << "file: " << obsFile << " (" << fileSize << " bytes, " << numEpochs << " epochs)" << endl;
+    cout << fixed << setprecision(1);
+    cout << "threads           MB/s    epochs/s  speedup  first(ms)" << endl;
+    cout << "mmap      " << setw(12) << mb / seqSec << setw(12) << numEpochs / seqSec
+         << setprecision(2) << setw(9) << 1.0 << endl;
+
+    std::vector<int> threadCounts = {1, 2, 4, maxThreads};
+    std::sort(threadCounts.begin(), threadCounts.end());
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+    // 最后一轮用 N 个线程、按历元索引切块
+    RinexObsIndex epochIndex;
+    epochIndex.build(obsFile);
+    threadCounts.push_back(-maxThreads);
+
+    for (int count: threadCounts) {
+        int n = std::abs(count);
+        bool useIndex = (count < 0);
+        double parSec = 0.0, firstSec = 0.0;
+        for (int r = 0; r < repeat; r++) {
+            std::vector<ObsData> epochs;
+            epochs.reserve(numEpochs);
+            Clock::time_point t0 = Clock::now();
+            {
+                RinexObsParallelReader reader(obsFile, n);
+                reader.setSelectedTypes(selectedTypes);
+                if (useIndex) reader.setEpochIndex(&epochIndex);
+                while (true) {
+                    try { epochs.push_back(reader.parseRinexObs()); }
+                    catch (EndOfFile &e) { break; }
+                    if (epochs.size() == 1) {
+                        firstSec += std::chrono::duration<double>(Clock::now() - t0).count();
+                    }
+                }
+            }
+            parSec += std::chrono::duration<double>(Clock::now() - t0).count();
+
+            if (epochs.size() != numEpochs) numMismatch++;
+            for (size_t i = 0; i < epochs.size() && i < numEpochs; i++) {
+                if (!sameObsData(epochs[i], reference[i])) numMismatch++;
+            }
+        }
+        parSec /= repeat;
+        firstSec /= repeat;
+
+        string label = std::to_string(n) + (useIndex ? " (index)" : "");
+        cout << setprecision(1) << setw(10) << label << setw(12) << mb / parSec
+             << setw(12) << numEpochs / parSec
+             << setprecision(2) << setw(9) << seqSec / parSec
+             << setprecision(1) << setw(11) << firstSec * 1.0e3 << endl;
+    }
+    cout << "hardware threads: " << std::thread::hardware_concurrency() << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
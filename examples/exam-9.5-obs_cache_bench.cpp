@@ -0,0 +1,145 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 观测值二进制缓存测试：
+//  1. RINEX -> 缓存文件的转换耗时和文件大小；
+//  2. 文本内存映射读取器 RinexObsMMapReader 与缓存读取器 ObsCacheReader 各完整读取一遍，
+//     输出 MB/s、epochs/s，并逐历元检查两者输出完全一致；
+//  3. 单颗卫星的时间序列：缓存直接按卫星取数 vs 解码全部历元后挑出该卫星。
+//
+// 用法：obs_cache_bench <RINEX 3.04 观测值文件> [卫星, 如 G01] [观测值类型, 如 L1C]
+// 注意：data/ABMF00GLP_R_20210010000_01D_MN.rnx 是导航电文文件，不能用于本测试。
+//
+#include <iostream>
+#include <chrono>
+#include <vector>
+
+#include "RinexObsMMapReader.h"
+#include "ObsCache.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(const Clock::time_point &t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+static std::map<string, std::set<string>> exampleTypes() {
+    std::map<string, std::set<string>> selectedTypes;
+    selectedTypes["G"].insert("C1C");
+    selectedTypes["G"].insert("C2W");
+    selectedTypes["G"].insert("L1C");
+    selectedTypes["G"].insert("L2W");
+    selectedTypes["C"].insert("C2I");
+    selectedTypes["C"].insert("C7I");
+    selectedTypes["C"].insert("L2I");
+    selectedTypes["C"].insert("L7I");
+    return selectedTypes;
+}
+
+static bool sameObsData(const ObsData &a, const ObsData &b) {
+    return a.station == b.station && a.epoch == b.epoch &&
+           a.satTypeValueData == b.satTypeValueData;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <rinex 3.04 obs file> [sat] [type]" << endl;
+        exit(-1);
+    }
+    string obsFile = argv[1];
+    SatID sat((argc > 2) ? string(argv[2]) : string("G01"));
+    string type = (argc > 3) ? argv[3] : "L1C";
+    string cacheFile = ObsCacheWriter::cacheName(obsFile);
+
+    std::map<string, std::set<string>> selectedTypes = exampleTypes();
+    size_t numMismatch = 0;
+
+    //-------------------
+    // 1. 转换
+    //-------------------
+    Clock::time_point t0 = Clock::now();
+    ObsCacheWriter::convert(obsFile, cacheFile);
+    double convertSec = secondsSince(t0);
+
+    //-------------------
+    // 2. 完整读取
+    //-------------------
+    std::vector<ObsData> textEpochs;
+    size_t textSize;
+    t0 = Clock::now();
+    {
+        RinexObsMMapReader reader(obsFile);
+        reader.setSelectedTypes(selectedTypes);
+        while (true) {
+            try { textEpochs.push_back(reader.parseRinexObs()); }
+            catch (EndOfFile &e) { break; }
+        }
+        textSize = reader.getFileSize();
+    }
+    double textSec = secondsSince(t0);
+
+    std::vector<ObsData> cacheEpochs;
+    size_t cacheSize;
+    t0 = Clock::now();
+    {
+        ObsCacheReader reader(cacheFile);
+        reader.setSelectedTypes(selectedTypes);
+        while (true) {
+            try { cacheEpochs.push_back(reader.parseRinexObs()); }
+            catch (EndOfFile &e) { break; }
+        }
+        cacheSize = reader.getFileSize();
+    }
+    double cacheSec = secondsSince(t0);
+
+    if (textEpochs.size() != cacheEpochs.size()) numMismatch++;
+    for (size_t i = 0; i < textEpochs.size() && i < cacheEpochs.size(); i++) {
+        if (!sameObsData(textEpochs[i], cacheEpochs[i])) numMismatch++;
+    }
+
+    size_t numEpochs = textEpochs.size();
+    cout << fixed << setprecision(1);
+    cout << "text : " << textSize << " bytes, cache : " << cacheSize << " bytes" << endl;
+    cout << "convert     : " << convertSec * 1e3 << " ms" << endl;
+    cout << "text mmap   : " << setw(8) << textSize / 1.0e6 / textSec << " MB/s  "
+         << setw(10) << numEpochs / textSec << " epochs/s" << endl;
+    cout << "cache       : " << setw(8) << cacheSize / 1.0e6 / cacheSec << " MB/s  "
+         << setw(10) << numEpochs / cacheSec << " epochs/s" << endl;
+    cout << setprecision(2) << "speedup     : " << textSec / cacheSec << "x" << endl;
+
+    //-------------------
+    // 3. 单星时间序列
+    //-------------------
+    std::vector<ObsSample> series;
+    t0 = Clock::now();
+    ObsCacheReader seriesReader(cacheFile);
+    bool isFound = seriesReader.getSatSeries(sat, type, series);
+    double seriesSec = secondsSince(t0);
+
+    // 对照：解码全部历元后挑出该卫星
+    size_t numDecoded = 0;
+    std::map<string, std::set<string>> allTypes;
+    allTypes[sat.system].insert(type);
+    t0 = Clock::now();
+    {
+        ObsCacheReader reader(cacheFile);
+        reader.setSelectedTypes(allTypes);
+        while (true) {
+            ObsData obsData;
+            try { obsData = reader.parseRinexObs(); }
+            catch (EndOfFile &e) { break; }
+            if (obsData.satTypeValueData.count(sat)) numDecoded++;
+        }
+    }
+    double decodeSec = secondsSince(t0);
+
+    cout << sat << " " << type << (isFound ? "" : " (not found)") << " : "
+         << series.size() << " samples" << endl;
+    cout << setprecision(3) << "  series    : " << seriesSec * 1e3 << " ms" << endl;
+    cout << "  decode all: " << decodeSec * 1e3 << " ms (" << numDecoded << " epochs with data)" << endl;
+    cout << "mismatched  : " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// Compact RINEX 直接读取测试：
+//  1. 原来的做法：调用外部程序 CRX2RNX 把 .crx 解压成临时 RINEX 文件，再用 RinexObsMMapReader 读回；
+//  2. CrinexObsReader 直接在压缩文件上边解压边解析；
+// 输出两种做法的耗时、读写的字节数和 epochs/s，并逐历元检查两者输出完全一致。
+//
+// 用法：crinex_bench <CRINEX 3.0 观测值文件> [CRX2RNX 程序路径，默认 tools/CRX2RNX]
+// 仓库中的 tools/CRX2RNX 没有执行权限，使用前先 chmod +x，或给出系统中安装的 CRX2RNX
+//
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include "RinexObsMMapReader.h"
+#include "CrinexObsReader.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(const Clock::time_point &t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+static std::map<string, std::set<string>> exampleTypes() {
+    std::map<string, std::set<string>> selectedTypes;
+    selectedTypes["G"].insert("C1C");
+    selectedTypes["G"].insert("C2W");
+    selectedTypes["G"].insert("L1C");
+    selectedTypes["G"].insert("L2W");
+    selectedTypes["C"].insert("C2I");
+    selectedTypes["C"].insert("C7I");
+    selectedTypes["C"].insert("L2I");
+    selectedTypes["C"].insert("L7I");
+    return selectedTypes;
+}
+
+static bool sameObsData(const ObsData &a, const ObsData &b) {
+    return a.station == b.station && a.epoch == b.epoch &&
+           a.satTypeValueData == b.satTypeValueData;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <crinex 3.0 obs file> [CRX2RNX path]" << endl;
+        exit(-1);
+    }
+    string crxFile = argv[1];
+    string crx2rnx = (argc > 2) ? argv[2] : "tools/CRX2RNX";
+    string tmpFile = crxFile + ".tmp.rnx";
+
+    std::map<string, std::set<string>> selectedTypes = exampleTypes();
+
+    //-------------------
+    // 1. 外部解压 + 重新读取
+    //-------------------
+    std::vector<ObsData> refEpochs;
+    size_t crxSize = 0, rnxSize = 0;
+    Clock::time_point t0 = Clock::now();
+    string cmd = "\"" + crx2rnx + "\" -f \"" + crxFile + "\" - > \"" + tmpFile + "\"";
+    if (system(cmd.c_str()) != 0) {
+        cerr << "failed to run: " << cmd << " (is " << crx2rnx << " executable?)" << endl;
+        exit(-1);
+    }
+    double extSec = secondsSince(t0);
+    {
+        RinexObsMMapReader reader(tmpFile);
+        reader.setSelectedTypes(selectedTypes);
+        while (true) {
+            try { refEpochs.push_back(reader.parseRinexObs()); }
+            catch (EndOfFile &e) { break; }
+        }
+        rnxSize = reader.getFileSize();
+    }
+    double extTotalSec = secondsSince(t0);
+    std::remove(tmpFile.c_str());
+
+    //-------------------
+    // 2. 直接读取
+    //-------------------
+    std::vector<ObsData> crxEpochs;
+    t0 = Clock::now();
+    {
+        CrinexObsReader reader(crxFile);
+        reader.setSelectedTypes(selectedTypes);
+        while (true) {
+            try { crxEpochs.push_back(reader.parseRinexObs()); }
+            catch (EndOfFile &e) { break; }
+        }
+        crxSize = reader.getFileSize();
+    }
+    double crxSec = secondsSince(t0);
+
+    size_t numMismatch = 0;
+    if (crxEpochs.size() != refEpochs.size()) numMismatch++;
+    for (size_t i = 0; i < crxEpochs.size() && i < refEpochs.size(); i++) {
+        if (!sameObsData(crxEpochs[i], refEpochs[i])) numMismatch++;
+    }
+
+    size_t numEpochs = refEpochs.size();
+    cout << "file: " << crxFile << " (" << crxSize << " bytes, " << numEpochs << " epochs)" << endl;
+    cout << fixed << setprecision(3);
+    cout << "CRX2RNX + re-read: " << extTotalSec << " s (decompress " << extSec << " s), "
+         << "disk " << crxSize + 2 * rnxSize << " bytes, temp file " << rnxSize << " bytes, "
+         << setprecision(1) << numEpochs / extTotalSec << " epochs/s" << endl;
+    cout << setprecision(3);
+    cout << "CrinexObsReader:   " << crxSec << " s, "
+         << "disk " << crxSize << " bytes, "
+         << setprecision(1) << numEpochs / crxSec << " epochs/s" << endl;
+    cout << setprecision(2) << "speedup: " << extTotalSec / crxSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
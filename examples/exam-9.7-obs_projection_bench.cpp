@@ -0,0 +1,146 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 观测值类型投影测试：选择的观测值类型在读完文件头后编译成每个系统要解析的列，
+// 解析时不选的列不再换算、也不插入 TypeValueMap。
+// 对比两种做法（RinexObsReader 和 RinexObsMMapReader 各测一遍）：
+//  1. 原来的做法：解析全部观测值类型，再用 chooseObs 挑出需要的类型；
+//  2. 直接按选择的类型解析；
+// 输出两种做法的耗时和节省的比例，并逐历元检查两者输出完全一致。
+//
+// 用法：obs_projection_bench [RINEX 3.04 观测值文件] [重复次数]
+// 默认文件为 data/ABMF00GLP_R_20210010000_01D_30S_MO.rnx（与 exam-6.1 相同，需要自行下载放到 data 下）。
+//
+#include <iostream>
+#include <chrono>
+#include <vector>
+
+#include "RinexObsReader.h"
+#include "RinexObsMMapReader.h"
+#include "GnssFunc.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static std::map<string, std::set<string>> exampleTypes() {
+    std::map<string, std::set<string>> selectedTypes;
+    selectedTypes["G"].insert("C1C");
+    selectedTypes["G"].insert("C2W");
+    selectedTypes["G"].insert("L1C");
+    selectedTypes["G"].insert("L2W");
+    selectedTypes["C"].insert("C2I");
+    selectedTypes["C"].insert("C7I");
+    selectedTypes["C"].insert("L2I");
+    selectedTypes["C"].insert("L7I");
+    return selectedTypes;
+}
+
+static bool sameObsData(const ObsData &a, const ObsData &b) {
+    return a.station == b.station && a.epoch == b.epoch &&
+           a.satTypeValueData == b.satTypeValueData;
+}
+
+// 读取整个文件；postFilter 不为空时先解析全部类型，再按 postFilter 挑选
+template<class Reader>
+static double readAll(Reader &reader, std::map<string, std::set<string>> *postFilter,
+                      std::vector<ObsData> &epochs) {
+    Clock::time_point t0 = Clock::now();
+    while (true) {
+        try {
+            ObsData obsData = reader.parseRinexObs();
+            if (postFilter != NULL) chooseObs(obsData, *postFilter);
+            epochs.push_back(std::move(obsData));
+        } catch (EndOfFile &e) { break; }
+    }
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int main(int argc, char *argv[]) {
+    string obsFile = (argc > 1) ? argv[1] : "data/ABMF00GLP_R_20210010000_01D_30S_MO.rnx";
+    int repeat = (argc > 2) ? atoi(argv[2]) : 3;
+    if (repeat < 1) repeat = 1;
+
+    std::map<string, std::set<string>> selectedTypes = exampleTypes();
+
+    // 文件头中的全部观测值类型，用来模拟原来先全部解析的做法
+    std::map<string, std::set<string>> allTypes;
+    size_t numTypes = 0, numSelected = 0;
+    {
+        RinexObsMMapReader reader(obsFile);
+        for (const auto &entry: reader.getHeader().mapObsTypes) {
+            allTypes[entry.first].insert(entry.second.begin(), entry.second.end());
+            if (entry.first == "G" || entry.first == "C") {
+                numTypes += entry.second.size();
+                for (const auto &type: entry.second) {
+                    if (selectedTypes[entry.first].count(type)) numSelected++;
+                }
+            }
+        }
+    }
+
+    size_t numMismatch = 0;
+    size_t numEpochs = 0;
+    double fullSec[2] = {0.0, 0.0}, projSec[2] = {0.0, 0.0};
+    for (int r = 0; r < repeat; r++) {
+        std::vector<ObsData> fullEpochs, projEpochs;
+
+        // RinexObsReader
+        {
+            std::fstream obsStream(obsFile);
+            if (!obsStream) {
+                cerr << "obs file open error!" << endl;
+                exit(-1);
+            }
+            RinexObsReader reader;
+            reader.setFileStream(&obsStream);
+            reader.setSelectedTypes(allTypes);
+            fullSec[0] += readAll(reader, &selectedTypes, fullEpochs);
+        }
+        {
+            std::fstream obsStream(obsFile);
+            RinexObsReader reader;
+            reader.setFileStream(&obsStream);
+            reader.setSelectedTypes(selectedTypes);
+            projSec[0] += readAll(reader, (std::map<string, std::set<string>> *) NULL, projEpochs);
+        }
+        if (fullEpochs.size() != projEpochs.size()) numMismatch++;
+        for (size_t i = 0; i < fullEpochs.size() && i < projEpochs.size(); i++) {
+            if (!sameObsData(fullEpochs[i], projEpochs[i])) numMismatch++;
+        }
+        numEpochs = projEpochs.size();
+
+        // RinexObsMMapReader
+        std::vector<ObsData> fullMMap, projMMap;
+        {
+            RinexObsMMapReader reader(obsFile);
+            reader.setSelectedTypes(allTypes);
+            fullSec[1] += readAll(reader, &selectedTypes, fullMMap);
+        }
+        {
+            RinexObsMMapReader reader(obsFile);
+            reader.setSelectedTypes(selectedTypes);
+            projSec[1] += readAll(reader, (std::map<string, std::set<string>> *) NULL, projMMap);
+        }
+        if (fullMMap.size() != projEpochs.size()) numMismatch++;
+        for (size_t i = 0; i < fullMMap.size() && i < projEpochs.size(); i++) {
+            if (!sameObsData(fullMMap[i], projEpochs[i])) numMismatch++;
+            if (!sameObsData(projMMap[i], projEpochs[i])) numMismatch++;
+        }
+    }
+
+    const char *names[2] = {"RinexObsReader    ", "RinexObsMMapReader"};
+    cout << "file: " << obsFile << " (" << numEpochs << " epochs, G/C types selected "
+         << numSelected << " of " << numTypes << ")" << endl;
+    cout << fixed << setprecision(3);
+    cout << "reader               parse+choose  projected   saved" << endl;
+    for (int k = 0; k < 2; k++) {
+        double full = fullSec[k] / repeat, proj = projSec[k] / repeat;
+        cout << names[k] << setw(14) << full << setw(11) << proj
+             << setprecision(1) << setw(7) << 100.0 * (full - proj) / full << "%"
+             << setprecision(3) << endl;
+    }
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 后台预读测试：模拟 RTK 主循环，每个历元先读取观测值，再做固定耗时的“解算”（忙等）。
+//  1. RinexObsReader：读取与解算交替进行；
+//  2. RinexObsPrefetchReader：后台线程预读，主循环只取出已经解析好的历元；
+// 输出两种做法的总耗时，并逐历元检查两者输出完全一致。
+// 多核机器上总耗时接近 max(解析, 解算)，单核机器上两者不能重叠，不会有加速。
+//
+// 用法：obs_prefetch_bench <RINEX 3.04 观测值文件> [每历元解算耗时(微秒)，默认 200] [队列容量，默认 64]
+// 注意：data/ABMF00GLP_R_20210010000_01D_MN.rnx 是导航电文文件，不能用于本测试。
+//
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <thread>
+
+#include "RinexObsReader.h"
+#include "RinexObsPrefetchReader.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static std::map<string, std::set<string>> exampleTypes() {
+    std::map<string, std::set<string>> selectedTypes;
+    selectedTypes["G"].insert("C1C");
+    selectedTypes["G"].insert("C2W");
+    selectedTypes["G"].insert("L1C");
+    selectedTypes["G"].insert("L2W");
+    selectedTypes["C"].insert("C2I");
+    selectedTypes["C"].insert("C7I");
+    selectedTypes["C"].insert("L2I");
+    selectedTypes["C"].insert("L7I");
+    return selectedTypes;
+}
+
+static bool sameObsData(const ObsData &a, const ObsData &b) {
+    return a.station == b.station && a.epoch == b.epoch &&
+           a.satTypeValueData == b.satTypeValueData;
+}
+
+// 模拟解算：忙等 us 微秒
+static void fakeSolve(int us) {
+    Clock::time_point t0 = Clock::now();
+    while (std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0).count() < us) {
+    }
+}
+
+// 按 RTK 主循环的方式读取并“解算”整个文件，返回总耗时
+template<class Reader>
+static double runLoop(Reader &reader, int solveUs, std::vector<ObsData> &epochs) {
+    Clock::time_point t0 = Clock::now();
+    while (true) {
+        ObsData obsData;
+        try {
+            obsData = reader.parseRinexObs();
+        } catch (EndOfFile &e) { break; }
+        fakeSolve(solveUs);
+        epochs.push_back(std::move(obsData));
+    }
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <rinex 3.04 obs file> [solve us per epoch] [capacity]" << endl;
+        exit(-1);
+    }
+    string obsFile = argv[1];
+    int solveUs = (argc > 2) ? atoi(argv[2]) : 200;
+    size_t capacity = (argc > 3) ? size_t(atoi(argv[3])) : 64;
+
+    std::map<string, std::set<string>> selectedTypes = exampleTypes();
+
+    std::vector<ObsData> seqEpochs, preEpochs;
+    double seqSec, preSec;
+    {
+        std::fstream obsStream(obsFile);
+        if (!obsStream) {
+            cerr << "obs file open error!" << endl;
+            exit(-1);
+        }
+        RinexObsReader reader;
+        reader.setFileStream(&obsStream);
+        reader.setSelectedTypes(selectedTypes);
+        seqSec = runLoop(reader, solveUs, seqEpochs);
+    }
+    {
+        std::fstream obsStream(obsFile);
+        RinexObsPrefetchReader reader;
+        reader.setFileStream(&obsStream);
+        reader.setSelectedTypes(selectedTypes);
+        reader.setCapacity(capacity);
+        preSec = runLoop(reader, solveUs, preEpochs);
+    }
+
+    size_t numMismatch = 0;
+    if (seqEpochs.size() != preEpochs.size()) numMismatch++;
+    for (size_t i = 0; i < seqEpochs.size() && i < preEpochs.size(); i++) {
+        if (!sameObsData(seqEpochs[i], preEpochs[i])) numMismatch++;
+    }
+
+    double solveSec = seqEpochs.size() * solveUs * 1.0e-6;
+    cout << "file: " << obsFile << " (" << seqEpochs.size() << " epochs, "
+         << std::thread::hardware_concurrency() << " hardware threads)" << endl;
+    cout << fixed << setprecision(3);
+    cout << "solve only:      " << solveSec << " s" << endl;
+    cout << "RinexObsReader:  " << seqSec << " s (parse ~" << seqSec - solveSec << " s)" << endl;
+    cout << "prefetch reader: " << preSec << " s, capacity " << capacity << endl;
+    cout << setprecision(2) << "speedup: " << seqSec / preSec << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
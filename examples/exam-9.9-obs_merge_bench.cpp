@@ -0,0 +1,146 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// 多测站历元归并测试：第一个文件为参考测站（相当于 RTK 的流动站），其余为其他测站。
+//  1. 原来的做法：逐个读取参考测站历元，其他测站用 parseRinexObs(epoch) 同步，缺历元时捕获 SyncException；
+//  2. ObsEpochMerger：k 路归并，RequireReference 策略，缺失的测站 isPresent 为 false；
+// 输出两种做法的耗时、组数和各测站缺失的历元数，并逐组检查两者输出完全一致。
+//
+// 用法：obs_merge_bench <参考测站观测值文件> <其他测站观测值文件> [...]
+// 注意：data/ABMF00GLP_R_20210010000_01D_MN.rnx 是导航电文文件，不能用于本测试。
+//
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <memory>
+
+#include "RinexObsMMapReader.h"
+#include "ObsEpochMerger.h"
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static std::map<string, std::set<string>> exampleTypes() {
+    std::map<string, std::set<string>> selectedTypes;
+    selectedTypes["G"].insert("C1C");
+    selectedTypes["G"].insert("C2W");
+    selectedTypes["G"].insert("L1C");
+    selectedTypes["G"].insert("L2W");
+    selectedTypes["C"].insert("C2I");
+    selectedTypes["C"].insert("C7I");
+    selectedTypes["C"].insert("L2I");
+    selectedTypes["C"].insert("L7I");
+    return selectedTypes;
+}
+
+static bool sameObsData(const ObsData &a, const ObsData &b) {
+    return a.station == b.station && a.epoch == b.epoch &&
+           a.satTypeValueData == b.satTypeValueData;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        cerr << "usage: " << argv[0] << " <reference obs file> <obs file> [...]" << endl;
+        exit(-1);
+    }
+    std::vector<string> obsFiles(argv + 1, argv + argc);
+    size_t n = obsFiles.size();
+    std::map<string, std::set<string>> selectedTypes = exampleTypes();
+
+    //-------------------
+    // 1. parseRinexObs(epoch) + SyncException
+    //-------------------
+    std::vector<ObsEpochGroup> syncGroups;
+    size_t numExceptions = 0;
+    Clock::time_point t0 = Clock::now();
+    {
+        std::vector<std::unique_ptr<RinexObsMMapReader>> readers;
+        for (const auto &file: obsFiles) {
+            readers.emplace_back(new RinexObsMMapReader(file));
+            readers.back()->setSelectedTypes(selectedTypes);
+        }
+        while (true) {
+            ObsEpochGroup group;
+            group.stations.resize(n);
+            group.isPresent.assign(n, false);
+            try {
+                group.stations[0] = readers[0]->parseRinexObs();
+            } catch (EndOfFile &e) { break; }
+            group.epoch = group.stations[0].epoch;
+            group.isPresent[0] = true;
+            group.numPresent = 1;
+
+            for (size_t i = 1; i < n; i++) {
+                try {
+                    ObsData obsData = readers[i]->parseRinexObs(group.epoch);
+                    // 文件读完时同步返回的历元不是参考时刻
+                    if (obsData.epoch - group.epoch <= 0.001 && obsData.epoch >= group.epoch) {
+                        group.stations[i] = std::move(obsData);
+                        group.isPresent[i] = true;
+                        group.numPresent++;
+                    }
+                } catch (SyncException &e) {
+                    numExceptions++;
+                }
+            }
+            syncGroups.push_back(std::move(group));
+        }
+    }
+    double syncSec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    //-------------------
+    // 2. ObsEpochMerger
+    //-------------------
+    std::vector<ObsEpochGroup> mergeGroups;
+    size_t numDropped;
+    t0 = Clock::now();
+    {
+        std::vector<std::unique_ptr<RinexObsMMapReader>> readers;
+        ObsEpochMerger merger;
+        for (const auto &file: obsFiles) {
+            readers.emplace_back(new RinexObsMMapReader(file));
+            readers.back()->setSelectedTypes(selectedTypes);
+            merger.addReader(readers.back().get());
+        }
+        merger.setMissingPolicy(ObsEpochMerger::RequireReference);
+        merger.setReferenceStation(0);
+
+        ObsEpochGroup group;
+        while (merger.next(group)) {
+            mergeGroups.push_back(std::move(group));
+        }
+        numDropped = merger.getNumDropped();
+    }
+    double mergeSec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    size_t numMismatch = 0;
+    std::vector<size_t> numMissing(n, 0);
+    if (syncGroups.size() != mergeGroups.size()) numMismatch++;
+    for (size_t k = 0; k < syncGroups.size() && k < mergeGroups.size(); k++) {
+        const ObsEpochGroup &a = syncGroups[k], &b = mergeGroups[k];
+        if (a.epoch != b.epoch || a.isPresent != b.isPresent) {
+            numMismatch++;
+            continue;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (!b.isPresent[i]) {
+                numMissing[i]++;
+            } else if (!sameObsData(a.stations[i], b.stations[i])) {
+                numMismatch++;
+            }
+        }
+    }
+
+    cout << "stations: " << n << ", groups: " << mergeGroups.size()
+         << ", dropped (no reference): " << numDropped << endl;
+    for (size_t i = 1; i < n; i++) {
+        cout << "  " << obsFiles[i] << " missing " << numMissing[i] << " epochs" << endl;
+    }
+    cout << fixed << setprecision(3);
+    cout << "parseRinexObs(epoch): " << syncSec << " s, " << numExceptions << " SyncException" << endl;
+    cout << "ObsEpochMerger:       " << mergeSec << " s" << endl;
+    cout << "mismatched: " << numMismatch << endl;
+
+    return numMismatch == 0 ? 0 : 1;
+}
@@ -9,6 +9,7 @@
 
 #include "GnssStruct.h"
 #include "RinexNavStore.hpp"
+#include "LiveEphStore.h"
 #include "SPPUCCodePhase.h"
 #include "RinexObsReader.h"
 #include "DecodeConst.h"
@@ -106,6 +107,9 @@ int main()
 
     RinexNavStore navStore;
 
+    // 解码得到的星历按快照发布，求解时每个历元取一个快照，解码和求解可以放在不同的线程中
+    LiveEphStore liveStore;
+
     WeekSecond weekSecond;//基准站
     WeekSecond weekSecond2;//流动站
 
@@ -124,11 +128,13 @@ int main()
     //流动站
     SPPUCCodePhase sppUCCodePhaseRover;
     sppUCCodePhaseRover.setRinexNavStore(&navStore);
+    sppUCCodePhaseRover.setLiveEphStore(&liveStore);
     sppUCCodePhaseRover.setDualCodeTypes(dualCodeTypes);
 
     //基准站
     SPPUCCodePhase sppUCCodePhaseBase;
     sppUCCodePhaseBase.setRinexNavStore(&navStore);//同流动站
+    sppUCCodePhaseBase.setLiveEphStore(&liveStore);
     sppUCCodePhaseBase.setStationAsBase();//isRover = false;
     sppUCCodePhaseBase.setDualCodeTypes(dualCodeTypes);//同流动站
 
@@ -283,12 +289,18 @@ int main()
                     obsData.epoch = epoch;
                     foundObs = decode_rangeb_oem7(tempData, &obsData);
                     break;
-                case ID_BDSEPHEM:
-                    foundBDEph = decode_BDSEph(tempData, navStore.bdsNav);
+                case ID_BDSEPHEM: {
+                    LiveEphStore::Writer writer(liveStore);
+                    foundBDEph = decode_BDSEph(tempData, writer.draft().bdsNav);
+                    if (foundBDEph == 2) writer.commit();
                     break;
-                case ID_GPSEPHEM:
-                    foundGPSEph = decode_GPSEph(tempData, navStore.gpsNav);
+                }
+                case ID_GPSEPHEM: {
+                    LiveEphStore::Writer writer(liveStore);
+                    foundGPSEph = decode_GPSEph(tempData, writer.draft().gpsNav);
+                    if (foundGPSEph == 2) writer.commit();
                     break;
+                }
                 case ID_IONUTC:
                     decode_ionutc(tempData, &IonPara);
                     break;
@@ -390,12 +402,18 @@ int main()
                     obsData2.epoch = epoch;
                     foundObs2 = decode_rangeb_oem7(tempData2, &obsData2);
                     break;
-                case ID_BDSEPHEM:
-                    foundBD2 = decode_BDSEph(tempData2, navStore.bdsNav);
+                case ID_BDSEPHEM: {
+                    LiveEphStore::Writer writer(liveStore);
+                    foundBD2 = decode_BDSEph(tempData2, writer.draft().bdsNav);
+                    if (foundBD2 == 2) writer.commit();
                     break;
-                case ID_GPSEPHEM:
-                   foundGPS2 = decode_GPSEph(tempData2, navStore.gpsNav);
+                }
+                case ID_GPSEPHEM: {
+                    LiveEphStore::Writer writer(liveStore);
+                    foundGPS2 = decode_GPSEph(tempData2, writer.draft().gpsNav);
+                    if (foundGPS2 == 2) writer.commit();
                     break;
+                }
                 case ID_IONUTC:
                     decode_ionutc(tempData2, &IonPara);
                     break;
@@ -0,0 +1,78 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// BroadcastOrbitBatch 的 AVX2 内核，每次四颗卫星；本文件用 -mavx2 编译（见 CMakeLists.txt），
+// 只有 BroadcastOrbitBatch::supportedSimdLevel() 确认 CPU 支持 AVX2 后才调用
+//
+#define GNSSLAB_ORBIT_KERNEL_IMPL
+#include "BroadcastOrbitKernel.h"
+
+#ifdef GNSSLAB_ORBIT_SIMD
+
+#include <immintrin.h>
+
+namespace {
+
+    struct AVX2Ops {
+        typedef __m256d T;
+        static const size_t WIDTH = 4;
+
+        static inline T set1(double v) { return _mm256_set1_pd(v); }
+
+        static inline T load(const double *p) { return _mm256_loadu_pd(p); }
+
+        static inline void store(double *p, T v) { _mm256_storeu_pd(p, v); }
+
+        static inline T add(T a, T b) { return _mm256_add_pd(a, b); }
+
+        static inline T sub(T a, T b) { return _mm256_sub_pd(a, b); }
+
+        static inline T mul(T a, T b) { return _mm256_mul_pd(a, b); }
+
+        static inline T div(T a, T b) { return _mm256_div_pd(a, b); }
+
+        static inline T greater(T a, T b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+
+        static inline T maskAnd(T mask, T v) { return _mm256_and_pd(mask, v); }
+
+        static inline T maskAndNot(T mask, T v) { return _mm256_andnot_pd(mask, v); }
+
+        static inline T maskXor(T a, T b) { return _mm256_xor_pd(a, b); }
+
+        // mask 为真的通道取 a，否则取 b
+        static inline T blend(T mask, T a, T b) { return _mm256_blendv_pd(b, a, mask); }
+
+        // mask 为真的通道取反
+        static inline T negate(T mask, T v) { return _mm256_xor_pd(v, _mm256_and_pd(mask, _mm256_set1_pd(-0.0))); }
+
+        static inline bool any(T mask) { return _mm256_movemask_pd(mask) != 0; }
+
+        // 轨道类型等于 type 的通道
+        static inline T typeMask(const int *p, int type) {
+            __m256i t = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+            return _mm256_castsi256_pd(_mm256_cmpeq_epi64(t, _mm256_set1_epi64x(type)));
+        }
+
+        // y 舍入到最近的整数 j，odd、upper 为 j 的第 0、1 位
+        static inline void quadrant(T y, T &j, T &odd, T &upper) {
+            __m128i ji = _mm256_cvtpd_epi32(y);
+            j = _mm256_cvtepi32_pd(ji);
+            __m256i jj = _mm256_cvtepi32_epi64(ji);
+            __m256i bit0 = _mm256_set1_epi64x(1), bit1 = _mm256_set1_epi64x(2);
+            odd = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(jj, bit0), bit0));
+            upper = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(jj, bit1), bit1));
+        }
+    };
+}
+
+size_t computeOrbitAVX2(const OrbitKernelArgs &args) {
+    return orbitkernel::computeOrbit<AVX2Ops>(args);
+}
+
+#else
+
+size_t computeOrbitAVX2(const OrbitKernelArgs &) {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,357 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <cmath>
+#include <algorithm>
+#include "BroadcastOrbitBatch.h"
+#include "BroadcastOrbitKernel.h"
+#include "CoordStruct.h"
+#include "Exception.h"
+
+#if defined(GNSSLAB_ORBIT_SIMD) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define debug 0
+
+// 开普勒方程牛顿迭代的最多次数；步长小于 KEPLER_TOLERANCE 后，下一步的改正小于 1e-16 弧度，不再迭代
+static const int KEPLER_ITERATIONS = 10;
+static const double KEPLER_TOLERANCE = 1.0e-8;
+
+// 牛顿迭代的步长不超过这个值时，用级数把 sinE、cosE 转过步长，不再计算三角函数
+static const double MAX_ROTATE_STEP = 0.05;
+
+// 把 (s, c) = (sin x, cos x) 更新为 (sin(x+d), cos(x+d))，|d| <= MAX_ROTATE_STEP 时级数截断误差小于 1e-17；
+// 乘以倒数常量，避免逐项做除法
+static inline void rotate(double &s, double &c, double d) {
+    double d2 = d * d;
+    double sind, cosd;
+    if (std::fabs(d) < 1.0e-3) {
+        sind = d * (1.0 - d2 * (1.0 / 6.0));
+        cosd = 1.0 - d2 * (0.5 - d2 * (1.0 / 24.0));
+    } else {
+        sind = d * (1.0 - d2 * (1.0 / 6.0) * (1.0 - d2 * (1.0 / 20.0) * (1.0 - d2 * (1.0 / 42.0))));
+        cosd = 1.0 - d2 * 0.5 * (1.0 - d2 * (1.0 / 12.0) * (1.0 - d2 * (1.0 / 30.0) * (1.0 - d2 * (1.0 / 56.0))));
+    }
+    double sNew = s * cosd + c * sind;
+    c = c * cosd - s * sind;
+    s = sNew;
+}
+
+// NavEphBDS::svXvt 中 GEO 模型的轨道半径和倾角
+static const double GEO_RADIUS = 35786000;
+static const double GEO_COS_INCL = std::cos(-5 * DEG_TO_RAD);
+
+void OrbitBatchResult::resize(size_t n) {
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    vx.resize(n);
+    vy.resize(n);
+    vz.resize(n);
+    clkbias.resize(n);
+    clkdrift.resize(n);
+    relcorr.resize(n);
+    tk.resize(n);
+    tc.resize(n);
+}
+
+Xvt OrbitBatchResult::getXvt(size_t k) const {
+    Xvt xvt;
+    xvt.x[0] = x[k];
+    xvt.x[1] = y[k];
+    xvt.x[2] = z[k];
+    xvt.v[0] = vx[k];
+    xvt.v[1] = vy[k];
+    xvt.v[2] = vz[k];
+    xvt.clkbias = clkbias[k];
+    xvt.clkdrift = clkdrift[k];
+    xvt.relcorr = relcorr[k];
+    return xvt;
+}
+
+BroadcastOrbitBatch::BroadcastOrbitBatch()
+        : maxEcc(0.0), simdLevel(supportedSimdLevel()) {
+}
+
+BroadcastOrbitBatch::SimdLevel BroadcastOrbitBatch::supportedSimdLevel() {
+#ifdef GNSSLAB_ORBIT_SIMD
+    static const SimdLevel level = []() {
+#ifdef _MSC_VER
+        // AVX2 要求 CPU 支持并且操作系统保存 YMM 寄存器（OSXSAVE、XCR0 的第 1、2 位）
+        int info[4];
+        __cpuid(info, 1);
+        bool osAVX = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+        __cpuidex(info, 7, 0);
+        bool hasAVX2 = osAVX && (info[1] & (1 << 5));
+#else
+        bool hasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+        return hasAVX2 ? SIMD_AVX2 : SIMD_SSE2;
+    }();
+    return level;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+void BroadcastOrbitBatch::setSimdLevel(SimdLevel level) {
+    simdLevel = std::min(level, supportedSimdLevel());
+}
+
+void BroadcastOrbitBatch::reserve(size_t num) {
+    ctToe.reserve(num);
+    ctToc.reserve(num);
+    orbitType.reserve(num);
+    for (std::vector<double> *p: {&A, &n, &M0, &ecc, &q, &sinOmega, &cosOmega,
+                                  &Cuc, &Cus, &Crc, &Crs, &Cic, &Cis, &i0, &IDOT,
+                                  &OMEGA0, &OMEGAdot, &omegaE, &dlkScale, &relScale, &af0, &af1, &af2}) {
+        p->reserve(num);
+    }
+}
+
+void BroadcastOrbitBatch::clear() {
+    ctToe.clear();
+    ctToc.clear();
+    orbitType.clear();
+    for (std::vector<double> *p: {&A, &n, &M0, &ecc, &q, &sinOmega, &cosOmega,
+                                  &Cuc, &Cus, &Crc, &Crs, &Cic, &Cis, &i0, &IDOT,
+                                  &OMEGA0, &OMEGAdot, &omegaE, &dlkScale, &relScale, &af0, &af1, &af2}) {
+        p->clear();
+    }
+    maxEcc = 0.0;
+}
+
+template<class Eph>
+size_t BroadcastOrbitBatch::addKepler(const Eph &eph, int type, double gm, double omegaEarth) {
+    double a = eph.sqrt_A * eph.sqrt_A;
+    double qk = std::sqrt(1.0 - eph.ecc * eph.ecc);
+
+    ctToe.push_back(eph.ctToe);
+    ctToc.push_back(eph.ctToc);
+    orbitType.push_back(type);
+    A.push_back(a);
+    n.push_back(std::sqrt(gm / (a * a * a)) + eph.Delta_n);
+    M0.push_back(eph.M0);
+    ecc.push_back(eph.ecc);
+    q.push_back(qk);
+    sinOmega.push_back(std::sin(eph.omega));
+    cosOmega.push_back(std::cos(eph.omega));
+    Cuc.push_back(eph.Cuc);
+    Cus.push_back(eph.Cus);
+    Crc.push_back(eph.Crc);
+    Crs.push_back(eph.Crs);
+    Cic.push_back(eph.Cic);
+    Cis.push_back(eph.Cis);
+    i0.push_back(eph.i0);
+    IDOT.push_back(eph.IDOT);
+    OMEGA0.push_back(eph.OMEGA_0 - omegaEarth * eph.Toe);
+    OMEGAdot.push_back(eph.OMEGA_DOT - omegaEarth);
+    omegaE.push_back(omegaEarth);
+    dlkScale.push_back(eph.sqrt_A * qk * std::sqrt(gm));
+    relScale.push_back(REL_CONST * eph.ecc * std::sqrt(a));
+    af0.push_back(eph.af0);
+    af1.push_back(eph.af1);
+    af2.push_back(eph.af2);
+    maxEcc = std::max(maxEcc, std::fabs(eph.ecc));
+    return ctToe.size() - 1;
+}
+
+size_t BroadcastOrbitBatch::add(const NavEphGPS &eph) {
+    GPSEllipsoid ell;
+    return addKepler(eph, KEPLER, ell.gm(), ell.angVelocity());
+}
+
+size_t BroadcastOrbitBatch::add(const NavEphBDS &eph) {
+    CGCS2000 ell;
+
+    // 与 NavEphBDS::svXvt 的分支相同
+    double incl = eph.i0 * RAD_TO_DEG;
+    int type = NO_ORBIT;
+    if (incl <= 60 && incl >= 50) {
+        type = KEPLER;
+    } else if (incl < 30 && incl >= 0) {
+        type = BDS_GEO;
+    }
+    return addKepler(eph, type, ell.getGM(), ell.getOmega());
+}
+
+void BroadcastOrbitBatch::compute(const std::vector<CommonTime> &epochs, OrbitBatchResult &result) const {
+    if (epochs.size() != size()) {
+        InvalidRequest e("BroadcastOrbitBatch: number of epochs differs from number of ephemerides");
+        throw (e);
+    }
+
+    size_t num = size();
+    result.resize(num);
+    for (size_t k = 0; k < num; k++) {
+        result.tk[k] = epochs[k] - ctToe[k];
+        result.tc[k] = epochs[k] - ctToc[k];
+    }
+    computeStates(result);
+}
+
+void BroadcastOrbitBatch::compute(const CommonTime &epoch, OrbitBatchResult &result) const {
+    size_t num = size();
+    result.resize(num);
+    for (size_t k = 0; k < num; k++) {
+        result.tk[k] = epoch - ctToe[k];
+        result.tc[k] = epoch - ctToc[k];
+    }
+    computeStates(result);
+}
+
+void BroadcastOrbitBatch::computeStates(OrbitBatchResult &result) const {
+    size_t num = size();
+
+    // 钟差
+    for (size_t k = 0; k < num; k++) {
+        double tc = result.tc[k];
+        result.clkbias[k] = af0[k] + tc * (af1[k] + tc * af2[k]);
+        result.clkdrift[k] = af1[k] + tc * af2[k];
+    }
+
+    // 向量内核计算完整的各组，剩下的用标量计算
+    size_t numDone = 0;
+    if (simdLevel != SIMD_SCALAR && maxEcc <= KERNEL_MAX_ECC) {
+        OrbitKernelArgs args;
+        args.num = num;
+        args.orbitType = orbitType.data();
+        args.tk = result.tk.data();
+        args.A = A.data();
+        args.n = n.data();
+        args.M0 = M0.data();
+        args.ecc = ecc.data();
+        args.q = q.data();
+        args.sinOmega = sinOmega.data();
+        args.cosOmega = cosOmega.data();
+        args.Cuc = Cuc.data();
+        args.Cus = Cus.data();
+        args.Crc = Crc.data();
+        args.Crs = Crs.data();
+        args.Cic = Cic.data();
+        args.Cis = Cis.data();
+        args.i0 = i0.data();
+        args.IDOT = IDOT.data();
+        args.OMEGA0 = OMEGA0.data();
+        args.OMEGAdot = OMEGAdot.data();
+        args.omegaE = omegaE.data();
+        args.dlkScale = dlkScale.data();
+        args.relScale = relScale.data();
+        args.x = result.x.data();
+        args.y = result.y.data();
+        args.z = result.z.data();
+        args.vx = result.vx.data();
+        args.vy = result.vy.data();
+        args.vz = result.vz.data();
+        args.relcorr = result.relcorr.data();
+        numDone = (simdLevel == SIMD_AVX2) ? computeOrbitAVX2(args) : computeOrbitSSE2(args);
+    }
+    computeStatesScalar(result, numDone);
+}
+
+void BroadcastOrbitBatch::computeStatesScalar(OrbitBatchResult &result, size_t begin) const {
+    size_t num = size();
+    for (size_t k = begin; k < num; k++) {
+        double tk = result.tk[k];
+        if (tk > 302400) tk = tk - 604800;
+        if (tk < -302400) tk = tk + 604800;
+
+        // 开普勒方程
+        double e = ecc[k];
+        double Mk = M0[k] + n[k] * tk;
+        double sinEk = std::sin(Mk);
+        double cosEk = std::cos(Mk);
+        double Ek = Mk;
+        for (int it = 0; it <= KEPLER_ITERATIONS; it++) {
+            // 第一步为初值 E = M + e*sinM
+            double dE = (it == 0) ? e * sinEk : (Mk - (Ek - e * sinEk)) / (1.0 - e * cosEk);
+            Ek += dE;
+            if (std::fabs(dE) <= MAX_ROTATE_STEP) {
+                rotate(sinEk, cosEk, dE);
+            } else {
+                sinEk = std::sin(Ek);
+                cosEk = std::cos(Ek);
+            }
+            if (it > 0 && std::fabs(dE) < KEPLER_TOLERANCE) break;
+        }
+
+        result.relcorr[k] = relScale[k] * sinEk;
+
+        if (orbitType[k] == BDS_GEO) {
+            double OMEGA_k = OMEGA0[k] + OMEGAdot[k] * tk;
+            double Xk = GEO_RADIUS * std::cos(OMEGA_k);
+            double Yk = GEO_RADIUS * std::sin(OMEGA_k);
+            double wt = omegaE[k] * tk;
+            double coswt = std::cos(wt);
+            double sinwt = std::sin(wt);
+            double xef = Xk * coswt + Yk * GEO_COS_INCL * sinwt;
+            double yef = -Xk * sinwt + Yk * GEO_COS_INCL * coswt;
+            result.x[k] = xef;
+            result.y[k] = yef;
+            result.z[k] = Yk * GEO_COS_INCL;
+            result.vx[k] = -omegaE[k] * yef;
+            result.vy[k] = omegaE[k] * xef;
+            result.vz[k] = 0.0;
+            continue;
+        }
+        if (orbitType[k] == NO_ORBIT) {
+            result.x[k] = result.y[k] = result.z[k] = 0.0;
+            result.vx[k] = result.vy[k] = result.vz[k] = 0.0;
+            continue;
+        }
+
+        // 真近点角的正弦、余弦，纬度幅角 phi = vk + omega
+        double denom = 1.0 - e * cosEk;
+        double sinvk = q[k] * sinEk / denom;
+        double cosvk = (cosEk - e) / denom;
+        double sinphi = sinvk * cosOmega[k] + cosvk * sinOmega[k];
+        double cosphi = cosvk * cosOmega[k] - sinvk * sinOmega[k];
+        double sin2phi = 2.0 * sinphi * cosphi;
+        double cos2phi = (cosphi - sinphi) * (cosphi + sinphi);
+
+        double duk = cos2phi * Cuc[k] + sin2phi * Cus[k];
+        double drk = cos2phi * Crc[k] + sin2phi * Crs[k];
+        double dik = cos2phi * Cic[k] + sin2phi * Cis[k];
+
+        // uk = phi + duk，duk 很小，正弦、余弦展开到舍入误差以下
+        double duk2 = duk * duk;
+        double sinduk = duk * (1.0 - duk2 * (1.0 / 6.0));
+        double cosduk = 1.0 - duk2 * (0.5 - duk2 * (1.0 / 24.0));
+        double sinuk = sinphi * cosduk + cosphi * sinduk;
+        double cosuk = cosphi * cosduk - sinphi * sinduk;
+
+        double a = A[k];
+        double rk = a * denom + drk;
+        double ik = i0[k] + dik + IDOT[k] * tk;
+
+        double xip = rk * cosuk;
+        double yip = rk * sinuk;
+
+        double OMEGA_k = OMEGA0[k] + OMEGAdot[k] * tk;
+        double sinOMG_k = std::sin(OMEGA_k);
+        double cosOMG_k = std::cos(OMEGA_k);
+        double sinik = std::sin(ik);
+        double cosik = std::cos(ik);
+
+        result.x[k] = xip * cosOMG_k - yip * cosik * sinOMG_k;
+        result.y[k] = xip * sinOMG_k + yip * cosik * cosOMG_k;
+        result.z[k] = yip * sinik;
+
+        // 速度，公式与 svXvt 相同
+        double dek = n[k] * a / rk;
+        double dlk = dlkScale[k] / (rk * rk);
+        double div = IDOT[k] - 2.0 * dlk * (Cic[k] * sin2phi - Cis[k] * cos2phi);
+        double domk = OMEGAdot[k];
+        double duv = dlk * (1.0 + 2.0 * (Cus[k] * cos2phi - Cuc[k] * sin2phi));
+        double drv = a * e * dek * sinEk - 2.0 * dlk * (Crc[k] * sin2phi - Crs[k] * cos2phi);
+        double dxp = drv * cosuk - rk * sinuk * duv;
+        double dyp = drv * sinuk + rk * cosuk * duv;
+
+        result.vx[k] = dxp * cosOMG_k - xip * sinOMG_k * domk - dyp * cosik * sinOMG_k
+                       + yip * (sinik * sinOMG_k * div - cosik * cosOMG_k * domk);
+        result.vy[k] = dxp * sinOMG_k + xip * cosOMG_k * domk + dyp * cosik * cosOMG_k
+                       - yip * (sinik * cosOMG_k * div + cosik * sinOMG_k * domk);
+        result.vz[k] = dyp * sinik + yip * cosik * div;
+    }
+}
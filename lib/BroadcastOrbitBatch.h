@@ -0,0 +1,137 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_BROADCASTORBITBATCH_H
+#define GNSSLAB_BROADCASTORBITBATCH_H
+
+#include <vector>
+
+#include "GnssStruct.h"
+#include "NavEphGPS.hpp"
+#include "NavEphBDS.h"
+
+// BroadcastOrbitBatch::compute 的结果，按结构数组存放，第 k 个元素对应第 k 组星历
+struct OrbitBatchResult {
+    void resize(size_t n);
+
+    Xvt getXvt(size_t k) const;
+
+    std::vector<double> x, y, z;          // 位置，米
+    std::vector<double> vx, vy, vz;       // 速度，米/秒
+    std::vector<double> clkbias;          // 钟差，秒
+    std::vector<double> clkdrift;         // 钟漂，秒/秒
+    std::vector<double> relcorr;          // 相对论改正，秒
+
+    std::vector<double> tk;               // 距 toe 的时间，秒
+    std::vector<double> tc;               // 距 toc 的时间，秒
+};
+
+// 批量计算广播星历的卫星位置、速度和钟差
+//
+// NavEphGPS::svXvt、NavEphBDS::svXvt 一次算一颗卫星，每次都重新计算 A、n、sqrt(1-e^2) 等只与星历有关的量，
+// 开普勒方程迭代到收敛，计算相对论改正时又把开普勒方程解一遍。
+// 这里把多组星历预先整理成结构数组，只与星历有关的量在 add 时算好；compute 对所有星历逐个计算，
+// 每一步都是对连续数组的同一种运算：
+//  - 开普勒方程的牛顿迭代在步长小于 1e-8 时停止（此后的改正已小于舍入误差），GPS、北斗的偏心率下只需两步，
+//    结果同时用于相对论改正；迭代中 sinE、cosE 由上一步的值按步长旋转得到，只在平近点角处计算一次三角函数；
+//  - 真近点角由 sinE、cosE 直接得到正弦、余弦，不计算 atan2；
+//  - 纬度幅角的改正量小于 1e-4 弧度，用级数展开计算正弦、余弦，二倍角用倍角公式。
+//
+// 轨道类型与标量计算的分支相同：GPS 和北斗 MEO/IGSO（倾角 50~60 度）按开普勒轨道计算，
+// 北斗 GEO（倾角小于 30 度）使用 NavEphBDS::svXvt 中的 GEO 模型，其他倾角只计算钟差。
+// 与标量计算的差异：位置小于 1e-6 米（exam-9.19）；-O2 编译时每颗卫星约 170 ns，svXvt 约 460 ns。
+//
+// x86-64 上打开 GNSSLAB_ORBIT_SIMD（CMake 选项，默认打开）时，位置、速度和相对论改正用向量内核计算
+// （BroadcastOrbitKernel.h）：AVX2 每次四颗、SSE2 每次两颗卫星，运行时检查 CPU 选择 AVX2 或 SSE2；
+// 不足一组的卫星、偏心率超过 KERNEL_MAX_ECC 的星历组仍用标量计算。标量计算保留作为参考，
+// setSimdLevel(SIMD_SCALAR) 可以强制使用。-O2 编译时每颗卫星 SSE2 约 95 ns，AVX2 约 55 ns。
+//
+// 用法：
+//      BroadcastOrbitBatch batch;
+//      for (...) batch.add(eph);
+//      OrbitBatchResult result;
+//      batch.compute(epochs, result);   // epochs[k] 为第 k 组星历的计算时刻
+//
+// epochs 的时间系统与星历相同，GPS 为 GPST，北斗为 BDT；compute 不修改对象，可以在多个线程中同时调用。
+class BroadcastOrbitBatch {
+public:
+    enum OrbitType {
+        KEPLER = 0,     // GPS、北斗 MEO/IGSO
+        BDS_GEO = 1,    // 北斗 GEO
+        NO_ORBIT = 2    // 只计算钟差
+    };
+
+    enum SimdLevel {
+        SIMD_SCALAR = 0,
+        SIMD_SSE2 = 1,
+        SIMD_AVX2 = 2
+    };
+
+    BroadcastOrbitBatch();
+
+    // 编译时打开、当前 CPU 也支持的最高指令集
+    static SimdLevel supportedSimdLevel();
+
+    // 计算使用的指令集，超过 supportedSimdLevel() 时取 supportedSimdLevel()；默认为 supportedSimdLevel()
+    void setSimdLevel(SimdLevel level);
+
+    SimdLevel getSimdLevel() const { return simdLevel; };
+
+    void reserve(size_t n);
+
+    // 加入一组星历，返回它的序号
+    size_t add(const NavEphGPS &eph);
+
+    size_t add(const NavEphBDS &eph);
+
+    size_t size() const { return ctToe.size(); };
+
+    OrbitType getOrbitType(size_t k) const { return OrbitType(orbitType[k]); };
+
+    void clear();
+
+    // 第 k 组星历在 epochs[k] 时刻的卫星状态，epochs 的个数与星历组数不同时抛出 InvalidRequest
+    void compute(const std::vector<CommonTime> &epochs, OrbitBatchResult &result) const;
+
+    // 所有星历在同一时刻的卫星状态
+    void compute(const CommonTime &epoch, OrbitBatchResult &result) const;
+
+private:
+    // result.tk、result.tc 已经算好后计算其余各项
+    void computeStates(OrbitBatchResult &result) const;
+
+    // 标量计算第 begin 组以后星历的位置、速度和相对论改正
+    void computeStatesScalar(OrbitBatchResult &result, size_t begin) const;
+
+    // 开普勒轨道共有的参数，返回序号
+    template<class Eph>
+    size_t addKepler(const Eph &eph, int type, double gm, double omegaE);
+
+    std::vector<CommonTime> ctToe;
+    std::vector<CommonTime> ctToc;
+    std::vector<int> orbitType;
+
+    // 只与星历有关的量
+    std::vector<double> A;                // 长半轴
+    std::vector<double> n;                // 改正后的平均角速度
+    std::vector<double> M0;
+    std::vector<double> ecc;
+    std::vector<double> q;                // sqrt(1-e^2)
+    std::vector<double> sinOmega;         // 近地点角距的正弦、余弦
+    std::vector<double> cosOmega;
+    std::vector<double> Cuc, Cus, Crc, Crs, Cic, Cis;
+    std::vector<double> i0;
+    std::vector<double> IDOT;
+    std::vector<double> OMEGA0;           // OMEGA_0 - omegaE * Toe
+    std::vector<double> OMEGAdot;         // OMEGA_DOT - omegaE
+    std::vector<double> omegaE;           // 地球自转角速度
+    std::vector<double> dlkScale;         // sqrt_A * q * sqrt(GM)
+    std::vector<double> relScale;         // REL_CONST * ecc * sqrt(A)
+    std::vector<double> af0, af1, af2;
+
+    double maxEcc;                        // 所有星历中最大的偏心率
+    SimdLevel simdLevel;
+};
+
+#endif //GNSSLAB_BROADCASTORBITBATCH_H
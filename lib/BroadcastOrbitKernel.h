@@ -0,0 +1,246 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_BROADCASTORBITKERNEL_H
+#define GNSSLAB_BROADCASTORBITKERNEL_H
+
+#include <cstddef>
+
+// BroadcastOrbitBatch::computeStates 的向量内核，只在 BroadcastOrbitBatch.cpp 和各指令集的内核文件中使用
+//
+// 内核按 V::WIDTH 颗卫星一组计算，与标量计算（BroadcastOrbitBatch::computeStatesScalar）的差别：
+//  - 开普勒方程固定做 KEPLER_NEWTON_STEPS 步牛顿迭代，不按步长判断收敛，各通道的分支一致；
+//    偏心率不超过 KERNEL_MAX_ECC 时初值误差小于 5e-4 弧度，三步后已小于舍入误差；
+//  - 轨道类型用通道掩码区分：每组都按开普勒轨道计算，组内有北斗 GEO 时再按 GEO 模型计算并按掩码选取，
+//    只计算钟差的通道置零；
+//  - 三角函数用多项式计算（Cephes 的系数，按 pi/2 分段），与 std::sin/std::cos 相差一两个 ulp。
+// 与标量计算的位置差异小于 1e-7 米（exam-9.19 中约 3e-8 米）。
+//
+// 内核文件不包含标准库的头文件，只用指针和 intrinsics：BroadcastOrbitAVX2.cpp 用 -mavx2 编译，
+// 这样不会生成 AVX2 版本的标准库内联函数而被链接到其他地方使用。
+
+// 内核可以处理的最大偏心率，牛顿迭代中 sinE、cosE 按步长旋转，要求第一步的步长 e*sinM 不超过 0.05
+static const double KERNEL_MAX_ECC = 0.05;
+
+// 初值 E = M + e*sinM 之后的牛顿迭代步数
+static const int KEPLER_NEWTON_STEPS = 3;
+
+// 内核的输入和输出，都是 BroadcastOrbitBatch 和 OrbitBatchResult 中数组的首地址
+struct OrbitKernelArgs {
+    size_t num;
+
+    const int *orbitType;
+    const double *tk;
+    const double *A, *n, *M0, *ecc, *q, *sinOmega, *cosOmega;
+    const double *Cuc, *Cus, *Crc, *Crs, *Cic, *Cis;
+    const double *i0, *IDOT, *OMEGA0, *OMEGAdot, *omegaE, *dlkScale, *relScale;
+
+    double *x, *y, *z, *vx, *vy, *vz, *relcorr;
+};
+
+// 各指令集的内核，计算前 num - num % 宽度 颗卫星的位置、速度和相对论改正，返回计算的个数
+size_t computeOrbitSSE2(const OrbitKernelArgs &args);
+
+size_t computeOrbitAVX2(const OrbitKernelArgs &args);
+
+// 下面的模板只在内核文件中实例化，V 提供向量类型 V::T 和对应指令集的运算
+#ifdef GNSSLAB_ORBIT_KERNEL_IMPL
+
+namespace orbitkernel {
+
+    // 轨道类型，与 BroadcastOrbitBatch::OrbitType 相同
+    static const int KEPLER = 0;
+    static const int BDS_GEO = 1;
+    static const int NO_ORBIT = 2;
+
+    // NavEphBDS::svXvt 中 GEO 模型的轨道半径和倾角的余弦 cos(-5 度)
+    static const double GEO_RADIUS = 35786000;
+    static const double GEO_COS_INCL = 0.99619469809174553;
+
+    // pi/2 分成三部分，前两部分的尾数较短，乘以象限号时没有舍入误差
+    static const double PIO2_1 = 1.57079625129699707031;
+    static const double PIO2_2 = 7.54978941586159635336E-8;
+    static const double PIO2_3 = 5.39030285815811905290E-15;
+    static const double TWO_OVER_PI = 0.63661977236758134308;
+
+    // (s, c) = (sin x, cos x)，|x| 不超过约 1e6 弧度
+    template<class V>
+    inline void sincos(typename V::T x, typename V::T &s, typename V::T &c) {
+        typedef typename V::T T;
+        T j, odd, upper;
+        V::quadrant(V::mul(x, V::set1(TWO_OVER_PI)), j, odd, upper);
+
+        T r = V::sub(V::sub(V::sub(x, V::mul(j, V::set1(PIO2_1))), V::mul(j, V::set1(PIO2_2))),
+                     V::mul(j, V::set1(PIO2_3)));
+        T z = V::mul(r, r);
+
+        // |r| <= pi/4 的多项式
+        T ps = V::set1(1.58962301576546568060E-10);
+        ps = V::add(V::mul(ps, z), V::set1(-2.50507477628578072866E-8));
+        ps = V::add(V::mul(ps, z), V::set1(2.75573136213857245213E-6));
+        ps = V::add(V::mul(ps, z), V::set1(-1.98412698295895385996E-4));
+        ps = V::add(V::mul(ps, z), V::set1(8.33333333332211858878E-3));
+        ps = V::add(V::mul(ps, z), V::set1(-1.66666666666666307295E-1));
+        T sr = V::add(r, V::mul(V::mul(r, z), ps));
+
+        T pc = V::set1(-1.13585365213876817300E-11);
+        pc = V::add(V::mul(pc, z), V::set1(2.08757008419747316778E-9));
+        pc = V::add(V::mul(pc, z), V::set1(-2.75573141792967388112E-7));
+        pc = V::add(V::mul(pc, z), V::set1(2.48015872888517045348E-5));
+        pc = V::add(V::mul(pc, z), V::set1(-1.38888888888730564116E-3));
+        pc = V::add(V::mul(pc, z), V::set1(4.16666666666665929218E-2));
+        T cr = V::add(V::sub(V::set1(1.0), V::mul(V::set1(0.5), z)), V::mul(V::mul(z, z), pc));
+
+        // 象限 0~3：(sr, cr)、(cr, -sr)、(-sr, -cr)、(-cr, sr)
+        T sinAbs = V::blend(odd, cr, sr);
+        T cosAbs = V::blend(odd, sr, cr);
+        s = V::negate(upper, sinAbs);
+        c = V::negate(V::maskXor(odd, upper), cosAbs);
+    }
+
+    // (s, c) 转过 d，|d| <= KERNEL_MAX_ECC 时级数截断误差小于 1e-17
+    template<class V>
+    inline void rotate(typename V::T &s, typename V::T &c, typename V::T d) {
+        typedef typename V::T T;
+        T one = V::set1(1.0);
+        T d2 = V::mul(d, d);
+        T sind = V::mul(d, V::sub(one, V::mul(V::mul(d2, V::set1(1.0 / 6.0)),
+                                            V::sub(one, V::mul(V::mul(d2, V::set1(1.0 / 20.0)),
+                                                               V::sub(one, V::mul(d2, V::set1(1.0 / 42.0))))))));
+        T cosd = V::sub(one, V::mul(V::mul(d2, V::set1(0.5)),
+                                    V::sub(one, V::mul(V::mul(d2, V::set1(1.0 / 12.0)),
+                                                       V::sub(one, V::mul(V::mul(d2, V::set1(1.0 / 30.0)),
+                                                                          V::sub(one, V::mul(d2, V::set1(1.0 / 56.0)))))))));
+        T sNew = V::add(V::mul(s, cosd), V::mul(c, sind));
+        c = V::sub(V::mul(c, cosd), V::mul(s, sind));
+        s = sNew;
+    }
+
+    template<class V>
+    size_t computeOrbit(const OrbitKernelArgs &a) {
+        typedef typename V::T T;
+        size_t numFull = a.num - a.num % V::WIDTH;
+        const T one = V::set1(1.0);
+        const T two = V::set1(2.0);
+
+        for (size_t k = 0; k < numFull; k += V::WIDTH) {
+            T tk = V::load(a.tk + k);
+            tk = V::sub(tk, V::maskAnd(V::greater(tk, V::set1(302400)), V::set1(604800)));
+            tk = V::add(tk, V::maskAnd(V::greater(V::set1(-302400), tk), V::set1(604800)));
+
+            // 开普勒方程，初值 E = M + e*sinM，之后固定步数的牛顿迭代
+            T e = V::load(a.ecc + k);
+            T Mk = V::add(V::load(a.M0 + k), V::mul(V::load(a.n + k), tk));
+            T sinEk, cosEk;
+            sincos<V>(Mk, sinEk, cosEk);
+            T dE = V::mul(e, sinEk);
+            T Ek = V::add(Mk, dE);
+            rotate<V>(sinEk, cosEk, dE);
+            for (int it = 0; it < KEPLER_NEWTON_STEPS; it++) {
+                dE = V::div(V::sub(Mk, V::sub(Ek, V::mul(e, sinEk))), V::sub(one, V::mul(e, cosEk)));
+                Ek = V::add(Ek, dE);
+                rotate<V>(sinEk, cosEk, dE);
+            }
+            V::store(a.relcorr + k, V::mul(V::load(a.relScale + k), sinEk));
+
+            T OMEGA_k = V::add(V::load(a.OMEGA0 + k), V::mul(V::load(a.OMEGAdot + k), tk));
+            T sinOMG_k, cosOMG_k;
+            sincos<V>(OMEGA_k, sinOMG_k, cosOMG_k);
+
+            // 真近点角的正弦、余弦，纬度幅角 phi = vk + omega
+            T denom = V::sub(one, V::mul(e, cosEk));
+            T sinvk = V::div(V::mul(V::load(a.q + k), sinEk), denom);
+            T cosvk = V::div(V::sub(cosEk, e), denom);
+            T sinOmega = V::load(a.sinOmega + k);
+            T cosOmega = V::load(a.cosOmega + k);
+            T sinphi = V::add(V::mul(sinvk, cosOmega), V::mul(cosvk, sinOmega));
+            T cosphi = V::sub(V::mul(cosvk, cosOmega), V::mul(sinvk, sinOmega));
+            T sin2phi = V::mul(two, V::mul(sinphi, cosphi));
+            T cos2phi = V::mul(V::sub(cosphi, sinphi), V::add(cosphi, sinphi));
+
+            T Cuc = V::load(a.Cuc + k), Cus = V::load(a.Cus + k);
+            T Crc = V::load(a.Crc + k), Crs = V::load(a.Crs + k);
+            T Cic = V::load(a.Cic + k), Cis = V::load(a.Cis + k);
+            T duk = V::add(V::mul(cos2phi, Cuc), V::mul(sin2phi, Cus));
+            T drk = V::add(V::mul(cos2phi, Crc), V::mul(sin2phi, Crs));
+            T dik = V::add(V::mul(cos2phi, Cic), V::mul(sin2phi, Cis));
+
+            T duk2 = V::mul(duk, duk);
+            T sinduk = V::mul(duk, V::sub(one, V::mul(duk2, V::set1(1.0 / 6.0))));
+            T cosduk = V::sub(one, V::mul(duk2, V::sub(V::set1(0.5), V::mul(duk2, V::set1(1.0 / 24.0)))));
+            T sinuk = V::add(V::mul(sinphi, cosduk), V::mul(cosphi, sinduk));
+            T cosuk = V::sub(V::mul(cosphi, cosduk), V::mul(sinphi, sinduk));
+
+            T A = V::load(a.A + k);
+            T IDOT = V::load(a.IDOT + k);
+            T rk = V::add(V::mul(A, denom), drk);
+            T ik = V::add(V::add(V::load(a.i0 + k), dik), V::mul(IDOT, tk));
+            T sinik, cosik;
+            sincos<V>(ik, sinik, cosik);
+
+            T xip = V::mul(rk, cosuk);
+            T yip = V::mul(rk, sinuk);
+
+            T x = V::sub(V::mul(xip, cosOMG_k), V::mul(V::mul(yip, cosik), sinOMG_k));
+            T y = V::add(V::mul(xip, sinOMG_k), V::mul(V::mul(yip, cosik), cosOMG_k));
+            T z = V::mul(yip, sinik);
+
+            // 速度，公式与标量计算相同
+            T dek = V::div(V::mul(V::load(a.n + k), A), rk);
+            T dlk = V::div(V::load(a.dlkScale + k), V::mul(rk, rk));
+            T twoDlk = V::mul(two, dlk);
+            T div = V::sub(IDOT, V::mul(twoDlk, V::sub(V::mul(Cic, sin2phi), V::mul(Cis, cos2phi))));
+            T domk = V::load(a.OMEGAdot + k);
+            T duv = V::mul(dlk, V::add(one, V::mul(two, V::sub(V::mul(Cus, cos2phi), V::mul(Cuc, sin2phi)))));
+            T drv = V::sub(V::mul(V::mul(V::mul(A, e), dek), sinEk),
+                           V::mul(twoDlk, V::sub(V::mul(Crc, sin2phi), V::mul(Crs, cos2phi))));
+            T dxp = V::sub(V::mul(drv, cosuk), V::mul(V::mul(rk, sinuk), duv));
+            T dyp = V::add(V::mul(drv, sinuk), V::mul(V::mul(rk, cosuk), duv));
+
+            T vx = V::add(V::sub(V::sub(V::mul(dxp, cosOMG_k), V::mul(V::mul(xip, sinOMG_k), domk)),
+                                 V::mul(V::mul(dyp, cosik), sinOMG_k)),
+                          V::mul(yip, V::sub(V::mul(V::mul(sinik, sinOMG_k), div),
+                                             V::mul(V::mul(cosik, cosOMG_k), domk))));
+            T vy = V::sub(V::add(V::add(V::mul(dxp, sinOMG_k), V::mul(V::mul(xip, cosOMG_k), domk)),
+                                 V::mul(V::mul(dyp, cosik), cosOMG_k)),
+                          V::mul(yip, V::add(V::mul(V::mul(sinik, cosOMG_k), div),
+                                             V::mul(V::mul(cosik, sinOMG_k), domk))));
+            T vz = V::add(V::mul(dyp, sinik), V::mul(V::mul(yip, cosik), div));
+
+            // 北斗 GEO 的通道
+            T geo = V::typeMask(a.orbitType + k, BDS_GEO);
+            if (V::any(geo)) {
+                T radius = V::set1(GEO_RADIUS);
+                T cosIncl = V::set1(GEO_COS_INCL);
+                T omegaE = V::load(a.omegaE + k);
+                T Xk = V::mul(radius, cosOMG_k);
+                T Yk = V::mul(radius, sinOMG_k);
+                T sinwt, coswt;
+                sincos<V>(V::mul(omegaE, tk), sinwt, coswt);
+                T xef = V::add(V::mul(Xk, coswt), V::mul(V::mul(Yk, cosIncl), sinwt));
+                T yef = V::sub(V::mul(V::mul(Yk, cosIncl), coswt), V::mul(Xk, sinwt));
+                x = V::blend(geo, xef, x);
+                y = V::blend(geo, yef, y);
+                z = V::blend(geo, V::mul(Yk, cosIncl), z);
+                vx = V::blend(geo, V::sub(V::set1(0.0), V::mul(omegaE, yef)), vx);
+                vy = V::blend(geo, V::mul(omegaE, xef), vy);
+                vz = V::blend(geo, V::set1(0.0), vz);
+            }
+
+            // 只计算钟差的通道置零
+            T none = V::typeMask(a.orbitType + k, NO_ORBIT);
+            V::store(a.x + k, V::maskAndNot(none, x));
+            V::store(a.y + k, V::maskAndNot(none, y));
+            V::store(a.z + k, V::maskAndNot(none, z));
+            V::store(a.vx + k, V::maskAndNot(none, vx));
+            V::store(a.vy + k, V::maskAndNot(none, vy));
+            V::store(a.vz + k, V::maskAndNot(none, vz));
+        }
+        return numFull;
+    }
+}
+
+#endif // GNSSLAB_ORBIT_KERNEL_IMPL
+
+#endif //GNSSLAB_BROADCASTORBITKERNEL_H
@@ -0,0 +1,77 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+// BroadcastOrbitBatch 的 SSE2 内核，每次两颗卫星；x86-64 上 SSE2 总是可用，不需要单独的编译选项
+//
+#define GNSSLAB_ORBIT_KERNEL_IMPL
+#include "BroadcastOrbitKernel.h"
+
+#ifdef GNSSLAB_ORBIT_SIMD
+
+#include <emmintrin.h>
+
+namespace {
+
+    struct SSE2Ops {
+        typedef __m128d T;
+        static const size_t WIDTH = 2;
+
+        static inline T set1(double v) { return _mm_set1_pd(v); }
+
+        static inline T load(const double *p) { return _mm_loadu_pd(p); }
+
+        static inline void store(double *p, T v) { _mm_storeu_pd(p, v); }
+
+        static inline T add(T a, T b) { return _mm_add_pd(a, b); }
+
+        static inline T sub(T a, T b) { return _mm_sub_pd(a, b); }
+
+        static inline T mul(T a, T b) { return _mm_mul_pd(a, b); }
+
+        static inline T div(T a, T b) { return _mm_div_pd(a, b); }
+
+        static inline T greater(T a, T b) { return _mm_cmpgt_pd(a, b); }
+
+        static inline T maskAnd(T mask, T v) { return _mm_and_pd(mask, v); }
+
+        static inline T maskAndNot(T mask, T v) { return _mm_andnot_pd(mask, v); }
+
+        static inline T maskXor(T a, T b) { return _mm_xor_pd(a, b); }
+
+        // mask 为真的通道取 a，否则取 b
+        static inline T blend(T mask, T a, T b) { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+
+        // mask 为真的通道取反
+        static inline T negate(T mask, T v) { return _mm_xor_pd(v, _mm_and_pd(mask, _mm_set1_pd(-0.0))); }
+
+        static inline bool any(T mask) { return _mm_movemask_pd(mask) != 0; }
+
+        // 轨道类型等于 type 的通道
+        static inline T typeMask(const int *p, int type) {
+            __m128i t = _mm_set_epi32(p[1], p[1], p[0], p[0]);
+            return _mm_castsi128_pd(_mm_cmpeq_epi32(t, _mm_set1_epi32(type)));
+        }
+
+        // y 舍入到最近的整数 j，odd、upper 为 j 的第 0、1 位
+        static inline void quadrant(T y, T &j, T &odd, T &upper) {
+            __m128i ji = _mm_cvtpd_epi32(y);
+            j = _mm_cvtepi32_pd(ji);
+            __m128i jj = _mm_unpacklo_epi32(ji, ji);
+            __m128i bit0 = _mm_set1_epi32(1), bit1 = _mm_set1_epi32(2);
+            odd = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(jj, bit0), bit0));
+            upper = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(jj, bit1), bit1));
+        }
+    };
+}
+
+size_t computeOrbitSSE2(const OrbitKernelArgs &args) {
+    return orbitkernel::computeOrbit<SSE2Ops>(args);
+}
+
+#else
+
+size_t computeOrbitSSE2(const OrbitKernelArgs &) {
+    return 0;
+}
+
+#endif
@@ -5,6 +5,37 @@
 #include "CSDetector.h"
 #define debug 1
 
+CSDetector::CSDetector()
+        : deltaTMax(120.0), minCycles(2.0) {
+    if (SYS == "G") gpsSignals.set('G', "L1", "L2", "C1", "C2");
+    if (SYS == "C") bdsSignals.set('C', "L2", "L7", "C2", "C7");
+}
+
+// MW 组合系数按频点编号查表，编译期算好；观测值编号在这里一次确定
+void CSDetector::MWSignals::set(char sys, const string &L1, const string &L2,
+                                const string &C1, const string &C2) {
+    L1Type = L1;
+    L2Type = L2;
+    C1Type = C1;
+    C2Type = C2;
+    L1Code = ObsCodeTable::intern(L1);
+    L2Code = ObsCodeTable::intern(L2);
+    C1Code = ObsCodeTable::intern(C1);
+    C2Code = ObsCodeTable::intern(C2);
+
+    int band1 = SignalCatalog::bandId(sys, L1[1]);
+    int band2 = SignalCatalog::bandId(sys, L2[1]);
+    pPair = &SignalCatalog::pair(band1, band2);
+    varianceMW = varOfMW(band1, band2);
+    isUsed = true;
+}
+
+const CSDetector::MWSignals *CSDetector::mwSignals(const string &sys) const {
+    if (sys == "G" && gpsSignals.isUsed) return &gpsSignals;
+    if (sys == "C" && bdsSignals.isUsed) return &bdsSignals;
+    return NULL;
+}
+
 VariableDataMap CSDetector::detect(ObsData &obsData) {
 
     VariableDataMap csFlagData;
@@ -12,145 +43,47 @@ VariableDataMap CSDetector::detect(ObsData &obsData) {
     // Loop through all the satellites
     CommonTime currentEpoch = obsData.epoch;
     SatIDSet badSatSet;//todo:注意这里可能又要删除坏卫星
-    for (auto stv: obsData.satTypeValueData) {
-        SatID sat = (stv).first;
-        string L1Type, L2Type, C1Type, C2Type;
-        if (sat.system == "G" && SYS == "G") {
-            L1Type = "L1";
-            L2Type = "L2";
-            C1Type = "C1";
-            C2Type = "C2";
-        }
-        else if(sat.system == "C" && SYS == "C") {
-            L1Type = "L2";
-            L2Type = "L7";
-            C1Type = "C2";
-            C2Type = "C7";
-        }
-        else // 请增加bds的处理
+    for (const auto &stv: obsData.satTypeValueData) {
+        const SatID &sat = stv.first;
+        const MWSignals *pSignals = mwSignals(sat.system);
+        if (pSignals == NULL) // 请增加bds的处理
         {
             badSatSet.insert(sat);
+            continue;
         }
-
-        // wavelengthMW of MW-combination, see LinearCombination
-        double wavelengthMW = wavelengthOfMW(sat.system, L1Type, L2Type);
-        double varianceMW = varOfMW(sat.system, L1Type, L2Type);
-
-        double f1 = getFreq(sat.system, L1Type);
-        double f2 = getFreq(sat.system, L2Type);
-
-       /* if (debug) {
-            cout << "f1:" << f1 << "f2:" << f2 << endl;
-        }*/
+        const SignalPair *pMWPair = pSignals->pPair;
 
         double L1Value, L2Value, C1Value, C2Value, mwValue;
 
         try {
-            L1Value = stv.second.at(L1Type);
-            L2Value = stv.second.at(L2Type);
-            C1Value = stv.second.at(C1Type);
-            C2Value = stv.second.at(C2Type);
-
-            mwValue
-                    = (f1 * L1Value - f2 * L2Value) / (f1 - f2)
-                      - (f1 * C1Value + f2 * C2Value) / (f1 + f2);
+            L1Value = stv.second.at(pSignals->L1Type);
+            L2Value = stv.second.at(pSignals->L2Type);
+            C1Value = stv.second.at(pSignals->C1Type);
+            C2Value = stv.second.at(pSignals->C2Type);
+
+            mwValue = pMWPair->mwPhase1 * L1Value + pMWPair->mwPhase2 * L2Value
+                      + pMWPair->mwCode1 * C1Value + pMWPair->mwCode2 * C2Value;
         } catch (std::out_of_range) {
             // 无法构成mw，这个卫星观测值周跳无法探测，删除这个卫星
             badSatSet.insert(sat);
             continue; // 继续处理下一个卫星
         }
 
-        satEpochMWData[sat][currentEpoch] = mwValue;
-
-      /*  if (debug) {
-            cout << "L1Value:" << L1Value << endl;
-            cout << "L2Value:" << L2Value << endl;
-            cout << "C1Value:" << C1Value << endl;
-            cout << "C2Value:" << C2Value << endl;
-            cout << "mwValue:" << mwValue << endl;
-            cout << "wavelength:" << C_MPS / (f1 - f2) << endl;
-        }*/
-
-        //>>>>>>>>>>>>>>>>>>>>>>
-
-        double currentDeltaT(0.0);
-        double currentBias(0.0);
-        double csFlag(0.0);
-
-        currentDeltaT = (currentEpoch - satMWData[sat].formerEpoch);
-        satMWData[sat].formerEpoch = currentEpoch;//这里就把当前历元赋值给先前历元，北斗时间就是北斗时间，GPST就是GPST
-      /*  if (debug) {
-            cout << "currentDeltaT:" << currentDeltaT << endl;
-        }*/
-        // Difference between current value of MW and average value
-        currentBias = std::abs(mwValue - satMWData[sat].meanMW);
-      /*  if (debug) {
-            cout << "currentBias:" << currentBias << endl;
-        }*/
-
-        // Increment window size
-        satMWData[sat].windowSize++;
-
-        /**
-         * cycle-slip condition
-         * 1. if data interrupt for a given time gap, then cyce slip should be set
-         * 2. if current bias is greater than 1 cycle and greater than 4 sigma of mean mw.
-         */
-        double sigLimit = 4 * std::sqrt(satMWData[sat].varMW);
-
-       /* if (debug) {
-            cout << "deltaTMax:" << deltaTMax << endl;
-            cout << "wavelengthMW:" << wavelengthMW << endl;
-            cout << "sigLimit:" << sigLimit << endl;
-            cout << "minCycles:" << minCycles * wavelengthMW << endl;
-        }*/
-
-        // 波长有可能为负值
-        if (currentDeltaT > deltaTMax ||
-            currentBias > std::abs(minCycles * wavelengthMW) ||
-            currentBias > sigLimit) {
-
-            // reset the filter window size/meanMW/InitialVarofMW
-            satMWData[sat].meanMW = mwValue;
-            satMWData[sat].varMW = varianceMW;
-            satMWData[sat].windowSize = 1;
-
-          /*  if (debug) {
-                cout << "* CS happened!" << endl;
-            }*/
-            csFlag = 1.0;
-        } else {
-            // MW bias from the mean value
-            double mwBias(mwValue - satMWData[sat].meanMW);
-            double size(static_cast<double>(satMWData[sat].windowSize));
-
-            // Compute average
-            satMWData[sat].meanMW += mwBias / size;
-
-            // Compute variance
-            // Var(i) = Var(i-1) + [ ( mw(i) - meanMW)^2/(i)- 1*Var(i-1) ]/(i);
-            satMWData[sat].varMW += (mwBias * mwBias - satMWData[sat].varMW) / size;
-        }
-
-        // for print
-        satEpochMeanMWData[sat][currentEpoch] = satMWData[sat].meanMW;
-        satEpochCSFlagData[sat][currentEpoch] = csFlag * mwValue;  // 放大到mw数值，以方便绘图
+        double csFlag = update(sat, currentEpoch, *pSignals, mwValue);
 
         // 将周跳探测标志存到模糊度变量中
         Variable amb1(obsData.station,
                       sat,
                       static_cast<Parameter>(Parameter::ambiguity),
-                      ObsID(sat.system, L1Type));
+                      ObsID(sat.system, pSignals->L1Type));
 
         Variable amb2(obsData.station,
                       sat,
                       static_cast<Parameter>(Parameter::ambiguity),
-                      ObsID(sat.system, L2Type));
+                      ObsID(sat.system, pSignals->L2Type));
 
         csFlagData[amb1] = csFlag;
         csFlagData[amb2] = csFlag;
-
-        //>>>>>>>>>>>>>>>>>>>>>>
     }
 
     // 删除坏卫星
@@ -160,3 +93,115 @@ VariableDataMap CSDetector::detect(ObsData &obsData) {
     return csFlagData;
 
 };
+
+VariableDataMap CSDetector::detect(ObsEpoch &obsEpoch) {
+
+    VariableDataMap csFlagData;
+
+    CommonTime currentEpoch = obsEpoch.epoch;
+    std::vector<int> badRows;
+    for (int row = 0; row < int(obsEpoch.numSats()); row++) {
+        SatID sat = obsEpoch.sat(row).toSatID();
+        const MWSignals *pSignals = mwSignals(sat.system);
+        if (pSignals == NULL || pSignals->L1Code < 0 || pSignals->L2Code < 0 ||
+            pSignals->C1Code < 0 || pSignals->C2Code < 0 ||
+            !obsEpoch.has(row, pSignals->L1Code) || !obsEpoch.has(row, pSignals->L2Code) ||
+            !obsEpoch.has(row, pSignals->C1Code) || !obsEpoch.has(row, pSignals->C2Code)) {
+            // 无法构成mw，这个卫星观测值周跳无法探测，删除这个卫星
+            badRows.push_back(row);
+            continue;
+        }
+        const SignalPair *pMWPair = pSignals->pPair;
+
+        double mwValue = pMWPair->mwPhase1 * obsEpoch.value(row, pSignals->L1Code)
+                         + pMWPair->mwPhase2 * obsEpoch.value(row, pSignals->L2Code)
+                         + pMWPair->mwCode1 * obsEpoch.value(row, pSignals->C1Code)
+                         + pMWPair->mwCode2 * obsEpoch.value(row, pSignals->C2Code);
+
+        double csFlag = update(sat, currentEpoch, *pSignals, mwValue);
+
+        // 将周跳探测标志存到模糊度变量中
+        Variable amb1(obsEpoch.station,
+                      sat,
+                      static_cast<Parameter>(Parameter::ambiguity),
+                      ObsID(sat.system, pSignals->L1Type));
+
+        Variable amb2(obsEpoch.station,
+                      sat,
+                      static_cast<Parameter>(Parameter::ambiguity),
+                      ObsID(sat.system, pSignals->L2Type));
+
+        csFlagData[amb1] = csFlag;
+        csFlagData[amb2] = csFlag;
+    }
+
+    // 删除坏卫星，从后往前删，最后一行移到被删除的位置时不影响前面的行号
+    for (int i = int(badRows.size()) - 1; i >= 0; i--)
+        obsEpoch.eraseSat(badRows[i]);
+
+    return csFlagData;
+}
+
+double CSDetector::update(const SatID &sat, const CommonTime &currentEpoch,
+                          const MWSignals &signals, double mwValue) {
+
+    // wavelengthMW of MW-combination, see LinearCombination
+    double wavelengthMW = signals.pPair->mwWavelength;
+    double varianceMW = signals.varianceMW;
+
+    satEpochMWData[sat][currentEpoch] = mwValue;
+
+    //>>>>>>>>>>>>>>>>>>>>>>
+
+    double currentDeltaT(0.0);
+    double currentBias(0.0);
+    double csFlag(0.0);
+
+    // 直接索引的滤波数据，每颗卫星只查找一次
+    MWData &mwData = satMWData[sat];
+    currentDeltaT = (currentEpoch - mwData.formerEpoch);
+    mwData.formerEpoch = currentEpoch;//这里就把当前历元赋值给先前历元，北斗时间就是北斗时间，GPST就是GPST
+
+    // Difference between current value of MW and average value
+    currentBias = std::abs(mwValue - mwData.meanMW);
+
+    // Increment window size
+    mwData.windowSize++;
+
+    /**
+     * cycle-slip condition
+     * 1. if data interrupt for a given time gap, then cyce slip should be set
+     * 2. if current bias is greater than 1 cycle and greater than 4 sigma of mean mw.
+     */
+    double sigLimit = 4 * std::sqrt(mwData.varMW);
+
+    // 波长有可能为负值
+    if (currentDeltaT > deltaTMax ||
+        currentBias > std::abs(minCycles * wavelengthMW) ||
+        currentBias > sigLimit) {
+
+        // reset the filter window size/meanMW/InitialVarofMW
+        mwData.meanMW = mwValue;
+        mwData.varMW = varianceMW;
+        mwData.windowSize = 1;
+
+        csFlag = 1.0;
+    } else {
+        // MW bias from the mean value
+        double mwBias(mwValue - mwData.meanMW);
+        double size(static_cast<double>(mwData.windowSize));
+
+        // Compute average
+        mwData.meanMW += mwBias / size;
+
+        // Compute variance
+        // Var(i) = Var(i-1) + [ ( mw(i) - meanMW)^2/(i)- 1*Var(i-1) ]/(i);
+        mwData.varMW += (mwBias * mwBias - mwData.varMW) / size;
+    }
+
+    // for print
+    satEpochMeanMWData[sat][currentEpoch] = mwData.meanMW;
+    satEpochCSFlagData[sat][currentEpoch] = csFlag * mwValue;  // 放大到mw数值，以方便绘图
+
+    return csFlag;
+}
@@ -8,16 +8,21 @@
 
 #include "GnssStruct.h"
 #include "GnssFunc.h"
+#include "SatIndex.h"
+#include "SignalCatalog.h"
+#include "ObsEpoch.h"
 
 class CSDetector {
 public:
 
-    CSDetector()
-            : deltaTMax(120.0), minCycles(2.0)
-    {};
+    CSDetector();
 
     VariableDataMap detect(ObsData &obsData);
 
+    // 与 detect(ObsData&) 相同，观测值按 ObsCodeTable 的编号取出，不再按类型名查找；
+    // 类型名与 convertObsType 之后相同（"L1"、"C1" 等）
+    VariableDataMap detect(ObsEpoch &obsEpoch);
+
     ~CSDetector(){};
 
     SatEpochValueMap satEpochMWData;
@@ -36,12 +41,35 @@ public:
         double varMW;           ///< Accumulated std value of combination.
     };
 
-    std::map<SatID, MWData> satMWData;
+    SatTable<MWData> satMWData;
 
 
     double deltaTMax;
     double minCycles;
 
+private:
+    // 一个系统构成 MW 组合的观测值：类型名、ObsCodeTable 编号和频点组合，构造时确定
+    struct MWSignals {
+        MWSignals() : isUsed(false), pPair(NULL), varianceMW(0.0) {};
+
+        void set(char sys, const string &L1, const string &L2, const string &C1, const string &C2);
+
+        bool isUsed;
+        string L1Type, L2Type, C1Type, C2Type;
+        int L1Code, L2Code, C1Code, C2Code;
+        const SignalPair *pPair;
+        double varianceMW;
+    };
+
+    // 系统的 MW 组合，不处理的系统返回 NULL
+    const MWSignals *mwSignals(const string &sys) const;
+
+    // 用本历元的 MW 值更新滤波，返回周跳标志
+    double update(const SatID &sat, const CommonTime &currentEpoch,
+                  const MWSignals &signals, double mwValue);
+
+    MWSignals gpsSignals;
+    MWSignals bdsSignals;
 };
 
 #endif //GNSSLAB_CSDETECTOR_H
@@ -0,0 +1,458 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include "CrinexObsReader.h"
+#include "RinexObsMMapReader.h"
+#include "RinexField.h"
+
+#define debug 0
+
+namespace {
+
+    // 头记录标签位于 61~80 列，去掉两端空白后比较
+    inline bool labelIs(const char *lb, const char *le, const char *label) {
+        const char *fb, *fe;
+        fieldRange(lb, le, 60, 20, fb, fe);
+        while (fb < fe && isspace(static_cast<unsigned char>(*fb))) ++fb;
+        while (fe > fb && isspace(static_cast<unsigned char>(*(fe - 1)))) --fe;
+        size_t n = strlen(label);
+        return size_t(fe - fb) == n && memcmp(fb, label, n) == 0;
+    }
+
+    // 文本差分还原：' ' 保留旧字符，'&' 变为空格，其余为新字符；差分行之后的部分保持不变
+    inline void repairText(string &oldText, const char *b, const char *e) {
+        size_t n = e - b;
+        if (oldText.size() < n) oldText.resize(n, ' ');
+        for (size_t i = 0; i < n; i++) {
+            char c = b[i];
+            if (c == '&') {
+                oldText[i] = ' ';
+            } else if (c != ' ') {
+                oldText[i] = c;
+            }
+        }
+    }
+
+    // 解析带符号整数，p 停在第一个非数字字符上
+    inline bool parseInt64(const char *&p, const char *e, int64_t &value) {
+        bool negative = false;
+        if (p < e && (*p == '-' || *p == '+')) {
+            negative = (*p == '-');
+            ++p;
+        }
+        const char *digits = p;
+        int64_t v = 0;
+        while (p < e && static_cast<unsigned>(*p - '0') < 10u) {
+            v = v * 10 + (*p - '0');
+            ++p;
+        }
+        value = negative ? -v : v;
+        return p > digits;
+    }
+}
+
+CrinexObsReader::CrinexObsReader()
+        : pCur(NULL), isHeaderRead(false), epochCount(0), hasPending(false) {
+}
+
+CrinexObsReader::CrinexObsReader(const string &fileName)
+        : CrinexObsReader() {
+    open(fileName);
+}
+
+void CrinexObsReader::open(const string &fileName) {
+    mappedFile.open(fileName);
+    pCur = mappedFile.begin();
+    isHeaderRead = false;
+    rinexHeader = RinexHeader();
+    for (auto &columns: sysColumns) columns.clear();
+    satArcs.clear();
+    epochLine.clear();
+    epochCount = 0;
+    hasPending = false;
+}
+
+// 从游标取出一行，去掉行尾的 '\r'
+bool CrinexObsReader::nextLine(const char *&lineBegin, const char *&lineEnd) {
+    const char *end = mappedFile.end();
+    if (pCur == NULL || pCur >= end) return false;
+
+    lineBegin = pCur;
+    const char *nl = static_cast<const char *>(memchr(pCur, '\n', end - pCur));
+    if (nl == NULL) {
+        lineEnd = end;
+        pCur = end;
+    } else {
+        lineEnd = nl;
+        pCur = nl + 1;
+    }
+    if (lineEnd > lineBegin && *(lineEnd - 1) == '\r') --lineEnd;
+    return true;
+}
+
+void CrinexObsReader::parseRinexHeader() {
+    const char *lb, *le, *fb, *fe;
+
+    // CRINEX 头两行：版本和压缩程序
+    if (!nextLine(lb, le) || !labelIs(lb, le, "CRINEX VERS   / TYPE")) {
+        FFStreamError e("CrinexObsReader: not a Compact RINEX file: " + mappedFile.getFileName());
+        throw e;
+    }
+    fieldRange(lb, le, 0, 20, fb, fe);
+    double crxVersion = rinexStod(fb, fe);
+    if (crxVersion != 3.0) {
+        FFStreamError e("CrinexObsReader: only CRINEX 3.0 (RINEX 3) is supported, got version "
+                        + string(fb, fe));
+        throw e;
+    }
+    if (!nextLine(lb, le) || !labelIs(lb, le, "CRINEX PROG / DATE")) {
+        FFStreamError e("CrinexObsReader: CRINEX PROG / DATE not found in " + mappedFile.getFileName());
+        throw e;
+    }
+
+    // 其后是原样保留的 RINEX 文件头
+    string satSys;
+    int numObs = 0;
+    std::map<string, std::vector<string>> mapObsTypes;
+    while (true) {
+        if (!nextLine(lb, le)) {
+            FFStreamError e("CrinexObsReader: END OF HEADER not found in " + mappedFile.getFileName());
+            throw e;
+        }
+
+        if (debug)
+            cout << "parseRinexHeader:" << string(lb, le) << endl;
+
+        if (labelIs(lb, le, "END OF HEADER")) {
+            break;
+        } else if (labelIs(lb, le, "MARKER NAME")) {
+            fieldRange(lb, le, 0, 60, fb, fe);
+            string markerName(fb, fe);
+            std::replace(markerName.begin(), markerName.end(), ' ', '_');
+            rinexHeader.station = markerName;
+        } else if (labelIs(lb, le, "RINEX VERSION / TYPE")) {
+            fieldRange(lb, le, 0, 20, fb, fe);
+            double version = rinexStod(fb, fe);
+            if (version != 3.04) {
+                cerr << "only support rinex 3.04 version!" << endl;
+                exit(-1);
+            }
+            rinexHeader.version = version;
+        } else if (labelIs(lb, le, "APPROX POSITION XYZ")) {
+            for (int i = 0; i < 3; i++) {
+                fieldRange(lb, le, 14 * i, 14, fb, fe);
+                rinexHeader.antennaPosition[i] = rinexStod(fb, fe);
+            }
+        } else if (labelIs(lb, le, "SYS / # / OBS TYPES")) {
+            // 续行的系统标识为空，沿用上一行的系统和观测值个数
+            if (fieldChar(lb, le, 0) != ' ') {
+                satSys = string(1, lb[0]);
+                fieldRange(lb, le, 3, 3, fb, fe);
+                numObs = rinexStoi(fb, fe);
+            }
+
+            const int maxObsPerLine = 13;
+            std::vector<string> &types = mapObsTypes[satSys];
+            for (int i = 0; i < maxObsPerLine && types.size() < size_t(numObs); i++) {
+                fieldRange(lb, le, 4 * i + 7, 3, fb, fe);
+                string typeStr(fb, fe);
+                typeStr.resize(3, ' ');
+                types.push_back(typeStr);
+            }
+        }
+    }
+    rinexHeader.mapObsTypes = mapObsTypes;
+
+    compileObsColumns();
+    satArcs.assign(128 * 100, SatArcs());
+    epochLine.clear();
+    epochCount = 0;
+    isHeaderRead = true;
+}
+
+void CrinexObsReader::setSelectedTypes(std::map<string, std::set<string>> &systemTypes) {
+    sysTypes = systemTypes;
+    compileObsColumns();
+}
+
+// 差分弧段需要全部列，选择结果记在每一列上，未选择的列只更新差分状态，不换算也不插入
+void CrinexObsReader::compileObsColumns() {
+    for (auto &columns: sysColumns) columns.clear();
+
+    for (const auto &sysEntry: rinexHeader.mapObsTypes) {
+        const string &sys = sysEntry.first;
+        if (sys != "G" && sys != "C") continue;
+
+        auto itSys = sysTypes.find(sys);
+
+        std::vector<ObsColumn> &columns = sysColumns[static_cast<unsigned char>(sys[0]) & 0x7f];
+        for (const auto &typeStr: sysEntry.second) {
+            ObsColumn column;
+            column.type = typeStr;
+            column.scale = RinexObsMMapReader::obsScale(sys, typeStr);
+            column.isSelected = (column.scale != 0.0 && itSys != sysTypes.end() &&
+                                 itSys->second.find(typeStr) != itSys->second.end());
+            columns.push_back(column);
+        }
+    }
+}
+
+const RinexHeader &CrinexObsReader::getHeader() {
+    if (!isHeaderRead) {
+        parseRinexHeader();
+    }
+    return rinexHeader;
+}
+
+ObsData CrinexObsReader::parseRinexObs() {
+    if (!isHeaderRead) {
+        parseRinexHeader();
+    }
+
+    if (hasPending) {
+        hasPending = false;
+        return std::move(pendingObs);
+    }
+
+    return decodeEpoch();
+}
+
+ObsData CrinexObsReader::decodeEpoch() {
+    const char *lb, *le, *fb, *fe;
+    while (true) {
+        if (!nextLine(lb, le)) {
+            EndOfFile err("EOF encountered!");
+            throw err;
+        }
+
+        // 完整给出的行：事件历元或初始化的历元行
+        if (lb < le && lb[0] == '>') {
+            fieldRange(lb, le, 31, 1, fb, fe);
+            int epochFlag = rinexStoi(fb, fe);
+
+            // 事件历元：后面跟着 numSats 行原样的头记录，整体跳过，
+            // 不作为后续历元行的差分基准
+            if (epochFlag >= 2 && epochFlag <= 5) {
+                fieldRange(lb, le, 32, 3, fb, fe);
+                int numRecords = rinexStoi(fb, fe);
+                for (int i = 0; i < numRecords; ++i) {
+                    if (!nextLine(lb, le)) {
+                        EndOfFile err("EOF encountered!");
+                        throw err;
+                    }
+                }
+                continue;
+            }
+
+            // 初始化的历元行：所有卫星的差分状态重新开始
+            epochLine.assign(lb, le);
+            for (auto &sat: satArcs) sat.lastEpoch = -1;
+        } else {
+            if (epochLine.empty()) {
+                FFStreamError e("CrinexObsReader: differenced epoch line without initial epoch: >"
+                                + string(lb, le) + "<");
+                throw e;
+            }
+            repairText(epochLine, lb, le);
+        }
+
+        const char *eb = epochLine.data();
+        const char *ee = eb + epochLine.size();
+        if (ee - eb < 2 || eb[0] != '>' || eb[1] != ' ') {
+            FFStreamError e("Bad epoch line: >" + epochLine + "<");
+            throw e;
+        }
+
+        fieldRange(eb, ee, 31, 1, fb, fe);
+        int epochFlag = rinexStoi(fb, fe);
+        if (epochFlag < 0 || epochFlag > 6 || (epochFlag >= 2 && epochFlag <= 5)) {
+            FFStreamError e("Invalid epoch flag: " + std::to_string(epochFlag));
+            throw e;
+        }
+
+        fieldRange(eb, ee, 32, 3, fb, fe);
+        int numSats = rinexStoi(fb, fe);
+
+        CommonTime currEpoch = RinexObsMMapReader::parseTime(eb, ee);
+
+        // 卫星列表从第 42 列开始，每颗卫星 3 个字符
+        const size_t satListPos = 41;
+        if (epochLine.size() < satListPos + 3 * size_t(numSats)) {
+            FFStreamError e("CrinexObsReader: satellite list too short: >" + epochLine + "<");
+            throw e;
+        }
+
+        // 钟差行，ObsData 不输出钟差
+        if (!nextLine(lb, le)) {
+            EndOfFile err("EOF encountered!");
+            throw err;
+        }
+
+        SatTypeValueMap stvData;
+        for (int isv = 0; isv < numSats; ++isv) {
+            if (!nextLine(lb, le)) {
+                EndOfFile err("EOF encountered!");
+                throw err;
+            }
+
+            const char *satId = eb + satListPos + 3 * isv;
+            char sysChar = satId[0];
+            if ((!isdigit(static_cast<unsigned char>(satId[1])) && satId[1] != ' ') ||
+                !isdigit(static_cast<unsigned char>(satId[2]))) {
+                FFStreamError e("Bad satellite id: >" + string(satId, 3) + "<");
+                throw e;
+            }
+
+            // 如果卫星系统不是GPS("G")也不是北斗("C")，则跳过
+            if (sysChar != 'G' && sysChar != 'C') {
+                continue;
+            }
+
+            SatID sat;
+            sat.system = string(1, sysChar);
+            sat.id = rinexStoi(satId + 1, satId + 3);
+
+            // 差分状态要逐历元延续，即使没有选择该系统也要解码
+            TypeValueMap typeObs;
+            decodeSatLine(lb, le, sysChar, sat.id, typeObs);
+            if (!typeObs.empty()) {
+                stvData[sat] = std::move(typeObs);
+            }
+        }
+        epochCount++;
+
+        ObsData obsData;
+        obsData.station = rinexHeader.station;
+        obsData.epoch = currEpoch;
+        obsData.satTypeValueData = std::move(stvData);
+        obsData.antennaPosition = rinexHeader.antennaPosition;
+
+        // 选择的观测值类型已经在解析时处理，不需要再调用 chooseObs
+
+        return obsData;
+    }
+}
+
+void CrinexObsReader::decodeSatLine(const char *lb, const char *le, char sysChar, int prn,
+                                    TypeValueMap &typeObs) {
+    const std::vector<ObsColumn> &columns = sysColumns[static_cast<unsigned char>(sysChar)];
+    if (columns.empty()) {
+        FFStreamError e(string("no SYS / # / OBS TYPES for system ") + sysChar);
+        throw e;
+    }
+
+    SatArcs &sat = satArcs[(static_cast<unsigned char>(sysChar) & 0x7f) * 100 + prn];
+
+    // 上一历元没有这颗卫星，所有弧段重新开始
+    if (sat.lastEpoch != epochCount - 1 || sat.arcs.size() != columns.size()) {
+        sat.arcs.assign(columns.size(), DiffArc());
+        for (auto &arc: sat.arcs) arc.arcOrder = 0;
+    }
+    sat.lastEpoch = epochCount;
+
+    const char *p = lb;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        DiffArc &arc = sat.arcs[i];
+
+        // 行已结束或空字段：没有观测值，弧段结束
+        if (p >= le || *p == ' ') {
+            arc.arcOrder = 0;
+            if (p < le) ++p;
+            continue;
+        }
+
+        int64_t value;
+        if (!parseInt64(p, le, value)) {
+            FFStreamError e("CrinexObsReader: bad data field: >" + string(lb, le) + "<");
+            throw e;
+        }
+
+        if (p < le && *p == '&') {
+            // “k&整数”：新的 k 阶弧段，整数为观测值本身
+            if (value < 0 || value > maxDiffOrder) {
+                FFStreamError e("CrinexObsReader: bad difference order: >" + string(lb, le) + "<");
+                throw e;
+            }
+            arc.arcOrder = int(value);
+            arc.order = 0;
+            ++p;
+            if (!parseInt64(p, le, arc.y[0])) {
+                FFStreamError e("CrinexObsReader: bad data field: >" + string(lb, le) + "<");
+                throw e;
+            }
+        } else {
+            if (arc.arcOrder == 0) {
+                FFStreamError e("CrinexObsReader: difference without arc initialization: >"
+                                + string(lb, le) + "<");
+                throw e;
+            }
+            if (arc.order < arc.arcOrder) arc.order++;
+            arc.y[arc.order] = value;
+            for (int k = arc.order - 1; k >= 0; k--) {
+                arc.y[k] += arc.y[k + 1];
+            }
+        }
+        if (p < le && *p == ' ') ++p;
+
+        // 未选择的列，或者频率未知、无法换算的载波相位
+        const ObsColumn &column = columns[i];
+        if (!column.isSelected) continue;
+
+        double data = (arc.y[0] / 1000.0) * column.scale;
+
+        // 观测值异常
+        if (std::abs(data) == 0.0) {
+            continue;
+        }
+
+        typeObs[column.type] = data;
+    }
+}
+
+ObsData CrinexObsReader::parseRinexObs(CommonTime &syncEpoch) {
+    ObsData obsData;
+    while (true) {
+        obsData = parseRinexObs();
+
+        // 首先寻找大于等于参考时刻的历元
+        if (obsData.epoch >= syncEpoch) {
+            break;
+        }
+    }
+
+    // 观测值超前了参考时刻，同步失败，保留该历元以便下一个历元再同步
+    if (obsData.epoch > (syncEpoch + 0.001)) {
+        pendingObs = std::move(obsData);
+        hasPending = true;
+        SyncException e("CrinexObsReader::can't synchronize the obs!");
+        throw (e);
+    }
+
+    return obsData;
+}
+
+void CrinexObsReader::chooseObs(ObsData &obsData) const {
+    SatTypeValueMap filteredSatTypeValueData;
+
+    for (auto &satEntry: obsData.satTypeValueData) {
+        auto itSys = sysTypes.find(satEntry.first.system);
+        if (itSys == sysTypes.end()) continue;
+
+        const auto &allowedTypes = itSys->second;
+        TypeValueMap filteredTypeValueMap;
+        for (const auto &typeValueEntry: satEntry.second) {
+            if (allowedTypes.find(typeValueEntry.first) != allowedTypes.end()) {
+                filteredTypeValueMap.insert(typeValueEntry);
+            }
+        }
+
+        if (!filteredTypeValueMap.empty()) {
+            filteredSatTypeValueData[satEntry.first] = std::move(filteredTypeValueMap);
+        }
+    }
+
+    obsData.satTypeValueData = std::move(filteredSatTypeValueData);
+}
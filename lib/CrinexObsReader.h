@@ -0,0 +1,119 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_CRINEXOBSREADER_H
+#define GNSSLAB_CRINEXOBSREADER_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "GnssStruct.h"
+#include "MappedFile.h"
+
+// Compact RINEX (Hatanaka 压缩) 观测值读取器
+//
+// 归档数据通常是 CRINEX 格式，以前只能先用 tools/CRX2RNX 解压成完整大小的临时
+// RINEX 文件，再用 RinexObsReader 读回来。本读取器直接映射 .crx 文件，边解压边产生 ObsData，
+// 接口和输出与 RinexObsMMapReader 完全一致（只保留 G/C 卫星、载波相位换算为米、剔除零值，
+// 按 setSelectedTypes 选择观测值），不再需要临时文件。
+//
+// CRINEX 3.0 的解压规则：
+//  - 历元行与上一历元行做文本差分：' ' 表示不变，'&' 表示变为空格；以 '>' 开头的行是完整的历元行，
+//    此时所有卫星的差分状态重新初始化；事件历元（flag 2~5）和其后的头记录行按原文给出；
+//  - 历元行之后是接收机钟差行，ObsData 不输出钟差，直接跳过；
+//  - 每颗卫星一行，各观测值之间用一个空格分隔：“k&整数”开始一个 k 阶差分弧段，
+//    普通整数是 min(上一阶数+1, k) 阶差分，空字段表示无观测值并结束该弧段，行提前结束时其余观测值都缺失；
+//    数值是观测值的 1000 倍，除以 1000 后与 F14.3 文本解析的结果逐位相同；
+//  - 行末是 LLI/信号强度的文本差分，ObsData 不输出这两项，不需要还原。
+// 不输出的卫星系统不需要解码数值，整行跳过。
+// 只支持 CRINEX 3.0（RINEX 3），CRINEX 1.0 对应的 RINEX 2 文件本程序不能处理。
+class CrinexObsReader {
+public:
+    CrinexObsReader();
+
+    explicit CrinexObsReader(const string &fileName);
+
+    // 映射 CRINEX 文件，失败时抛出 FileMissingException
+    void open(const string &fileName);
+
+    // 选择的观测值类型在读完文件头后编译到每一列上，解析时不选的列不换算、不插入
+    void setSelectedTypes(std::map<string, std::set<string>> &systemTypes);
+
+    // 读取 CRINEX 头两行和其后的 RINEX 文件头，不是 CRINEX 3.0 时抛出 FFStreamError
+    void parseRinexHeader();
+
+    // 按顺序解压下一个历元，读完后抛出 EndOfFile
+    ObsData parseRinexObs();
+
+    // 与 RinexObsReader::parseRinexObs(syncEpoch) 语义相同：返回第一个不早于 syncEpoch 的历元，
+    // 若超前 1ms 以上则抛出 SyncException，该历元留到下一次读取时再返回（差分状态不能回退）
+    ObsData parseRinexObs(CommonTime &syncEpoch);
+
+    void chooseObs(ObsData &obsData) const;
+
+    const RinexHeader &getHeader();
+
+    // 已映射的压缩文件字节数，用于吞吐量统计
+    size_t getFileSize() const { return mappedFile.size(); }
+
+    ~CrinexObsReader() {};
+
+private:
+    // Hatanaka 压缩允许的最高差分阶数
+    static const int maxDiffOrder = 5;
+
+    // 一个观测值的差分弧段：y[0] 为观测值（1000 倍），y[k] 为 k 阶差分
+    struct DiffArc {
+        int64_t y[maxDiffOrder + 1];
+        int order;       // 当前已有的差分阶数
+        int arcOrder;    // 弧段开始时给定的阶数，0 表示弧段不存在
+    };
+
+    // 一颗卫星的差分状态
+    struct SatArcs {
+        SatArcs() : lastEpoch(-1) {};
+
+        std::vector<DiffArc> arcs;
+        long lastEpoch;  // 最后出现的历元序号，不是上一历元时所有弧段重新开始
+    };
+
+    // 一个观测值列：类型名、换算到米的系数（非载波相位为 1，未知频率的载波为 0），以及是否输出
+    struct ObsColumn {
+        string type;
+        double scale;
+        bool isSelected;
+    };
+
+    bool nextLine(const char *&lineBegin, const char *&lineEnd);
+
+    // 解码一个数据历元（跳过事件历元）
+    ObsData decodeEpoch();
+
+    // 解码一颗卫星的数据行，把观测值写入 typeObs
+    void decodeSatLine(const char *lb, const char *le, char sysChar, int prn,
+                       TypeValueMap &typeObs);
+
+    void compileObsColumns();
+
+    MappedFile mappedFile;
+    const char *pCur;
+    RinexHeader rinexHeader;
+    std::map<string, std::set<string>> sysTypes;
+    bool isHeaderRead;
+
+    // 以系统标识字符直接索引的观测值列
+    std::vector<ObsColumn> sysColumns[128];
+
+    // 以 系统字符 * 100 + PRN 直接索引的卫星差分状态
+    std::vector<SatArcs> satArcs;
+
+    string epochLine;     // 还原后的上一历元行（含卫星列表）
+    long epochCount;      // 已解码的数据历元数
+
+    // 同步失败时超前的历元，下一次读取时直接返回
+    ObsData pendingObs;
+    bool hasPending;
+};
+
+#endif //GNSSLAB_CRINEXOBSREADER_H
@@ -0,0 +1,206 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <algorithm>
+#include "DesignMatrix.h"
+#include "Exception.h"
+
+#define debug 0
+
+void DesignMatrix::clear() {
+    equIDs.clear();
+    prefits.clear();
+    weights.clear();
+    rowStart.assign(1, 0);
+    colIndex.clear();
+    coeffs.clear();
+    extraColumns.clear();
+    for (int h: columnVars) {
+        columnOf[h] = -1;
+    }
+    columnVars.clear();
+    isFinished = false;
+}
+
+int DesignMatrix::addRow(const EquID &equID) {
+    if (isFinished) {
+        InvalidRequest e("DesignMatrix::addRow() called after finish(), call clear() first");
+        throw (e);
+    }
+    if (rowStart.empty()) {
+        rowStart.push_back(0);
+    }
+    equIDs.push_back(equID);
+    prefits.push_back(0.0);
+    weights.push_back(0.0);
+    rowStart.push_back(int(coeffs.size()));
+    return int(equIDs.size()) - 1;
+}
+
+void DesignMatrix::addCoeff(int h, double coeff) {
+    if (equIDs.empty()) {
+        InvalidRequest e("DesignMatrix::addCoeff() called before addRow()");
+        throw (e);
+    }
+
+    // 与 EquData::varCoeffData[var] = coeff 相同，同一参数再次写入时覆盖
+    for (int k = rowStart[equIDs.size() - 1]; k < int(coeffs.size()); k++) {
+        if (colIndex[k] == h) {
+            coeffs[k] = coeff;
+            return;
+        }
+    }
+    colIndex.push_back(h);
+    coeffs.push_back(coeff);
+    rowStart.back() = int(coeffs.size());
+}
+
+void DesignMatrix::finish() {
+    if (isFinished) return;
+    if (pRegistry == NULL) {
+        InvalidRequest e("DesignMatrix: VariableRegistry is not set");
+        throw (e);
+    }
+    if (rowStart.empty()) {
+        rowStart.push_back(0);
+    }
+
+    int nRows = numRows();
+
+    // linearize 按卫星和观测值类型的顺序写入，通常已经有序
+    bool isSorted = true;
+    for (int i = 1; i < nRows; i++) {
+        if (equIDs[i] < equIDs[i - 1]) {
+            isSorted = false;
+            break;
+        }
+    }
+    if (!isSorted) {
+        rowOrder.resize(nRows);
+        for (int i = 0; i < nRows; i++) rowOrder[i] = i;
+        std::stable_sort(rowOrder.begin(), rowOrder.end(),
+                         [this](int a, int b) { return equIDs[a] < equIDs[b]; });
+
+        std::vector<EquID> sortedIDs(nRows);
+        std::vector<double> sortedPrefits(nRows), sortedWeights(nRows);
+        std::vector<int> sortedStart(nRows + 1, 0), sortedIndex;
+        std::vector<double> sortedCoeffs;
+        sortedIndex.reserve(colIndex.size());
+        sortedCoeffs.reserve(coeffs.size());
+        for (int i = 0; i < nRows; i++) {
+            int r = rowOrder[i];
+            sortedIDs[i] = equIDs[r];
+            sortedPrefits[i] = prefits[r];
+            sortedWeights[i] = weights[r];
+            for (int k = rowStart[r]; k < rowStart[r + 1]; k++) {
+                sortedIndex.push_back(colIndex[k]);
+                sortedCoeffs.push_back(coeffs[k]);
+            }
+            sortedStart[i + 1] = int(sortedCoeffs.size());
+        }
+        equIDs.swap(sortedIDs);
+        prefits.swap(sortedPrefits);
+        weights.swap(sortedWeights);
+        rowStart.swap(sortedStart);
+        colIndex.swap(sortedIndex);
+        coeffs.swap(sortedCoeffs);
+    }
+
+    // 行已经有序，同一个 EquID 重复增加时必然相邻
+    for (int i = 1; i < nRows; i++) {
+        if (!(equIDs[i - 1] < equIDs[i])) {
+            InvalidRequest e("DesignMatrix::finish() the same EquID is added more than once");
+            throw (e);
+        }
+    }
+
+    // 列按规范顺序排列
+    columnVars.assign(colIndex.begin(), colIndex.end());
+    columnVars.insert(columnVars.end(), extraColumns.begin(), extraColumns.end());
+    pRegistry->sortCanonical(columnVars);
+
+    columnOf.resize(pRegistry->size(), -1);
+    for (int i = 0; i < int(columnVars.size()); i++) {
+        columnOf[columnVars[i]] = i;
+    }
+    for (int &c: colIndex) {
+        c = columnOf[c];
+    }
+
+    isFinished = true;
+}
+
+int DesignMatrix::firstColumn(const Parameter &type) const {
+    for (int i = 0; i < int(columnVars.size()); i++) {
+        if (pRegistry->paraType(columnVars[i]) == type) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void DesignMatrix::normalEquation(MatrixXd &normalMatrix, VectorXd &normalVector) const {
+    int n = numCols();
+    normalMatrix.setZero(n, n);
+    normalVector.setZero(n);
+
+    for (int r = 0; r < numRows(); r++) {
+        double w = weights[r];
+        double wl = w * prefits[r];
+        for (int a = rowStart[r]; a < rowStart[r + 1]; a++) {
+            int ca = colIndex[a];
+            double wa = w * coeffs[a];
+            normalVector(ca) += coeffs[a] * wl;
+            for (int b = rowStart[r]; b < rowStart[r + 1]; b++) {
+                normalMatrix(ca, colIndex[b]) += wa * coeffs[b];
+            }
+        }
+    }
+}
+
+void DesignMatrix::residual(const VectorXd &x, VectorXd &resid) const {
+    resid.resize(numRows());
+    for (int r = 0; r < numRows(); r++) {
+        double hx = 0.0;
+        for (int k = rowStart[r]; k < rowStart[r + 1]; k++) {
+            hx += coeffs[k] * x(colIndex[k]);
+        }
+        resid(r) = prefits[r] - hx;
+    }
+}
+
+void DesignMatrix::assign(const IndexedEquSys &equSys) {
+    pRegistry = equSys.pRegistry;
+    clear();
+    for (const auto &ed: equSys.obsEquData) {
+        int row = addRow(ed.first);
+        for (const auto &vc: ed.second.varCoeffs) {
+            addCoeff(vc.first, vc.second);
+        }
+        setPrefit(row, ed.second.prefit);
+        setWeight(row, ed.second.weight);
+    }
+    extraColumns = equSys.varSet;
+    finish();
+}
+
+void DesignMatrix::toEquSys(EquSys &equSys) const {
+    if (!isFinished) {
+        InvalidRequest e("DesignMatrix::toEquSys() called before finish()");
+        throw (e);
+    }
+
+    equSys.obsEquData.clear();
+    equSys.varSet.clear();
+    for (int r = 0; r < numRows(); r++) {
+        EquData &equData = equSys.obsEquData[equIDs[r]];
+        equData.prefit = prefits[r];
+        equData.weight = weights[r];
+        for (int k = rowStart[r]; k < rowStart[r + 1]; k++) {
+            equData.varCoeffData[pRegistry->variable(columnVars[colIndex[k]])] = coeffs[k];
+        }
+    }
+    for (int h: columnVars) {
+        equSys.varSet.insert(equSys.varSet.end(), pRegistry->variable(h));
+    }
+}
@@ -0,0 +1,138 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_DESIGNMATRIX_H
+#define GNSSLAB_DESIGNMATRIX_H
+
+#include <vector>
+#include <Eigen/Eigen>
+
+#include "GnssStruct.h"
+#include "VariableRegistry.h"
+
+using namespace Eigen;
+
+// 按行压缩存放的观测方程（设计矩阵），由 linearize 直接写入，SolverLSQ/SolverKalman 直接使用
+//
+// EquSys 的每个方程都是一个 map<Variable,double>，求解时还要逐个系数查找参数的列号，
+// 再填入稠密的 H 矩阵和 numObs x numObs 的权矩阵。这里每行只保存非零系数：
+//  - 写入时系数以变量句柄表示，finish() 之后换成列号，求解时不再查找；
+//  - 列按句柄的规范顺序排列，与 VariableSet 的遍历顺序相同，状态向量的顺序不变；
+//  - 行按 EquID 排序，与 EquSys::obsEquData 的顺序相同；
+//  - 先验残差和权各存一个向量，法方程直接由非零系数累加。
+//
+// 用法：
+//      design.setVariableRegistry(&registry);
+//      design.clear();
+//      int row = design.addRow(equID);
+//      design.addCoeff(hdx, cosines[0]);
+//      ...
+//      design.setPrefit(row, prefit);
+//      design.setWeight(row, weight);
+//      design.finish();
+//      solverLsq.solve(design);
+//
+// clear() 保留已分配的内存，同一个对象可以逐历元重复使用。
+class DesignMatrix {
+public:
+    DesignMatrix() : pRegistry(NULL), isFinished(false) {};
+
+    void setVariableRegistry(VariableRegistry *pReg) {
+        pRegistry = pReg;
+    };
+
+    VariableRegistry *getVariableRegistry() const {
+        return pRegistry;
+    };
+
+    void clear();
+
+    // 增加一个观测方程，返回行号；之后的 addCoeff 都写入这一行。同一个 EquID 只能增加一次，
+    // 重复时 finish() 抛出 InvalidRequest；finish() 之后要先 clear()
+    int addRow(const EquID &equID);
+
+    // 在最后一行中设置参数的系数，已有时覆盖
+    void addCoeff(int h, double coeff);
+
+    // 声明未知参数：没有任何系数的参数也占一列（与 EquSys::varSet 相同）
+    void addColumn(int h) {
+        extraColumns.push_back(h);
+    };
+
+    void setPrefit(int row, double prefit) {
+        prefits[row] = prefit;
+    };
+
+    void setWeight(int row, double weight) {
+        weights[row] = weight;
+    };
+
+    // 所有方程写完后调用：确定列的顺序，把系数中的句柄换成列号，并把行按 EquID 排序；
+    // 有重复的 EquID 时抛出 InvalidRequest
+    void finish();
+
+    bool finished() const { return isFinished; };
+
+    int numRows() const { return int(equIDs.size()); };
+
+    int numCols() const { return int(columnVars.size()); };
+
+    size_t numCoeffs() const { return coeffs.size(); };
+
+    const EquID &equID(int row) const { return equIDs[row]; };
+
+    double prefit(int row) const { return prefits[row]; };
+
+    double weight(int row) const { return weights[row]; };
+
+    // 第 row 行的系数为 coeffs[k]，列号为 colIndex[k]，k 从 rowStart[row] 到 rowStart[row+1]
+    const std::vector<int> &getRowStart() const { return rowStart; };
+
+    const std::vector<int> &getColIndex() const { return colIndex; };
+
+    const std::vector<double> &getCoeffs() const { return coeffs; };
+
+    // 各列对应的变量句柄，按规范顺序排列
+    const std::vector<int> &columns() const { return columnVars; };
+
+    // 句柄所在的列，不是未知参数时返回 -1
+    int column(int h) const {
+        return (size_t(h) < columnOf.size()) ? columnOf[h] : -1;
+    };
+
+    // 第一个指定类型参数所在的列，没有时返回 -1
+    int firstColumn(const Parameter &type) const;
+
+    // 法方程 N = H'WH，b = H'W*prefit
+    void normalEquation(MatrixXd &normalMatrix, VectorXd &normalVector) const;
+
+    // 残差 prefit - H*x
+    void residual(const VectorXd &x, VectorXd &resid) const;
+
+    // 由 IndexedEquSys 生成，系数的顺序与原来相同
+    void assign(const IndexedEquSys &equSys);
+
+    // 转换成 EquSys，供差分等仍然使用 EquSys 的模块
+    void toEquSys(EquSys &equSys) const;
+
+private:
+    VariableRegistry *pRegistry;
+    bool isFinished;
+
+    std::vector<EquID> equIDs;
+    std::vector<double> prefits;
+    std::vector<double> weights;
+    std::vector<int> rowStart;
+    std::vector<int> colIndex;      // finish() 之前是句柄
+    std::vector<double> coeffs;
+
+    std::vector<int> extraColumns;
+    std::vector<int> columnVars;
+    std::vector<int> columnOf;
+
+    // finish() 中行排序用的临时数据
+    std::vector<int> rowOrder;
+};
+
+#endif //GNSSLAB_DESIGNMATRIX_H
@@ -0,0 +1,176 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_EPHEMERISSTORE_H
+#define GNSSLAB_EPHEMERISSTORE_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "GnssStruct.h"
+#include "SatIndex.h"
+#include "Exception.h"
+
+// 按时间索引的多组广播星历
+//
+// 每颗卫星的所有星历按 ctToe 排序存放在连续的数组中（add 时插入到对应位置），查找时用二分法定位，
+// 在健康（SV_health 为 0）且在有效期内（Eph::isValid）的星历中选择 toe 离查找时刻最近的一组，
+// 返回常引用，不复制星历。
+//
+// 查找可以带一个 Hint，记住每颗卫星上一次查到的星历：相邻历元的查找时刻通常仍然离这组星历最近，
+// 这时只检查前后两组星历的 toe，不需要二分查找。Hint 只是查找的起点，星历增加后仍然可以使用。
+//
+// Eph 需要有 ctToe、SV_health 和 isValid(const CommonTime&)，如 NavEphGPS、NavEphBDS。
+// 同一颗卫星 toe 相同的星历以后加入的为准（与原来 map<CommonTime, Eph> 的赋值相同）。
+//
+// 用法：
+//      EphemerisStore<NavEphGPS>::Hint hint;      // 每个调用者一个
+//      const NavEphGPS &eph = store.find(sat, t, &hint);
+//
+// find/search 返回的引用和指针指向存储的数组，下一次 add() 或 clear() 之后失效，需要保留时复制一份。
+// 查找不修改存储，星历加入完成后可以在多个线程中同时查找，每个线程使用自己的 Hint；
+// add() 不能与查找同时进行。
+template<class Eph>
+class EphemerisStore {
+public:
+    // 每颗卫星上一次查到的星历序号，由调用者持有
+    class Hint {
+    public:
+        Hint() : lastHit(PackedSat::numSats, -1) {};
+
+    private:
+        friend class EphemerisStore;
+
+        std::vector<int> lastHit;
+    };
+
+    EphemerisStore() : numEph(0) {};
+
+    void add(const PackedSat &sat, const Eph &eph) {
+        SatEphs &satEphs = table[sat];
+        std::vector<Eph> &ephs = satEphs.ephs;
+
+        // 第一组 toe 晚于 eph 的星历；通常按时间顺序加入，插在最后
+        typename std::vector<Eph>::iterator it = ephs.end();
+        if (!ephs.empty() && !(ephs.back().ctToe - eph.ctToe < 0.0)) {
+            it = std::upper_bound(ephs.begin(), ephs.end(), eph,
+                                  [](const Eph &a, const Eph &b) { return a.ctToe - b.ctToe < 0.0; });
+        }
+        if (it != ephs.begin() && (it - 1)->ctToe - eph.ctToe == 0.0) {
+            *(it - 1) = eph;
+        } else {
+            ephs.insert(it, eph);
+        }
+
+        double half = std::max(eph.ctToe - eph.beginValid, eph.endValid - eph.ctToe);
+        satEphs.maxHalfValid = std::max(satEphs.maxHalfValid, half);
+        numEph++;
+    }
+
+    void add(const SatID &sat, const Eph &eph) {
+        add(PackedSat(sat), eph);
+    }
+
+    // t 时刻的星历，没有可用的星历时抛出 InvalidRequest
+    const Eph &find(const PackedSat &sat, const CommonTime &t, Hint *pHint = NULL) const {
+        const Eph *pEph = search(sat, t, pHint);
+        if (pEph == NULL) {
+            InvalidRequest e("EphemerisStore: no valid ephemeris for " + sat.toSatID().toString()
+                             + " at " + t.toString());
+            throw (e);
+        }
+        return *pEph;
+    }
+
+    const Eph &find(const SatID &sat, const CommonTime &t, Hint *pHint = NULL) const {
+        return find(PackedSat(sat), t, pHint);
+    }
+
+    // t 时刻的星历，没有可用的星历时返回 NULL
+    const Eph *search(const PackedSat &sat, const CommonTime &t, Hint *pHint = NULL) const {
+        const SatEphs *pSatEphs = table.find(sat);
+        if (pSatEphs == NULL || pSatEphs->ephs.empty()) return NULL;
+
+        const SatEphs &satEphs = *pSatEphs;
+        const std::vector<Eph> &ephs = satEphs.ephs;
+        int n = int(ephs.size());
+
+        // 上一次的星历仍然可用，且前后两组的 toe 都不比它更近。
+        // toe 有序，离 t 的距离先减后增，前后两组都不更近时就是最近的一组，与 Hint 是否过期无关
+        int k = (pHint != NULL) ? pHint->lastHit[sat.ordinal()] : -1;
+        if (k >= 0 && k < n && isUsable(ephs[k], t)) {
+            double dt = std::fabs(t - ephs[k].ctToe);
+            if ((k == 0 || std::fabs(t - ephs[k - 1].ctToe) > dt) &&
+                (k == n - 1 || std::fabs(t - ephs[k + 1].ctToe) >= dt)) {
+                return &ephs[k];
+            }
+        }
+
+        // 第一组 toe 晚于 t 的星历
+        int hi = int(std::upper_bound(ephs.begin(), ephs.end(), t,
+                                      [](const CommonTime &time, const Eph &eph) {
+                                          return time - eph.ctToe < 0.0;
+                                      }) - ephs.begin());
+        int lo = hi - 1;
+
+        // 从 t 两侧向外找 toe 最近的可用星历，相同距离时取较早的一组
+        int best = -1;
+        while (lo >= 0 || hi < n) {
+            double dtLo = (lo >= 0) ? t - ephs[lo].ctToe : -1.0;
+            double dtHi = (hi < n) ? ephs[hi].ctToe - t : -1.0;
+            int i;
+            if (dtHi < 0.0 || (dtLo >= 0.0 && dtLo <= dtHi)) {
+                i = lo--;
+            } else {
+                i = hi++;
+            }
+            if (isUsable(ephs[i], t)) {
+                best = i;
+                break;
+            }
+            // toe 与 t 相差超过最长的有效期半长后，更远的星历都不会覆盖 t
+            if (std::fabs(t - ephs[i].ctToe) > satEphs.maxHalfValid) break;
+        }
+
+        if (pHint != NULL) pHint->lastHit[sat.ordinal()] = best;
+        return (best >= 0) ? &ephs[best] : NULL;
+    }
+
+    // 一颗卫星按 toe 排序的所有星历，没有时返回 NULL
+    const std::vector<Eph> *ephemerides(const PackedSat &sat) const {
+        const SatEphs *pSatEphs = table.find(sat);
+        return (pSatEphs != NULL) ? &pSatEphs->ephs : NULL;
+    }
+
+    bool contains(const PackedSat &sat) const {
+        const SatEphs *pSatEphs = table.find(sat);
+        return pSatEphs != NULL && !pSatEphs->ephs.empty();
+    }
+
+    // 星历的总组数（去掉重复的 toe 之前）
+    size_t size() const { return numEph; };
+
+    void clear() {
+        table.clear();
+        numEph = 0;
+    }
+
+private:
+    struct SatEphs {
+        SatEphs() : maxHalfValid(0.0) {};
+
+        std::vector<Eph> ephs;
+        double maxHalfValid;      // 有效期半长的最大值，秒
+    };
+
+    static bool isUsable(const Eph &eph, const CommonTime &t) {
+        return eph.SV_health == 0 && eph.isValid(t);
+    }
+
+    SatTable<SatEphs> table;
+    size_t numEph;
+};
+
+#endif //GNSSLAB_EPHEMERISSTORE_H
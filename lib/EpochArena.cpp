@@ -0,0 +1,238 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <new>
+#include <cstddef>
+#include <mutex>
+#include "EpochArena.h"
+
+#define debug 0
+
+static thread_local EpochArena *pCurrentArena = NULL;
+
+EpochArena::EpochArena(size_t size)
+        : chunkIndex(0), offset(0), chunkSize(size), usedBytes(0), capacityBytes(0), heapCalls(0), allocations(0) {
+}
+
+EpochArena::~EpochArena() {
+    for (const Chunk &chunk: chunks) {
+        ::operator delete(chunk.data);
+    }
+}
+
+void *EpochArena::allocate(size_t bytes, size_t align) {
+    if (align < alignof(std::max_align_t)) {
+        align = alignof(std::max_align_t);
+    }
+    allocations++;
+
+    while (chunkIndex < chunks.size()) {
+        Chunk &chunk = chunks[chunkIndex];
+        size_t start = (offset + align - 1) & ~(align - 1);
+        if (start + bytes <= chunk.size) {
+            offset = start + bytes;
+            usedBytes += bytes;
+            return chunk.data + start;
+        }
+        // 当前块剩余的空间不够，换下一块
+        chunkIndex++;
+        offset = 0;
+    }
+
+    Chunk chunk;
+    chunk.size = (bytes + align > chunkSize) ? bytes + align : chunkSize;
+    chunk.data = static_cast<char *>(::operator new(chunk.size));
+    chunks.push_back(chunk);
+    capacityBytes += chunk.size;
+    heapCalls++;
+
+    chunkIndex = chunks.size() - 1;
+    offset = bytes;
+    usedBytes += bytes;
+    return chunk.data;
+}
+
+void EpochArena::reset() {
+    chunkIndex = 0;
+    offset = 0;
+    usedBytes = 0;
+}
+
+EpochArena *EpochArena::current() {
+    return pCurrentArena;
+}
+
+EpochArena::Scope::Scope(EpochArena &arena) : pPrevious(pCurrentArena) {
+    pCurrentArena = &arena;
+}
+
+EpochArena::Scope::~Scope() {
+    pCurrentArena = pPrevious;
+}
+
+//--------------------
+// NodePool
+//--------------------
+namespace {
+    const size_t poolGranularity = 16;
+    const size_t numPools = NodePool::maxPooledBytes / poolGranularity;
+    const size_t poolChunkBytes = 64 * 1024;
+
+    // 线程缓存与全局空闲链表之间一次移动的节点数
+    const size_t batchNodes = 64;
+
+    struct FreeNode {
+        FreeNode *next;
+    };
+
+    struct Pool {
+        Pool() : freeList(NULL) {};
+        std::mutex mutex;
+        FreeNode *freeList;
+    };
+
+    // 节点池的内存在程序结束前不释放，其它全局对象析构时仍然可以归还节点
+    Pool *pools() {
+        static Pool *p = new Pool[numPools];
+        return p;
+    }
+
+    std::atomic<size_t> poolHeapCalls(0);
+    std::atomic<size_t> poolAllocations(0);
+
+    // 每个线程的节点缓存：分配和释放先在缓存中进行，不加锁；
+    // 缓存空了从全局链表取一批，超过两批时还回一批
+    struct LocalList {
+        FreeNode *head;
+        size_t count;
+    };
+
+    enum CacheState {
+        CacheUnused = 0, CacheActive, CacheFlushed
+    };
+
+    // 平凡类型的 thread_local，线程中其它 thread_local 对象析构后仍然可以访问
+    thread_local LocalList localLists[numPools];
+    thread_local int cacheState = CacheUnused;
+
+    // 从 list 中取出至多 n 个节点，还给全局链表
+    void returnNodes(size_t index, LocalList &list, size_t n) {
+        if (n == 0) return;
+        FreeNode *first = list.head;
+        FreeNode *last = first;
+        for (size_t i = 1; i < n; i++) last = last->next;
+        list.head = last->next;
+        list.count -= n;
+
+        Pool &pool = pools()[index];
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        last->next = pool.freeList;
+        pool.freeList = first;
+    }
+
+    // 线程结束时把缓存中的节点全部还给全局链表；之后该线程的释放直接进入全局链表
+    struct CacheFlusher {
+        ~CacheFlusher() {
+            for (size_t i = 0; i < numPools; i++) {
+                returnNodes(i, localLists[i], localLists[i].count);
+            }
+            cacheState = CacheFlushed;
+        }
+    };
+
+    thread_local CacheFlusher cacheFlusher;
+
+    // 当前线程的缓存，线程正在结束时返回 NULL
+    inline LocalList *localList(size_t index) {
+        if (cacheState == CacheActive) return &localLists[index];
+        if (cacheState == CacheFlushed) return NULL;
+        (void) &cacheFlusher;   // 第一次使用时构造，线程结束时析构
+        cacheState = CacheActive;
+        return &localLists[index];
+    }
+
+    // 从全局链表取一批节点放入 list，全局链表空时申请一块新内存
+    void fillNodes(size_t index, LocalList &list) {
+        size_t nodeBytes = (index + 1) * poolGranularity;
+        Pool &pool = pools()[index];
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (pool.freeList == NULL) {
+            // 申请一块内存，切成同样大小的节点
+            char *chunk = static_cast<char *>(::operator new(poolChunkBytes));
+            poolHeapCalls++;
+            size_t numNodes = poolChunkBytes / nodeBytes;
+            for (size_t i = 0; i < numNodes; i++) {
+                FreeNode *node = reinterpret_cast<FreeNode *>(chunk + i * nodeBytes);
+                node->next = pool.freeList;
+                pool.freeList = node;
+            }
+        }
+        for (size_t i = 0; i < batchNodes && pool.freeList != NULL; i++) {
+            FreeNode *node = pool.freeList;
+            pool.freeList = node->next;
+            node->next = list.head;
+            list.head = node;
+            list.count++;
+        }
+    }
+}
+
+void *NodePool::allocate(size_t bytes) {
+    if (bytes == 0) bytes = 1;
+    poolAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (bytes > maxPooledBytes) {
+        poolHeapCalls++;
+        return ::operator new(bytes);
+    }
+
+    size_t index = (bytes - 1) / poolGranularity;
+    LocalList *pList = localList(index);
+    LocalList temp = {NULL, 0};
+    LocalList &list = (pList != NULL) ? *pList : temp;
+    if (list.head == NULL) {
+        fillNodes(index, list);
+    }
+    FreeNode *node = list.head;
+    list.head = node->next;
+    list.count--;
+
+    // 线程正在结束，多取的节点直接还回去
+    if (pList == NULL) {
+        returnNodes(index, list, list.count);
+    }
+    return node;
+}
+
+void NodePool::deallocate(void *p, size_t bytes) {
+    if (p == NULL) return;
+    if (bytes == 0) bytes = 1;
+    if (bytes > maxPooledBytes) {
+        ::operator delete(p);
+        return;
+    }
+
+    size_t index = (bytes - 1) / poolGranularity;
+    FreeNode *node = static_cast<FreeNode *>(p);
+    LocalList *pList = localList(index);
+    if (pList == NULL) {
+        LocalList temp = {node, 1};
+        node->next = NULL;
+        returnNodes(index, temp, 1);
+        return;
+    }
+
+    node->next = pList->head;
+    pList->head = node;
+    pList->count++;
+    if (pList->count > 2 * batchNodes) {
+        returnNodes(index, *pList, batchNodes);
+    }
+}
+
+size_t NodePool::numHeapCalls() {
+    return poolHeapCalls;
+}
+
+size_t NodePool::numAllocations() {
+    return poolAllocations;
+}
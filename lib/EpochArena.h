@@ -0,0 +1,166 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_EPOCHARENA_H
+#define GNSSLAB_EPOCHARENA_H
+
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <type_traits>
+
+// 历元内存区（monotonic buffer）
+//
+// RTK 每个历元都要构造和析构大量 map/set（ObsData、各个 EquSys、周跳标志、卫星位置和高度角等），
+// 节点逐个向全局堆申请和释放。EpochArena 从预先申请的内存块中顺序分配，释放时什么也不做，
+// 历元结束后由 reset() 整体回收；内存块保留下来供下一个历元使用，稳定后内存区本身不再申请内存块。
+// 内存区只管容器的节点：节点里的 std::string 超过短字符串长度时、RinexObsReader 读行的缓冲、
+// Eigen 的矩阵等仍然使用全局堆，实际数据处理中每个历元调用全局堆的次数不是零（见 exam-9.15）。
+//
+// 容器通过 EpochAllocator 使用内存区：EpochArena::Scope 存在期间，当前线程中构造的容器都从这个内存区分配。
+// 用法：
+//      EpochArena epochArena;
+//      while (true) {
+//          epochArena.reset();                     // 上一个历元的容器都已析构
+//          EpochArena::Scope scope(epochArena);
+//          ...                                     // 这里构造的容器都分配在 epochArena 中
+//      }
+// 注意：Scope 内构造的容器（以及移动构造得到的容器）不能保存到 reset() 之后；
+// 需要跨历元保存的数据要复制到 Scope 之外构造的容器中（复制构造的容器不使用内存区，见 EpochAllocator）。
+class EpochArena {
+public:
+    explicit EpochArena(size_t chunkSize = 64 * 1024);
+
+    ~EpochArena();
+
+    void *allocate(size_t bytes, size_t align);
+
+    // 整体回收，保留内存块
+    void reset();
+
+    // 当前历元已分配的字节数
+    size_t bytesUsed() const { return usedBytes; };
+
+    // 全部内存块的字节数
+    size_t capacity() const { return capacityBytes; };
+
+    // 申请内存块的次数（即调用全局堆的次数）
+    size_t numHeapCalls() const { return heapCalls; };
+
+    // 容器从内存区分配的次数
+    size_t numAllocations() const { return allocations; };
+
+    // 当前线程正在使用的内存区，没有时为 NULL
+    static EpochArena *current();
+
+    class Scope {
+    public:
+        explicit Scope(EpochArena &arena);
+
+        ~Scope();
+
+    private:
+        Scope(const Scope &);
+
+        Scope &operator=(const Scope &);
+
+        EpochArena *pPrevious;
+    };
+
+private:
+    EpochArena(const EpochArena &);
+
+    EpochArena &operator=(const EpochArena &);
+
+    struct Chunk {
+        char *data;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t chunkIndex;
+    size_t offset;
+
+    size_t chunkSize;
+    size_t usedBytes;
+    size_t capacityBytes;
+    size_t heapCalls;
+    size_t allocations;
+};
+
+// 节点池：不在 EpochArena::Scope 中构造的容器使用，按 16 字节一档的空闲链表回收节点
+//
+// 跨历元保存的容器（SolverKalman 的参数集合、固定的模糊度等）每个历元都清空重填，
+// 节点释放后回到空闲链表，下一个历元直接取用，稳定后同样不再调用全局堆。
+// 超过 maxPooledBytes 的申请直接使用全局堆。节点池是全局的，可以在一个线程分配、在另一个线程释放。
+// 每个线程先在自己的节点缓存中分配和释放，不加锁；缓存空了从全局链表成批取用，积累太多时成批还回，
+// 线程结束时全部还回。全局链表每个 16 字节档位一把互斥锁，多个线程同时解析观测值时
+// 成批移动节点会争用同一档位的锁。
+// 节点池从全局堆申请的内存块从不释放（程序结束前一直保留），占用的内存是各档位节点数的峰值。
+class NodePool {
+public:
+    static const size_t maxPooledBytes = 512;
+
+    static void *allocate(size_t bytes);
+
+    static void deallocate(void *p, size_t bytes);
+
+    // 调用全局堆的次数
+    static size_t numHeapCalls();
+
+    // 容器从节点池分配的次数
+    static size_t numAllocations();
+};
+
+// 供 std::map/std::set 等容器使用的分配器
+//
+// 默认构造时记下当前线程的 EpochArena，没有时使用 NodePool。
+// 复制构造的容器不使用内存区（select_on_container_copy_construction），
+// 赋值时不传递分配器，所以把内存区中的数据赋值给长期存在的容器是安全的。
+// swap 要求两个容器的分配器相同，不能确定时用移动赋值代替（分配器不同时逐个移动元素）。
+template<class T>
+class EpochAllocator {
+public:
+    typedef T value_type;
+    typedef std::false_type propagate_on_container_copy_assignment;
+    typedef std::false_type propagate_on_container_move_assignment;
+    typedef std::false_type propagate_on_container_swap;
+
+    EpochAllocator() : pArena(EpochArena::current()) {};
+
+    template<class U>
+    EpochAllocator(const EpochAllocator<U> &other) : pArena(other.arena()) {};
+
+    T *allocate(size_t n) {
+        if (pArena != NULL) {
+            return static_cast<T *>(pArena->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T *>(NodePool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n) {
+        if (pArena == NULL) {
+            NodePool::deallocate(p, n * sizeof(T));
+        }
+    }
+
+    EpochAllocator select_on_container_copy_construction() const {
+        return EpochAllocator(static_cast<EpochArena *>(NULL));
+    }
+
+    EpochArena *arena() const { return pArena; };
+
+    template<class U>
+    bool operator==(const EpochAllocator<U> &other) const { return pArena == other.arena(); };
+
+    template<class U>
+    bool operator!=(const EpochAllocator<U> &other) const { return pArena != other.arena(); };
+
+private:
+    explicit EpochAllocator(EpochArena *pA) : pArena(pA) {};
+
+    EpochArena *pArena;
+};
+
+#endif //GNSSLAB_EPOCHARENA_H
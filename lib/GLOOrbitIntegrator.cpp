@@ -0,0 +1,49 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <cmath>
+
+#include "GLOOrbitIntegrator.h"
+
+Xvt GLOOrbitIntegrator::getXvt(const NavEphGLO &eph, const CommonTime &t) {
+    SatNodes &nodes = satNodes[PackedSat('R', eph.prn)];
+
+    if (!nodes.hasEph || nodes.toe != eph.ctToe || nodes.pos0[0] != eph.pos[0] ||
+        nodes.pos0[1] != eph.pos[1] || nodes.pos0[2] != eph.pos[2]) {
+        nodes.hasEph = true;
+        nodes.toe = eph.ctToe;
+        for (int i = 0; i < 3; i++) nodes.pos0[i] = eph.pos[i];
+        nodes.forward.resize(6);
+        eph.initialState(&nodes.forward[0]);
+        nodes.backward = nodes.forward;
+        numResets++;
+    }
+
+    // 与 NavEphGLO::svXvt 相同：先走 k 个整步，再走剩下的不足一步
+    double dt = t - eph.ctToe;
+    double h = (dt < 0.0) ? -NavEphGLO::STEP_SIZE : NavEphGLO::STEP_SIZE;
+    size_t k = size_t(std::fabs(dt) / NavEphGLO::STEP_SIZE);
+
+    vector<double> &table = (dt < 0.0) ? nodes.backward : nodes.forward;
+    size_t numNodes = table.size() / 6;
+    if (k >= numNodes) {
+        table.resize(6 * (k + 1));
+        for (size_t i = numNodes; i <= k; i++) {
+            std::copy(table.begin() + 6 * (i - 1), table.begin() + 6 * i, table.begin() + 6 * i);
+            eph.rk4Step(h, &table[6 * i]);
+            numSteps++;
+        }
+    }
+
+    double state[6];
+    std::copy(table.begin() + 6 * k, table.begin() + 6 * (k + 1), state);
+    double rest = dt - double(k) * h;
+    if (rest != 0.0) {
+        eph.rk4Step(rest, state);
+    }
+    return eph.toXvt(state, dt);
+}
+
+void GLOOrbitIntegrator::clear() {
+    satNodes.clear();
+}
@@ -0,0 +1,60 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_GLOORBITINTEGRATOR_H
+#define GNSSLAB_GLOORBITINTEGRATOR_H
+
+#include <vector>
+
+#include "GnssStruct.h"
+#include "SatIndex.h"
+#include "NavEphGLO.h"
+
+// GLONASS 星历的增量积分
+//
+// NavEphGLO::svXvt 每次都从 toe 开始积分，1 Hz 处理时每颗卫星每秒要重复走十几个整步。
+// 这里每颗卫星保存当前星历从 toe 向后、向前积分到的各个整步（toe ± k * STEP_SIZE）的状态：
+//  - 查询时刻所在的整步已经算过时直接取出，只走最后一个不足一步的步长；
+//  - 否则从已经算到的最远整步继续向外积分，算出的整步都保存下来。
+// 向前、向后查询都不需要重新积分，走的步与 svXvt 完全相同，结果也完全相同。
+// 星历（toe 或参考时刻的位置）变化时清除该卫星保存的状态，一组星历的有效期内每颗卫星最多保存几十个整步。
+//
+// 用法：
+//      GLOOrbitIntegrator integrator;
+//      Xvt xvt = integrator.getXvt(navStore.findGLOEph(sat, t), t);
+//
+// 保存的状态不加锁，一个 GLOOrbitIntegrator 只能在一个线程中使用。
+class GLOOrbitIntegrator {
+public:
+    GLOOrbitIntegrator() : numSteps(0), numResets(0) {};
+
+    // t 时刻（UTC）由 eph 积分得到的卫星状态，与 eph.svXvt(t) 相同
+    Xvt getXvt(const NavEphGLO &eph, const CommonTime &t);
+
+    // 清除保存的状态，计数不变
+    void clear();
+
+    // 走过的整步数和换星历的次数
+    size_t getNumSteps() const { return numSteps; };
+
+    size_t getNumResets() const { return numResets; };
+
+private:
+    struct SatNodes {
+        SatNodes() : hasEph(false) {};
+
+        bool hasEph;
+        CommonTime toe;             // 当前星历的 toe
+        double pos0[3];             // 当前星历在 toe 的位置，与 toe 一起区分星历
+        vector<double> forward;     // toe + k * STEP_SIZE 的状态，k = 0, 1, ...，每个 6 个数
+        vector<double> backward;    // toe - k * STEP_SIZE 的状态
+    };
+
+    SatTable<SatNodes> satNodes;
+
+    size_t numSteps;
+    size_t numResets;
+};
+
+#endif //GNSSLAB_GLOORBITINTEGRATOR_H
@@ -8,6 +8,9 @@
 #include "TimeConvert.h"
 #include "GnssStruct.h"
 #include "GnssFunc.h"
+#include "SatIndex.h"
+#include "SignalCatalog.h"
+#include "RinexField.h"
 #include "ARLambda.hpp"
 
 #define debug 1
@@ -73,7 +76,10 @@ void parseRinexHeader(std::fstream &rinexFileStream, RinexHeader &rinexHeader) {
     }
 };
 
-ObsData parseRinexObs(std::fstream &rinexFileStream) {
+// pSysTypes 为 NULL 时解析所有观测值类型，否则只解析其中的类型，
+// 不在其中的列不做数值转换，选完后没有观测值的卫星不输出（与 chooseObs 的结果相同）
+static ObsData parseRinexObs(std::fstream &rinexFileStream,
+                             const std::map<std::string, std::set<std::string>> *pSysTypes) {
     static bool isHeaderRead = false;
     static RinexHeader rinexHeader;
 
@@ -103,7 +109,7 @@ ObsData parseRinexObs(std::fstream &rinexFileStream) {
         throw e;
     }
 
-    int epochFlag = stoi(line.substr(31, 1));
+    int epochFlag = rinexStoi(line, 31, 1);
     if (epochFlag < 0 || epochFlag > 6) {
         FFStreamError e("Invalid epoch flag: " + std::to_string(epochFlag));
         throw e;
@@ -114,7 +120,7 @@ ObsData parseRinexObs(std::fstream &rinexFileStream) {
         std::cout << " currEpoch" << currEpoch << std::endl;
     }
 
-    int numSats = stoi(line.substr(32, 3));
+    int numSats = rinexStoi(line, 32, 3);
 
     if (debug) cout << numSats << endl;
 
@@ -150,6 +156,13 @@ ObsData parseRinexObs(std::fstream &rinexFileStream) {
                 continue;
             }
 
+            const std::set<std::string> *pAllowedTypes = NULL;
+            if (pSysTypes != NULL) {
+                auto itSys = pSysTypes->find(sat.system);
+                if (itSys == pSysTypes->end()) continue;
+                pAllowedTypes = &itSys->second;
+            }
+
             int size = rinexHeader.mapObsTypes.at(satIndex[isv].system).size();
 
             // 有些文件没有观测值，后面就没有输出，这里用空格来替换，否则解析错误
@@ -164,15 +177,15 @@ ObsData parseRinexObs(std::fstream &rinexFileStream) {
             TypeValueMap typeSSI;
             for (int i = 0; i < size; ++i) {
                 size_t pos = 3 + 16 * i;
-                std::string str = line.substr(pos, 16);
 
                 // ObsType
-                std::string obsTypeStr = rinexHeader.mapObsTypes.at(sat.system)[i];
+                const std::string &obsTypeStr = rinexHeader.mapObsTypes.at(sat.system)[i];
+                if (pAllowedTypes != NULL && pAllowedTypes->find(obsTypeStr) == pAllowedTypes->end()) {
+                    continue;
+                }
 
                 // 观测值
-                std::string tmpStr = str.substr(0, 14);
-
-                double data = safeStod(tmpStr);
+                double data = rinexStod(line, pos, 14);
 
                 // 载波相位
                 if (obsTypeStr[0] == 'L') {
@@ -183,7 +196,7 @@ ObsData parseRinexObs(std::fstream &rinexFileStream) {
                     if (obsTypeStr[1] == 'A') {
                         n = 1;
                     } else {
-                        n = stoi(obsTypeStr.substr(1, 1));
+                        n = rinexStoi(obsTypeStr, 1, 1);
                     }
 
                     wavelength = getWavelength(sat.system, n);
@@ -208,6 +221,8 @@ ObsData parseRinexObs(std::fstream &rinexFileStream) {
                 typeObs[obsTypeStr] = data;
             }
 
+            if (pSysTypes != NULL && typeObs.empty()) continue;
+
             // 插入当前卫星的数据到 stvData
             stvData[satIndex[isv]] = typeObs;
 
@@ -222,6 +237,15 @@ ObsData parseRinexObs(std::fstream &rinexFileStream) {
     return obsData;
 }
 
+ObsData parseRinexObs(std::fstream &rinexFileStream) {
+    return parseRinexObs(rinexFileStream, NULL);
+}
+
+ObsData parseRinexObs(std::fstream &rinexFileStream,
+                      const std::map<std::string, std::set<std::string>> &sysTypes) {
+    return parseRinexObs(rinexFileStream, &sysTypes);
+}
+
 
 CommonTime parseTime(const string &line) {
 
@@ -241,12 +265,12 @@ CommonTime parseTime(const string &line) {
     int year, month, day, hour, min;
     double sec;
 
-    year = stoi(line.substr(2, 4));
-    month = stoi(line.substr(7, 2));
-    day = stoi(line.substr(10, 2));
-    hour = stoi(line.substr(13, 2));
-    min = stoi(line.substr(16, 2));
-    sec = safeStod(line.substr(19, 11));
+    year = rinexStoi(line, 2, 4);
+    month = rinexStoi(line, 7, 2);
+    day = rinexStoi(line, 10, 2);
+    hour = rinexStoi(line, 13, 2);
+    min = rinexStoi(line, 16, 2);
+    sec = rinexStod(line, 19, 11);
 
     // Real Rinex has epochs 'yy mm dd hr 59 60.0' surprisingly often.
     double ds = 0;
@@ -296,7 +320,7 @@ void chooseObs(ObsData &obsData, std::map<std::string, std::set<std::string>> &s
     }
 
     // Replace the original data with the filtered data
-    obsData.satTypeValueData.swap(filteredSatTypeValueData);
+    obsData.satTypeValueData = std::move(filteredSatTypeValueData);
 }
 
 // L1C => L1
@@ -316,19 +340,28 @@ void convertObsType(ObsData &obsData) {
 };
 
 double wavelengthOfMW(string sys, string L1Type, string L2Type) {
-    double f1 = getFreq(sys, L1Type);
-    double f2 = getFreq(sys, L2Type);
-    double wavelength = C_MPS / (f1 - f2);
-    return wavelength;
+    return wavelengthOfMW(SignalCatalog::bandId(sys, L1Type), SignalCatalog::bandId(sys, L2Type));
 };
 
-double varOfMW(string, string L1Type, string L2Type) {
+double wavelengthOfMW(int band1, int band2) {
+    if (band1 < 0 || band2 < 0) {
+        return 0.0;
+    }
+    return SignalCatalog::pair(band1, band2).mwWavelength;
+};
+
+double varOfMW(string sys, string L1Type, string L2Type) {
+    return varOfMW(SignalCatalog::bandId(sys, L1Type), SignalCatalog::bandId(sys, L2Type));
+};
+
+// 目前各频点组合都取相同的先验方差
+double varOfMW(int, int) {
     double var = sqrt(2.0) / 2 * 0.3;
     return var;
 };
 
 void detectCSMW(ObsData &obsData,
-                std::map<Variable, int> &csFlagData,
+                VariableIntMap &csFlagData,
                 SatEpochValueMap &satEpochMWData,
                 SatEpochValueMap &satEpochMeanMWData,
                 SatEpochValueMap &satEpochCSFlagData) {
@@ -351,7 +384,13 @@ void detectCSMW(ObsData &obsData,
     };
 
     // 这个数据在下次调用时需要用到，所以定位为static变量
-    static std::map<SatID, MWData> satMWData;
+    static SatTable<MWData> satMWData;
+
+    // GPS L1/L2 的频点编号和 MW 组合系数，编译期算好
+    constexpr int bandL1 = SignalCatalog::bandId('G', '1');
+    constexpr int bandL2 = SignalCatalog::bandId('G', '2');
+    const SignalPair &mwPairGPS = SignalCatalog::pair(bandL1, bandL2);
+    static const string L1Type("L1"), L2Type("L2"), C1Type("C1"), C2Type("C2");
 
     //==========================
     // 逐个卫星做周跳探测
@@ -359,29 +398,20 @@ void detectCSMW(ObsData &obsData,
     // Loop through all the satellites
     CommonTime currentEpoch = obsData.epoch;
     SatIDSet badSatSet;
-    for (auto stv: obsData.satTypeValueData) {
-        SatID sat = (stv).first;
-        string L1Type, L2Type, C1Type, C2Type;
+    for (const auto &stv: obsData.satTypeValueData) {
+        const SatID &sat = stv.first;
+        const SignalPair *pMWPair;
         if (sat.system == "G") {
-            L1Type = "L1";
-            L2Type = "L2";
-            C1Type = "C1";
-            C2Type = "C2";
+            pMWPair = &mwPairGPS;
         } else // 请增加bds的处理
         {
             badSatSet.insert(sat);
+            continue;
         }
 
         // wavelengthMW of MW-combination, see LinearCombination
-        double wavelengthMW = wavelengthOfMW(sat.system, L1Type, L2Type);
-        double varianceMW = varOfMW(sat.system, L1Type, L2Type);
-
-        double f1 = getFreq(sat.system, L1Type);
-        double f2 = getFreq(sat.system, L2Type);
-
-        if (debug) {
-            cout << "f1:" << f1 << "f2:" << f2 << endl;
-        }
+        double wavelengthMW = pMWPair->mwWavelength;
+        double varianceMW = varOfMW(bandL1, bandL2);
 
         double L1Value, L2Value, C1Value, C2Value, mwValue;
 
@@ -391,9 +421,8 @@ void detectCSMW(ObsData &obsData,
             C1Value = stv.second.at(C1Type);
             C2Value = stv.second.at(C2Type);
 
-            mwValue
-                    = (f1 * L1Value - f2 * L2Value) / (f1 - f2)
-                      - (f1 * C1Value + f2 * C2Value) / (f1 + f2);
+            mwValue = pMWPair->mwPhase1 * L1Value + pMWPair->mwPhase2 * L2Value
+                      + pMWPair->mwCode1 * C1Value + pMWPair->mwCode2 * C2Value;
         } catch (std::out_of_range) {
             // 无法构成mw，这个卫星观测值周跳无法探测，删除这个卫星
             badSatSet.insert(sat);
@@ -408,7 +437,7 @@ void detectCSMW(ObsData &obsData,
             cout << "C1Value:" << C1Value << endl;
             cout << "C2Value:" << C2Value << endl;
             cout << "mwValue:" << mwValue << endl;
-            cout << "wavelength:" << C_MPS / (f1 - f2) << endl;
+            cout << "wavelength:" << wavelengthMW << endl;
         }
 
         //-------------------
@@ -416,26 +445,28 @@ void detectCSMW(ObsData &obsData,
         double currentBias(0.0);
         int csFlag(0.0);
 
-        currentDeltaT = (currentEpoch - satMWData[sat].formerEpoch);
-        satMWData[sat].formerEpoch = currentEpoch;
+        // 直接索引的滤波数据，每颗卫星只查找一次
+        MWData &mwData = satMWData[sat];
+        currentDeltaT = (currentEpoch - mwData.formerEpoch);
+        mwData.formerEpoch = currentEpoch;
         if (debugCSMW) {
             cout << "currentDeltaT:" << currentDeltaT << endl;
         }
         // Difference between current value of MW and average value
-        currentBias = std::abs(mwValue - satMWData[sat].meanMW);
+        currentBias = std::abs(mwValue - mwData.meanMW);
         if (debugCSMW) {
             cout << "currentBias:" << currentBias << endl;
         }
 
         // Increment window size
-        satMWData[sat].windowSize++;
+        mwData.windowSize++;
 
         /**
          * cycle-slip condition
          * 1. if data interrupt for a given time gap, then cyce slip should be set
          * 2. if current bias is greater than 1 cycle and greater than 4 sigma of mean mw.
          */
-        double sigLimit = 4 * std::sqrt(satMWData[sat].varMW);
+        double sigLimit = 4 * std::sqrt(mwData.varMW);
 
         if (debugCSMW) {
             cout << "deltaTMax:" << deltaTMax << endl;
@@ -450,9 +481,9 @@ void detectCSMW(ObsData &obsData,
             currentBias > sigLimit) {
 
             // reset the filter window size/meanMW/InitialVarofMW
-            satMWData[sat].meanMW = mwValue;
-            satMWData[sat].varMW = varianceMW;
-            satMWData[sat].windowSize = 1;
+            mwData.meanMW = mwValue;
+            mwData.varMW = varianceMW;
+            mwData.windowSize = 1;
 
             if (debugCSMW) {
                 cout << "* CS happened!" << endl;
@@ -460,19 +491,19 @@ void detectCSMW(ObsData &obsData,
             csFlag = 1.0;
         } else {
             // MW bias from the mean value
-            double mwBias(mwValue - satMWData[sat].meanMW);
-            double size(static_cast<double>(satMWData[sat].windowSize));
+            double mwBias(mwValue - mwData.meanMW);
+            double size(static_cast<double>(mwData.windowSize));
 
             // Compute average
-            satMWData[sat].meanMW += mwBias / size;
+            mwData.meanMW += mwBias / size;
 
             // Compute variance
             // Var(i) = Var(i-1) + [ ( mw(i) - meanMW)^2/(i)- 1*Var(i-1) ]/(i);
-            satMWData[sat].varMW += (mwBias * mwBias - satMWData[sat].varMW) / size;
+            mwData.varMW += (mwBias * mwBias - mwData.varMW) / size;
         }
 
         // for print
-        satEpochMeanMWData[sat][currentEpoch] = satMWData[sat].meanMW;
+        satEpochMeanMWData[sat][currentEpoch] = mwData.meanMW;
 
         // 放大到mw数值，以方便绘图
         satEpochCSFlagData[sat][currentEpoch] = csFlag * mwValue;
@@ -496,7 +527,7 @@ void differenceStation(EquSys& equSysRover,
                        EquSys& equSysSD)
 {
     // 逐个观测值类型取出类型
-    std::map<EquID, EquData> obsEquDataDiff;
+    EquDataMap obsEquDataDiff;
     VariableSet varSetDiff;
     for(auto& oe: equSysRover.obsEquData)
     {
@@ -538,7 +569,7 @@ void differenceStation(EquSys& equSysRover,
         // trop = 0, sigmaTrop = 0.0001*.0001*baseline
         //------------------------------------------------------------
         // 未知参数与流动站的参数是相同的。
-        std::map<Variable, double> vcDataTemp;
+        VariableDataMap vcDataTemp;
         for(auto vc: oe.second.varCoeffData)
         {
             if(vc.first.getParaType() != Parameter::iono)
@@ -661,10 +692,10 @@ void differenceSat( SatID& datumSat,
     // string obsStr = obsType + system;
     //----------------------------------------------------
 
-    std::map<ObsID, EquData> datumEquData;
-    std::map<EquID, EquData> otherEquData;
+    EpochMap<ObsID, EquData> datumEquData;
+    EquDataMap otherEquData;
 
-    std::map<EquID, EquData> equData;
+    EquDataMap equData;
     equData = equSysSD.obsEquData;
     /*if (debug)
     {
@@ -693,7 +724,7 @@ void differenceSat( SatID& datumSat,
     // dx，dy，dz的系数求差；
     // 接收机钟差进一步差分掉了；
     // 模糊度除了基准卫星，其他卫星变成双差模式，系数不变
-    std::map<EquID, EquData> equDataDD;
+    EquDataMap equDataDD;
     VariableSet varSetDD;
     for(auto ed: otherEquData)
     {
@@ -770,10 +801,10 @@ void differenceSat( SatID& datumSat,
     // string obsStr = obsType + system;
     //----------------------------------------------------
 
-    std::map<ObsID, EquData> datumEquData;
-    std::map<EquID, EquData> otherEquData;
+    EpochMap<ObsID, EquData> datumEquData;
+    EquDataMap otherEquData;
 
-    std::map<EquID, EquData> equData;
+    EquDataMap equData;
     equData = equSysSD.obsEquData;
 
     for(auto ed: equData)
@@ -797,7 +828,7 @@ void differenceSat( SatID& datumSat,
     // dx，dy，dz的系数求差；
     // 接收机钟差进一步差分掉了；
     // 模糊度除了基准卫星，其他卫星变成双差模式，系数不变
-    std::map<EquID, EquData> equDataDD;
+    EquDataMap equDataDD;
     VariableSet varSetDD;
     for(auto ed: otherEquData)
     {
@@ -1016,6 +1047,325 @@ void ambiguityDatum(bool& firstEpoch,
     }
 };
 
+//--------------------
+// 以变量句柄表示的差分和模糊度处理
+//--------------------
+void differenceStation(IndexedEquSys& equSysRover,
+                       IndexedEquSys& equSysBase,
+                       IndexedEquSys& equSysSD)
+{
+    const VariableRegistry &registry = *equSysRover.pRegistry;
+
+    std::map<EquID, IndexedEquData> obsEquDataDiff;
+    std::vector<int> varSetDiff;
+    for(const auto& oe: equSysRover.obsEquData)
+    {
+        // 在参考站中查找当前观测值，如果没有找到就跳过
+        auto itBase = equSysBase.obsEquData.find(oe.first);
+        if(itBase == equSysBase.obsEquData.end())
+        {
+            continue;
+        }
+        const IndexedEquData &oeBase = itBase->second;
+
+        IndexedEquData &oeDiff = obsEquDataDiff[oe.first];
+        oeDiff.prefit = oe.second.prefit - oeBase.prefit;
+
+        // 与 Variable 版本相同，站间差分后不再估计电离层参数
+        for(const auto& vc: oe.second.varCoeffs)
+        {
+            if(registry.paraType(vc.first) != Parameter::iono)
+            {
+                oeDiff.varCoeffs.push_back(vc);
+                varSetDiff.push_back(vc.first);
+            }
+        }
+
+        double varDiff = 1.0/oe.second.weight + 1.0/oeBase.weight;
+        oeDiff.weight = 1.0/varDiff;
+    }
+    registry.sortCanonical(varSetDiff);
+
+    equSysSD.pRegistry = equSysRover.pRegistry;
+    equSysSD.obsEquData.swap(obsEquDataDiff);
+    equSysSD.varSet.swap(varSetDiff);
+};
+
+void differenceStation(IndexedEquSys& equSysRover, VariableTable<double>& csFlagRover,
+                       IndexedEquSys& equSysBase, VariableTable<double>& csFlagBase,
+                       IndexedEquSys& equSysSD, VariableTable<double>& csFlagSD)
+{
+    differenceStation(equSysRover,
+                      equSysBase,
+                      equSysSD);
+
+    VariableRegistry &registry = *equSysRover.pRegistry;
+
+    // 去掉测站名后匹配流动站和基准站的模糊度
+    VariableTable<double> tempFlagBase;
+    for(int h: csFlagBase.keys())
+    {
+        tempFlagBase[registry.withoutStation(h)] = *csFlagBase.find(h);
+    }
+
+    for(int h: csFlagRover.keys())
+    {
+        int stripped = registry.withoutStation(h);
+        const double *pFlagBase = tempFlagBase.find(stripped);
+        if(pFlagBase == NULL)
+        {
+            continue;
+        }
+
+        // 基准站或者流动站一个发生周跳，就标志周跳
+        double flagSD = (*csFlagRover.find(h) || *pFlagBase) ? 1.0 : 0.0;
+        csFlagSD[registry.withStation(stripped, equSysRover.station)] = flagSD;
+    }
+};
+
+// 星间差分共用的部分：取出基准卫星各观测类型的方程
+static void findDatumEquData(SatID& datumSat,
+                             const IndexedEquSys& equSysSD,
+                             std::map<ObsID, const IndexedEquData*>& datumEquData)
+{
+    for(const auto& ed: equSysSD.obsEquData)
+    {
+        if(ed.first.sat == datumSat)
+        {
+            datumEquData[ObsID(ed.first.sat.system, ed.first.obsType)] = &ed.second;
+        }
+    }
+}
+
+void differenceSat( SatID& datumSat,
+                    IndexedEquSys& equSysSD,
+                    IndexedEquSys& equSysDD )
+{
+    const VariableRegistry &registry = *equSysSD.pRegistry;
+
+    std::map<ObsID, const IndexedEquData*> datumEquData;
+    findDatumEquData(datumSat, equSysSD, datumEquData);
+
+    std::map<EquID, IndexedEquData> equDataDD;
+    std::vector<int> varSetDD;
+    for(const auto& ed: equSysSD.obsEquData)
+    {
+        if(ed.first.sat == datumSat)
+        {
+            continue;
+        }
+
+        // 基准卫星没有这个类型的观测值时剔除
+        auto itDatum = datumEquData.find(ObsID(ed.first.sat.system, ed.first.obsType));
+        if(itDatum == datumEquData.end())
+        {
+            continue;
+        }
+        const IndexedEquData &datum = *itDatum->second;
+
+        IndexedEquData edDD;
+        edDD.prefit = ed.second.prefit - datum.prefit;
+
+        // 接收机钟差消除了，只保留了坐标和模糊度参数
+        bool isValid = true;
+        for(const auto& vc: ed.second.varCoeffs)
+        {
+            const Parameter &type = registry.paraType(vc.first);
+            if(type == Parameter::dX || type == Parameter::dY || type == Parameter::dZ)
+            {
+                const double *pCoeffDatum = datum.findCoeff(vc.first);
+                if(pCoeffDatum == NULL)
+                {
+                    isValid = false;
+                    break;
+                }
+                edDD.varCoeffs.push_back(std::make_pair(vc.first, vc.second - *pCoeffDatum));
+                varSetDD.push_back(vc.first);
+            }
+            else if(type == Parameter::ambiguity)
+            {
+                edDD.varCoeffs.push_back(vc);
+                varSetDD.push_back(vc.first);
+            }
+        }
+        if(!isValid)
+        {
+            continue;
+        }
+
+        double varDiff = 1.0/ed.second.weight + 1.0/datum.weight;
+        edDD.weight = 1.0/varDiff;
+        equDataDD[ed.first] = std::move(edDD);
+    }
+    registry.sortCanonical(varSetDD);
+
+    equSysDD.pRegistry = equSysSD.pRegistry;
+    equSysDD.obsEquData.swap(equDataDD);
+    equSysDD.varSet.swap(varSetDD);
+};
+
+void differenceSat( SatID& datumSat,
+                    IndexedEquSys& equSysSD, VariableTable<double>& csFlagSD,
+                    IndexedEquSys& equSysDD, VariableTable<double>& csFlagDD )
+{
+    const VariableRegistry &registry = *equSysSD.pRegistry;
+
+    std::map<ObsID, const IndexedEquData*> datumEquData;
+    findDatumEquData(datumSat, equSysSD, datumEquData);
+
+    std::map<EquID, IndexedEquData> equDataDD;
+    std::vector<int> varSetDD;
+    for(const auto& ed: equSysSD.obsEquData)
+    {
+        if(ed.first.sat == datumSat)
+        {
+            continue;
+        }
+
+        auto itDatum = datumEquData.find(ObsID(ed.first.sat.system, ed.first.obsType));
+        if(itDatum == datumEquData.end())
+        {
+            continue;
+        }
+        const IndexedEquData &datum = *itDatum->second;
+
+        // 基准卫星的模糊度，有多个时与 Variable 版本一样取规范顺序中的最后一个
+        int datumAmb = -1;
+        double datumAmbCoeff = 0.0;
+        for(const auto& vc: datum.varCoeffs)
+        {
+            if(registry.paraType(vc.first) == Parameter::ambiguity &&
+               (datumAmb < 0 || registry.less(datumAmb, vc.first)))
+            {
+                datumAmb = vc.first;
+                datumAmbCoeff = vc.second;
+            }
+        }
+
+        IndexedEquData edDD;
+        edDD.prefit = ed.second.prefit - datum.prefit;
+
+        bool isValid = true;
+        for(const auto& vc: ed.second.varCoeffs)
+        {
+            const Parameter &type = registry.paraType(vc.first);
+            if(type == Parameter::dX || type == Parameter::dY || type == Parameter::dZ)
+            {
+                const double *pCoeffDatum = datum.findCoeff(vc.first);
+                if(pCoeffDatum == NULL)
+                {
+                    isValid = false;
+                    break;
+                }
+                edDD.setCoeff(vc.first, vc.second - *pCoeffDatum);
+                varSetDD.push_back(vc.first);
+            }
+            else if(type == Parameter::ambiguity && datumAmb >= 0)
+            {
+                // 把基准模糊度插入到方程中，也就是估计基准模糊度，而不是合并成双差模糊度
+                // warning: 是负号
+                edDD.setCoeff(datumAmb, -datumAmbCoeff);
+                edDD.setCoeff(vc.first, vc.second);
+                varSetDD.push_back(datumAmb);
+                varSetDD.push_back(vc.first);
+            }
+        }
+        if(!isValid)
+        {
+            continue;
+        }
+
+        double varDiff = 1.0/ed.second.weight + 1.0/datum.weight;
+        edDD.weight = 1.0/varDiff;
+        equDataDD[ed.first] = std::move(edDD);
+    }
+    registry.sortCanonical(varSetDD);
+
+    equSysDD.pRegistry = equSysSD.pRegistry;
+    equSysDD.obsEquData.swap(equDataDD);
+    equSysDD.varSet.swap(varSetDD);
+
+    // 直接把站间单差模糊度标志给双差即可，因为估计的模糊度仍然为站间单差模糊度
+    csFlagDD = csFlagSD;
+};
+
+void ambiguityDatum(bool& firstEpoch,
+                    SatID& datumSat,
+                    VariableTable<double>& fixedAmbData,
+                    IndexedEquSys& equSysDD)
+{
+    const VariableRegistry &registry = *equSysDD.pRegistry;
+
+    // 对于第一个历元，直接将基准卫星模糊度固定为零；其余历元使用上一历元的固定值
+    const std::vector<int> &handles = firstEpoch ? equSysDD.varSet : fixedAmbData.keys();
+    for(int h: handles)
+    {
+        const Variable &var = registry.variable(h);
+        if(var.sat != datumSat)
+        {
+            continue;
+        }
+
+        EquID equIDDatum;
+        equIDDatum.sat = datumSat;
+        equIDDatum.obsType = var.getParaType().toString()
+                             + var.getObsID().toString();
+
+        IndexedEquData equDataDatum;
+        equDataDatum.prefit = firstEpoch ? 0.0 : *fixedAmbData.find(h);
+        equDataDatum.varCoeffs.push_back(std::make_pair(h, 1.0));
+        equDataDatum.weight = 1.0E+8;
+
+        // 将模糊度基准观测方程加入到观测系统中
+        equSysDD.obsEquData[equIDDatum] = equDataDatum;
+    }
+};
+
+void fixSolution(VectorXd& stateVec,
+                 MatrixXd& covMatrix,
+                 const IndexedEquSys& equSys,
+                 double& ratio,
+                 Vector3d& dxyzFixed,
+                 VariableTable<double>& fixedAmbData)
+{
+    const VariableRegistry &registry = *equSys.pRegistry;
+
+    // 模糊度参数排在最后
+    std::vector<int> ambVars;
+    for(int h: equSys.varSet)
+    {
+        if(registry.paraType(h) == Parameter::ambiguity)
+        {
+            ambVars.push_back(h);
+        }
+    }
+
+    int numAmb = ambVars.size();
+    int numXYZT = equSys.varSet.size() - numAmb;
+
+    VectorXd ambSol = stateVec.tail(numAmb);
+    MatrixXd ambCov = covMatrix.block(numXYZT, numXYZT, numAmb, numAmb);
+
+    ARLambda arLambda;
+    VectorXd ambSolFixed = arLambda.resolve(ambSol, ambCov);
+
+    fixedAmbData.clear();
+    for(int i = 0; i < numAmb; i++)
+    {
+        fixedAmbData[ambVars[i]] = ambSolFixed(i);
+    }
+
+    ratio = arLambda.squaredRatio;
+
+    VectorXd xVec = stateVec.head(numXYZT);
+    MatrixXd Qxb = covMatrix.block(0, numXYZT, numXYZT, numAmb);
+    MatrixXd Qbb = covMatrix.block(numXYZT, numXYZT, numAmb, numAmb);
+
+    VectorXd xVecFixed = xVec - Qxb * Qbb.inverse() * (ambSol - ambSolFixed);
+
+    dxyzFixed = xVecFixed;
+};
+
 // print solution to files
 void printSolution(std::fstream & solStream,
                    CommonTime& ctTime,
@@ -14,6 +14,7 @@
 #include "CoordStruct.h"
 #include "GnssStruct.h"
 #include "StringUtils.h"
+#include "VariableRegistry.h"
 
 using namespace Eigen;
 
@@ -40,6 +41,10 @@ void parseRinexHeader(std::fstream &rinexFileStream,
 
 ObsData parseRinexObs(std::fstream &rinexFileStream);
 
+// 只解析 sysTypes 中的观测值类型，结果与 parseRinexObs 之后再 chooseObs 相同
+ObsData parseRinexObs(std::fstream &rinexFileStream,
+                      const std::map<string, std::set<string>> &sysTypes);
+
 CommonTime parseTime(const string &line);
 
 void chooseObs(ObsData &obsData,
@@ -51,12 +56,18 @@ double wavelengthOfMW(string sys,
                       string L1Type,
                       string L2Type);
 
-double varOfMW(string,
+// 以 SignalCatalog 的频点编号给出两个频点，编号无效时返回 0
+double wavelengthOfMW(int band1, int band2);
+
+double varOfMW(string sys,
                string L1Type,
                string L2Type);
 
+// 以 SignalCatalog 的频点编号给出两个频点
+double varOfMW(int band1, int band2);
+
 void detectCSMW(ObsData &obsData,
-                std::map<Variable, int> &csFlagData,
+                VariableIntMap &csFlagData,
                 SatEpochValueMap &satEpochMWData,
                 SatEpochValueMap &satEpochMeanMWData,
                 SatEpochValueMap &satEpochCSFlagData);
@@ -93,6 +104,38 @@ void fixSolution(VectorXd& stateVec,
                  Vector3d& dxyzFixed,
                  VariableDataMap& fixedAmbData);
 
+//--------------------
+// 以变量句柄表示的站间差分、星间差分、模糊度基准和模糊度固定，结果与上面的函数相同；
+// 流动站和基准站的方程、周跳标志必须登记在同一个 VariableRegistry 中
+//--------------------
+void differenceStation(IndexedEquSys& equSysRover,
+                       IndexedEquSys& equSysBase,
+                       IndexedEquSys& equSysSD);
+
+void differenceStation(IndexedEquSys& equSysRover, VariableTable<double>& csFlagRover,
+                       IndexedEquSys& equSysBase, VariableTable<double>& csFlagBase,
+                       IndexedEquSys& equSysSD, VariableTable<double>& csFlagSD);
+
+void differenceSat( SatID& datumSat,
+                    IndexedEquSys& equSysSD,
+                    IndexedEquSys& equSysDD);
+
+void differenceSat( SatID& datumSat,
+                    IndexedEquSys& equSysSD, VariableTable<double>& csFlagSD,
+                    IndexedEquSys& equSysDD, VariableTable<double>& csFlagDD);
+
+void ambiguityDatum(bool& firstEpoch,
+                    SatID& datumSat,
+                    VariableTable<double>& fixedAmbData,
+                    IndexedEquSys& equSysDD);
+
+void fixSolution(VectorXd& stateVec,
+                 MatrixXd& covMatrix,
+                 const IndexedEquSys& equSys,
+                 double& ratio,
+                 Vector3d& dxyzFixed,
+                 VariableTable<double>& fixedAmbData);
+
 // print solution to files
 void printSolution(std::fstream & solStream,
                    CommonTime& ctTime,
@@ -6,6 +6,7 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <scoped_allocator>
 #include <iostream>
 #include <iomanip> // 包含此头文件以使用 std::fixed 和 std::setprecision
 #include <string>
@@ -16,6 +17,7 @@
 #include "TimeConvert.h"
 #include "CoordStruct.h"
 #include "TimeStruct.h"
+#include "EpochArena.h"
 
 //---------------
 // 卫星号管理
@@ -94,7 +96,17 @@ struct RinexHeader {
 };
 
 
-typedef std::map<string, double> TypeValueMap;
+// 历元内的容器都使用 EpochAllocator，在 EpochArena::Scope 中构造时分配在历元内存区，见 EpochArena.h
+// scoped_allocator_adaptor 让嵌套的容器（如 SatTypeValueMap 中的 TypeValueMap）使用外层容器的分配器，
+// 把历元内的 ObsData 赋值给长期保存的 ObsData 时，内层的 map 也复制到节点池中
+template<class Key, class T>
+using EpochMap = std::map<Key, T, std::less<Key>,
+        std::scoped_allocator_adaptor<EpochAllocator<std::pair<const Key, T>>>>;
+
+template<class Key>
+using EpochSet = std::set<Key, std::less<Key>, EpochAllocator<Key>>;
+
+typedef EpochMap<string, double> TypeValueMap;
 
 inline std::ostream &operator<<(std::ostream &os, const TypeValueMap &typeValueMap) {
     for (const auto &entry: typeValueMap) {
@@ -104,7 +116,7 @@ inline std::ostream &operator<<(std::ostream &os, const TypeValueMap &typeValueM
     return os;
 }
 
-typedef std::map<SatID, double> SatValueMap;
+typedef EpochMap<SatID, double> SatValueMap;
 inline std::ostream &operator<<(std::ostream &os, const SatValueMap &satValueMap) {
     for (const auto &entry: satValueMap) {
         os << "  sat: " << entry.first
@@ -114,7 +126,7 @@ inline std::ostream &operator<<(std::ostream &os, const SatValueMap &satValueMap
 }
 
 
-typedef std::map<SatID, TypeValueMap> SatTypeValueMap;
+typedef EpochMap<SatID, TypeValueMap> SatTypeValueMap;
 
 inline std::ostream &operator<<(std::ostream &os, const SatTypeValueMap &satTypeValueMap) {
     for (const auto &satEntry: satTypeValueMap) {
@@ -184,10 +196,12 @@ public:
     double clkbias;      ///< Sat clock correction in seconds
     double clkdrift;     ///< satellite clock drift in seconds/second
     double relcorr;
-    std::map<string, double> typeTGDData;
+    TypeValueMap typeTGDData;
 
 }; // end class Xvt
 
+typedef EpochMap<SatID, Xvt> SatXvtMap;
+
 // Output operator for Xvt
 inline std::ostream &operator<<(std::ostream &os, Xvt &xvt)
 throw() {
@@ -353,9 +367,9 @@ inline std::ostream &operator<<(std::ostream &os, const Variable &v) {
     return os;
 }
 
-typedef std::set<Variable> VariableSet;
-typedef std::map<Variable, double> VariableDataMap;
-typedef std::map<Variable, int> VariableIntMap;
+typedef EpochSet<Variable> VariableSet;
+typedef EpochMap<Variable, double> VariableDataMap;
+typedef EpochMap<Variable, int> VariableIntMap;
 
 //===========
 // EquationData
@@ -410,16 +424,18 @@ struct EquData
 {
     string station;
     double prefit;
-    std::map<Variable, double> varCoeffData;
+    VariableDataMap varCoeffData;
     double weight;
 };
 
+typedef EpochMap<EquID, EquData> EquDataMap;
+
 // 所有观测方程数据，包括未知参数和每个方程的数据
 struct EquSys
 {
     // 每个观测方程的未知参数和系数及先验残差
     string station;
-    std::map<EquID, EquData> obsEquData;
+    EquDataMap obsEquData;
     // 整个方程系统的所有未知参数
     VariableSet varSet;
 };
@@ -243,3 +243,30 @@ noexcept(false) {
 
 
 
+
+// Corrects the a posteriori estimate using the normal equation of the
+// measurements, normalMatrix = H'WH and normalVector = H'W*mVector.
+// It gives the same result as Correct(), without forming the dense
+// measurement weight matrix.
+int KalmanFilter::MeasUpdateNormal(const MatrixXd &normalMatrix,
+                                   const VectorXd &normalVector)
+noexcept(false) {
+
+    try {
+        MatrixXd invPMinus = Pminus.inverse();
+        MatrixXd invTemp(normalMatrix + invPMinus);
+
+        // Compute the a posteriori error covariance matrix
+        P = invTemp.inverse();
+
+        // Compute the a posteriori state estimation
+        xhat = P * (normalVector + (invPMinus * xhatminus));
+    }
+    catch (std::exception &e) {
+        InvalidSolver eis("MeasUpdateNormal(): Unable to compute xhat.");
+        throw (eis);
+    }
+
+    return 0;
+
+}  // End of method 'KalmanFilter::MeasUpdateNormal()'
@@ -185,6 +185,23 @@ public:
     }
 
 
+    /** Corrects the a posteriori estimate using the normal equation of
+     *  the measurements instead of the measurements themselves.
+     *
+     * @param normalMatrix     H' * W * H
+     * @param normalVector     H' * W * mVector
+     *
+     * @return
+     *  0 if OK
+     *  -1 if problems arose
+     *
+     * postfitResidual is not updated, since H is not available here.
+     */
+    virtual int MeasUpdateNormal(const MatrixXd &normalMatrix,
+                                 const VectorXd &normalVector)
+    noexcept(false);
+
+
     /// Destructor.
     virtual ~KalmanFilter() {};
 
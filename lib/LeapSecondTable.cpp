@@ -0,0 +1,103 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "LeapSecondTable.h"
+#include "Exception.h"
+
+#define debug 0
+
+const char *LeapSecondTable::DEFAULT_FILE = "data/Leap_Second.dat";
+
+LeapSecondTable &LeapSecondTable::instance() {
+    // 局部静态变量只初始化一次，多个线程同时第一次调用也是安全的；不释放，程序退出时仍可使用
+    static LeapSecondTable *pTable = new LeapSecondTable();
+    return *pTable;
+}
+
+LeapSecondTable::LeapSecondTable()
+        : source("built-in"), lastIndex(-1) {
+    // mjd, TAI - UTC
+    static const double builtIn[][2] = {
+            {41317.0, 10}, {41499.0, 11}, {41683.0, 12}, {42048.0, 13},
+            {42413.0, 14}, {42778.0, 15}, {43144.0, 16}, {43509.0, 17},
+            {43874.0, 18}, {44239.0, 19}, {44786.0, 20}, {45151.0, 21},
+            {45516.0, 22}, {46247.0, 23}, {47161.0, 24}, {47892.0, 25},
+            {48257.0, 26}, {48804.0, 27}, {49169.0, 28}, {49534.0, 29},
+            {50083.0, 30}, {50630.0, 31}, {51179.0, 32}, {53736.0, 33},
+            {54832.0, 34}, {56109.0, 35}, {57204.0, 36}, {57754.0, 37}
+    };
+    for (size_t i = 0; i < sizeof(builtIn) / sizeof(builtIn[0]); i++) {
+        mjds.push_back(builtIn[i][0]);
+        leapSecs.push_back(builtIn[i][1]);
+    }
+}
+
+void LeapSecondTable::loadFile(const string &file) {
+    std::ifstream strm(file.c_str());
+    if (!strm) {
+        FileMissingException e("LeapSecondTable: can't open " + file);
+        throw e;
+    }
+
+    vector<double> newMjds, newLeapSecs;
+    string line;
+    int lineNumber = 0;
+    while (std::getline(strm, line)) {
+        lineNumber++;
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+
+        std::istringstream ss(line);
+        double mjd, leapSec;
+        int day, month, year;
+        if (!(ss >> mjd >> day >> month >> year >> leapSec)) {
+            FFStreamError e("LeapSecondTable: bad record at line " + std::to_string(lineNumber) + " of " + file);
+            throw e;
+        }
+        if (!newMjds.empty() && mjd <= newMjds.back()) {
+            FFStreamError e("LeapSecondTable: records are not sorted by MJD in " + file);
+            throw e;
+        }
+        newMjds.push_back(mjd);
+        newLeapSecs.push_back(leapSec);
+    }
+    if (newMjds.empty()) {
+        FFStreamError e("LeapSecondTable: no record in " + file);
+        throw e;
+    }
+
+    mjds.swap(newMjds);
+    leapSecs.swap(newLeapSecs);
+    source = file;
+    lastIndex.store(-1, std::memory_order_relaxed);
+
+    if (debug) {
+        cout << "LeapSecondTable: " << mjds.size() << " records from " << file
+             << ", last " << mjds.back() << " " << leapSecs.back() << endl;
+    }
+}
+
+double LeapSecondTable::getLeapSeconds(double mjd) const {
+    int n = int(mjds.size());
+
+    // 先看上一次的区间
+    int i = lastIndex.load(std::memory_order_relaxed);
+    if (i >= 0 && i < n && mjds[i] <= mjd && (i + 1 == n || mjd < mjds[i + 1])) {
+        return leapSecs[i];
+    }
+
+    // 1972.1.1
+    if (mjd < mjds[0]) {
+        InvalidRequest e("Time MUST be greater than 1972 for leapSec!");
+        throw (e);
+    }
+
+    // 最后一条不大于 mjd 的记录
+    i = int(std::upper_bound(mjds.begin(), mjds.end(), mjd) - mjds.begin()) - 1;
+    lastIndex.store(i, std::memory_order_relaxed);
+    return leapSecs[i];
+}
@@ -0,0 +1,67 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_LEAPSECONDTABLE_H
+#define GNSSLAB_LEAPSECONDTABLE_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 跳秒表（TAI - UTC），供 getLeapSeconds 和 convertTimeSystem 使用
+//
+// 原来 getLeapSeconds 每次调用都新建一个 28 项的 std::map，再把所有记录遍历一遍，
+// 而 RinexNavStore::getXvt 对每颗卫星、每个历元都要转换时间系统。这里把跳秒表只建立一次：
+//  - 记录按 MJD 从小到大放在数组中，查询时二分查找 MJD 所在的区间；
+//  - 记住上一次查到的区间，下一次查询先检查这个区间，连续处理的历元几乎总在同一区间内，不需要查找；
+//  - instance() 是全局的表，初始为内置的表（到 2017.1.1 的 37 秒），不会自动读取任何文件，
+//    转换结果与进程的当前目录无关；有新的跳秒时由调用者用 loadFile 显式读取。
+//
+// 文件每行一条记录：MJD 日 月 年 TAI-UTC，例如
+//      57754.0    1  1 2017       37
+//
+// 用法：
+//      double leapSec = LeapSecondTable::instance().getLeapSeconds(ct.m_day);
+//      // 有新的跳秒时，在处理数据之前读取新的文件，文件打不开时抛出 FileMissingException
+//      LeapSecondTable::instance().loadFile(leapFile);
+//
+// 查询可以在多个线程中同时进行（上一次的区间用原子变量记录）；loadFile 不能与查询同时进行。
+class LeapSecondTable {
+public:
+    // 示例程序使用的跳秒文件，相对于当前目录；库本身不读取这个文件
+    static const char *DEFAULT_FILE;
+
+    // 全局的跳秒表，初始为内置的表
+    static LeapSecondTable &instance();
+
+    // 内置的跳秒表
+    LeapSecondTable();
+
+    // 读取跳秒文件，替换当前的表；文件打不开时抛出 FileMissingException，格式不对时抛出 FFStreamError，
+    // 出错时当前的表不变
+    void loadFile(const string &file);
+
+    // mjd 当天的 TAI - UTC（秒），早于第一条记录（1972.1.1）时抛出 InvalidRequest
+    double getLeapSeconds(double mjd) const;
+
+    size_t size() const { return mjds.size(); };
+
+    // 表的来源：文件名，或 "built-in"
+    const string &getSource() const { return source; };
+
+private:
+    LeapSecondTable(const LeapSecondTable &);
+
+    LeapSecondTable &operator=(const LeapSecondTable &);
+
+    vector<double> mjds;        // 跳秒生效的 MJD，从小到大
+    vector<double> leapSecs;    // 对应的 TAI - UTC
+    string source;
+
+    mutable std::atomic<int> lastIndex;     // 上一次查到的区间
+};
+
+#endif //GNSSLAB_LEAPSECONDTABLE_H
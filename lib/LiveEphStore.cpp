@@ -0,0 +1,180 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include "LiveEphStore.h"
+#include "TimeConvert.h"
+#include "Exception.h"
+
+#define debug 0
+
+const NavEphGPS &LiveEphStore::Snapshot::findGPSEph(const SatID &sat) const {
+    if (sat.id < 1 || sat.id > MAXGPSPRN || gpsNav[sat.id - 1].prn == 0) {
+        InvalidRequest e("LiveEphStore: no ephemeris for " + sat.toString());
+        throw (e);
+    }
+    return gpsNav[sat.id - 1];
+}
+
+const NavEphBDS &LiveEphStore::Snapshot::findBDSEph(const SatID &sat) const {
+    if (sat.id < 1 || sat.id > MAXBDSPRN || bdsNav[sat.id - 1].prn == 0) {
+        InvalidRequest e("LiveEphStore: no ephemeris for " + sat.toString());
+        throw (e);
+    }
+    return bdsNav[sat.id - 1];
+}
+
+Xvt LiveEphStore::Snapshot::getXvt(const SatID &sat, const CommonTime &epoch) const {
+    if (sat.system == "G") {
+        CommonTime realEpoch = convertTimeSystem(epoch, TimeSystem::GPS);
+        return findGPSEph(sat).svXvt(realEpoch);
+    } else if (sat.system == "C") {
+        CommonTime realEpoch = convertTimeSystem(epoch, TimeSystem::BDT);
+        return findBDSEph(sat).svXvt(realEpoch);
+    }
+    InvalidRequest e("LiveEphStore: don't support the input satellite system!");
+    throw (e);
+}
+
+LiveEphStore::Writer::Writer(LiveEphStore &store)
+        : store(store), lock(store.writeMutex),
+          pDraft(new Snapshot(*store.current.load(std::memory_order_acquire))) {
+}
+
+LiveEphStore::Writer::~Writer() {
+    delete pDraft;
+}
+
+uint64_t LiveEphStore::Writer::commit() {
+    if (pDraft == NULL) {
+        InvalidRequest e("LiveEphStore: the draft has already been committed");
+        throw (e);
+    }
+    Snapshot *pSnap = pDraft;
+    pDraft = NULL;
+    return store.publish(pSnap);
+}
+
+LiveEphStore::LiveEphStore()
+        : current(new Snapshot()), currentVersion(0), numReaders(0) {
+    for (int i = 0; i < MAX_READERS; i++) {
+        hazards[i].store(NULL, std::memory_order_relaxed);
+        slotUsed[i].store(false, std::memory_order_relaxed);
+    }
+}
+
+LiveEphStore::~LiveEphStore() {
+    for (size_t i = 0; i < retired.size(); i++) {
+        delete retired[i];
+    }
+    delete current.load();
+}
+
+int LiveEphStore::addReader() {
+    for (int reader = 0; reader < MAX_READERS; reader++) {
+        bool expected = false;
+        if (!slotUsed[reader].compare_exchange_strong(expected, true, std::memory_order_acq_rel)) continue;
+
+        // 槽号的上界只增不减，回收时检查的槽总能覆盖所有占用的槽
+        int n = numReaders.load(std::memory_order_relaxed);
+        while (n < reader + 1 && !numReaders.compare_exchange_weak(n, reader + 1, std::memory_order_seq_cst)) {
+        }
+        return reader;
+    }
+    InvalidRequest e("LiveEphStore: too many readers");
+    throw (e);
+}
+
+void LiveEphStore::removeReader(int reader) {
+    if (reader < 0 || reader >= MAX_READERS) return;
+    hazards[reader].store(NULL, std::memory_order_release);
+    slotUsed[reader].store(false, std::memory_order_release);
+}
+
+void LiveEphStore::ReaderSlot::reset(LiveEphStore *pNewStore) {
+    if (pStore != NULL) {
+        pStore->removeReader(reader);
+    }
+    pStore = NULL;
+    reader = -1;
+    if (pNewStore != NULL) {
+        reader = pNewStore->addReader();
+        pStore = pNewStore;
+    }
+}
+
+const LiveEphStore::Snapshot &LiveEphStore::acquire(int reader) {
+    // 先登记再确认：登记后 current 没有变，写的一方回收时一定能看到这个登记
+    Snapshot *pSnap = current.load(std::memory_order_acquire);
+    while (true) {
+        hazards[reader].store(pSnap, std::memory_order_seq_cst);
+        Snapshot *pNow = current.load(std::memory_order_seq_cst);
+        if (pNow == pSnap) return *pSnap;
+        pSnap = pNow;
+    }
+}
+
+void LiveEphStore::release(int reader) {
+    hazards[reader].store(NULL, std::memory_order_release);
+}
+
+uint64_t LiveEphStore::publish(Snapshot *pSnap) {
+    Snapshot *pOld = current.load(std::memory_order_relaxed);
+    pSnap->version = pOld->version + 1;
+    current.store(pSnap, std::memory_order_seq_cst);
+    currentVersion.store(pSnap->version, std::memory_order_release);
+    retired.push_back(pOld);
+
+    // 释放没有读者登记的旧快照
+    int n = std::min(numReaders.load(std::memory_order_seq_cst), int(MAX_READERS));
+    size_t m = 0;
+    for (size_t i = 0; i < retired.size(); i++) {
+        bool inUse = false;
+        for (int r = 0; r < n; r++) {
+            if (hazards[r].load(std::memory_order_seq_cst) == retired[i]) {
+                inUse = true;
+                break;
+            }
+        }
+        if (inUse) {
+            retired[m++] = retired[i];
+        } else {
+            delete retired[i];
+        }
+    }
+    retired.resize(m);
+
+    if (debug) {
+        cout << "LiveEphStore: version " << pSnap->version << ", retired " << retired.size() << endl;
+    }
+    return pSnap->version;
+}
+
+uint64_t LiveEphStore::publishGPS(const NavEphGPS &eph) {
+    if (eph.prn < 1 || eph.prn > MAXGPSPRN) {
+        InvalidRequest e("LiveEphStore: invalid GPS prn");
+        throw (e);
+    }
+    Writer writer(*this);
+    writer.draft().gpsNav[eph.prn - 1] = eph;
+    return writer.commit();
+}
+
+uint64_t LiveEphStore::publishBDS(const NavEphBDS &eph) {
+    if (eph.prn < 1 || eph.prn > MAXBDSPRN) {
+        InvalidRequest e("LiveEphStore: invalid BDS prn");
+        throw (e);
+    }
+    Writer writer(*this);
+    writer.draft().bdsNav[eph.prn - 1] = eph;
+    return writer.commit();
+}
+
+uint64_t LiveEphStore::getVersion() const {
+    // 不占用读者槽时解引用 current，发布新快照时旧快照可能已经释放
+    return currentVersion.load(std::memory_order_acquire);
+}
+
+size_t LiveEphStore::getNumRetired() const {
+    std::lock_guard<std::mutex> guard(writeMutex);
+    return retired.size();
+}
@@ -0,0 +1,175 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_LIVEEPHSTORE_H
+#define GNSSLAB_LIVEEPHSTORE_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+
+#include "GnssStruct.h"
+#include "NavEphGPS.hpp"
+#include "NavEphBDS.h"
+#include "DecodeConst.h"
+
+// 实时解码的广播星历，解码线程更新、多个求解线程同时读取
+//
+// 原来解码直接写 RinexNavStore::gpsNav/bdsNav，求解时从同一个数组读取，只能在一个线程中运行。
+// 这里按 read-copy-update 的方式管理：
+//  - 所有卫星的星历放在一个快照（Snapshot）中，快照发布后不再修改；
+//  - 解码线程用 Writer 复制当前快照作为草稿，在草稿上解码，解码到星历后 commit，
+//    用一次原子指针交换发布新快照，版本号加 1。多个解码线程的 Writer 依次进行，只有写的一方加锁；
+//  - 求解线程先占用一个读者槽（addReader），每个历元 acquire 取当前快照，整个历元都用这一份，
+//    读到的星历不会被中途替换，release 后才可能被释放。读取不加锁，只有两次原子读和一次原子写；
+//    不再读取时用 removeReader 归还槽，ReaderSlot 在析构时自动归还；
+//  - 旧快照在发布新快照时回收：没有读者槽指向它时释放，否则留到以后的发布再检查（hazard pointer）。
+//
+// 每次发布都复制整个快照（GPS 和北斗各一个 prn 数组，约 46 KB），在 x86-64 上一次 commit 约 3 us。
+// 广播星历每颗卫星一到两小时才更新一次，实时流中每秒不过几条星历电文，复制的开销可以忽略；
+// 草稿必须是完整的数组，decode_GPSEph/decode_BDSEph 才能直接在上面解码。
+// 用法：
+//      LiveEphStore liveStore;
+//      // 解码线程
+//      LiveEphStore::Writer writer(liveStore);
+//      if (decode_GPSEph(buff, writer.draft().gpsNav) == 2) writer.commit();
+//      // 求解线程
+//      spp.setLiveEphStore(&liveStore);
+//
+// 每个读者槽只能在一个线程中使用；LiveEphStore 析构时不能再有读者和写者，ReaderSlot 要先于它析构。
+class LiveEphStore {
+public:
+    static const int MAX_READERS = 64;
+
+    // 某一版本所有卫星的星历，以 prn 为索引，与 RinexNavStore::gpsNav/bdsNav 相同
+    struct Snapshot {
+        Snapshot() : version(0) {};
+
+        // prn 对应的星历，没有时抛出 InvalidRequest
+        const NavEphGPS &findGPSEph(const SatID &sat) const;
+        const NavEphBDS &findBDSEph(const SatID &sat) const;
+
+        // 与 RinexNavStore::getXvt 相同，只支持 GPS 和北斗
+        Xvt getXvt(const SatID &sat, const CommonTime &epoch) const;
+
+        uint64_t version;
+        NavEphGPS gpsNav[MAXGPSPRN];
+        NavEphBDS bdsNav[MAXBDSPRN];
+    };
+
+    // 解码线程的一次更新：构造时加写锁并复制当前快照，commit 发布草稿，
+    // 没有 commit 就析构时丢弃草稿
+    class Writer {
+    public:
+        explicit Writer(LiveEphStore &store);
+
+        ~Writer();
+
+        Snapshot &draft() { return *pDraft; };
+
+        // 发布草稿，返回新的版本号；一个 Writer 只能 commit 一次
+        uint64_t commit();
+
+    private:
+        Writer(const Writer &);
+
+        Writer &operator=(const Writer &);
+
+        LiveEphStore &store;
+        std::unique_lock<std::mutex> lock;
+        Snapshot *pDraft;
+    };
+
+    // 求解线程一个历元的读取：构造时 acquire，析构时 release
+    class ReadGuard {
+    public:
+        ReadGuard(LiveEphStore &store, int reader)
+                : store(store), reader(reader), snapshot(store.acquire(reader)) {};
+
+        ~ReadGuard() { store.release(reader); };
+
+        const Snapshot &get() const { return snapshot; };
+
+    private:
+        ReadGuard(const ReadGuard &);
+
+        ReadGuard &operator=(const ReadGuard &);
+
+        LiveEphStore &store;
+        int reader;
+        const Snapshot &snapshot;
+    };
+
+    // 读者槽的所有者：reset 时占用 pStore 的一个槽，析构或换成其他 store 时归还；
+    // 复制时另外占用一个槽，副本可以在另一个线程中使用
+    class ReaderSlot {
+    public:
+        ReaderSlot() : pStore(NULL), reader(-1) {};
+
+        ReaderSlot(const ReaderSlot &other) : pStore(NULL), reader(-1) { reset(other.pStore); };
+
+        ReaderSlot &operator=(const ReaderSlot &other) {
+            if (this != &other) reset(other.pStore);
+            return *this;
+        };
+
+        ~ReaderSlot() { reset(NULL); };
+
+        // 归还原来的槽，再占用 pNewStore 的一个槽；pNewStore 为 NULL 时只归还
+        void reset(LiveEphStore *pNewStore);
+
+        LiveEphStore *store() const { return pStore; };
+
+        int id() const { return reader; };
+
+    private:
+        LiveEphStore *pStore;
+        int reader;
+    };
+
+    LiveEphStore();
+
+    ~LiveEphStore();
+
+    // 占用一个空闲的读者槽，返回槽号；槽用完时抛出 InvalidRequest
+    int addReader();
+
+    // 归还读者槽，之后可以被 addReader 再次占用；槽上不能有未 release 的快照
+    void removeReader(int reader);
+
+    // 当前快照，release 之前不会被释放；同一个槽不能嵌套 acquire
+    const Snapshot &acquire(int reader);
+
+    void release(int reader);
+
+    // 只更新一颗卫星的星历（prn 取自星历），返回新的版本号
+    uint64_t publishGPS(const NavEphGPS &eph);
+    uint64_t publishBDS(const NavEphBDS &eph);
+
+    // 当前的版本号，没有发布过时为 0；不访问快照，可以在任何线程中调用
+    uint64_t getVersion() const;
+
+    // 已发布、还没有释放的旧快照数
+    size_t getNumRetired() const;
+
+private:
+    LiveEphStore(const LiveEphStore &);
+
+    LiveEphStore &operator=(const LiveEphStore &);
+
+    // 发布 pSnap，回收没有读者的旧快照；调用时持有写锁
+    uint64_t publish(Snapshot *pSnap);
+
+    std::atomic<Snapshot *> current;
+    std::atomic<uint64_t> currentVersion;   // current 的版本号，发布后更新；读取时不能解引用 current
+    std::atomic<const Snapshot *> hazards[MAX_READERS];
+    std::atomic<bool> slotUsed[MAX_READERS];
+    std::atomic<int> numReaders;         // 用过的槽号的上界，回收时只检查这些槽
+
+    mutable std::mutex writeMutex;
+    std::vector<Snapshot *> retired;     // 写锁保护
+};
+
+#endif //GNSSLAB_LIVEEPHSTORE_H
@@ -0,0 +1,162 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+        : pData(NULL), fileSize(0), isEmptyFile(false),
+#ifdef _WIN32
+          hFile(NULL), hMapping(NULL)
+#else
+          fd(-1)
+#endif
+{
+}
+
+MappedFile::MappedFile(const string &fileName)
+        : MappedFile() {
+    open(fileName);
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+void MappedFile::open(const string &name) {
+    close();
+    fileName = name;
+
+    HANDLE h = CreateFileA(name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (h == INVALID_HANDLE_VALUE) {
+        FileMissingException e("MappedFile: can't open file " + name);
+        throw e;
+    }
+    hFile = h;
+
+    LARGE_INTEGER len;
+    if (!GetFileSizeEx(h, &len)) {
+        close();
+        FileMissingException e("MappedFile: can't get size of " + name);
+        throw e;
+    }
+    fileSize = static_cast<size_t>(len.QuadPart);
+
+    // 空文件不能建立映射，直接当作长度为 0 的区间
+    if (fileSize == 0) {
+        isEmptyFile = true;
+        return;
+    }
+
+    HANDLE m = CreateFileMappingA(h, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m == NULL) {
+        close();
+        FileMissingException e("MappedFile: can't map file " + name);
+        throw e;
+    }
+    hMapping = m;
+
+    void *p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (p == NULL) {
+        close();
+        FileMissingException e("MappedFile: can't map file " + name);
+        throw e;
+    }
+    pData = static_cast<const char *>(p);
+}
+
+void MappedFile::close() {
+    if (pData != NULL) UnmapViewOfFile(pData);
+    if (hMapping != NULL) CloseHandle(static_cast<HANDLE>(hMapping));
+    if (hFile != NULL) CloseHandle(static_cast<HANDLE>(hFile));
+    pData = NULL;
+    hMapping = NULL;
+    hFile = NULL;
+    fileSize = 0;
+    isEmptyFile = false;
+}
+
+int64_t MappedFile::modifiedTime(const string &name) {
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!GetFileAttributesExA(name.c_str(), GetFileExInfoStandard, &attr)) {
+        FileMissingException e("MappedFile: can't get time of " + name);
+        throw e;
+    }
+    // 100 纳秒为单位
+    int64_t t = (int64_t(attr.ftLastWriteTime.dwHighDateTime) << 32) | attr.ftLastWriteTime.dwLowDateTime;
+    return t * 100;
+}
+
+#else
+
+void MappedFile::open(const string &name) {
+    close();
+    fileName = name;
+
+    fd = ::open(name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        FileMissingException e("MappedFile: can't open file " + name);
+        throw e;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close();
+        FileMissingException e("MappedFile: can't get size of " + name);
+        throw e;
+    }
+    fileSize = static_cast<size_t>(st.st_size);
+
+    // 空文件不能建立映射，直接当作长度为 0 的区间
+    if (fileSize == 0) {
+        isEmptyFile = true;
+        return;
+    }
+
+    void *p = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        close();
+        FileMissingException e("MappedFile: can't map file " + name);
+        throw e;
+    }
+    pData = static_cast<const char *>(p);
+
+    // 观测值文件是从头到尾顺序读取的，提示内核加大预读
+    madvise(p, fileSize, MADV_SEQUENTIAL);
+}
+
+void MappedFile::close() {
+    if (pData != NULL) munmap(const_cast<char *>(pData), fileSize);
+    if (fd >= 0) ::close(fd);
+    pData = NULL;
+    fd = -1;
+    fileSize = 0;
+    isEmptyFile = false;
+}
+
+int64_t MappedFile::modifiedTime(const string &name) {
+    struct stat st;
+    if (stat(name.c_str(), &st) != 0) {
+        FileMissingException e("MappedFile: can't get time of " + name);
+        throw e;
+    }
+#ifdef __APPLE__
+    return int64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    return int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+}
+
+#endif
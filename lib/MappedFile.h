@@ -0,0 +1,65 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_MAPPEDFILE_H
+#define GNSSLAB_MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+
+#include "Exception.h"
+
+using namespace std;
+
+// 只读内存映射文件
+// 把整个文件映射到进程地址空间，读取器直接在 [begin(), end()) 上用指针游标解析，
+// 不再经过 fstream/getline，也不产生逐行的 string 拷贝。
+// 文件内容由操作系统按页调入，映射在对象析构或 close() 时解除。
+class MappedFile {
+public:
+    MappedFile();
+
+    explicit MappedFile(const string &fileName);
+
+    ~MappedFile();
+
+    // 打开并映射文件，失败时抛出 FileMissingException
+    void open(const string &fileName);
+
+    void close();
+
+    bool isOpen() const { return pData != NULL || isEmptyFile; }
+
+    const char *begin() const { return pData; }
+
+    const char *end() const { return pData + fileSize; }
+
+    size_t size() const { return fileSize; }
+
+    const string &getFileName() const { return fileName; }
+
+    // 文件的修改时间（纳秒，只用于比较是否变化），文件不存在时抛出 FileMissingException
+    static int64_t modifiedTime(const string &fileName);
+
+private:
+    // 不允许拷贝，映射句柄只能有一个所有者
+    MappedFile(const MappedFile &);
+
+    MappedFile &operator=(const MappedFile &);
+
+    const char *pData;
+    size_t fileSize;
+    bool isEmptyFile;
+    string fileName;
+
+#ifdef _WIN32
+    void *hFile;
+    void *hMapping;
+#else
+    int fd;
+#endif
+};
+
+#endif //GNSSLAB_MAPPEDFILE_H
@@ -5,6 +5,8 @@
 #include <string>
 #include "NavEphBDS.h"
 
+#define debug 0
+
 using namespace std;
 
 void NavEphBDS::printData() const {
@@ -157,7 +159,7 @@ Xvt NavEphBDS::svXvt(const CommonTime& t) const
      sv.clkbias = svClockBias(t);
      sv.clkdrift = svClockDrift(t);
 
-     if (1)
+     if (debug)
      {
           cout << "关于时间的改正：" << endl;
           cout << sv.relcorr << " " << sv.clkbias << " " << sv.clkdrift << endl;
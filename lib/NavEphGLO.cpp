@@ -0,0 +1,124 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <iomanip>
+
+#include "NavEphGLO.h"
+#include "CoordStruct.h"
+
+using namespace std;
+
+const double NavEphGLO::STEP_SIZE = 60.0;
+
+namespace {
+
+    const PZ90 pz90;
+
+    // 运动方程：state 为位置、速度，acc 为日月摄动加速度，deriv 为 state 的导数
+    inline void derivative(const double state[6], const double acc[3], double deriv[6]) {
+        static const double GM = pz90.getGM();
+        static const double AE = pz90.getA();
+        static const double J2 = pz90.getJ2();
+        static const double OMGE = pz90.getOmega();
+
+        double x = state[0], y = state[1], z = state[2];
+        double r2 = x * x + y * y + z * z;
+        double r = std::sqrt(r2);
+        double mu = GM / (r2 * r);
+        double c = 1.5 * J2 * GM * AE * AE / (r2 * r2 * r);
+        double z2 = 5.0 * z * z / r2;
+
+        deriv[0] = state[3];
+        deriv[1] = state[4];
+        deriv[2] = state[5];
+        deriv[3] = (-mu - c * (1.0 - z2) + OMGE * OMGE) * x + 2.0 * OMGE * state[4] + acc[0];
+        deriv[4] = (-mu - c * (1.0 - z2) + OMGE * OMGE) * y - 2.0 * OMGE * state[3] + acc[1];
+        deriv[5] = (-mu - c * (3.0 - z2)) * z + acc[2];
+    }
+}
+
+void NavEphGLO::printData() const {
+    cout << "****************************************************************"
+         << "************" << endl
+         << "GLONASS Broadcast Ephemeris Data: " << endl;
+    cout << "Toe: " << this->CivilToe.year << " " << this->CivilToe.month << " "
+         << this->CivilToe.day << " " << this->CivilToe.hour << " "
+         << this->CivilToe.minute << " " << this->CivilToe.second << endl;
+    cout << scientific << setprecision(8)
+         << "TauN:   " << setw(16) << TauN << endl
+         << "GammaN: " << setw(16) << GammaN << endl
+         << "tk:     " << setw(16) << tk << endl;
+    cout << "X: " << setw(16) << pos[0] << setw(16) << vel[0] << setw(16) << acc[0] << endl
+         << "Y: " << setw(16) << pos[1] << setw(16) << vel[1] << setw(16) << acc[1] << endl
+         << "Z: " << setw(16) << pos[2] << setw(16) << vel[2] << setw(16) << acc[2] << endl;
+    cout << "health: " << SV_health << " freqNum: " << freqNum << " ageOfInfo: " << ageOfInfo << endl;
+}
+
+double NavEphGLO::svClockBias(const CommonTime &t) const {
+    return -TauN + GammaN * (t - ctToe);
+}
+
+double NavEphGLO::svClockDrift(const CommonTime &/*t*/) const {
+    return GammaN;
+}
+
+bool NavEphGLO::isValid(const CommonTime &ct) const {
+    if (ct < beginValid || ct > endValid) return false;
+    return true;
+}
+
+void NavEphGLO::initialState(double state[6]) const {
+    for (int i = 0; i < 3; i++) {
+        state[i] = pos[i];
+        state[i + 3] = vel[i];
+    }
+}
+
+void NavEphGLO::rk4Step(double h, double state[6]) const {
+    double k1[6], k2[6], k3[6], k4[6], w[6];
+
+    derivative(state, acc, k1);
+    for (int i = 0; i < 6; i++) w[i] = state[i] + k1[i] * h / 2.0;
+    derivative(w, acc, k2);
+    for (int i = 0; i < 6; i++) w[i] = state[i] + k2[i] * h / 2.0;
+    derivative(w, acc, k3);
+    for (int i = 0; i < 6; i++) w[i] = state[i] + k3[i] * h;
+    derivative(w, acc, k4);
+
+    for (int i = 0; i < 6; i++) {
+        state[i] += (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]) * h / 6.0;
+    }
+}
+
+Xvt NavEphGLO::toXvt(const double state[6], double dt) const {
+    Xvt sv;
+    sv.x[0] = state[0];
+    sv.x[1] = state[1];
+    sv.x[2] = state[2];
+    sv.v[0] = state[3];
+    sv.v[1] = state[4];
+    sv.v[2] = state[5];
+    sv.clkbias = -TauN + GammaN * dt;
+    sv.clkdrift = GammaN;
+
+    // GLONASS 的钟差参数中已经包含相对论效应
+    sv.relcorr = 0.0;
+    return sv;
+}
+
+Xvt NavEphGLO::svXvt(const CommonTime &t) const {
+    double dt = t - ctToe;
+    double h = (dt < 0.0) ? -STEP_SIZE : STEP_SIZE;
+    long numSteps = long(std::fabs(dt) / STEP_SIZE);
+
+    double state[6];
+    initialState(state);
+    for (long i = 0; i < numSteps; i++) {
+        rk4Step(h, state);
+    }
+    double rest = dt - numSteps * h;
+    if (rest != 0.0) {
+        rk4Step(rest, state);
+    }
+    return toXvt(state, dt);
+}
@@ -0,0 +1,87 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#pragma once
+#ifndef NAVEPHGLO_H
+#define NAVEPHGLO_H
+
+#include <cmath>
+
+#include "GnssStruct.h"
+#include "TimeStruct.h"
+
+// GLONASS 广播星历
+//
+// GLONASS 不播发轨道根数，而是播发参考时刻 toe（RINEX 中为 UTC）的位置、速度和日月摄动加速度（PZ-90，地固系），
+// 其他时刻的位置要按 ICD 的运动方程（中心引力、J2 项、地球自转，加上播发的加速度）用 4 阶 Runge-Kutta 法数值积分。
+// 积分从 toe 开始，以 STEP_SIZE 秒为步长走整步，最后用一个不足一步的步长到达查询时刻。
+//
+// svXvt 每次都从 toe 积分，查询时刻离 toe 15 分钟时要走 15 步，每步计算 4 次加速度；
+// 高采样率处理时用 GLOOrbitIntegrator，它缓存每颗卫星积分到的整步状态，从那里向前或向后继续积分，
+// 结果与 svXvt 完全相同。
+//
+// PZ-90.11 与 ITRF 的差异在厘米级，位置不做框架转换。
+class NavEphGLO {
+public:
+    /// 积分步长，秒
+    static const double STEP_SIZE;
+
+    /// Default constructor
+    NavEphGLO(void)
+            : beginValid(END_OF_TIME),
+              endValid(BEGINNING_OF_TIME) {
+        beginValid.m_timeSystem = TimeSystem::UTC;
+        endValid.m_timeSystem = TimeSystem::UTC;
+    }
+
+    /// Destructor
+    virtual ~NavEphGLO(void) {}
+
+    /// Dump the overhead information to the given output stream.
+    void printData() const;
+
+    /// Compute the satellite clock bias (seconds) at the given time
+    double svClockBias(const CommonTime &t) const;
+
+    /// Compute the satellite clock drift (sec/sec) at the given time
+    double svClockDrift(const CommonTime &t) const;
+
+    /// Compute satellite position at the given time, integrated from toe.
+    Xvt svXvt(const CommonTime &t) const;
+
+    /// Check if the ephemeris is valid at the given time.
+    bool isValid(const CommonTime &ct) const;
+
+    // 用 toe 的位置、速度（state 的前 3 个、后 3 个）初始化积分状态
+    void initialState(double state[6]) const;
+
+    // 从 state 积分 h 秒（h 可以为负）
+    void rk4Step(double h, double state[6]) const;
+
+    // 积分到的状态转为 Xvt，dt 为状态时刻与 toe 之差，秒
+    Xvt toXvt(const double state[6], double dt) const;
+
+    /// Ephemeris data
+    ///   SV/EPOCH/SV CLK
+    int prn = 0;
+    CivilTime CivilToe;              ///< Reference time (UTC)
+    double TauN = 0.0;               ///< SV clock bias (sec), RINEX 中为 -TauN
+    double GammaN = 0.0;             ///< SV relative frequency bias
+    double tk = 0.0;                 ///< Message frame time (sec of UTC day)
+
+    ///   BROADCAST ORBIT-1/2/3
+    double pos[3] = {0.0, 0.0, 0.0}; ///< Position at toe (meters, PZ-90)
+    double vel[3] = {0.0, 0.0, 0.0}; ///< Velocity at toe (m/s)
+    double acc[3] = {0.0, 0.0, 0.0}; ///< Luni-solar acceleration (m/s^2)
+    double SV_health = 0.0;          ///< Health (0 = OK, Bn)
+    double freqNum = 0.0;            ///< Frequency number (-7 ... +13)
+    double ageOfInfo = 0.0;          ///< Age of oper. information (days, En)
+
+    /// Member data
+    CommonTime ctToe;          ///< Toe in CommonTime form, UTC
+    CommonTime beginValid;     ///< Time at beginning of validity
+    CommonTime endValid;       ///< Time at end of fit validity
+
+}; // end class NavEphGLO
+
+#endif //NAVEPHGLO_H
@@ -0,0 +1,570 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <algorithm>
+#include "ObsCache.h"
+#include "RinexObsMMapReader.h"
+#include "RinexObsIndex.h"
+#include "RinexField.h"
+
+#define debug 0
+
+namespace {
+
+    const char cacheMagic[8] = {'G', 'L', 'O', 'B', 'C', '0', '0', '2'};
+
+    enum Section {
+        EpochDay = 0, EpochSod, EpochSatStart,
+        SatRecId, SatRecEpoch, SatRecObsStart,
+        ObsCode, ObsValue, ObsLLI, ObsSNR,
+        CodeTable, SatIdTable, SatSeriesStart, SatSeriesRec,
+        NumSections
+    };
+
+    struct CacheHeader {
+        char magic[8];
+        uint64_t sourceSize;
+        int64_t sourceMtime;
+        uint64_t numEpochs;
+        uint64_t numSatRecs;
+        uint64_t numObs;
+        uint64_t numCodes;
+        uint64_t numSats;
+        int32_t timeSystem;
+        int32_t reserved;
+        double version;
+        double antennaPosition[3];
+        char station[64];
+        uint64_t sectionOffsets[NumSections];
+    };
+
+    inline uint16_t satKey(char sys, int prn) {
+        return static_cast<uint16_t>((static_cast<unsigned char>(sys) << 8) | (prn & 0xff));
+    }
+
+    inline uint64_t align8(uint64_t n) {
+        return (n + 7) & ~uint64_t(7);
+    }
+
+    // 取出 pos 开始的一行，去掉行尾的 '\r'
+    inline bool nextLine(const char *&pos, const char *end,
+                         const char *&lineBegin, const char *&lineEnd) {
+        if (pos >= end) return false;
+
+        lineBegin = pos;
+        const char *nl = static_cast<const char *>(memchr(pos, '\n', end - pos));
+        if (nl == NULL) {
+            lineEnd = end;
+            pos = end;
+        } else {
+            lineEnd = nl;
+            pos = nl + 1;
+        }
+        if (lineEnd > lineBegin && *(lineEnd - 1) == '\r') --lineEnd;
+        return true;
+    }
+
+    inline unsigned char flagDigit(char c) {
+        return (c >= '0' && c <= '9') ? static_cast<unsigned char>(c - '0') : 0;
+    }
+
+    // 按列写出，每列补齐到 8 字节
+    class SectionWriter {
+    public:
+        SectionWriter(std::ostream &s, uint64_t start) : strm(s), pos(start) {}
+
+        template<typename T>
+        uint64_t write(const std::vector<T> &data) {
+            uint64_t offset = pos;
+            uint64_t bytes = data.size() * sizeof(T);
+            if (bytes > 0) {
+                strm.write(reinterpret_cast<const char *>(&data[0]), bytes);
+            }
+            static const char zeros[8] = {0};
+            uint64_t padded = align8(bytes);
+            strm.write(zeros, padded - bytes);
+            pos += padded;
+            return offset;
+        }
+
+    private:
+        std::ostream &strm;
+        uint64_t pos;
+    };
+}
+
+void ObsCacheWriter::convert(const string &rinexFile, const string &cacheFile) {
+    std::ofstream cacheStream(cacheFile.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!cacheStream) {
+        FileMissingException e("ObsCacheWriter: can't write " + cacheFile);
+        throw e;
+    }
+
+    try {
+        convert(rinexFile, cacheStream);
+        cacheStream.close();
+        if (!cacheStream) {
+            FileMissingException e("ObsCacheWriter: can't write " + cacheFile);
+            throw e;
+        }
+    } catch (BaseException &e) {
+        // 不留下写了一半的缓存文件
+        cacheStream.close();
+        std::remove(cacheFile.c_str());
+        throw;
+    }
+}
+
+void ObsCacheWriter::convert(const string &rinexFile, std::ostream &cacheStream) {
+    RinexObsMMapReader reader(rinexFile);
+    const RinexHeader &rinexHeader = reader.getHeader();
+
+    RinexObsIndex index;
+    index.build(rinexFile);
+
+    MappedFile mappedFile(rinexFile);
+    const char *begin = mappedFile.begin();
+    const char *end = mappedFile.end();
+
+    // 观测值类型编号：按文件头中系统和类型的顺序
+    std::vector<char> codeTable;
+    std::vector<uint16_t> sysCodes[128];
+    for (const auto &sysEntry: rinexHeader.mapObsTypes) {
+        unsigned char sys = static_cast<unsigned char>(sysEntry.first[0]) & 0x7f;
+        for (const auto &typeStr: sysEntry.second) {
+            sysCodes[sys].push_back(static_cast<uint16_t>(codeTable.size() / 4));
+            codeTable.push_back(static_cast<char>(sys));
+            for (int i = 0; i < 3; i++) {
+                codeTable.push_back(i < int(typeStr.size()) ? typeStr[i] : ' ');
+            }
+        }
+    }
+
+    std::vector<int64_t> epochDay;
+    std::vector<double> epochSod;
+    std::vector<uint64_t> epochSatStart;
+    std::vector<uint16_t> satRecId;
+    std::vector<uint32_t> satRecEpoch;
+    std::vector<uint64_t> satRecObsStart;
+    std::vector<uint16_t> obsCode;
+    std::vector<double> obsValue;
+    std::vector<unsigned char> obsLLI;
+    std::vector<unsigned char> obsSNR;
+    std::map<uint16_t, std::vector<uint32_t>> satSeries;
+
+    epochDay.reserve(index.size());
+    epochSod.reserve(index.size());
+    epochSatStart.reserve(index.size() + 1);
+
+    TimeSystem timeSystem;
+    const char *lb, *le, *fb, *fe;
+    for (size_t k = 0; k < index.size(); k++) {
+        const char *pos = begin + index[k].offset;
+        if (!nextLine(pos, end, lb, le)) {
+            EndOfFile err("EOF encountered!");
+            throw err;
+        }
+
+        long day;
+        double sod;
+        index[k].epoch.get(day, sod, timeSystem);
+        epochDay.push_back(day);
+        epochSod.push_back(sod);
+        epochSatStart.push_back(satRecId.size());
+
+        fieldRange(lb, le, 32, 3, fb, fe);
+        int numSats = rinexStoi(fb, fe);
+        for (int isv = 0; isv < numSats; ++isv) {
+            if (!nextLine(pos, end, lb, le)) {
+                EndOfFile err("EOF encountered!");
+                throw err;
+            }
+
+            fieldRange(lb, le, 1, 2, fb, fe);
+            if (fe - fb != 2 ||
+                (!isdigit(static_cast<unsigned char>(fb[0])) && fb[0] != ' ') ||
+                !isdigit(static_cast<unsigned char>(fb[1]))) {
+                FFStreamError e("Bad satellite id: >" + string(lb, le) + "<");
+                throw e;
+            }
+
+            // 文件头中没有观测值类型的系统无法解码，跳过
+            const std::vector<uint16_t> &codes = sysCodes[static_cast<unsigned char>(lb[0]) & 0x7f];
+            if (codes.empty()) continue;
+
+            uint16_t key = satKey(lb[0], rinexStoi(fb, fe));
+            satSeries[key].push_back(static_cast<uint32_t>(satRecId.size()));
+            satRecId.push_back(key);
+            satRecEpoch.push_back(static_cast<uint32_t>(k));
+            satRecObsStart.push_back(obsCode.size());
+
+            for (size_t i = 0; i < codes.size(); ++i) {
+                fieldRange(lb, le, 3 + 16 * i, 16, fb, fe);
+                if (isBlankField(fb, fe)) continue;
+
+                fieldRange(lb, le, 3 + 16 * i, 14, fb, fe);
+                obsCode.push_back(codes[i]);
+                obsValue.push_back(rinexStod(fb, fe));
+                obsLLI.push_back(flagDigit(fieldChar(lb, le, 3 + 16 * i + 14)));
+                obsSNR.push_back(flagDigit(fieldChar(lb, le, 3 + 16 * i + 15)));
+            }
+        }
+    }
+    epochSatStart.push_back(satRecId.size());
+    satRecObsStart.push_back(obsCode.size());
+
+    std::vector<uint16_t> satTable;
+    std::vector<uint64_t> satSeriesStart;
+    std::vector<uint32_t> satSeriesRec;
+    satSeriesRec.reserve(satRecId.size());
+    for (const auto &entry: satSeries) {
+        satTable.push_back(entry.first);
+        satSeriesStart.push_back(satSeriesRec.size());
+        satSeriesRec.insert(satSeriesRec.end(), entry.second.begin(), entry.second.end());
+    }
+    satSeriesStart.push_back(satSeriesRec.size());
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.sourceSize = mappedFile.size();
+    header.sourceMtime = MappedFile::modifiedTime(rinexFile);
+    header.numEpochs = epochDay.size();
+    header.numSatRecs = satRecId.size();
+    header.numObs = obsCode.size();
+    header.numCodes = codeTable.size() / 4;
+    header.numSats = satTable.size();
+    header.timeSystem = static_cast<int32_t>(timeSystem.system);
+    header.version = rinexHeader.version;
+    for (int i = 0; i < 3; i++) {
+        header.antennaPosition[i] = rinexHeader.antennaPosition[i];
+    }
+    strncpy(header.station, rinexHeader.station.c_str(), sizeof(header.station) - 1);
+
+    // 先占位写文件头，各列写完后再回填偏移
+    cacheStream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    SectionWriter writer(cacheStream, sizeof(header));
+    header.sectionOffsets[EpochDay] = writer.write(epochDay);
+    header.sectionOffsets[EpochSod] = writer.write(epochSod);
+    header.sectionOffsets[EpochSatStart] = writer.write(epochSatStart);
+    header.sectionOffsets[SatRecId] = writer.write(satRecId);
+    header.sectionOffsets[SatRecEpoch] = writer.write(satRecEpoch);
+    header.sectionOffsets[SatRecObsStart] = writer.write(satRecObsStart);
+    header.sectionOffsets[ObsCode] = writer.write(obsCode);
+    header.sectionOffsets[ObsValue] = writer.write(obsValue);
+    header.sectionOffsets[ObsLLI] = writer.write(obsLLI);
+    header.sectionOffsets[ObsSNR] = writer.write(obsSNR);
+    header.sectionOffsets[CodeTable] = writer.write(codeTable);
+    header.sectionOffsets[SatIdTable] = writer.write(satTable);
+    header.sectionOffsets[SatSeriesStart] = writer.write(satSeriesStart);
+    header.sectionOffsets[SatSeriesRec] = writer.write(satSeriesRec);
+
+    cacheStream.seekp(0);
+    cacheStream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!cacheStream) {
+        FileMissingException e("ObsCacheWriter: can't write the cache of " + rinexFile);
+        throw e;
+    }
+
+    if (debug)
+        cout << "ObsCacheWriter: " << header.numEpochs << " epochs, " << header.numSatRecs
+             << " sat records, " << header.numObs << " obs from " << rinexFile << endl;
+}
+
+ObsCacheReader::ObsCacheReader()
+        : pImage(NULL), imageSize(0), sourceSize(0), sourceMtime(0), numEpochs(0), numSatRecs(0), numObs(0), numCodes(0), numSats(0),
+          currEpoch(0) {
+}
+
+ObsCacheReader::ObsCacheReader(const string &cacheFile)
+        : ObsCacheReader() {
+    open(cacheFile);
+}
+
+void ObsCacheReader::open(const string &cacheFile) {
+    close();
+    mappedFile.open(cacheFile);
+    pImage = mappedFile.begin();
+    imageSize = mappedFile.size();
+    attach(cacheFile);
+}
+
+void ObsCacheReader::close() {
+    mappedFile.close();
+    std::vector<uint64_t>().swap(memImage);
+    pImage = NULL;
+    imageSize = 0;
+    numEpochs = numSatRecs = numObs = numCodes = numSats = 0;
+    currEpoch = 0;
+}
+
+// 检查 [pImage, pImage + imageSize) 中的缓存并读出文件头，name 只用于出错信息
+void ObsCacheReader::attach(const string &name) {
+    currEpoch = 0;
+
+    CacheHeader header;
+    if (imageSize < sizeof(header)) {
+        FFStreamError e("ObsCacheReader: bad cache file " + name);
+        throw e;
+    }
+    memcpy(&header, pImage, sizeof(header));
+    if (memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0) {
+        FFStreamError e("ObsCacheReader: bad cache file " + name);
+        throw e;
+    }
+
+    sourceSize = header.sourceSize;
+    sourceMtime = header.sourceMtime;
+    numEpochs = header.numEpochs;
+    numSatRecs = header.numSatRecs;
+    numObs = header.numObs;
+    numCodes = header.numCodes;
+    numSats = header.numSats;
+    timeSystem = TimeSystem(static_cast<TimeSystem::SystemType>(header.timeSystem));
+    sectionOffsets.assign(header.sectionOffsets, header.sectionOffsets + NumSections);
+
+    // 每一列都必须完整地落在文件内，先排除会使下面的乘法溢出的数目
+    if (numEpochs > imageSize || numSatRecs > imageSize || numObs > imageSize ||
+        numCodes > imageSize || numSats > imageSize) {
+        FFStreamError e("ObsCacheReader: truncated cache file " + name);
+        throw e;
+    }
+    const uint64_t sectionBytes[NumSections] = {
+            numEpochs * 8, numEpochs * 8, (numEpochs + 1) * 8,
+            numSatRecs * 2, numSatRecs * 4, (numSatRecs + 1) * 8,
+            numObs * 2, numObs * 8, numObs, numObs,
+            numCodes * 4, numSats * 2, (numSats + 1) * 8, numSatRecs * 4
+    };
+    for (int i = 0; i < NumSections; i++) {
+        if (sectionOffsets[i] % 8 != 0 ||
+            sectionOffsets[i] > imageSize ||
+            sectionBytes[i] > imageSize - sectionOffsets[i]) {
+            FFStreamError e("ObsCacheReader: truncated cache file " + name);
+            throw e;
+        }
+    }
+
+    // 解码时直接用这些编号取下标，载入时逐个检查，损坏的缓存不会越界访问
+    bool badIndex = false;
+    const uint16_t *obsCode = column<uint16_t>(ObsCode);
+    for (size_t o = 0; o < numObs; o++) {
+        if (obsCode[o] >= numCodes) badIndex = true;
+    }
+    const uint64_t *epochSatStart = column<uint64_t>(EpochSatStart);
+    for (size_t k = 0; k < numEpochs; k++) {
+        if (epochSatStart[k] > epochSatStart[k + 1]) badIndex = true;
+    }
+    if (epochSatStart[numEpochs] != numSatRecs) badIndex = true;
+    const uint64_t *satRecObsStart = column<uint64_t>(SatRecObsStart);
+    const uint32_t *satRecEpoch = column<uint32_t>(SatRecEpoch);
+    for (size_t r = 0; r < numSatRecs; r++) {
+        if (satRecObsStart[r] > satRecObsStart[r + 1] || satRecEpoch[r] >= numEpochs) badIndex = true;
+    }
+    if (satRecObsStart[numSatRecs] != numObs) badIndex = true;
+    const uint64_t *satSeriesStart = column<uint64_t>(SatSeriesStart);
+    const uint32_t *satSeriesRec = column<uint32_t>(SatSeriesRec);
+    for (size_t s = 0; s < numSats; s++) {
+        if (satSeriesStart[s] > satSeriesStart[s + 1]) badIndex = true;
+    }
+    if (satSeriesStart[numSats] > numSatRecs) badIndex = true;
+    for (size_t k = 0; k < numSatRecs; k++) {
+        if (satSeriesRec[k] >= numSatRecs) badIndex = true;
+    }
+    if (badIndex) {
+        FFStreamError e("ObsCacheReader: bad index in cache file " + name);
+        throw e;
+    }
+
+    rinexHeader = RinexHeader();
+    rinexHeader.station = string(header.station, strnlen(header.station, sizeof(header.station)));
+    rinexHeader.version = header.version;
+    for (int i = 0; i < 3; i++) {
+        rinexHeader.antennaPosition[i] = header.antennaPosition[i];
+    }
+    const char *codes = column<char>(CodeTable);
+    for (size_t c = 0; c < numCodes; c++) {
+        rinexHeader.mapObsTypes[string(1, codes[4 * c])].push_back(string(codes + 4 * c + 1, 3));
+    }
+
+    compileCodes();
+}
+
+void ObsCacheReader::openOrConvert(const string &rinexFile) {
+    string cacheFile = ObsCacheWriter::cacheName(rinexFile);
+
+    uint64_t rinexSize;
+    {
+        MappedFile rinex(rinexFile);
+        rinexSize = rinex.size();
+    }
+    int64_t rinexMtime = MappedFile::modifiedTime(rinexFile);
+
+    // 大小和修改时间都相同才认为缓存是这个文件的
+    try {
+        open(cacheFile);
+        if (sourceSize == rinexSize && sourceMtime == rinexMtime) return;
+    } catch (BaseException &e) {
+        if (debug)
+            cout << "ObsCacheReader: " << e.what() << endl;
+    }
+
+    close();
+    try {
+        ObsCacheWriter::convert(rinexFile, cacheFile);
+        open(cacheFile);
+        return;
+    } catch (FileMissingException &e) {
+        // 缓存写不了（只读目录、磁盘已满）时不影响处理，改为在内存中转换
+        cerr << e.what() << endl;
+    }
+
+    close();
+    string image;
+    {
+        std::ostringstream strm(ios::out | ios::binary);
+        ObsCacheWriter::convert(rinexFile, strm);
+        image = strm.str();
+    }
+    // 用 uint64_t 数组存放，保证各列 8 字节对齐
+    memImage.assign((image.size() + 7) / 8, 0);
+    if (!image.empty()) memcpy(&memImage[0], image.data(), image.size());
+    pImage = reinterpret_cast<const char *>(memImage.data());
+    imageSize = image.size();
+    attach(rinexFile + " (in memory)");
+}
+
+void ObsCacheReader::setSelectedTypes(std::map<string, std::set<string>> &systemTypes) {
+    sysTypes = systemTypes;
+    compileCodes();
+}
+
+// 预先算好每个观测值类型的换算系数和是否输出，解码时只需查表
+void ObsCacheReader::compileCodes() {
+    codeType.assign(numCodes, string());
+    codeScale.assign(numCodes, 0.0);
+    codeKeep.assign(numCodes, 0);
+
+    if (pImage == NULL) return;
+
+    const char *codes = column<char>(CodeTable);
+    for (size_t c = 0; c < numCodes; c++) {
+        string sys(1, codes[4 * c]);
+        codeType[c] = string(codes + 4 * c + 1, 3);
+
+        // 与 RinexObsReader 一致，只保留 G/C
+        if (sys != "G" && sys != "C") continue;
+
+        codeScale[c] = RinexObsMMapReader::obsScale(sys, codeType[c]);
+
+        auto itSys = sysTypes.find(sys);
+        codeKeep[c] = (codeScale[c] != 0.0 && itSys != sysTypes.end() &&
+                       itSys->second.find(codeType[c]) != itSys->second.end());
+    }
+}
+
+CommonTime ObsCacheReader::getEpoch(size_t i) const {
+    return CommonTime(static_cast<long>(column<int64_t>(EpochDay)[i]),
+                      column<double>(EpochSod)[i], timeSystem);
+}
+
+ObsData ObsCacheReader::parseRinexObs() {
+    if (currEpoch >= numEpochs) {
+        EndOfFile err("EOF encountered!");
+        throw err;
+    }
+    return getEpochData(currEpoch++);
+}
+
+ObsData ObsCacheReader::getEpochData(size_t i) const {
+    const uint64_t *epochSatStart = column<uint64_t>(EpochSatStart);
+    const uint16_t *satRecId = column<uint16_t>(SatRecId);
+    const uint64_t *satRecObsStart = column<uint64_t>(SatRecObsStart);
+    const uint16_t *obsCode = column<uint16_t>(ObsCode);
+    const double *obsValue = column<double>(ObsValue);
+
+    SatTypeValueMap stvData;
+    for (uint64_t r = epochSatStart[i]; r < epochSatStart[i + 1]; r++) {
+        TypeValueMap typeObs;
+        for (uint64_t o = satRecObsStart[r]; o < satRecObsStart[r + 1]; o++) {
+            uint16_t c = obsCode[o];
+            if (!codeKeep[c]) continue;
+
+            double data = obsValue[o] * codeScale[c];
+
+            // 观测值异常
+            if (std::abs(data) == 0.0) {
+                continue;
+            }
+
+            typeObs[codeType[c]] = data;
+        }
+
+        if (!typeObs.empty()) {
+            SatID sat;
+            sat.system = string(1, static_cast<char>(satRecId[r] >> 8));
+            sat.id = satRecId[r] & 0xff;
+            stvData[sat] = std::move(typeObs);
+        }
+    }
+
+    ObsData obsData;
+    obsData.station = rinexHeader.station;
+    obsData.epoch = getEpoch(i);
+    obsData.satTypeValueData = std::move(stvData);
+    obsData.antennaPosition = rinexHeader.antennaPosition;
+    return obsData;
+}
+
+bool ObsCacheReader::getSatSeries(const SatID &sat, const string &type,
+                                  std::vector<ObsSample> &series) const {
+    series.clear();
+    if (sat.system.empty() || pImage == NULL) return false;
+
+    // 卫星表按编码排序，二分查找
+    uint16_t key = satKey(sat.system[0], sat.id);
+    const uint16_t *satTable = column<uint16_t>(SatIdTable);
+    const uint16_t *it = std::lower_bound(satTable, satTable + numSats, key);
+    if (it == satTable + numSats || *it != key) return false;
+    size_t s = it - satTable;
+
+    const char *codes = column<char>(CodeTable);
+    size_t c = 0;
+    for (; c < numCodes; c++) {
+        if (codes[4 * c] == sat.system[0] && type.size() == 3 &&
+            memcmp(type.data(), codes + 4 * c + 1, 3) == 0) {
+            break;
+        }
+    }
+    if (c == numCodes) return false;
+
+    const uint64_t *satSeriesStart = column<uint64_t>(SatSeriesStart);
+    const uint32_t *satSeriesRec = column<uint32_t>(SatSeriesRec);
+    const uint32_t *satRecEpoch = column<uint32_t>(SatRecEpoch);
+    const uint64_t *satRecObsStart = column<uint64_t>(SatRecObsStart);
+    const uint16_t *obsCode = column<uint16_t>(ObsCode);
+    const double *obsValue = column<double>(ObsValue);
+    const unsigned char *obsLLI = column<unsigned char>(ObsLLI);
+    const unsigned char *obsSNR = column<unsigned char>(ObsSNR);
+
+    series.reserve(satSeriesStart[s + 1] - satSeriesStart[s]);
+    for (uint64_t k = satSeriesStart[s]; k < satSeriesStart[s + 1]; k++) {
+        uint32_t r = satSeriesRec[k];
+        for (uint64_t o = satRecObsStart[r]; o < satRecObsStart[r + 1]; o++) {
+            if (obsCode[o] != c) continue;
+
+            ObsSample sample;
+            sample.epoch = getEpoch(satRecEpoch[r]);
+            sample.value = obsValue[o];
+            sample.lli = obsLLI[o];
+            sample.snr = obsSNR[o];
+            series.push_back(sample);
+            break;
+        }
+    }
+    return true;
+}
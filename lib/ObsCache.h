@@ -0,0 +1,134 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_OBSCACHE_H
+#define GNSSLAB_OBSCACHE_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <stdint.h>
+
+#include "GnssStruct.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+// 观测值二进制缓存（列存储）
+//
+// 同一个 RINEX 文件常常要用不同的解算设置反复处理，每次都要重新解析文本。
+// ObsCacheWriter 把 RINEX 3 观测值文件中的全部观测值（所有系统、所有类型，
+// 保持 RINEX 中的原始数值，载波相位仍以周为单位）连同 LLI 和信号强度写成二进制文件，
+// ObsCacheReader 映射该文件，按与 RinexObsReader 相同的规则
+// （只保留 G/C、载波相位换算为米、剔除零值、按 setSelectedTypes 选择）产生 ObsData，
+// 结果与文本读取器逐位相同。
+//
+// 文件按列组织，所有数组 8 字节对齐，可直接在映射内存上访问：
+//   历元列      epochDay[int64], epochSod[double], epochSatStart[uint64, nEpoch+1]
+//   卫星记录列  satRecId[uint16], satRecEpoch[uint32], satRecObsStart[uint64, nSatRec+1]
+//   观测值列    obsCode[uint16], obsValue[double], obsLLI[uint8], obsSNR[uint8]
+//   观测值类型  codeTable[nCode][4]，每项为 系统字符 + 3 位类型，如 "GL1C"
+//   卫星序列    satTable[uint16], satSeriesStart[uint64, nSat+1], satSeriesRec[uint32]
+// 卫星标识编码为 (系统字符 << 8) | PRN，排序与 SatID 一致。
+// 卫星序列列按卫星列出它出现的全部卫星记录，单颗卫星的时间序列不需要解码整个历元。
+// 文件使用本机字节序，只用作本机的缓存。文件头记录 RINEX 文件的大小和修改时间，
+// 两者都一致时才认为缓存有效。
+class ObsCacheWriter {
+public:
+    // 把 RINEX 3 观测值文件转换为缓存文件，失败时抛出 FileMissingException / FFStreamError
+    // 写失败时删除不完整的缓存文件
+    static void convert(const string &rinexFile, const string &cacheFile);
+
+    // 转换结果写到流中，流必须支持 seekp
+    static void convert(const string &rinexFile, std::ostream &cacheStream);
+
+    // 缓存文件的默认文件名
+    static string cacheName(const string &rinexFile) {
+        return rinexFile + ".obc";
+    }
+};
+
+// 单颗卫星某一观测值类型的一个采样
+struct ObsSample {
+    CommonTime epoch;
+    double value;          // RINEX 原始数值，载波相位单位为周
+    unsigned char lli;     // 失锁标识，空白为 0
+    unsigned char snr;     // 信号强度，空白为 0
+};
+
+class ObsCacheReader {
+public:
+    ObsCacheReader();
+
+    explicit ObsCacheReader(const string &cacheFile);
+
+    // 映射缓存文件，文件不存在或格式不对时抛出 FileMissingException / FFStreamError
+    void open(const string &cacheFile);
+
+    // 缓存文件存在且与 rinexFile 对应（文件大小和修改时间一致）时直接打开，否则先转换；
+    // 缓存文件写不了时给出提示，在内存中转换，读取结果相同
+    void openOrConvert(const string &rinexFile);
+
+    void close();
+
+    void setSelectedTypes(std::map<string, std::set<string>> &systemTypes);
+
+    // 按顺序返回下一个历元，读完后抛出 EndOfFile
+    ObsData parseRinexObs();
+
+    // 第 i 个历元，不改变读取位置
+    ObsData getEpochData(size_t i) const;
+
+    size_t getNumEpochs() const { return numEpochs; }
+
+    CommonTime getEpoch(size_t i) const;
+
+    // 单颗卫星某一观测值类型的时间序列，没有该卫星或类型时返回 false
+    bool getSatSeries(const SatID &sat, const string &type,
+                      std::vector<ObsSample> &series) const;
+
+    const RinexHeader &getHeader() const { return rinexHeader; }
+
+    size_t getFileSize() const { return imageSize; }
+
+    ~ObsCacheReader() {};
+
+private:
+    template<typename T>
+    const T *column(int i) const {
+        return reinterpret_cast<const T *>(pImage + sectionOffsets[i]);
+    }
+
+    void attach(const string &name);
+
+    void compileCodes();
+
+    // 缓存内容：映射的缓存文件，或写不了缓存文件时在内存中转换的结果
+    MappedFile mappedFile;
+    std::vector<uint64_t> memImage;
+    const char *pImage;
+    size_t imageSize;
+
+    RinexHeader rinexHeader;
+    std::map<string, std::set<string>> sysTypes;
+    TimeSystem timeSystem;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+
+    size_t numEpochs;
+    size_t numSatRecs;
+    size_t numObs;
+    size_t numCodes;
+    size_t numSats;
+    std::vector<uint64_t> sectionOffsets;
+
+    // 每个观测值类型编号对应的类型名、换算系数，以及是否输出
+    std::vector<string> codeType;
+    std::vector<double> codeScale;
+    std::vector<char> codeKeep;
+
+    size_t currEpoch;
+};
+
+#endif //GNSSLAB_OBSCACHE_H
@@ -0,0 +1,200 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <algorithm>
+#include <stdexcept>
+#include "ObsEpoch.h"
+
+#define debug 0
+
+//---------------
+// ObsCodeTable
+//---------------
+string ObsCodeTable::names[ObsCodeTable::maxCodes];
+char ObsCodeTable::bandChars[ObsCodeTable::maxCodes];
+std::atomic<int> ObsCodeTable::numCodes(0);
+
+std::mutex &ObsCodeTable::mutex() {
+    static std::mutex m;
+    return m;
+}
+
+int ObsCodeTable::intern(const string &code) {
+    int found = find(code);
+    if (found >= 0) return found;
+
+    std::lock_guard<std::mutex> lock(mutex());
+    int n = numCodes.load(std::memory_order_relaxed);
+    for (int i = 0; i < n; i++) {
+        if (names[i] == code) return i;
+    }
+    if (n == maxCodes) {
+        return -1;
+    }
+    names[n] = code;
+    bandChars[n] = (code.size() >= 2) ? code[1] : ' ';
+    numCodes.store(n + 1, std::memory_order_release);
+    return n;
+}
+
+// 不加锁：names[i] 在 numCodes 增加之前写好且以后不再修改，acquire 读到 n 后前 n 项都已可见
+int ObsCodeTable::find(const string &code) {
+    int n = numCodes.load(std::memory_order_acquire);
+    for (int i = 0; i < n; i++) {
+        if (names[i] == code) return i;
+    }
+    return -1;
+}
+
+const string &ObsCodeTable::name(int code) {
+    return names[code];
+}
+
+int ObsCodeTable::size() {
+    return numCodes.load(std::memory_order_acquire);
+}
+
+//---------------
+// ObsEpoch
+//---------------
+ObsEpoch::ObsEpoch()
+        : ObsEpoch(64) {
+}
+
+ObsEpoch::ObsEpoch(size_t rowCapacity)
+        : antennaPosition(0.0, 0.0, 0.0),
+          rowCapacity(std::max<size_t>(rowCapacity, 1)), numRows(0), codeMask(0),
+          sats(this->rowCapacity), masks(this->rowCapacity, 0),
+          values(ObsCodeTable::maxCodes * this->rowCapacity, 0.0),
+          llis(ObsCodeTable::maxCodes * this->rowCapacity, 0),
+          snrs(ObsCodeTable::maxCodes * this->rowCapacity, 0),
+          rowOf(PackedSat::numSats, -1) {
+}
+
+void ObsEpoch::clear() {
+    // 只清理用过的列
+    for (int code = 0; code < ObsCodeTable::maxCodes; code++) {
+        if (!((codeMask >> code) & 1)) continue;
+        size_t i = size_t(code) * rowCapacity;
+        std::fill(values.begin() + i, values.begin() + i + numRows, 0.0);
+        std::fill(llis.begin() + i, llis.begin() + i + numRows, 0);
+        std::fill(snrs.begin() + i, snrs.begin() + i + numRows, 0);
+    }
+    for (size_t row = 0; row < numRows; row++) {
+        rowOf[sats[row].ordinal()] = -1;
+        masks[row] = 0;
+    }
+    numRows = 0;
+    codeMask = 0;
+}
+
+int ObsEpoch::addSat(const PackedSat &sat) {
+    int16_t &row = rowOf[sat.ordinal()];
+    if (row >= 0) {
+        return row;
+    }
+    if (numRows == rowCapacity) {
+        growRows();
+    }
+    row = int16_t(numRows);
+    sats[numRows] = sat;
+    masks[numRows] = 0;
+    numRows++;
+    return row;
+}
+
+void ObsEpoch::eraseSat(int row) {
+    size_t last = numRows - 1;
+    rowOf[sats[row].ordinal()] = -1;
+    for (int code = 0; code < ObsCodeTable::maxCodes; code++) {
+        if (!((codeMask >> code) & 1)) continue;
+        size_t i = size_t(code) * rowCapacity;
+        values[i + row] = values[i + last];
+        llis[i + row] = llis[i + last];
+        snrs[i + row] = snrs[i + last];
+        values[i + last] = 0.0;
+        llis[i + last] = 0;
+        snrs[i + last] = 0;
+    }
+    if (size_t(row) != last) {
+        sats[row] = sats[last];
+        masks[row] = masks[last];
+        rowOf[sats[row].ordinal()] = int16_t(row);
+    }
+    masks[last] = 0;
+    numRows--;
+}
+
+// 行容量加倍，各列按新的行容量重新排列
+void ObsEpoch::growRows() {
+    size_t newCapacity = rowCapacity * 2;
+    std::vector<double> newValues(ObsCodeTable::maxCodes * newCapacity, 0.0);
+    std::vector<uint8_t> newLlis(ObsCodeTable::maxCodes * newCapacity, 0);
+    std::vector<uint8_t> newSnrs(ObsCodeTable::maxCodes * newCapacity, 0);
+    for (int code = 0; code < ObsCodeTable::maxCodes; code++) {
+        if (!((codeMask >> code) & 1)) continue;
+        size_t i = size_t(code) * rowCapacity, j = size_t(code) * newCapacity;
+        std::copy(values.begin() + i, values.begin() + i + numRows, newValues.begin() + j);
+        std::copy(llis.begin() + i, llis.begin() + i + numRows, newLlis.begin() + j);
+        std::copy(snrs.begin() + i, snrs.begin() + i + numRows, newSnrs.begin() + j);
+    }
+    values.swap(newValues);
+    llis.swap(newLlis);
+    snrs.swap(newSnrs);
+    sats.resize(newCapacity);
+    masks.resize(newCapacity, 0);
+    rowCapacity = newCapacity;
+}
+
+double ObsEpoch::SatView::at(const string &type) const {
+    int code = ObsCodeTable::find(type);
+    if (code < 0 || !pEpoch->has(row, code)) {
+        throw std::out_of_range("ObsEpoch::SatView::at: no " + type);
+    }
+    return pEpoch->value(row, code);
+}
+
+size_t ObsEpoch::SatView::count(const string &type) const {
+    int code = ObsCodeTable::find(type);
+    return (code >= 0 && pEpoch->has(row, code)) ? 1 : 0;
+}
+
+void ObsEpoch::toObsData(ObsData &obsData) const {
+    obsData.station = station;
+    obsData.epoch = epoch;
+    obsData.antennaPosition = antennaPosition;
+    obsData.satTypeValueData.clear();
+    for (size_t row = 0; row < numRows; row++) {
+        TypeValueMap &typeObs = obsData.satTypeValueData[sats[row].toSatID()];
+        uint64_t mask = masks[row];
+        for (int code = 0; mask != 0; code++, mask >>= 1) {
+            if (mask & 1) {
+                typeObs[ObsCodeTable::name(code)] = value(int(row), code);
+            }
+        }
+    }
+}
+
+ObsData ObsEpoch::toObsData() const {
+    ObsData obsData;
+    toObsData(obsData);
+    return obsData;
+}
+
+void ObsEpoch::fromObsData(const ObsData &obsData) {
+    clear();
+    station = obsData.station;
+    epoch = obsData.epoch;
+    antennaPosition = obsData.antennaPosition;
+    for (const auto &stv: obsData.satTypeValueData) {
+        int row = addSat(PackedSat(stv.first));
+        for (const auto &tv: stv.second) {
+            int code = ObsCodeTable::intern(tv.first);
+            if (code < 0) {
+                InvalidRequest e("ObsEpoch: too many observation types, " + tv.first);
+                throw e;
+            }
+            set(row, code, tv.second);
+        }
+    }
+}
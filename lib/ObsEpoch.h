@@ -0,0 +1,178 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_OBSEPOCH_H
+#define GNSSLAB_OBSEPOCH_H
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+#include "GnssStruct.h"
+#include "SatIndex.h"
+#include "SignalCatalog.h"
+
+// 观测值类型（"C1C"、"L2W" 等）的全局编号表
+//
+// 同一个类型名在整个程序中只有一个编号，与卫星系统无关；编号从 0 开始连续分配，
+// 最多 maxCodes 个，作为 ObsEpoch 中的列号和观测值掩码的位号。
+// 这是观测值类型唯一的一套编号，频率、波长和组合系数由 band(code, sys) 得到 SignalCatalog 的频点后查表。
+// intern 只在编译选择列表时调用，分配新编号时加锁；find 和 name 不加锁，可以在任意线程中调用。
+class ObsCodeTable {
+public:
+    static const int maxCodes = 64;
+
+    // 返回类型名的编号，没有时分配一个新编号；编号用完时返回 -1
+    static int intern(const string &code);
+
+    // 返回类型名的编号，没有时返回 -1
+    static int find(const string &code);
+
+    static const string &name(int code);
+
+    // 类型名第二个字符表示的频点在 sys 系统中的 SignalCatalog 频点编号，没有该频点时返回 -1
+    static int band(int code, char sys) {
+        return SignalCatalog::bandId(sys, bandChars[code]);
+    }
+
+    static int size();
+
+private:
+    static std::mutex &mutex();
+
+    static string names[maxCodes];
+    static char bandChars[maxCodes];
+    static std::atomic<int> numCodes;
+};
+
+// 一个历元的观测值，按列（structure of arrays）存放
+//
+// 卫星按加入顺序排成行，每个观测值类型按 ObsCodeTable 的编号占一列：
+//  - 第 code 列的观测值是连续的 numSats() 个 double，column(code) 直接给出首地址；
+//  - 每颗卫星一个 64 位掩码，第 code 位表示该类型是否有观测值，缺失的观测值为 0；
+//  - LLI 和信号强度（SSI）与观测值同样按列存放，空白为 0；
+//  - 卫星到行号的映射按 PackedSat 的序号直接索引，查找卫星是一次数组访问。
+// clear() 只把用过的行和列清零，不释放内存；同一个 ObsEpoch 对象在多个历元间重复使用时，
+// 除了卫星数超过行容量时的扩容，不再分配内存。
+//
+// 为了逐步迁移现有算法，toObsData/fromObsData 与 ObsData 互相转换，
+// view(row) 提供与 TypeValueMap 相同的 at/count 接口。
+class ObsEpoch {
+public:
+    ObsEpoch();
+
+    explicit ObsEpoch(size_t rowCapacity);
+
+    // 清空卫星和观测值，保留已分配的内存
+    void clear();
+
+    // 加入卫星并返回行号，卫星已存在时返回原来的行号，卫星无效时抛出 InvalidRequest
+    int addSat(const PackedSat &sat);
+
+    // 卫星所在行号，不存在或卫星无效时返回 -1
+    int findSat(const PackedSat &sat) const {
+        return sat.isValid() ? rowOf[sat.ordinal()] : -1;
+    }
+
+    bool contains(const PackedSat &sat) const {
+        return findSat(sat) >= 0;
+    }
+
+    // 删除一行，最后一行移到被删除的位置
+    void eraseSat(int row);
+
+    size_t numSats() const { return numRows; }
+
+    bool empty() const { return numRows == 0; }
+
+    PackedSat sat(int row) const { return sats[row]; }
+
+    void set(int row, int code, double value, uint8_t lli = 0, uint8_t snr = 0) {
+        size_t i = size_t(code) * rowCapacity + row;
+        values[i] = value;
+        llis[i] = lli;
+        snrs[i] = snr;
+        masks[row] |= uint64_t(1) << code;
+        codeMask |= uint64_t(1) << code;
+    }
+
+    bool has(int row, int code) const {
+        return (masks[row] >> code) & 1;
+    }
+
+    double value(int row, int code) const {
+        return values[size_t(code) * rowCapacity + row];
+    }
+
+    uint8_t lli(int row, int code) const {
+        return llis[size_t(code) * rowCapacity + row];
+    }
+
+    uint8_t snr(int row, int code) const {
+        return snrs[size_t(code) * rowCapacity + row];
+    }
+
+    // 第 code 列的观测值，共 numSats() 个，缺失为 0
+    const double *column(int code) const {
+        return &values[size_t(code) * rowCapacity];
+    }
+
+    // 第 row 颗卫星有哪些类型的观测值
+    uint64_t obsMask(int row) const { return masks[row]; }
+
+    // 本历元用到的类型
+    uint64_t getCodeMask() const { return codeMask; }
+
+    // 兼容旧接口：以类型名访问一颗卫星的观测值
+    class SatView {
+    public:
+        SatView(const ObsEpoch *pEpoch, int row) : pEpoch(pEpoch), row(row) {};
+
+        PackedSat sat() const { return pEpoch->sat(row); }
+
+        // 与 TypeValueMap::at 相同，没有该观测值时抛出 std::out_of_range
+        double at(const string &type) const;
+
+        size_t count(const string &type) const;
+
+    private:
+        const ObsEpoch *pEpoch;
+        int row;
+    };
+
+    SatView view(int row) const { return SatView(this, row); }
+
+    // 转换为 ObsData，结果与直接读出的 ObsData 相同
+    void toObsData(ObsData &obsData) const;
+
+    ObsData toObsData() const;
+
+    // 从 ObsData 转换；卫星不在 PackedSat 范围内或类型编号用完时抛出 InvalidRequest
+    void fromObsData(const ObsData &obsData);
+
+    string station;
+    CommonTime epoch;
+    Eigen::Vector3d antennaPosition;
+
+private:
+    void growRows();
+
+    size_t rowCapacity;
+    size_t numRows;
+    uint64_t codeMask;
+
+    std::vector<PackedSat> sats;
+    std::vector<uint64_t> masks;
+
+    // 按列存放，第 code 列从 code * rowCapacity 开始
+    std::vector<double> values;
+    std::vector<uint8_t> llis;
+    std::vector<uint8_t> snrs;
+
+    // 以 PackedSat::ordinal() 索引的行号，-1 表示不存在
+    std::vector<int16_t> rowOf;
+};
+
+#endif //GNSSLAB_OBSEPOCH_H
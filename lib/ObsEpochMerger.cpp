@@ -0,0 +1,101 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <algorithm>
+#include "ObsEpochMerger.h"
+
+#define debug 0
+
+ObsEpochMerger::ObsEpochMerger()
+        : isStarted(false), tolerance(0.001), missingPolicy(KeepPartial),
+          referenceStation(0), numDropped(0) {
+}
+
+size_t ObsEpochMerger::addSource(const std::function<ObsData()> &source) {
+    if (isStarted) {
+        InvalidRequest e("ObsEpochMerger::addSource: merging already started");
+        throw e;
+    }
+    sources.push_back(source);
+    return sources.size() - 1;
+}
+
+bool ObsEpochMerger::fill(size_t i) {
+    try {
+        heads[i] = sources[i]();
+    } catch (EndOfFile &e) {
+        if (debug)
+            cout << "ObsEpochMerger: station " << i << " EOF" << endl;
+        return false;
+    }
+    return true;
+}
+
+// 堆顶为历元最早的测站，历元相同时序号小的在前
+bool ObsEpochMerger::isLater(size_t a, size_t b) const {
+    if (heads[a].epoch != heads[b].epoch) return heads[b].epoch < heads[a].epoch;
+    return b < a;
+}
+
+void ObsEpochMerger::pushHead(size_t i) {
+    heap.push_back(i);
+    std::push_heap(heap.begin(), heap.end(), [this](size_t a, size_t b) { return isLater(a, b); });
+}
+
+size_t ObsEpochMerger::popHead() {
+    std::pop_heap(heap.begin(), heap.end(), [this](size_t a, size_t b) { return isLater(a, b); });
+    size_t i = heap.back();
+    heap.pop_back();
+    return i;
+}
+
+bool ObsEpochMerger::next(ObsEpochGroup &group) {
+    if (!isStarted) {
+        if (missingPolicy == RequireReference && referenceStation >= sources.size()) {
+            InvalidRequest e("ObsEpochMerger: reference station out of range");
+            throw e;
+        }
+        heads.resize(sources.size());
+        heap.reserve(sources.size());
+        for (size_t i = 0; i < sources.size(); i++) {
+            if (fill(i)) pushHead(i);
+        }
+        isStarted = true;
+    }
+
+    while (!heap.empty()) {
+        size_t n = sources.size();
+        group.stations.resize(n);
+        group.isPresent.assign(n, false);
+        group.numPresent = 0;
+
+        // 最早的历元，以及与它相差不超过容许值的其他测站
+        size_t first = popHead();
+        group.epoch = heads[first].epoch;
+        members.assign(1, first);
+        while (!heap.empty() && (heads[heap.front()].epoch - group.epoch) <= tolerance) {
+            members.push_back(popHead());
+        }
+
+        for (size_t i: members) {
+            group.stations[i] = std::move(heads[i]);
+            group.isPresent[i] = true;
+            group.numPresent++;
+            if (fill(i)) pushHead(i);
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (!group.isPresent[i]) group.stations[i] = ObsData();
+        }
+
+        bool keep = true;
+        if (missingPolicy == DropIncomplete) {
+            keep = (group.numPresent == n);
+        } else if (missingPolicy == RequireReference) {
+            keep = group.isPresent[referenceStation];
+        }
+        if (keep) return true;
+
+        numDropped++;
+    }
+    return false;
+}
@@ -0,0 +1,92 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_OBSEPOCHMERGER_H
+#define GNSSLAB_OBSEPOCHMERGER_H
+
+#include <vector>
+#include <functional>
+
+#include "GnssStruct.h"
+
+// 一组时间对齐的多测站观测值
+struct ObsEpochGroup {
+    CommonTime epoch;                 // 组内最早的历元
+    std::vector<ObsData> stations;    // 按测站加入的顺序，缺失的测站为空的 ObsData
+    std::vector<bool> isPresent;      // 每个测站在本组中是否有观测值
+    size_t numPresent;
+};
+
+// 多测站观测值的 k 路归并同步
+//
+// RTK 例子中基准站与流动站的同步靠 parseRinexObs(epoch) 和 SyncException 实现，
+// 只适用于两个文件，而且每次缺历元都要抛异常。本类接收 N 个读取器，每个读取器只保留一个
+// 待处理的历元，用按时间排序的最小堆做 k 路归并：每次取出最早的历元，把各测站中与它相差
+// 不超过 tolerance 的历元放在同一组。next() 没有更多数据时返回 false，只有读取器读完时
+// 捕获一次 EndOfFile，处理过程中不再用异常控制流程。
+//
+// 有测站缺失时的处理方式：
+//  - KeepPartial      输出所有组，缺失的测站 isPresent 为 false（默认）；
+//  - DropIncomplete   只输出所有测站都有观测值的组；
+//  - RequireReference 只输出参考测站（setReferenceStation）有观测值的组，其他测站可以缺失，
+//                     相当于以流动站为准、基准站缺失时跳过的 RTK 同步方式。
+// 被丢弃的组数可以用 getNumDropped() 查询。
+class ObsEpochMerger {
+public:
+    enum MissingPolicy {
+        KeepPartial,
+        DropIncomplete,
+        RequireReference
+    };
+
+    ObsEpochMerger();
+
+    // 加入一个读取器，返回测站序号；读取器可以是 RinexObsReader、RinexObsMMapReader、
+    // RinexObsPrefetchReader、CrinexObsReader 或 ObsCacheReader，需要在第一次 next() 之前加入
+    template<class Reader>
+    size_t addReader(Reader *pReader) {
+        return addSource([pReader]() { return pReader->parseRinexObs(); });
+    }
+
+    size_t addSource(const std::function<ObsData()> &source);
+
+    // 同一组内历元之差的容许值（秒），默认 0.001
+    void setTolerance(double seconds) { tolerance = seconds; };
+
+    void setMissingPolicy(MissingPolicy policy) { missingPolicy = policy; };
+
+    void setReferenceStation(size_t index) { referenceStation = index; };
+
+    // 取出下一组，所有读取器都读完时返回 false
+    bool next(ObsEpochGroup &group);
+
+    size_t getNumStations() const { return sources.size(); }
+
+    size_t getNumDropped() const { return numDropped; }
+
+    ~ObsEpochMerger() {};
+
+private:
+    // 读取测站 i 的下一个历元，读完时返回 false
+    bool fill(size_t i);
+
+    bool isLater(size_t a, size_t b) const;
+
+    void pushHead(size_t i);
+
+    size_t popHead();
+
+    std::vector<std::function<ObsData()>> sources;
+    std::vector<ObsData> heads;       // 每个测站待处理的历元
+    std::vector<size_t> heap;         // 有待处理历元的测站序号，按历元排成最小堆
+    std::vector<size_t> members;      // 当前组的测站序号
+    bool isStarted;
+
+    double tolerance;
+    MissingPolicy missingPolicy;
+    size_t referenceStation;
+    size_t numDropped;
+};
+
+#endif //GNSSLAB_OBSEPOCHMERGER_H
@@ -0,0 +1,174 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <cmath>
+#include "OrbitInterpolator.h"
+#include "Exception.h"
+
+#define debug 0
+
+// 二分法确定星历切换点的精度，秒
+static const double SWITCH_TOLERANCE = 1.0e-3;
+
+// 短于这个长度的弧段不拟合，直接计算，秒
+static const double MIN_ARC_LENGTH = 1.0;
+
+void OrbitInterpolator::setArcLength(double seconds) {
+    if (seconds < MIN_ARC_LENGTH) {
+        InvalidRequest e("OrbitInterpolator: arc length is too short");
+        throw (e);
+    }
+    arcLength = seconds;
+    clear();
+}
+
+void OrbitInterpolator::setDegree(int n) {
+    if (n < 1 || n > MAX_DEGREE) {
+        InvalidRequest e("OrbitInterpolator: degree out of range");
+        throw (e);
+    }
+    degree = n;
+    clear();
+}
+
+Xvt OrbitInterpolator::getXvt(const SatID &sat, const CommonTime &t) {
+    if (pEphStore == NULL) {
+        InvalidRequest e("OrbitInterpolator: RinexNavStore is not set");
+        throw (e);
+    }
+
+    PackedSat packedSat(sat);
+    Segment *pSeg = segments.find(packedSat);
+    if (pSeg == NULL || !pSeg->contains(t)) {
+        pSeg = &segments[packedSat];
+        if (!fitSegment(sat, t, *pSeg)) {
+            return pEphStore->getXvt(sat, t);
+        }
+    }
+    numEvaluations++;
+
+    // Clenshaw 递推计算 Chebyshev 级数，9 个级数同时递推，互不依赖，可以向量化
+    const Segment &seg = *pSeg;
+    double tau = 2.0 * (t - seg.start) / seg.length - 1.0;
+    double b1[NUM_SERIES] = {0.0}, b2[NUM_SERIES] = {0.0};
+    for (int j = seg.degree; j >= 1; j--) {
+        const double *c = seg.coef[j];
+        for (int s = 0; s < NUM_SERIES; s++) {
+            double b0 = 2.0 * tau * b1[s] - b2[s] + c[s];
+            b2[s] = b1[s];
+            b1[s] = b0;
+        }
+    }
+    double value[NUM_SERIES];
+    for (int s = 0; s < NUM_SERIES; s++) {
+        value[s] = tau * b1[s] - b2[s] + seg.coef[0][s];
+    }
+
+    Xvt xvt;
+    xvt.x[0] = value[0];
+    xvt.x[1] = value[1];
+    xvt.x[2] = value[2];
+    xvt.v[0] = value[3];
+    xvt.v[1] = value[4];
+    xvt.v[2] = value[5];
+    xvt.clkbias = value[6];
+    xvt.clkdrift = value[7];
+    xvt.relcorr = value[8];
+    return xvt;
+}
+
+void OrbitInterpolator::clear() {
+    segments.clear();
+}
+
+bool OrbitInterpolator::usesEph(const SatID &sat, const CommonTime &t, const CommonTime &toe) {
+    try {
+        return pEphStore->getToe(sat, t) - toe == 0.0;
+    }
+    catch (InvalidRequest &e) {
+        return false;
+    }
+}
+
+bool OrbitInterpolator::fitSegment(const SatID &sat, const CommonTime &t, Segment &seg) {
+    // 没有可用星历时抛出异常
+    CommonTime toe = pEphStore->getToe(sat, t);
+
+    // 包含 t 的弧段，从当天 0 时起按 arcLength 划分，不跨天
+    long day;
+    double sod;
+    TimeSystem ts;
+    t.get(day, sod, ts);
+    double startSod = std::floor(sod / arcLength) * arcLength;
+    double endSod = std::min(startSod + arcLength, double(SEC_PER_DAY));
+    CommonTime a(day, startSod, ts);
+    CommonTime b(day, endSod, ts);
+
+    // 收缩到与 t 使用同一组星历的部分
+    if (!usesEph(sat, a, toe)) {
+        CommonTime good = t;
+        while (good - a > SWITCH_TOLERANCE) {
+            CommonTime mid = a + 0.5 * (good - a);
+            if (usesEph(sat, mid, toe)) good = mid;
+            else a = mid;
+        }
+        a = good;
+    }
+    if (!usesEph(sat, b, toe)) {
+        CommonTime good = t;
+        while (b - good > SWITCH_TOLERANCE) {
+            CommonTime mid = good + 0.5 * (b - good);
+            if (usesEph(sat, mid, toe)) good = mid;
+            else b = mid;
+        }
+        b = good;
+    }
+
+    double length = b - a;
+    if (length < MIN_ARC_LENGTH) {
+        seg.length = -1.0;
+        return false;
+    }
+
+    // 在 Chebyshev 节点上计算卫星状态
+    int n = degree + 1;
+    double f[NUM_SERIES][MAX_DEGREE + 1];
+    for (int k = 0; k < n; k++) {
+        double tau = std::cos(PI * (k + 0.5) / n);
+        Xvt xvt = pEphStore->getXvt(sat, a + 0.5 * (tau + 1.0) * length);
+        f[0][k] = xvt.x[0];
+        f[1][k] = xvt.x[1];
+        f[2][k] = xvt.x[2];
+        f[3][k] = xvt.v[0];
+        f[4][k] = xvt.v[1];
+        f[5][k] = xvt.v[2];
+        f[6][k] = xvt.clkbias;
+        f[7][k] = xvt.clkdrift;
+        f[8][k] = xvt.relcorr;
+    }
+
+    // c_j = 2/n * sum_k f_k * T_j(tau_k)，c_0 取一半
+    for (int j = 0; j < n; j++) {
+        double scale = (j == 0) ? 1.0 / n : 2.0 / n;
+        for (int s = 0; s < NUM_SERIES; s++) {
+            seg.coef[j][s] = 0.0;
+        }
+        for (int k = 0; k < n; k++) {
+            double Tj = std::cos(PI * j * (k + 0.5) / n);
+            for (int s = 0; s < NUM_SERIES; s++) {
+                seg.coef[j][s] += scale * f[s][k] * Tj;
+            }
+        }
+    }
+
+    seg.start = a;
+    seg.length = length;
+    seg.toe = toe;
+    seg.degree = degree;
+    numFits++;
+
+    if (debug) {
+        cout << "OrbitInterpolator: " << sat << " " << a << " length " << length << endl;
+    }
+    return true;
+}
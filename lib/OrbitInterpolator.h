@@ -0,0 +1,102 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_ORBITINTERPOLATOR_H
+#define GNSSLAB_ORBITINTERPOLATOR_H
+
+#include "GnssStruct.h"
+#include "SatIndex.h"
+#include "RinexNavStore.hpp"
+
+// 高采样率处理用的广播星历轨道和钟差插值
+//
+// NavEphGPS::svXvt、NavEphBDS::svXvt 每次都要迭代解开普勒方程并计算十几次三角函数，
+// 10~50 Hz 处理时每个历元每颗卫星都算一遍。这里把时间轴按 arcLength 秒划分成弧段，
+// 第一次用到某颗卫星的某个弧段时，在 degree+1 个 Chebyshev 节点上用 RinexNavStore::getXvt 计算，
+// 拟合位置、速度、钟差、钟漂和相对论改正的 Chebyshev 多项式；之后弧段内的查询只计算多项式。
+//
+// 弧段只用一组星历拟合：弧段内 getXvt 换用另一组星历时（toe 不同），
+// 用二分法把弧段收缩到与查询时刻使用同一组星历的部分，因此插值结果始终对应直接计算时选用的星历。
+//
+// 与直接计算的最大差异（exam-9.18，一天的 GPS 广播星历），位置差异的下限约 2e-7 m 来自浮点舍入：
+//  - 10 分钟弧段、6 阶（默认）：位置 3e-7 m，速度 6e-11 m/s，钟差加相对论改正 < 1e-18 s；
+//  - 15 分钟弧段、8 阶：位置 2e-7 m；15 分钟弧段、6 阶：位置 3e-6 m；
+//  - 10 分钟弧段、4 阶：位置 5e-3 m；5 分钟弧段、4 阶：位置 1.4e-4 m。
+// 阶数每降低一阶或弧段加长，误差增长很快，改变默认设置前要用 exam-9.18 检查。
+// 默认设置下 -O2 编译时每秒插值约 770 万次，直接计算约 190 万次。
+//
+// 用法：
+//      OrbitInterpolator orbitInterp(&navStore);
+//      spp.setOrbitInterpolator(&orbitInterp);
+//
+// 星历有更新（如实时解码写入了新的星历）后要调用 clear()。不加锁，只能在一个线程中使用。
+class OrbitInterpolator {
+public:
+    static const int MAX_DEGREE = 16;
+
+    explicit OrbitInterpolator(RinexNavStore *pStore = NULL)
+            : pEphStore(pStore), arcLength(600.0), degree(6), numFits(0), numEvaluations(0) {};
+
+    void setRinexNavStore(RinexNavStore *pStore) {
+        pEphStore = pStore;
+        clear();
+    };
+
+    // 弧段长度，秒
+    void setArcLength(double seconds);
+
+    double getArcLength() const { return arcLength; };
+
+    // 多项式的阶数，1 到 MAX_DEGREE
+    void setDegree(int n);
+
+    int getDegree() const { return degree; };
+
+    // t 时刻的卫星状态；没有可用星历时与 RinexNavStore::getXvt 相同，抛出 InvalidRequest
+    Xvt getXvt(const SatID &sat, const CommonTime &t);
+
+    // 清除已拟合的弧段
+    void clear();
+
+    // 拟合的弧段数和插值的次数
+    size_t getNumFits() const { return numFits; };
+
+    size_t getNumEvaluations() const { return numEvaluations; };
+
+private:
+    // 位置 3 个、速度 3 个、钟差、钟漂、相对论改正
+    static const int NUM_SERIES = 9;
+
+    struct Segment {
+        Segment() : length(-1.0), degree(0) {};
+
+        bool contains(const CommonTime &t) const {
+            double dt = t - start;
+            return dt >= 0.0 && dt <= length;
+        };
+
+        CommonTime start;
+        double length;         // 弧段长度，秒；小于 0 表示还没有拟合
+        CommonTime toe;        // 拟合使用的星历
+        int degree;
+        double coef[MAX_DEGREE + 1][NUM_SERIES];   // 按阶数存放，同一阶的 9 个系数连续
+    };
+
+    // t 时刻 getXvt 选用的星历 toe 是否为 toe
+    bool usesEph(const SatID &sat, const CommonTime &t, const CommonTime &toe);
+
+    // 拟合包含 t 的弧段，返回 false 表示 t 离星历切换点太近，不能构成弧段
+    bool fitSegment(const SatID &sat, const CommonTime &t, Segment &seg);
+
+    RinexNavStore *pEphStore;
+    double arcLength;
+    int degree;
+
+    SatTable<Segment> segments;
+
+    size_t numFits;
+    size_t numEvaluations;
+};
+
+#endif //GNSSLAB_ORBITINTERPOLATOR_H
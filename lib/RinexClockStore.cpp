@@ -0,0 +1,481 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+#include <limits>
+
+#include "RinexClockStore.h"
+#include "RinexField.h"
+#include "TimeConvert.h"
+#include "Exception.h"
+
+#define debug 0
+
+namespace {
+
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    // 历元与网格的偏差超过这个值（秒）时认为不在网格上
+    const double EPOCH_TOLERANCE = 1.0e-3;
+
+    const char cacheMagic[8] = {'G', 'L', 'C', 'L', 'K', '0', '0', '2'};
+
+    struct CacheHeader {
+        char magic[8];
+        uint64_t sourceSize;
+        int64_t sourceMtime;
+        uint64_t numEpochs;
+        uint64_t numSats;
+        int64_t firstDay;
+        double firstSod;
+        double interval;
+        int32_t timeSystem;
+        int32_t reserved;
+        uint64_t satTableOffset;
+        uint64_t dataOffset;
+    };
+
+    // 一条卫星钟差记录
+    struct ClockRecord {
+        double offset;      // 相对于文件第一条记录的秒数
+        PackedSat sat;
+        double bias;        // 秒
+    };
+
+    inline uint64_t align8(uint64_t n) {
+        return (n + 7) & ~uint64_t(7);
+    }
+
+    // 从 p 开始的一行，le 为行尾（不含换行符和 '\r'），返回下一行的开头
+    inline const char *nextLine(const char *p, const char *e, const char *&le) {
+        const char *nl = static_cast<const char *>(memchr(p, '\n', e - p));
+        le = (nl != NULL) ? nl : e;
+        if (le > p && le[-1] == '\r') --le;
+        return (nl != NULL) ? nl + 1 : e;
+    }
+
+    // 把行 [lb, le) 按空白拆分，最多 maxTokens 个，返回个数
+    inline int splitTokens(const char *lb, const char *le, const char *tb[], const char *te[], int maxTokens) {
+        int n = 0;
+        const char *p = lb;
+        while (n < maxTokens) {
+            while (p < le && (*p == ' ' || *p == '\t')) ++p;
+            if (p == le) break;
+            tb[n] = p;
+            while (p < le && *p != ' ' && *p != '\t') ++p;
+            te[n] = p;
+            n++;
+        }
+        return n;
+    }
+
+    // TIME SYSTEM ID 中的时间系统；GAL、QZS 与 GPS 时只差整数周，按 GPS 处理
+    TimeSystem timeSystemOf(const string &str, const string &file) {
+        if (str == "GPS" || str == "GAL" || str == "QZS") return TimeSystem::GPS;
+        if (str == "BDT") return TimeSystem::BDT;
+        if (str == "UTC") return TimeSystem::UTC;
+        if (str == "TAI") return TimeSystem::TAI;
+        FFStreamError e("RinexClockStore: unsupported time system " + str + " in " + file);
+        throw (e);
+    }
+}
+
+struct RinexClockStore::FileData {
+    CommonTime firstEpoch;
+    double interval;
+    TimeSystem timeSys;
+    vector<ClockRecord> records;    // offset 已换算为相对于 firstEpoch
+};
+
+static void parseFile(const string &file, RinexClockStore::FileData &data) {
+    MappedFile mapped;
+    mapped.open(file);
+
+    const char *p = mapped.begin();
+    const char *end = mapped.end();
+    const char *lb, *le;
+
+    // 头记录只用到 TIME SYSTEM ID，没有时为 GPS 时
+    data.timeSys = TimeSystem::GPS;
+    bool hasEoH = false;
+    while (p < end) {
+        lb = p;
+        p = nextLine(p, end, le);
+        if (le - lb < 73) continue;
+        if (memcmp(lb + 60, "END OF HEADER", 13) == 0) {
+            hasEoH = true;
+            break;
+        }
+        if (le - lb >= 74 && memcmp(lb + 60, "TIME SYSTEM ID", 14) == 0) {
+            const char *tb[1], *te[1];
+            if (splitTokens(lb, lb + 60, tb, te, 1) == 1) {
+                data.timeSys = timeSystemOf(string(tb[0], te[0]), file);
+            }
+        }
+    }
+    if (!hasEoH) {
+        FFStreamError e("RinexClockStore: missing END OF HEADER in " + file);
+        throw (e);
+    }
+
+    // AS 名称 年 月 日 时 分 秒 个数 钟差 [中误差]，RINEX 3.04 的名称为 9 列，按空白拆分可以同时处理各个版本
+    CommonTime refEpoch;
+    bool hasRef = false;
+    const char *prevDateBegin = NULL;     // 上一条记录的日期字段，日期相同时不再换算
+    size_t prevDateLen = 0;
+    double prevOffset = 0.0;
+    while (p < end) {
+        lb = p;
+        p = nextLine(p, end, le);
+        if (le - lb < 2 || lb[0] != 'A' || lb[1] != 'S') continue;
+
+        const char *tb[10], *te[10];
+        if (splitTokens(lb, le, tb, te, 10) < 10) {
+            FFStreamError e("RinexClockStore: bad AS record in " + file + ": " + string(lb, le));
+            throw (e);
+        }
+
+        const char *name = tb[1];
+        int prn = rinexStoi(name + 1, te[1]);
+        if (te[1] - name != 3 || PackedSat::sysIndex(name[0]) < 0 || prn < 1 || prn > PackedSat::maxPrn) {
+            continue;
+        }
+
+        double offset;
+        size_t dateLen = te[7] - tb[2];
+        if (prevDateBegin != NULL && dateLen == prevDateLen && memcmp(prevDateBegin, tb[2], dateLen) == 0) {
+            offset = prevOffset;
+        } else {
+            CivilTime cvt(rinexStoi(tb[2], te[2]), rinexStoi(tb[3], te[3]), rinexStoi(tb[4], te[4]),
+                          rinexStoi(tb[5], te[5]), rinexStoi(tb[6], te[6]), 0.0, data.timeSys);
+            CommonTime ct = CivilTime2CommonTime(cvt);
+            ct += rinexStod(tb[7], te[7]);
+            if (!hasRef) {
+                refEpoch = ct;
+                hasRef = true;
+            }
+            offset = ct - refEpoch;
+            prevDateBegin = tb[2];
+            prevDateLen = dateLen;
+            prevOffset = offset;
+        }
+
+        ClockRecord rec;
+        rec.offset = offset;
+        rec.sat = PackedSat(name[0], prn);
+        rec.bias = rinexStod(tb[9], te[9]);
+        data.records.push_back(rec);
+    }
+
+    // 采样间隔取相邻历元的最小间隔
+    vector<double> offsets;
+    offsets.reserve(data.records.size() / 16 + 1);
+    for (size_t i = 0; i < data.records.size(); i++) {
+        if (offsets.empty() || data.records[i].offset != offsets.back()) {
+            offsets.push_back(data.records[i].offset);
+        }
+    }
+    std::sort(offsets.begin(), offsets.end());
+    offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+    if (offsets.size() < 2) {
+        FFStreamError e("RinexClockStore: fewer than two satellite clock epochs in " + file);
+        throw (e);
+    }
+    data.interval = offsets.back() - offsets.front();
+    for (size_t i = 1; i < offsets.size(); i++) {
+        data.interval = std::min(data.interval, offsets[i] - offsets[i - 1]);
+    }
+    if (data.interval <= EPOCH_TOLERANCE) {
+        FFStreamError e("RinexClockStore: invalid epoch interval in " + file);
+        throw (e);
+    }
+
+    data.firstEpoch = refEpoch + offsets.front();
+    for (ClockRecord &rec: data.records) {
+        rec.offset -= offsets.front();
+    }
+}
+
+RinexClockStore::RinexClockStore()
+        : interval(0.0), numEpochs(0), timeSys(TimeSystem::GPS),
+          satRows(PackedSat::numSats, (const double *) NULL) {
+}
+
+void RinexClockStore::clear() {
+    interval = 0.0;
+    numEpochs = 0;
+    timeSys = TimeSystem::GPS;
+    satList.clear();
+    satRows.assign(PackedSat::numSats, NULL);
+    vector<double>().swap(ownedData);
+    mappedFile.close();
+}
+
+void RinexClockStore::loadFile(const string &file) {
+    FileData data;
+    parseFile(file, data);
+    merge(data);
+}
+
+void RinexClockStore::loadFiles(const vector<string> &files) {
+    for (const string &file: files) {
+        loadFile(file);
+    }
+}
+
+void RinexClockStore::merge(const FileData &file) {
+    // 先确定新网格并检查所有记录，出错时不修改已有的数据
+    CommonTime newFirst = file.firstEpoch;
+    double newInterval = file.interval;
+    long shift = 0;                     // 已有数据在新网格中的起点
+    if (numEpochs > 0) {
+        if (std::fabs(file.interval - interval) > EPOCH_TOLERANCE || file.timeSys != timeSys) {
+            FFStreamError e("RinexClockStore: epoch interval or time system differs from the loaded files");
+            throw (e);
+        }
+        newInterval = interval;
+        double offset = (file.firstEpoch - firstEpoch) / interval;
+        long n = std::lround(offset);
+        if (std::fabs(offset - n) * interval > EPOCH_TOLERANCE) {
+            FFStreamError e("RinexClockStore: epochs are not on the grid of the loaded files");
+            throw (e);
+        }
+        if (n < 0) {
+            shift = -n;
+        } else {
+            newFirst = firstEpoch;
+        }
+    }
+
+    double base = file.firstEpoch - newFirst;
+    long newNumEpochs = long(numEpochs) + shift;
+    vector<long> index(file.records.size());
+    vector<char> isNewSat(PackedSat::numSats, 0);
+    for (size_t i = 0; i < file.records.size(); i++) {
+        double offset = (base + file.records[i].offset) / newInterval;
+        long n = std::lround(offset);
+        if (n < 0 || std::fabs(offset - n) * newInterval > EPOCH_TOLERANCE) {
+            FFStreamError e("RinexClockStore: epochs are not on the grid of the loaded files");
+            throw (e);
+        }
+        index[i] = n;
+        newNumEpochs = std::max(newNumEpochs, n + 1);
+        size_t ord = file.records[i].sat.ordinal();
+        if (satRows[ord] == NULL) isNewSat[ord] = 1;
+    }
+
+    // 新的卫星表按 PackedSat 顺序，已有的行平移后复制过来
+    vector<SatID> newSatList;
+    for (size_t ord = 0; ord < PackedSat::numSats; ord++) {
+        if (satRows[ord] != NULL || isNewSat[ord]) {
+            newSatList.push_back(PackedSat::fromOrdinal(ord).toSatID());
+        }
+    }
+    vector<double> newData(newSatList.size() * newNumEpochs, NaN);
+    vector<size_t> newRow(PackedSat::numSats, 0);
+    for (size_t i = 0; i < newSatList.size(); i++) {
+        size_t ord = PackedSat(newSatList[i]).ordinal();
+        newRow[ord] = i;
+        if (satRows[ord] != NULL) {
+            std::copy(satRows[ord], satRows[ord] + numEpochs, newData.begin() + i * newNumEpochs + shift);
+        }
+    }
+    for (size_t i = 0; i < file.records.size(); i++) {
+        const ClockRecord &rec = file.records[i];
+        newData[newRow[rec.sat.ordinal()] * newNumEpochs + index[i]] = rec.bias;
+    }
+
+    mappedFile.close();
+    ownedData.swap(newData);
+    satList.swap(newSatList);
+    firstEpoch = newFirst;
+    interval = newInterval;
+    numEpochs = size_t(newNumEpochs);
+    timeSys = file.timeSys;
+    indexRows(ownedData.empty() ? NULL : &ownedData[0]);
+
+    if (debug) {
+        cout << "RinexClockStore: " << satList.size() << " sats, " << numEpochs << " epochs from "
+             << firstEpoch << ", interval " << interval << endl;
+    }
+}
+
+void RinexClockStore::indexRows(const double *data) {
+    satRows.assign(PackedSat::numSats, NULL);
+    for (size_t i = 0; i < satList.size(); i++) {
+        satRows[PackedSat(satList[i]).ordinal()] = data + i * numEpochs;
+    }
+}
+
+void RinexClockStore::writeCache(const string &cacheFile, uint64_t sourceSize, int64_t sourceMtime) const {
+    std::ofstream strm(cacheFile.c_str(), std::ios::binary | std::ios::trunc);
+    if (!strm) {
+        FileMissingException e("RinexClockStore: can't create cache file " + cacheFile);
+        throw e;
+    }
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.sourceSize = sourceSize;
+    header.sourceMtime = sourceMtime;
+    header.numEpochs = numEpochs;
+    header.numSats = satList.size();
+    long day;
+    double sod;
+    TimeSystem ts;
+    firstEpoch.get(day, sod, ts);
+    header.firstDay = day;
+    header.firstSod = sod;
+    header.interval = interval;
+    header.timeSystem = static_cast<int32_t>(timeSys.system);
+    header.satTableOffset = align8(sizeof(header));
+    header.dataOffset = header.satTableOffset + align8(satList.size() * sizeof(uint16_t));
+
+    static const char zeros[8] = {0};
+    strm.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    strm.write(zeros, header.satTableOffset - sizeof(header));
+
+    vector<uint16_t> satTable(satList.size());
+    for (size_t i = 0; i < satList.size(); i++) {
+        satTable[i] = PackedSat(satList[i]).packed();
+    }
+    uint64_t tableBytes = satTable.size() * sizeof(uint16_t);
+    if (tableBytes > 0) {
+        strm.write(reinterpret_cast<const char *>(&satTable[0]), tableBytes);
+    }
+    strm.write(zeros, align8(tableBytes) - tableBytes);
+
+    for (size_t i = 0; i < satList.size(); i++) {
+        const double *row = satRows[PackedSat(satList[i]).ordinal()];
+        strm.write(reinterpret_cast<const char *>(row), numEpochs * sizeof(double));
+    }
+    strm.close();
+    if (!strm) {
+        // 不留下写了一半的缓存文件
+        std::remove(cacheFile.c_str());
+        FileMissingException e("RinexClockStore: error writing cache file " + cacheFile);
+        throw e;
+    }
+}
+
+void RinexClockStore::openCache(const string &cacheFile) {
+    clear();
+    mappedFile.open(cacheFile);
+
+    CacheHeader header;
+    if (mappedFile.size() < sizeof(header)) {
+        clear();
+        FFStreamError e("RinexClockStore: bad cache file " + cacheFile);
+        throw e;
+    }
+    memcpy(&header, mappedFile.begin(), sizeof(header));
+
+    // 先检查卫星数和偏移，再用除法检查钟差数组的大小，numSats * numEpochs 不会溢出；
+    // 头、卫星表、钟差数组依次排列，互不重叠
+    uint64_t fileSize = mappedFile.size();
+    if (memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+        header.satTableOffset % 8 != 0 || header.dataOffset % 8 != 0 ||
+        header.numSats > uint64_t(PackedSat::numSats) ||
+        header.satTableOffset < sizeof(header) || header.satTableOffset > fileSize ||
+        header.numSats * sizeof(uint16_t) > fileSize - header.satTableOffset ||
+        header.dataOffset < header.satTableOffset + align8(header.numSats * sizeof(uint16_t)) ||
+        header.timeSystem <= 0 || header.timeSystem >= TimeSystem::count ||
+        !std::isfinite(header.interval) || header.interval <= 0.0 ||
+        !std::isfinite(header.firstSod) ||
+        header.dataOffset > fileSize ||
+        (header.numSats > 0 &&
+         header.numEpochs > (fileSize - header.dataOffset) / sizeof(double) / header.numSats)) {
+        clear();
+        FFStreamError e("RinexClockStore: bad cache file " + cacheFile);
+        throw e;
+    }
+
+    const uint16_t *satTable = reinterpret_cast<const uint16_t *>(mappedFile.begin() + header.satTableOffset);
+    for (size_t i = 0; i < header.numSats; i++) {
+        int sys = (satTable[i] >> 8) - 1;
+        int prn = satTable[i] & 0xff;
+        if (sys < 0 || sys >= PackedSat::numSys || prn < 1 || prn > PackedSat::maxPrn) {
+            clear();
+            FFStreamError e("RinexClockStore: bad cache file " + cacheFile);
+            throw e;
+        }
+        satList.push_back(PackedSat(PackedSat::sysChars()[sys], prn).toSatID());
+    }
+
+    numEpochs = header.numEpochs;
+    interval = header.interval;
+    firstEpoch = CommonTime(long(header.firstDay), header.firstSod,
+                            TimeSystem(static_cast<TimeSystem::SystemType>(header.timeSystem)));
+    timeSys = firstEpoch.m_timeSystem;
+    indexRows(reinterpret_cast<const double *>(mappedFile.begin() + header.dataOffset));
+}
+
+void RinexClockStore::openOrConvert(const string &clkFile) {
+    string cacheFile = cacheName(clkFile);
+
+    uint64_t clkSize;
+    {
+        MappedFile clk(clkFile);
+        clkSize = clk.size();
+    }
+    int64_t clkMtime = MappedFile::modifiedTime(clkFile);
+
+    // 大小和修改时间都相同才认为缓存是这个文件的
+    try {
+        openCache(cacheFile);
+        CacheHeader header;
+        memcpy(&header, mappedFile.begin(), sizeof(header));
+        if (header.sourceSize == clkSize && header.sourceMtime == clkMtime) return;
+    } catch (BaseException &e) {
+        if (debug)
+            cout << "RinexClockStore: " << e.what() << endl;
+    }
+
+    clear();
+    loadFile(clkFile);
+
+    // 缓存写不了（只读目录、磁盘已满）时不影响处理，直接使用读入的数据
+    try {
+        writeCache(cacheFile, clkSize, clkMtime);
+    } catch (FileMissingException &e) {
+        cerr << e.what() << endl;
+        return;
+    }
+    openCache(cacheFile);
+}
+
+bool RinexClockStore::hasSat(const SatID &sat) const {
+    return satRows[PackedSat(sat).ordinal()] != NULL;
+}
+
+void RinexClockStore::getClock(const SatID &sat, const CommonTime &t, double &bias, double &drift) const {
+    const double *row = satRows[PackedSat(sat).ordinal()];
+    if (row == NULL) {
+        InvalidRequest e("RinexClockStore: no precise clock for " + sat.toString());
+        throw (e);
+    }
+
+    double x = (convertTimeSystem(t, timeSys) - firstEpoch) / interval;
+    if (numEpochs < 2 || x < 0.0 || x > double(numEpochs - 1)) {
+        InvalidRequest e("RinexClockStore: epoch is out of the precise clock span for " + sat.toString());
+        throw (e);
+    }
+
+    // 与 SP3Store 的窗口一样，最后一个历元用前一个区间；t 正好在历元 k 上而历元 k+1 缺钟差时，
+    // 同样改用前一个区间，这时钟差就是历元 k 的值
+    long k = std::min(long(x), long(numEpochs) - 2);
+    if (x == double(k) && k > 0 && std::isnan(row[k + 1])) k--;
+    double c0 = row[k], c1 = row[k + 1];
+    if (std::isnan(c0) || std::isnan(c1)) {
+        InvalidRequest e("RinexClockStore: missing precise clock around the epoch for " + sat.toString());
+        throw (e);
+    }
+    double u = x - double(k);
+    bias = (u == 1.0) ? c1 : c0 + u * (c1 - c0);
+    drift = (c1 - c0) / interval;
+}
@@ -0,0 +1,113 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_RINEXCLOCKSTORE_H
+#define GNSSLAB_RINEXCLOCKSTORE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "GnssStruct.h"
+#include "SatIndex.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+// RINEX 钟差文件（精密卫星钟差，30 秒或 5 秒采样）的存储
+//
+// 只读取卫星钟差记录（AS），接收机钟差等其他记录跳过。数据按采样间隔放在等间隔的历元网格上，
+// 每颗卫星一行、每个历元一列，缺少的历元记为 NaN。采样间隔取相邻历元的最小间隔，所有历元都必须落在网格上。
+// 查询时刻的位置由 (t - t0) / interval 直接算出，钟差在相邻两个历元之间线性插值，钟漂取这两个历元的差分，
+// 不需要查找，与文件大小无关。
+//
+// 文本文件很大，解析一天 5 秒采样的文件需要几百毫秒。writeCache 把网格写成二进制文件，
+// openCache 映射该文件后直接在映射内存上查询，不再解析文本，也不复制数据：
+//   头          magic "GLCLK002"、源文件大小和修改时间、历元数、卫星数、首历元、采样间隔、时间系统
+//   卫星表      uint16[numSats]，PackedSat 的编码，补齐到 8 字节
+//   钟差        double[numSats][numEpochs]，秒
+// 文件使用本机字节序，只用作本机的缓存。
+//
+// 用法：
+//      RinexClockStore clkStore;
+//      clkStore.openOrConvert(clkFile);
+//      spp.setClockStore(&clkStore);
+//
+// 查询不修改对象，加载完成后可以在多个线程中同时查询。
+class RinexClockStore {
+public:
+    RinexClockStore();
+
+    // 读入 RINEX 钟差文件并入已有的数据（包括已打开的缓存），同一卫星、同一历元以后读入的为准。
+    // 文件不存在时抛出 FileMissingException；格式错误，或采样间隔、时间系统与已有数据不一致、
+    // 历元不在已有的网格上时抛出 FFStreamError，这时不修改已有的数据
+    void loadFile(const string &file);
+
+    // 依次读入多个文件，出错时已经读入的文件保留
+    void loadFiles(const vector<string> &files);
+
+    // 把当前数据写成二进制缓存文件，sourceSize、sourceMtime 记录对应的文本文件大小和修改时间；
+    // 文件写不了时删除不完整的文件，抛出 FileMissingException
+    void writeCache(const string &cacheFile, uint64_t sourceSize = 0, int64_t sourceMtime = 0) const;
+
+    // 映射缓存文件，替换已有的数据；文件不存在或格式不对时抛出 FileMissingException / FFStreamError，
+    // 这时已有的数据也被清除
+    void openCache(const string &cacheFile);
+
+    // 缓存文件存在且与 clkFile 对应（文件大小和修改时间一致）时直接打开，否则读入文本并写出缓存；
+    // 缓存文件写不了时给出提示，使用读入的数据
+    void openOrConvert(const string &clkFile);
+
+    // 缓存文件的默认文件名
+    static string cacheName(const string &clkFile) {
+        return clkFile + ".clc";
+    }
+
+    // t 时刻的卫星钟差（秒）和钟漂（秒/秒）；没有该卫星、t 超出数据范围或相邻历元缺少钟差时抛出 InvalidRequest。
+    // t 正好在有钟差的历元上时只要前后有一侧不缺就行，钟漂取那一侧的差分
+    void getClock(const SatID &sat, const CommonTime &t, double &bias, double &drift) const;
+
+    bool hasSat(const SatID &sat) const;
+
+    // 清除所有数据，关闭缓存文件
+    void clear();
+
+    const vector<SatID> &getSatList() const { return satList; };
+
+    size_t getNumEpochs() const { return numEpochs; };
+
+    double getInterval() const { return interval; };
+
+    CommonTime getFirstEpoch() const { return firstEpoch; };
+
+    TimeSystem getTimeSystem() const { return timeSys; };
+
+    // 一个文件的解析结果，只在 RinexClockStore.cpp 中使用
+    struct FileData;
+
+private:
+    // 不允许拷贝，数据可能指向映射内存
+    RinexClockStore(const RinexClockStore &);
+
+    RinexClockStore &operator=(const RinexClockStore &);
+
+    // 把 file 并入网格，数据复制到 ownedData
+    void merge(const FileData &file);
+
+    // 按 satList 的顺序重建 satRows
+    void indexRows(const double *data);
+
+    CommonTime firstEpoch;
+    double interval;
+    size_t numEpochs;
+    TimeSystem timeSys;
+
+    vector<SatID> satList;             // 按 PackedSat 顺序
+    vector<const double *> satRows;    // 按 PackedSat::ordinal() 索引，没有的卫星为 NULL
+
+    vector<double> ownedData;          // 从文本读入的数据，[satList.size()][numEpochs]
+    MappedFile mappedFile;             // 打开的缓存文件
+};
+
+#endif //GNSSLAB_RINEXCLOCKSTORE_H
@@ -0,0 +1,214 @@
+//
+// Created by shjzh on 2026/10/18.
+//
+
+#ifndef GNSSLAB_RINEXFIELD_H
+#define GNSSLAB_RINEXFIELD_H
+
+// RINEX 定宽字段解析
+//
+// RINEX 文件中的数值都是定宽字段：观测值 F14.3，导航电文 D19.12（指数可能写成 D），
+// 历元行和头记录中的 I 型整数。这里的函数直接在字符区间 [b, e) 上解析，
+// 不构造临时 string、不抛异常，结果与 safeStod/safeStoi 逐位相同：
+//  - 全空白字段返回 0；
+//  - 指数符号 E/e/D/d 都接受，不需要事先把整行的 'D' 替换成 'e'；
+//  - 常见的定点和科学计数写法走快速路径：尾数不超过 2^53、十进制指数 |k|<=22 时，
+//    尾数和 10^k 都能精确表示，一次乘（除）法得到的就是正确舍入的结果，与 strtod 一致；
+//  - 其余情况（超长尾数、极端指数、非法字符等）拷贝到栈上交给 strtod/strtol。
+// 字段超出行尾的部分按空格处理，相当于先用空格把行补齐。
+
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+#include <limits>
+#include <stdint.h>
+
+using namespace std;
+
+// 取行 [lb, le) 中第 pos 列起、长度为 len 的字段
+inline void fieldRange(const char *lb, const char *le, size_t pos, size_t len,
+                       const char *&fb, const char *&fe) {
+    size_t lineLen = le - lb;
+    if (pos >= lineLen) {
+        fb = fe = le;
+        return;
+    }
+    fb = lb + pos;
+    fe = (len < lineLen - pos) ? fb + len : le;
+}
+
+// 取第 pos 列的字符，超出行尾返回空格
+inline char fieldChar(const char *lb, const char *le, size_t pos) {
+    return (pos < size_t(le - lb)) ? lb[pos] : ' ';
+}
+
+inline bool isBlankField(const char *b, const char *e) {
+    for (; b < e; ++b) {
+        if (*b != ' ') return false;
+    }
+    return true;
+}
+
+namespace rinex_field_detail {
+
+    // 能精确表示的 10 的幂
+    static const double exactPow10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    inline bool isDigit(char c) {
+        return static_cast<unsigned>(c - '0') < 10u;
+    }
+
+    inline bool isExpChar(char c) {
+        return c == 'E' || c == 'e' || c == 'D' || c == 'd';
+    }
+
+    // 慢速路径：与 safeStod 相同的 strtod 语义，D 指数改写成 E
+    inline double slowStod(const char *b, const char *e, double defaultValue) {
+        char buf[64];
+        size_t n = e - b;
+        if (n >= sizeof(buf)) n = sizeof(buf) - 1;
+        for (size_t i = 0; i < n; i++) {
+            buf[i] = (b[i] == 'D' || b[i] == 'd') ? 'E' : b[i];
+        }
+        buf[n] = '\0';
+
+        char *stop;
+        errno = 0;
+        double value = strtod(buf, &stop);
+        if (stop == buf) return defaultValue;
+        if (errno == ERANGE) return std::numeric_limits<double>::max();
+        return value;
+    }
+}
+
+// 解析浮点数字段，等价于 safeStod(string(b, e))（D 指数视同 E）
+inline double rinexStod(const char *b, const char *e, double defaultValue = 0.0) {
+    using namespace rinex_field_detail;
+
+    const char *p = b;
+    while (p < e && *p == ' ') ++p;
+    if (p == e) return defaultValue;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int numDigits = 0;       // 有效数字个数（不含前导零）
+    int exp10 = 0;
+    bool hasDigit = false;
+
+    for (; p < e && isDigit(*p); ++p) {
+        hasDigit = true;
+        if (numDigits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0) numDigits++;
+        } else {
+            return slowStod(b, e, defaultValue);
+        }
+    }
+    if (p < e && *p == '.') {
+        for (++p; p < e && isDigit(*p); ++p) {
+            hasDigit = true;
+            if (numDigits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) numDigits++;
+                exp10--;
+            } else {
+                return slowStod(b, e, defaultValue);
+            }
+        }
+    }
+    if (!hasDigit) return slowStod(b, e, defaultValue);
+
+    if (p < e && isExpChar(*p)) {
+        const char *q = p + 1;
+        bool expNegative = false;
+        if (q < e && (*q == '-' || *q == '+')) {
+            expNegative = (*q == '-');
+            ++q;
+        }
+        if (q == e || !isDigit(*q)) return slowStod(b, e, defaultValue);
+        int expValue = 0;
+        for (; q < e && isDigit(*q); ++q) {
+            if (expValue < 10000) expValue = expValue * 10 + (*q - '0');
+        }
+        exp10 += expNegative ? -expValue : expValue;
+        p = q;
+    }
+
+    // 数字后面只允许有空格
+    for (; p < e; ++p) {
+        if (*p != ' ') return slowStod(b, e, defaultValue);
+    }
+
+    if (mantissa == 0) return negative ? -0.0 : 0.0;
+    if (mantissa > (uint64_t(1) << 53) || exp10 > 22 || exp10 < -22) {
+        return slowStod(b, e, defaultValue);
+    }
+
+    double value = static_cast<double>(mantissa);
+    if (exp10 >= 0) value *= exactPow10[exp10];
+    else value /= exactPow10[-exp10];
+    return negative ? -value : value;
+}
+
+// 解析整数字段，等价于 safeStoi(string(b, e))
+inline int rinexStoi(const char *b, const char *e) {
+    using namespace rinex_field_detail;
+
+    while (b < e && isspace(static_cast<unsigned char>(*b))) ++b;
+    if (b == e) return 0;
+
+    const char *p = b;
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    int value = 0;
+    int numDigits = 0;
+    for (; p < e && isDigit(*p) && numDigits < 9; ++p, ++numDigits) {
+        value = value * 10 + (*p - '0');
+    }
+    if (numDigits == 0) return 0;
+    if (p == e || !isDigit(*p)) return negative ? -value : value;
+
+    // 超过 9 位，交给 strtol 判断是否溢出
+    char buf[32];
+    size_t n = e - b;
+    if (n >= sizeof(buf)) n = sizeof(buf) - 1;
+    memcpy(buf, b, n);
+    buf[n] = '\0';
+    errno = 0;
+    long lvalue = strtol(buf, NULL, 10);
+    if (errno == ERANGE ||
+        lvalue > std::numeric_limits<int>::max() ||
+        lvalue < std::numeric_limits<int>::min())
+        return 0;
+    return static_cast<int>(lvalue);
+}
+
+// 按列号取字段再解析，替代 safeStod(line.substr(pos, len))
+inline double rinexStod(const std::string &line, size_t pos, size_t len, double defaultValue = 0.0) {
+    const char *fb, *fe;
+    fieldRange(line.data(), line.data() + line.size(), pos, len, fb, fe);
+    return rinexStod(fb, fe, defaultValue);
+}
+
+// 替代 safeStoi(line.substr(pos, len))
+inline int rinexStoi(const std::string &line, size_t pos, size_t len) {
+    const char *fb, *fe;
+    fieldRange(line.data(), line.data() + line.size(), pos, len, fb, fe);
+    return rinexStoi(fb, fe);
+}
+
+#endif //GNSSLAB_RINEXFIELD_H
@@ -7,6 +7,13 @@
 
 #include "RinexNavStore.hpp"
 #include "StringUtils.h"
+#include "RinexField.h"
+#include "MappedFile.h"
+
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <exception>
 
 using namespace std;
 #define debug 0
@@ -30,30 +37,94 @@ const string RinexNavStore::stringIonBeta = "ION BETA";
 const string RinexNavStore::stringEoH = "END OF HEADER";
 
 
-void RinexNavStore::loadGPSEph(NavEphGPS &gpsEph, string &line, fstream &navFileStream) {
+// 行 [lb, le) 去掉行尾的 '\r'
+static inline void trimCR(const char *lb, const char *&le) {
+    if (le > lb && le[-1] == '\r') --le;
+}
 
-    SatID sat(line.substr(0,3));
+// 从 p 开始的一行，le 为行尾（不含换行符），返回下一行的开头
+static inline const char *nextLine(const char *p, const char *e, const char *&le) {
+    const char *nl = static_cast<const char *>(memchr(p, '\n', e - p));
+    le = (nl != NULL) ? nl : e;
+    trimCR(p, le);
+    return (nl != NULL) ? nl + 1 : e;
+}
 
-    ///add each sat into the satTable
-    vector<SatID>::iterator result = find(satTable.begin(), satTable.end(), sat);
-    if (result == satTable.end()) {
-        satTable.push_back(sat);
-    }
+// 第 i 行第 pos 列起 19 列的 D19.12 字段
+static inline double navField(const RinexNavStore::RecordLines &rec, int i, size_t pos) {
+    const char *fb, *fe;
+    fieldRange(rec.lineBegin[i], rec.lineEnd[i], pos, 19, fb, fe);
+    return rinexStod(fb, fe);
+}
 
-    int yr = safeStoi(line.substr(4, 4));
-    int mo = safeStoi(line.substr(9, 2));
-    int day = safeStoi(line.substr(12, 2));
-    int hr = safeStoi(line.substr(15, 2));
-    int min = safeStoi(line.substr(18, 2));
-    double sec = safeStod(line.substr(21, 2));
+// 轨道参数行的第 k 个字段（0~3）
+static inline double orbitField(const RinexNavStore::RecordLines &rec, int i, int k) {
+    return navField(rec, i, 4 + 19 * k);
+}
+
+// 历元行第 pos 列起 len 列的整数字段
+static inline int epochField(const RinexNavStore::RecordLines &rec, size_t pos, size_t len) {
+    const char *fb, *fe;
+    fieldRange(rec.lineBegin[0], rec.lineEnd[0], pos, len, fb, fe);
+    return rinexStoi(fb, fe);
+}
+
+// 历元行中的 toc，民用时
+static CivilTime epochOf(const RinexNavStore::RecordLines &rec, short &ds) {
+    int yr = epochField(rec, 4, 4);
+    int mo = epochField(rec, 9, 2);
+    int day = epochField(rec, 12, 2);
+    int hr = epochField(rec, 15, 2);
+    int min = epochField(rec, 18, 2);
+    const char *fb, *fe;
+    fieldRange(rec.lineBegin[0], rec.lineEnd[0], 21, 2, fb, fe);
+    double sec = rinexStod(fb, fe);
 
     /// Fix RINEX epochs of the form 'yy mm dd hr 59 60.0'
-    short ds = 0;
+    ds = 0;
     if (sec >= 60.) {
         ds = sec;
         sec = 0;
     }
-    CivilTime cvt(yr, mo, day, hr, min, sec);
+    return CivilTime(yr, mo, day, hr, min, sec);
+}
+
+// 用 getline 读入的 8 行构造 RecordLines
+static void fillRecordLines(string &line, fstream &navFileStream, string lines[8],
+                            RinexNavStore::RecordLines &rec) {
+    lines[0] = line;
+    for (int i = 1; i < 8; i++) {
+        getline(navFileStream, lines[i]);
+    }
+    for (int i = 0; i < 8; i++) {
+        rec.lineBegin[i] = lines[i].data();
+        rec.lineEnd[i] = lines[i].data() + lines[i].size();
+        trimCR(rec.lineBegin[i], rec.lineEnd[i]);
+    }
+    line = lines[7];
+}
+
+void RinexNavStore::loadGPSEph(NavEphGPS &gpsEph, string &line, fstream &navFileStream) {
+    string lines[8];
+    RecordLines rec;
+    fillRecordLines(line, navFileStream, lines, rec);
+    parseGPSEph(rec, gpsEph);
+    addGPSEph(gpsEph);
+}
+
+void RinexNavStore::loadBDSEph(NavEphBDS &bdsEph, string &line, fstream &navFileStream) {
+    string lines[8];
+    RecordLines rec;
+    fillRecordLines(line, navFileStream, lines, rec);
+    parseBDSEph(rec, bdsEph);
+    addBDSEph(bdsEph);
+}
+
+void RinexNavStore::parseGPSEph(const RecordLines &rec, NavEphGPS &gpsEph) {
+    int prn = epochField(rec, 1, 2);
+
+    short ds;
+    CivilTime cvt = epochOf(rec, ds);
     gpsEph.CivilToc = cvt;
     gpsEph.ctToe = CivilTime2CommonTime(cvt);;
 
@@ -64,84 +135,43 @@ void RinexNavStore::loadGPSEph(NavEphGPS &gpsEph, string &line, fstream &navFile
     CommonTime2WeekSecond(gpsEph.ctToe, gws);     // sow is system-independent
 
     gpsEph.Toc = gws.sow;
-    gpsEph.af0 = safeStod(line.substr(23, 19));
-    gpsEph.af1 = safeStod(line.substr(42, 19));
-    gpsEph.af2 = safeStod(line.substr(61, 19));
+    gpsEph.af0 = navField(rec, 0, 23);
+    gpsEph.af1 = navField(rec, 0, 42);
+    gpsEph.af2 = navField(rec, 0, 61);
 
     ///orbit-1
-    int n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    gpsEph.IODE = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.Crs = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.Delta_n = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.M0 = safeStod(line.substr(n, 19));
+    gpsEph.IODE = orbitField(rec, 1, 0);
+    gpsEph.Crs = orbitField(rec, 1, 1);
+    gpsEph.Delta_n = orbitField(rec, 1, 2);
+    gpsEph.M0 = orbitField(rec, 1, 3);
     ///orbit-2
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    gpsEph.Cuc = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.ecc = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.Cus = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.sqrt_A = safeStod(line.substr(n, 19));
+    gpsEph.Cuc = orbitField(rec, 2, 0);
+    gpsEph.ecc = orbitField(rec, 2, 1);
+    gpsEph.Cus = orbitField(rec, 2, 2);
+    gpsEph.sqrt_A = orbitField(rec, 2, 3);
     ///orbit-3
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    gpsEph.Toe = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.Cic = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.OMEGA_0 = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.Cis = safeStod(line.substr(n, 19));
+    gpsEph.Toe = orbitField(rec, 3, 0);
+    gpsEph.Cic = orbitField(rec, 3, 1);
+    gpsEph.OMEGA_0 = orbitField(rec, 3, 2);
+    gpsEph.Cis = orbitField(rec, 3, 3);
     ///orbit-4
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    gpsEph.i0 = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.Crc = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.omega = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.OMEGA_DOT = safeStod(line.substr(n, 19));
+    gpsEph.i0 = orbitField(rec, 4, 0);
+    gpsEph.Crc = orbitField(rec, 4, 1);
+    gpsEph.omega = orbitField(rec, 4, 2);
+    gpsEph.OMEGA_DOT = orbitField(rec, 4, 3);
     ///orbit-5
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    gpsEph.IDOT = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.L2Codes = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.GPSWeek = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.L2Pflag = safeStod(line.substr(n, 19));
+    gpsEph.IDOT = orbitField(rec, 5, 0);
+    gpsEph.L2Codes = orbitField(rec, 5, 1);
+    gpsEph.GPSWeek = orbitField(rec, 5, 2);
+    gpsEph.L2Pflag = orbitField(rec, 5, 3);
     ///orbit-6
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    gpsEph.URA = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.SV_health = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.TGD = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.IODC = safeStod(line.substr(n, 19));
+    gpsEph.URA = orbitField(rec, 6, 0);
+    gpsEph.SV_health = orbitField(rec, 6, 1);
+    gpsEph.TGD = orbitField(rec, 6, 2);
+    gpsEph.IODC = orbitField(rec, 6, 3);
     ///orbit-7
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    gpsEph.HOWtime = safeStod(line.substr(n, 19));
-    n += 19;
-    gpsEph.fitInterval = safeStod(line.substr(n, 19));
-    n += 19;
+    gpsEph.HOWtime = orbitField(rec, 7, 0);
+    gpsEph.fitInterval = orbitField(rec, 7, 1);
 
     /// some process
     /// Some RINEX files have HOW < 0.
@@ -179,34 +209,18 @@ void RinexNavStore::loadGPSEph(NavEphGPS &gpsEph, string &line, fstream &navFile
 
     gpsEph.ctToc.setTimeSystem(TimeSystem::GPS);
 
-    gpsEphData[sat][gpsEph.ctToe] = gpsEph;
+    /// fit interval in hours, 0 means the default 4 hours
+    double fitHours = (gpsEph.fitInterval > 0.0) ? gpsEph.fitInterval : 4.0;
+    gpsEph.prn = prn;
+    gpsEph.beginValid = gpsEph.ctToe - fitHours * 1800.0;
+    gpsEph.endValid = gpsEph.ctToe + fitHours * 1800.0;
 }
 
-void RinexNavStore::loadBDSEph(NavEphBDS& bdsEph, string& line, fstream &navFileStream)
-{
-    SatID sat(line.substr(0,3));//读取prn号
-
-    ///add each sat into the satTable，同时也避免了重复添加
-    vector<SatID>::iterator result = find(satTable.begin(), satTable.end(), sat);
-    if (result == satTable.end()) {
-        satTable.push_back(sat);
-    }
-
-    int yr = safeStoi(line.substr(4, 4));
-    int mo = safeStoi(line.substr(9, 2));
-    int day = safeStoi(line.substr(12, 2));
-    int hr = safeStoi(line.substr(15, 2));
-    int min = safeStoi(line.substr(18, 2));
-    double sec = safeStod(line.substr(21, 2));
-
-    /// Fix RINEX epochs of the form 'yy mm dd hr 59 60.0'
-    short ds = 0;
-    if (sec >= 60.) {
-        ds = sec;
-        sec = 0;
-    }
+void RinexNavStore::parseBDSEph(const RecordLines &rec, NavEphBDS &bdsEph) {
+    int prn = epochField(rec, 1, 2);
 
-    CivilTime cvt(yr, mo, day, hr, min, sec);
+    short ds;
+    CivilTime cvt = epochOf(rec, ds);
     bdsEph.CivilToc = cvt;
     bdsEph.ctToe = CivilTime2CommonTime(cvt);;
 
@@ -217,84 +231,43 @@ void RinexNavStore::loadBDSEph(NavEphBDS& bdsEph, string& line, fstream &navFile
     CommonTime2WeekSecond(bdsEph.ctToe, bws);     // sow is system-independent
 
     bdsEph.Toc = bws.sow;
-    bdsEph.af0 = safeStod(line.substr(23, 19));
-    bdsEph.af1 = safeStod(line.substr(42, 19));
-    bdsEph.af2 = safeStod(line.substr(61, 19));
+    bdsEph.af0 = navField(rec, 0, 23);
+    bdsEph.af1 = navField(rec, 0, 42);
+    bdsEph.af2 = navField(rec, 0, 61);
 
     ///orbit-1
-    int n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    bdsEph.AODE = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.Crs = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.Delta_n = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.M0 = safeStod(line.substr(n, 19));
+    bdsEph.AODE = orbitField(rec, 1, 0);
+    bdsEph.Crs = orbitField(rec, 1, 1);
+    bdsEph.Delta_n = orbitField(rec, 1, 2);
+    bdsEph.M0 = orbitField(rec, 1, 3);
     ///orbit-2
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    bdsEph.Cuc = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.ecc = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.Cus = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.sqrt_A = safeStod(line.substr(n, 19));
+    bdsEph.Cuc = orbitField(rec, 2, 0);
+    bdsEph.ecc = orbitField(rec, 2, 1);
+    bdsEph.Cus = orbitField(rec, 2, 2);
+    bdsEph.sqrt_A = orbitField(rec, 2, 3);
     ///orbit-3
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    bdsEph.Toe = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.Cic = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.OMEGA_0 = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.Cis = safeStod(line.substr(n, 19));
+    bdsEph.Toe = orbitField(rec, 3, 0);
+    bdsEph.Cic = orbitField(rec, 3, 1);
+    bdsEph.OMEGA_0 = orbitField(rec, 3, 2);
+    bdsEph.Cis = orbitField(rec, 3, 3);
     ///orbit-4
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    bdsEph.i0 = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.Crc = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.omega = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.OMEGA_DOT = safeStod(line.substr(n, 19));
+    bdsEph.i0 = orbitField(rec, 4, 0);
+    bdsEph.Crc = orbitField(rec, 4, 1);
+    bdsEph.omega = orbitField(rec, 4, 2);
+    bdsEph.OMEGA_DOT = orbitField(rec, 4, 3);
     ///orbit-5
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    bdsEph.IDOT = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.spare1 = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.BDSWeek = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.spare2 = safeStod(line.substr(n, 19));
+    bdsEph.IDOT = orbitField(rec, 5, 0);
+    bdsEph.spare1 = orbitField(rec, 5, 1);
+    bdsEph.BDSWeek = orbitField(rec, 5, 2);
+    bdsEph.spare2 = orbitField(rec, 5, 3);
     ///orbit-6
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    bdsEph.URA = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.SV_health = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.TGD1 = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.TGD2 = safeStod(line.substr(n, 19));
+    bdsEph.URA = orbitField(rec, 6, 0);
+    bdsEph.SV_health = orbitField(rec, 6, 1);
+    bdsEph.TGD1 = orbitField(rec, 6, 2);
+    bdsEph.TGD2 = orbitField(rec, 6, 3);
     ///orbit-7
-    n = 4;
-    getline(navFileStream, line);
-    replace(line.begin(), line.end(), 'D', 'e');
-    bdsEph.HOWtime = safeStod(line.substr(n, 19));
-    n += 19;
-    bdsEph.AODC = safeStod(line.substr(n, 19));
-    n += 19;
+    bdsEph.HOWtime = orbitField(rec, 7, 0);
+    bdsEph.AODC = orbitField(rec, 7, 1);
 
     /// some process
     /// Some RINEX files have HOW < 0.
@@ -322,7 +295,7 @@ void RinexNavStore::loadBDSEph(NavEphBDS& bdsEph, string& line, fstream &navFile
             adjHOWtime += FULLWEEK;
             adjWeeknum--;
         }
-        }
+    }
 
     double dt = bdsEph.Toc - adjHOWtime;
     int week = bdsEph.BDSWeek;
@@ -332,36 +305,77 @@ void RinexNavStore::loadBDSEph(NavEphBDS& bdsEph, string& line, fstream &navFile
 
     bdsEph.ctToc.setTimeSystem(TimeSystem::BDT);
 
-    bdsEphData[sat][bdsEph.ctToe] = bdsEph;
+    /// 北斗GEO卫星星历有效期较长（toe前后4小时），其他卫星toe前后2小时
+    double halfValid = (prn <= 5 || prn >= 59) ? 14400.0 : 7200.0;
+    bdsEph.prn = prn;
+    bdsEph.beginValid = bdsEph.ctToe - halfValid;
+    bdsEph.endValid = bdsEph.ctToe + halfValid;
 }
 
-
-void RinexNavStore::loadFile(string &file) {
-    rx3NavFile = file;
-    if (rx3NavFile.size() == 0) {
-        cout << "the nav file path is empty!" << endl;
-        exit(-1);
+void RinexNavStore::parseGLOEph(const RecordLines &rec, NavEphGLO &gloEph) {
+    int prn = epochField(rec, 1, 2);
+
+    /// GLONASS 的历元为 UTC
+    short ds;
+    CivilTime cvt = epochOf(rec, ds);
+    gloEph.CivilToe = cvt;
+    gloEph.ctToe = CivilTime2CommonTime(cvt);
+    if (ds != 0) gloEph.ctToe += ds;
+    gloEph.ctToe.setTimeSystem(TimeSystem::UTC);
+
+    gloEph.TauN = -navField(rec, 0, 23);
+    gloEph.GammaN = navField(rec, 0, 42);
+    gloEph.tk = navField(rec, 0, 61);
+
+    ///orbit-1/2/3，km、km/s、km/s^2
+    for (int i = 0; i < 3; i++) {
+        gloEph.pos[i] = orbitField(rec, i + 1, 0) * 1000.0;
+        gloEph.vel[i] = orbitField(rec, i + 1, 1) * 1000.0;
+        gloEph.acc[i] = orbitField(rec, i + 1, 2) * 1000.0;
     }
+    gloEph.SV_health = orbitField(rec, 1, 3);
+    gloEph.freqNum = orbitField(rec, 2, 3);
+    gloEph.ageOfInfo = orbitField(rec, 3, 3);
+
+    /// 星历每 30 分钟更新一次，toe 前后 30 分钟内可用
+    gloEph.prn = prn;
+    gloEph.beginValid = gloEph.ctToe - 1800.0;
+    gloEph.endValid = gloEph.ctToe + 1800.0;
+}
 
-    /*if (debug)
-        cout << "RinexNavStore: fileName:" << rx3NavFile << endl;*/
-
-    fstream navFileStream(rx3NavFile.c_str(), ios::in);
-    if (!navFileStream) {
-        cerr << "can't open file:" << rx3NavFile << endl;
-        exit(-1);
+void RinexNavStore::addSat(const PackedSat &sat) {
+    if (!satInTable.contains(sat)) {
+        satInTable[sat] = 1;
+        satTable.push_back(sat.toSatID());
     }
+}
 
-    int lineNumber(0);
+void RinexNavStore::addGPSEph(const NavEphGPS &gpsEph) {
+    PackedSat sat('G', gpsEph.prn);
+    addSat(sat);
+    gpsEphData.add(sat, gpsEph);
+}
 
-    ///first, we should read nav head
-    while (1) {
-        string line;
-        getline(navFileStream, line);
+void RinexNavStore::addBDSEph(const NavEphBDS &bdsEph) {
+    PackedSat sat('C', bdsEph.prn);
+    addSat(sat);
+    bdsEphData.add(sat, bdsEph);
+}
 
-        /*if (debug)
-            cout << "RinexNavStore:" << line << endl;*/
+void RinexNavStore::addGLOEph(const NavEphGLO &gloEph) {
+    PackedSat sat('R', gloEph.prn);
+    addSat(sat);
+    gloEphData.add(sat, gloEph);
+}
+
+const char *RinexNavStore::parseHeader(const char *b, const char *end) {
+    const char *p = b;
+    while (p < end) {
+        const char *le;
+        const char *lb = p;
+        p = nextLine(p, end, le);
 
+        string line(lb, le);
         stripTrailing(line);
 
         if (line.length() == 0) continue;
@@ -374,14 +388,12 @@ void RinexNavStore::loadFile(string &file) {
             throw (e);
         }
 
-        lineNumber++;
-
         string thisLabel(line, 60, 20);
 
         /// following is huge if else else ... endif for each record type
         if (thisLabel == stringVersion) {
             /// "RINEX VERSION / TYPE"
-            version = safeStod(line.substr(0, 20));
+            version = rinexStod(line, 0, 20);
             fileType = strip(line.substr(20, 20));
             if(version<3.0)
             {
@@ -410,7 +422,7 @@ void RinexNavStore::loadFile(string &file) {
             string ionoCorrType = strip(line.substr(0, 4));
             vector<double> ionoCorrCoeff;
             for (int i = 0; i < 4; i++) {
-                double ionoCorr = safeStod(line.substr(5 + 12 * i, 12));
+                double ionoCorr = rinexStod(line, 5 + 12 * i, 12);
                 ionoCorrCoeff.push_back(ionoCorr);
             }
             ionoCorrData[ionoCorrType].clear();
@@ -420,68 +432,247 @@ void RinexNavStore::loadFile(string &file) {
             string timeSysCorrType = strip(line.substr(0, 4));
 
             TimeSysCorr timeSysCorrValue;
-            timeSysCorrValue.A0 = safeStod(line.substr(5, 17));
-            timeSysCorrValue.A1 = safeStod(line.substr(22, 16));
-            timeSysCorrValue.refSOW = safeStoi(line.substr(38, 7));
-            timeSysCorrValue.refWeek = safeStoi(line.substr(45, 5));
+            timeSysCorrValue.A0 = rinexStod(line, 5, 17);
+            timeSysCorrValue.A1 = rinexStod(line, 22, 16);
+            timeSysCorrValue.refSOW = rinexStoi(line, 38, 7);
+            timeSysCorrValue.refWeek = rinexStoi(line, 45, 5);
             timeSysCorrValue.geoProvider = string(" ");
             timeSysCorrValue.geoUTCid = 0;
 
             timeSysCorrData[timeSysCorrType] = timeSysCorrValue;
         } else if (thisLabel == stringLeapSeconds) {
             /// "LEAP SECONDS"
-            leapSeconds = safeStoi(line.substr(0, 6));
-            leapDelta = safeStoi(line.substr(6, 6));
-            leapWeek = safeStoi(line.substr(12, 6));
-            leapDay = safeStoi(line.substr(18, 6));
+            leapSeconds = rinexStoi(line, 0, 6);
+            leapDelta = rinexStoi(line, 6, 6);
+            leapWeek = rinexStoi(line, 12, 6);
+            leapDay = rinexStoi(line, 18, 6);
         } else if (thisLabel == stringEoH) {
             /// "END OF HEADER"
-            break;
+            return p;
         }
     }
 
-    ///now, start read nav data
-    while (navFileStream.peek() != EOF) {
-        string line;
-        getline(navFileStream, line);
+    FFStreamError err("RinexNavStore: END OF HEADER is missing in " + rx3NavFile);
+    throw (err);
+}
 
-       // if (debug)
-         //   cout << "RinexNavStore:" << line << endl;
+void RinexNavStore::parseRecords(const char *b, const char *e,
+                                 vector<NavEphGPS> &gpsEphs, vector<NavEphBDS> &bdsEphs,
+                                 vector<NavEphGLO> &gloEphs) {
+    char wanted = SYS[0];
+    const char *p = b;
+    while (p < e) {
+        // GLONASS 记录为历元行和 3 行轨道参数，RINEX 3.05 的第 4 行轨道参数作为续行跳过
+        if (*p == 'R') {
+            RecordLines rec;
+            for (int i = 0; i < 4; i++) {
+                rec.lineBegin[i] = p;
+                p = nextLine(p, e, rec.lineEnd[i]);
+            }
+            gloEphs.push_back(NavEphGLO());
+            parseGLOEph(rec, gloEphs.back());
+            continue;
+        }
 
-        replace(line.begin(), line.end(), 'D', 'e');
+        // 其他系统的记录和续行不拆分字段，直接找下一行
+        if (*p != wanted) {
+            const char *nl = static_cast<const char *>(memchr(p, '\n', e - p));
+            p = (nl != NULL) ? nl + 1 : e;
+            continue;
+        }
 
-        if (line[0] == 'G' && SYS == "G") {
-            //if (1) cout << "gps" << endl;
-          //  if (1) cout << "RinexNavStore:" << line << endl;
-            NavEphGPS gpsEph;
-            loadGPSEph(gpsEph, line, navFileStream);
+        RecordLines rec;
+        for (int i = 0; i < 8; i++) {
+            rec.lineBegin[i] = p;
+            p = nextLine(p, e, rec.lineEnd[i]);
+        }
 
-            /*if (1)
-            {
+        if (wanted == 'G') {
+            gpsEphs.push_back(NavEphGPS());
+            parseGPSEph(rec, gpsEphs.back());
+        } else if (wanted == 'C') {
+            bdsEphs.push_back(NavEphBDS());
+            parseBDSEph(rec, bdsEphs.back());
+        }
+    }
+}
+
+void RinexNavStore::loadFile(string &file) {
+    rx3NavFile = file;
+    if (rx3NavFile.size() == 0) {
+        cout << "the nav file path is empty!" << endl;
+        exit(-1);
+    }
+
+    MappedFile mapped;
+    try {
+        mapped.open(rx3NavFile);
+    }
+    catch (FileMissingException &e) {
+        cerr << "can't open file:" << rx3NavFile << endl;
+        exit(-1);
+    }
 
-                cout << gpsEph.af0 << " " << gpsEph.af1 << " " << gpsEph.af2 << endl;
-                cout << gpsEph.IODE << " " << gpsEph.Crs << endl;
+    const char *data = parseHeader(mapped.begin(), mapped.end());
 
-            }*/
+    vector<NavEphGPS> gpsEphs;
+    vector<NavEphBDS> bdsEphs;
+    vector<NavEphGLO> gloEphs;
+    parseRecords(data, mapped.end(), gpsEphs, bdsEphs, gloEphs);
+    for (const NavEphGPS &gpsEph: gpsEphs) addGPSEph(gpsEph);
+    for (const NavEphBDS &bdsEph: bdsEphs) addBDSEph(bdsEph);
+    for (const NavEphGLO &gloEph: gloEphs) addGLOEph(gloEph);
+}
+
+// loadFiles 中一个文件的解析结果
+namespace {
+
+    struct NavFileResult {
+        RinexNavStore header;
+        vector<NavEphGPS> gpsEphs;
+        vector<NavEphBDS> bdsEphs;
+        vector<NavEphGLO> gloEphs;
+        std::exception_ptr error;
+    };
+
+    inline double issueOf(const NavEphGPS &eph) { return eph.IODE; }
+
+    inline double issueOf(const NavEphBDS &eph) { return eph.AODE; }
+
+    // GLONASS 没有 IODE，用参考时刻的 X 坐标区分数据组
+    inline double issueOf(const NavEphGLO &eph) { return eph.pos[0]; }
+
+    // 按卫星、toe 稳定排序后去掉卫星、toe、IODE 都相同的星历，保留最先的一组，返回去掉的组数；
+    // toe 相同而 IODE 不同的星历保持原来的先后顺序，加入 EphemerisStore 后仍以后面的为准。
+    // 星历有近 500 字节，只排序指针
+    template<class Eph>
+    size_t removeDuplicates(vector<const Eph *> &ephs) {
+        std::stable_sort(ephs.begin(), ephs.end(), [](const Eph *a, const Eph *b) {
+            if (a->prn != b->prn) return a->prn < b->prn;
+            return a->ctToe - b->ctToe < 0.0;
+        });
+
+        size_t m = 0;
+        size_t runStart = 0;        // 当前卫星、toe 相同的一段在结果中的起点
+        for (size_t i = 0; i < ephs.size(); i++) {
+            const Eph &eph = *ephs[i];
+            if (m == 0 || ephs[m - 1]->prn != eph.prn || ephs[m - 1]->ctToe - eph.ctToe != 0.0) {
+                runStart = m;
+            } else {
+                bool isDuplicate = false;
+                for (size_t j = runStart; j < m; j++) {
+                    if (issueOf(*ephs[j]) == issueOf(eph)) {
+                        isDuplicate = true;
+                        break;
+                    }
+                }
+                if (isDuplicate) continue;
+            }
+            ephs[m++] = ephs[i];
         }
-        if (line[0] == 'C' && SYS == "C")
-        {
+        size_t numRemoved = ephs.size() - m;
+        ephs.resize(m);
+        return numRemoved;
+    }
+}
 
-           // if (1) cout << "bds" << endl;
-           // if (1) cout << "RinexNavStore:" << line << endl;
-            NavEphBDS bdsEph;
-            loadBDSEph(bdsEph, line, navFileStream);
-            /*if (1)
-            {
+void RinexNavStore::mergeHeader(const RinexNavStore &other) {
+    rx3NavFile = other.rx3NavFile;
+    version = other.version;
+    fileType = other.fileType;
+    fileSys = other.fileSys;
+    fileProgram = other.fileProgram;
+    fileAgency = other.fileAgency;
+    date = other.date;
+    commentList.insert(commentList.end(), other.commentList.begin(), other.commentList.end());
+
+    for (ionoCorrMap::const_iterator it = other.ionoCorrData.begin(); it != other.ionoCorrData.end(); ++it) {
+        ionoCorrData[it->first] = it->second;
+    }
+    for (timeSysCorrMap::const_iterator it = other.timeSysCorrData.begin(); it != other.timeSysCorrData.end(); ++it) {
+        timeSysCorrData[it->first] = it->second;
+    }
 
-                cout << bdsEph.IDOT << " " << bdsEph.spare1 << " " << bdsEph.BDSWeek << " " << bdsEph.spare2 << endl;
-                cout << bdsEph.URA << " " << bdsEph.SV_health<< " " << bdsEph.TGD1 << " " << bdsEph.TGD2 << endl;
+    if (other.leapSeconds != 0) {
+        leapSeconds = other.leapSeconds;
+        leapDelta = other.leapDelta;
+        leapWeek = other.leapWeek;
+        leapDay = other.leapDay;
+    }
+}
 
-            }*/
-           // if (1) cout << "cToe" << bdsEph.ctToe << endl;
+int RinexNavStore::loadThreadCount(int numThreads, size_t numFiles) {
+    int numCores = int(std::thread::hardware_concurrency());
+    if (numCores <= 1) return 1;
+    if (numThreads <= 0) numThreads = numCores;
+    return std::max(std::min(numThreads, int(numFiles)), 1);
+}
 
+size_t RinexNavStore::loadFiles(const vector<string> &files, int numThreads) {
+    if (files.empty()) return 0;
+
+    vector<NavFileResult> results(files.size());
+    std::atomic<size_t> nextFile(0);
+
+    // 每个线程依次取下一个还没有解析的文件，结果只写入该文件自己的 NavFileResult
+    auto worker = [&]() {
+        size_t k;
+        while ((k = nextFile++) < files.size()) {
+            NavFileResult &result = results[k];
+            try {
+                result.header.rx3NavFile = files[k];
+                MappedFile mapped(files[k]);
+                const char *data = result.header.parseHeader(mapped.begin(), mapped.end());
+                parseRecords(data, mapped.end(), result.gpsEphs, result.bdsEphs, result.gloEphs);
+            }
+            catch (...) {
+                result.error = std::current_exception();
+            }
+        }
+    };
+
+    numThreads = loadThreadCount(numThreads, files.size());
+
+    // 单核时多线程只增加切换的开销，在当前线程中逐个解析
+    if (numThreads == 1) {
+        worker();
+    } else {
+        vector<std::thread> workers;
+        for (int i = 0; i < numThreads; i++) {
+            workers.push_back(std::thread(worker));
         }
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+    }
+
+    for (size_t k = 0; k < results.size(); k++) {
+        if (results[k].error) std::rethrow_exception(results[k].error);
     }
+
+    // 按文件顺序合并后去重，再一次加入
+    vector<const NavEphGPS *> gpsEphs;
+    vector<const NavEphBDS *> bdsEphs;
+    vector<const NavEphGLO *> gloEphs;
+    for (size_t k = 0; k < results.size(); k++) {
+        const NavFileResult &result = results[k];
+        mergeHeader(result.header);
+        for (const NavEphGPS &gpsEph: result.gpsEphs) gpsEphs.push_back(&gpsEph);
+        for (const NavEphBDS &bdsEph: result.bdsEphs) bdsEphs.push_back(&bdsEph);
+        for (const NavEphGLO &gloEph: result.gloEphs) gloEphs.push_back(&gloEph);
+    }
+
+    size_t numRemoved = removeDuplicates(gpsEphs) + removeDuplicates(bdsEphs) + removeDuplicates(gloEphs);
+    for (const NavEphGPS *pEph: gpsEphs) addGPSEph(*pEph);
+    for (const NavEphBDS *pEph: bdsEphs) addBDSEph(*pEph);
+    for (const NavEphGLO *pEph: gloEphs) addGLOEph(*pEph);
+
+    if (debug) {
+        cout << "RinexNavStore: " << files.size() << " files, " << gpsEphs.size() << " GPS, "
+             << bdsEphs.size() << " BDS and " << gloEphs.size() << " GLONASS ephemerides, "
+             << numRemoved << " duplicates" << endl;
+    }
+    return numRemoved;
 }
 
 Xvt RinexNavStore::getXvt(const SatID &sat, const CommonTime &epoch) {
@@ -499,8 +690,9 @@ Xvt RinexNavStore::getXvt(const SatID &sat, const CommonTime &epoch) {
             cout << CommonTime2CivilTime(epoch) << endl;*/
 
         //todo:这里就涉及到星历的获取方式了，改这里！！！！
-        NavEphGPS gpsEph = findGPSEph(sat, realEpoch);
-        cout << "sat: " << sat << " prn: " << gpsEph.prn << endl;
+        const NavEphGPS &gpsEph = findGPSEph(sat, realEpoch);
+        if (debug)
+            cout << "sat: " << sat << " prn: " << gpsEph.prn << endl;
        // cout << "Toc: " << gpsEph.Toc << endl;
 
        /* if (1)
@@ -534,7 +726,7 @@ Xvt RinexNavStore::getXvt(const SatID &sat, const CommonTime &epoch) {
 
 
 
-        NavEphBDS bdsEph = findBDSEph(sat, realEpoch);//todo:初步判断这里没错
+        const NavEphBDS &bdsEph = findBDSEph(sat, realEpoch);//todo:初步判断这里没错
 
 
       /* if (1)
@@ -547,6 +739,11 @@ Xvt RinexNavStore::getXvt(const SatID &sat, const CommonTime &epoch) {
         xvt = bdsEph.svXvt(realEpoch);//todo:问题在这里！！！！问题在这里 ！！！！！初步判断为传参不成功
         //if (1) cout << "bdsxvt" << endl;
 
+    } else if (sat.system == "R") {
+        // convertTimeSystem 不修改时间系统的标记，这里标为 UTC，与星历的有效期比较时才不会出错
+        realEpoch = convertTimeSystem(epoch, TimeSystem::UTC);
+        realEpoch.setTimeSystem(TimeSystem::UTC);
+        xvt = gloIntegrator.getXvt(findGLOEph(sat, realEpoch), realEpoch);
     }
     else {
         InvalidRequest e("RinexNavStore: don't support the input satellite system!");
@@ -556,54 +753,47 @@ Xvt RinexNavStore::getXvt(const SatID &sat, const CommonTime &epoch) {
     return xvt;
 }
 
-NavEphGPS RinexNavStore::findGPSEph(const SatID &sat, const CommonTime &epoch) {
-  //  GPSWeekSecond targetWS;
-    //cout << "epoch: " << epoch << endl;//todo:这里参数传入是正常的
-  //  CommonTime2WeekSecond(epoch, targetWS);
-   // cout << "targetWS: " << targetWS.week << " " << targetWS.sow <<  endl;//todo:这里输出不了，说明转换有问题
-    NavEphGPS GPSEph;
-    GPSEph = gpsNav[sat.id - 1];
-
-    // todo:
-    // 这里应该改进，寻找最接近的历元的卫星星历
-   /* for (auto it: gpsEphData[sat]) {
-        GPSWeekSecond ws;
-        CommonTime2WeekSecond(it.first, ws);
-        double diff = ws.sow - targetWS.sow;
-        if (diff >= -7201.0 && diff <= 7201.0) {
-            gpsEph = it.second;
-            break;
-        }
-    }*/
-
-    return GPSEph;
+CommonTime RinexNavStore::getToe(const SatID &sat, const CommonTime &epoch) {
+    if (sat.system == "G" && SYS == "G") {
+        return findGPSEph(sat, convertTimeSystem(epoch, TimeSystem::GPS)).ctToe;
+    } else if (sat.system == "C" && SYS == "C") {
+        return findBDSEph(sat, convertTimeSystem(epoch, TimeSystem::BDT)).ctToe;
+    } else if (sat.system == "R") {
+        CommonTime realEpoch = convertTimeSystem(epoch, TimeSystem::UTC);
+        realEpoch.setTimeSystem(TimeSystem::UTC);
+        return findGLOEph(sat, realEpoch).ctToe;
+    }
+    InvalidRequest e("RinexNavStore: don't support the input satellite system!");
+    throw (e);
 }
 
-NavEphBDS RinexNavStore::findBDSEph(const SatID& sat, const CommonTime& epoch)
-{
-  /*  BDSWeekSecond targetWS;
-    CommonTime2WeekSecond(epoch, targetWS);*/
-    NavEphBDS bdsEph;
-    bdsEph = bdsNav[sat.id - 1];
-    // 3.2 北斗GEO卫星星历有效期较长（通常4小时），其他卫星2小时
-   /* double maxValidDiff = (sat.id <= 5) ? 14400.0 : 7200.0;  // GEO(PRN1-5)有效期4小时，其他2小时
-    double minDiff = std::numeric_limits<double>::max();
-
-    for (auto it: bdsEphData[sat]) {
-        BDSWeekSecond ws;
-        CommonTime2WeekSecond(it.first, ws);
-        double diff = std::abs(ws.sow - targetWS.sow);
-        if (diff <= maxValidDiff && diff < minDiff) {
-            minDiff = diff;
-            bdsEph = it.second;
-        }
-    }*/
-    return bdsEph;
+const NavEphGPS &RinexNavStore::findGPSEph(const SatID &sat, const CommonTime &epoch) {
+    PackedSat packedSat(sat);
+    if (gpsEphData.contains(packedSat)) {
+        return gpsEphData.find(packedSat, epoch, &gpsHint);
+    }
 
+    // 实时流解码的星历，每颗卫星只有一组
+    if (sat.id < 1 || sat.id > MAXGPSPRN || gpsNav[sat.id - 1].prn == 0) {
+        InvalidRequest e("RinexNavStore: no ephemeris for " + sat.toString());
+        throw (e);
+    }
+    return gpsNav[sat.id - 1];
 }
 
+const NavEphBDS &RinexNavStore::findBDSEph(const SatID &sat, const CommonTime &epoch) {
+    PackedSat packedSat(sat);
+    if (bdsEphData.contains(packedSat)) {
+        return bdsEphData.find(packedSat, epoch, &bdsHint);
+    }
 
+    if (sat.id < 1 || sat.id > MAXBDSPRN || bdsNav[sat.id - 1].prn == 0) {
+        InvalidRequest e("RinexNavStore: no ephemeris for " + sat.toString());
+        throw (e);
+    }
+    return bdsNav[sat.id - 1];
+}
 
-
-
-
+const NavEphGLO &RinexNavStore::findGLOEph(const SatID &sat, const CommonTime &epoch) {
+    return gloEphData.find(PackedSat(sat), epoch, &gloHint);
+}
@@ -20,10 +20,15 @@
 #include <map>
 #include <algorithm>
 #include <fstream>
+#include <vector>
 
 #include "NavEphGPS.hpp"
 #include "NavEphBDS.h"
+#include "NavEphGLO.h"
+#include "GLOOrbitIntegrator.h"
 #include "GnssStruct.h"
+#include "EphemerisStore.h"
+#include "SatIndex.h"
 
 
 using namespace std;
@@ -31,17 +36,48 @@ using namespace std;
 class RinexNavStore {
 public:
 
-    RinexNavStore() {};
+    RinexNavStore()
+            : version(0.0), leapSeconds(0), leapDelta(0), leapWeek(0), leapDay(0) {};
 
+    // 一条 GPS、北斗星历记录的 8 行：历元行和 7 行轨道参数（GLONASS 只用前 4 行），
+    // lineBegin[i]、lineEnd[i] 为第 i 行的首尾（不含换行符），文件中缺少的行为空区间
+    struct RecordLines {
+        const char *lineBegin[8];
+        const char *lineEnd[8];
+    };
+
+    // line 为记录的历元行，其余 7 行从 navFile 读入，读完后 line 为最后一行
     void loadGPSEph(NavEphGPS &gpsEph, string &line, fstream &navFile);
     void loadBDSEph(NavEphBDS &bdsEph, string &line, fstream &navFile);
     void loadFile(string &file);
+
+    // 加载多个导航文件（如连续多天的文件），numThreads 个线程同时解析（0 为 CPU 核数，
+    // 单核或取不到核数时不论 numThreads 都在当前线程中逐个解析，见 loadThreadCount），
+    // 解析完后按文件顺序一次并入：
+    //  - 卫星、toe、IODE（北斗为 AODE）都相同的星历只保留最先读到的一组；
+    //  - 头记录中版本、程序、日期等取最后一个文件的，电离层、时间系统改正按类型以后面的文件为准，
+    //    跳秒取最后一个有 LEAP SECONDS 的文件，注释依次追加。
+    // 文件不存在或格式错误时抛出 FileMissingException、FFStreamError（多个文件出错时为排在最前的一个），
+    // 这时不修改已有的数据。返回去掉的重复星历组数。
+    size_t loadFiles(const vector<string> &files, int numThreads = 0);
+    // loadFiles 实际使用的线程数
+    static int loadThreadCount(int numThreads, size_t numFiles);
+    // GLONASS 卫星的状态由 gloIntegrator 积分得到，不受 SYS 的限制
     Xvt getXvt(const SatID &sat, const CommonTime &epoch);
-    NavEphGPS findGPSEph(const SatID &sat, const CommonTime &epoch);
-    NavEphBDS findBDSEph(const SatID &sat, const CommonTime &epoch);
+
+    // 在 epoch 时刻可用的星历中选择 toe 最近的一组；
+    // 没有从文件读入的星历时使用实时解码写入的 gpsNav/bdsNav，都没有时抛出 InvalidRequest
+    const NavEphGPS &findGPSEph(const SatID &sat, const CommonTime &epoch);
+    const NavEphBDS &findBDSEph(const SatID &sat, const CommonTime &epoch);
+
+    // GLONASS 星历只从文件读入，epoch 为 UTC
+    const NavEphGLO &findGLOEph(const SatID &sat, const CommonTime &epoch);
+
+    // epoch 时刻 getXvt 选用的星历的 toe，用来判断两个时刻是否由同一组星历计算
+    CommonTime getToe(const SatID &sat, const CommonTime &epoch);
 
     NavEphGPS gpsNav[MAXGPSPRN];
-    NavEphBDS bdsNav[MAXBDSPRN];//广播星历，以prn为索引//todo:我先暂时只定义一个结构来存储
+    NavEphBDS bdsNav[MAXBDSPRN];//实时解码的广播星历，以prn为索引，每颗卫星只保存最新的一组
 
 
     /// destructor
@@ -94,10 +130,42 @@ public:
     ///in order to get the eph data num easily
     vector<SatID> satTable;
 
-    map<SatID, std::map<CommonTime, NavEphGPS>> gpsEphData;
-    map<SatID, std::map<CommonTime, NavEphBDS>> bdsEphData;
+    ///all ephemerides loaded from files, indexed by satellite and toe
+    EphemerisStore<NavEphGPS> gpsEphData;
+    EphemerisStore<NavEphBDS> bdsEphData;
+    EphemerisStore<NavEphGLO> gloEphData;
+
+    ///GLONASS orbit integration, keeps the integrated steps of each satellite
+    GLOOrbitIntegrator gloIntegrator;
+
+private:
+    // 解析头记录，写入本对象的头记录成员，返回 END OF HEADER 的下一行
+    const char *parseHeader(const char *b, const char *e);
+
+    // 解析头记录之后的星历记录，只取 SYS 对应的系统和 GLONASS，其他系统的记录逐行跳过
+    static void parseRecords(const char *b, const char *e,
+                             vector<NavEphGPS> &gpsEphs, vector<NavEphBDS> &bdsEphs,
+                             vector<NavEphGLO> &gloEphs);
+
+    static void parseGPSEph(const RecordLines &rec, NavEphGPS &gpsEph);
+    static void parseBDSEph(const RecordLines &rec, NavEphBDS &bdsEph);
+    static void parseGLOEph(const RecordLines &rec, NavEphGLO &gloEph);
+
+    // 加入星历，第一次出现的卫星同时加入 satTable
+    void addGPSEph(const NavEphGPS &gpsEph);
+    void addBDSEph(const NavEphBDS &bdsEph);
+    void addGLOEph(const NavEphGLO &gloEph);
+    void addSat(const PackedSat &sat);
+
+    // 其他文件的头记录按 loadFiles 的规则并入
+    void mergeHeader(const RinexNavStore &other);
 
+    SatTable<char> satInTable;     // satTable 中已有的卫星
 
+    // findGPSEph 等查找星历时每颗卫星上一次查到的星历
+    EphemerisStore<NavEphGPS>::Hint gpsHint;
+    EphemerisStore<NavEphBDS>::Hint bdsHint;
+    EphemerisStore<NavEphGLO>::Hint gloHint;
 
 };
 
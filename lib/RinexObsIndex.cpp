@@ -0,0 +1,235 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include "RinexObsIndex.h"
+#include "RinexObsMMapReader.h"
+#include "MappedFile.h"
+#include "RinexField.h"
+
+#define debug 0
+
+namespace {
+
+    // sidecar 文件格式（本机字节序）：
+    //   char[8]  magic
+    //   uint64   观测值文件大小
+    //   int64    观测值文件的修改时间
+    //   uint64   第一个数据历元的偏移
+    //   uint64   历元个数 n
+    //   n 个 { int64 day; double sod; int32 timeSystem; int32 保留; uint64 offset; }
+    const char indexMagic[8] = {'G', 'L', 'E', 'I', 'D', 'X', '0', '2'};
+
+    struct DiskEntry {
+        int64_t day;
+        double sod;
+        int32_t timeSystem;
+        int32_t reserved;
+        uint64_t offset;
+    };
+
+    // 取出 pCur 开始的一行，去掉行尾的 '\r'，pCur 移动到下一行行首
+    inline bool nextLine(const char *&pCur, const char *end,
+                         const char *&lineBegin, const char *&lineEnd) {
+        if (pCur >= end) return false;
+
+        lineBegin = pCur;
+        const char *nl = static_cast<const char *>(memchr(pCur, '\n', end - pCur));
+        if (nl == NULL) {
+            lineEnd = end;
+            pCur = end;
+        } else {
+            lineEnd = nl;
+            pCur = nl + 1;
+        }
+        if (lineEnd > lineBegin && *(lineEnd - 1) == '\r') --lineEnd;
+        return true;
+    }
+
+    inline bool epochLess(const RinexObsIndex::Entry &a, const RinexObsIndex::Entry &b) {
+        return a.epoch < b.epoch;
+    }
+}
+
+void RinexObsIndex::build(const string &obsFile) {
+    MappedFile mappedFile(obsFile);
+    const char *begin = mappedFile.begin();
+    const char *end = mappedFile.end();
+    const char *pCur = begin;
+    const char *lb, *le, *fb, *fe;
+
+    entries.clear();
+    fileSize = mappedFile.size();
+    fileMtime = MappedFile::modifiedTime(obsFile);
+
+    // 跳过文件头
+    static const char endOfHeader[] = "END OF HEADER";
+    while (true) {
+        if (!nextLine(pCur, end, lb, le)) {
+            FFStreamError e("RinexObsIndex: END OF HEADER not found in " + obsFile);
+            throw e;
+        }
+        fieldRange(lb, le, 60, 20, fb, fe);
+        if (size_t(fe - fb) >= sizeof(endOfHeader) - 1 &&
+            memcmp(fb, endOfHeader, sizeof(endOfHeader) - 1) == 0) {
+            break;
+        }
+    }
+    dataOffset = pCur - begin;
+
+    // 只看历元行，卫星数据行按行跳过
+    while (nextLine(pCur, end, lb, le)) {
+        if (le - lb < 2 || lb[0] != '>' || lb[1] != ' ') {
+            FFStreamError e("RinexObsIndex: bad epoch line: >" + string(lb, le) + "<");
+            throw e;
+        }
+
+        fieldRange(lb, le, 31, 1, fb, fe);
+        int epochFlag = rinexStoi(fb, fe);
+        fieldRange(lb, le, 32, 3, fb, fe);
+        int numSats = rinexStoi(fb, fe);
+
+        if (epochFlag < 2 || epochFlag > 5) {
+            Entry entry;
+            entry.epoch = RinexObsMMapReader::parseTime(lb, le);
+            entry.offset = lb - begin;
+            entries.push_back(entry);
+        }
+
+        for (int i = 0; i < numSats; ++i) {
+            if (!nextLine(pCur, end, fb, fe)) break;
+        }
+    }
+
+    // 正常的观测值文件本身就是按时间排列的
+    if (!std::is_sorted(entries.begin(), entries.end(), epochLess)) {
+        std::stable_sort(entries.begin(), entries.end(), epochLess);
+    }
+
+    if (debug)
+        cout << "RinexObsIndex: " << entries.size() << " epochs in " << obsFile << endl;
+}
+
+bool RinexObsIndex::load(const string &obsFile) {
+    std::ifstream idxStream(sidecarName(obsFile).c_str(), ios::in | ios::binary);
+    if (!idxStream) return false;
+
+    char magic[8];
+    uint64_t idxFileSize, idxDataOffset, count;
+    int64_t idxFileMtime;
+    idxStream.read(magic, sizeof(magic));
+    idxStream.read(reinterpret_cast<char *>(&idxFileSize), sizeof(idxFileSize));
+    idxStream.read(reinterpret_cast<char *>(&idxFileMtime), sizeof(idxFileMtime));
+    idxStream.read(reinterpret_cast<char *>(&idxDataOffset), sizeof(idxDataOffset));
+    idxStream.read(reinterpret_cast<char *>(&count), sizeof(count));
+    if (!idxStream || memcmp(magic, indexMagic, sizeof(indexMagic)) != 0) {
+        return false;
+    }
+
+    // 观测值文件大小或修改时间变了，或者偏移处不是历元行，说明 sidecar 已经过期；
+    // 大小不变的修改（比如改正一个历元的时间）只能由修改时间发现
+    MappedFile mappedFile;
+    int64_t obsMtime;
+    try {
+        mappedFile.open(obsFile);
+        obsMtime = MappedFile::modifiedTime(obsFile);
+    } catch (FileMissingException &e) {
+        return false;
+    }
+    if (idxFileSize != mappedFile.size() || idxFileMtime != obsMtime || count > idxFileSize) {
+        return false;
+    }
+
+    std::vector<DiskEntry> diskEntries(count);
+    if (count > 0) {
+        idxStream.read(reinterpret_cast<char *>(&diskEntries[0]), count * sizeof(DiskEntry));
+        if (!idxStream) return false;
+
+        const uint64_t offsets[2] = {diskEntries.front().offset, diskEntries.back().offset};
+        for (uint64_t offset: offsets) {
+            if (offset >= idxFileSize || mappedFile.begin()[offset] != '>') {
+                return false;
+            }
+        }
+    }
+
+    entries.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const DiskEntry &d = diskEntries[i];
+        entries[i].epoch = CommonTime(static_cast<long>(d.day), d.sod,
+                                      static_cast<TimeSystem::SystemType>(d.timeSystem));
+        entries[i].offset = d.offset;
+    }
+    fileSize = idxFileSize;
+    fileMtime = idxFileMtime;
+    dataOffset = idxDataOffset;
+    return true;
+}
+
+void RinexObsIndex::save(const string &obsFile) const {
+    string idxFile = sidecarName(obsFile);
+    std::ofstream idxStream(idxFile.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!idxStream) {
+        FileMissingException e("RinexObsIndex: can't write " + idxFile);
+        throw e;
+    }
+
+    uint64_t count = entries.size();
+    idxStream.write(indexMagic, sizeof(indexMagic));
+    idxStream.write(reinterpret_cast<const char *>(&fileSize), sizeof(fileSize));
+    idxStream.write(reinterpret_cast<const char *>(&fileMtime), sizeof(fileMtime));
+    idxStream.write(reinterpret_cast<const char *>(&dataOffset), sizeof(dataOffset));
+    idxStream.write(reinterpret_cast<const char *>(&count), sizeof(count));
+
+    std::vector<DiskEntry> diskEntries(count);
+    for (size_t i = 0; i < count; i++) {
+        DiskEntry &d = diskEntries[i];
+        long day;
+        double sod;
+        TimeSystem ts;
+        entries[i].epoch.get(day, sod, ts);
+        d.day = day;
+        d.sod = sod;
+        d.timeSystem = static_cast<int32_t>(ts.system);
+        d.reserved = 0;
+        d.offset = entries[i].offset;
+    }
+    if (count > 0) {
+        idxStream.write(reinterpret_cast<const char *>(&diskEntries[0]), count * sizeof(DiskEntry));
+    }
+
+    if (!idxStream) {
+        FileMissingException e("RinexObsIndex: can't write " + idxFile);
+        throw e;
+    }
+}
+
+void RinexObsIndex::loadOrBuild(const string &obsFile, bool saveSidecar) {
+    if (load(obsFile)) return;
+
+    build(obsFile);
+
+    // sidecar 只是加速用的，写不了（比如只读目录）不影响使用
+    if (saveSidecar) {
+        try {
+            save(obsFile);
+        } catch (FileMissingException &e) {
+            cerr << e.what() << endl;
+        }
+    }
+}
+
+size_t RinexObsIndex::lowerBound(const CommonTime &t) const {
+    Entry key;
+    key.epoch = t;
+    key.offset = 0;
+    return std::lower_bound(entries.begin(), entries.end(), key, epochLess) - entries.begin();
+}
+
+void RinexObsIndex::range(const CommonTime &t0, const CommonTime &t1,
+                          size_t &first, size_t &last) const {
+    first = lowerBound(t0);
+    last = (t1 <= t0) ? first : std::max(first, lowerBound(t1));
+}
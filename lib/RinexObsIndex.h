@@ -0,0 +1,75 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_RINEXOBSINDEX_H
+#define GNSSLAB_RINEXOBSINDEX_H
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#include "TimeStruct.h"
+
+using namespace std;
+
+// RINEX 3 观测值文件的历元索引：历元时刻 -> 历元行 ('>') 在文件中的字节偏移
+//
+// 建立索引时只解析历元行的时间和卫星数，卫星数据行直接按行跳过，不做数值转换。
+// 索引按时间排序，读取器可以据此用二分查找在 O(log n) 内定位任意历元或时间段 [t0, t1)，
+// 处理大文件中的一个时间窗口时不必解析它前面的所有历元。
+//
+// 索引可以保存为观测值文件旁边的 sidecar 文件（<obsFile>.eidx），下次直接读取；
+// sidecar 中记录了观测值文件的大小和修改时间，文件变化后（包括大小不变的修改）自动重建。
+// 事件历元（flag 2~5）不进入索引。
+class RinexObsIndex {
+public:
+    struct Entry {
+        CommonTime epoch;
+        uint64_t offset;
+    };
+
+    RinexObsIndex() : dataOffset(0), fileSize(0), fileMtime(0) {};
+
+    // 扫描观测值文件建立索引，文件打不开时抛出 FileMissingException
+    void build(const string &obsFile);
+
+    // 读取 sidecar 索引；sidecar 不存在、格式不对或与观测值文件不匹配时返回 false
+    bool load(const string &obsFile);
+
+    // 把索引写到 sidecar 文件，写失败时抛出 FileMissingException
+    void save(const string &obsFile) const;
+
+    // 优先读取 sidecar，失败则重新扫描，并按需写出新的 sidecar
+    void loadOrBuild(const string &obsFile, bool saveSidecar = true);
+
+    static string sidecarName(const string &obsFile) {
+        return obsFile + ".eidx";
+    }
+
+    // 第一个不早于 t 的历元序号，没有则返回 size()
+    size_t lowerBound(const CommonTime &t) const;
+
+    // 落在 [t0, t1) 内的历元序号区间 [first, last)
+    void range(const CommonTime &t0, const CommonTime &t1,
+               size_t &first, size_t &last) const;
+
+    const Entry &operator[](size_t i) const { return entries[i]; }
+
+    size_t size() const { return entries.size(); }
+
+    bool empty() const { return entries.empty(); }
+
+    // 第一个数据历元的偏移（即 END OF HEADER 的下一行）
+    uint64_t getDataOffset() const { return dataOffset; }
+
+    ~RinexObsIndex() {};
+
+private:
+    std::vector<Entry> entries;
+    uint64_t dataOffset;
+    uint64_t fileSize;
+    int64_t fileMtime;      // 观测值文件的修改时间，见 MappedFile::modifiedTime
+};
+
+#endif //GNSSLAB_RINEXOBSINDEX_H
@@ -0,0 +1,602 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include "RinexObsMMapReader.h"
+#include "TimeConvert.h"
+#include "RinexField.h"
+
+#define debug 0
+
+namespace {
+
+    // 头记录标签位于 61~80 列，去掉两端空白后比较
+    inline bool labelIs(const char *lb, const char *le, const char *label) {
+        const char *fb, *fe;
+        fieldRange(lb, le, 60, 20, fb, fe);
+        while (fb < fe && isspace(static_cast<unsigned char>(*fb))) ++fb;
+        while (fe > fb && isspace(static_cast<unsigned char>(*(fe - 1)))) --fe;
+        size_t n = strlen(label);
+        return size_t(fe - fb) == n && memcmp(fb, label, n) == 0;
+    }
+}
+
+RinexObsMMapReader::RinexObsMMapReader()
+        : pCur(NULL), dataOffset(0), isHeaderRead(false), pEpochIndex(NULL) {
+    std::fill(hasObsTypes, hasObsTypes + 128, false);
+}
+
+RinexObsMMapReader::RinexObsMMapReader(const string &fileName)
+        : pCur(NULL), dataOffset(0), isHeaderRead(false), pEpochIndex(NULL) {
+    std::fill(hasObsTypes, hasObsTypes + 128, false);
+    open(fileName);
+}
+
+void RinexObsMMapReader::open(const string &fileName) {
+    mappedFile.open(fileName);
+    pCur = mappedFile.begin();
+    dataOffset = 0;
+    isHeaderRead = false;
+    rinexHeader = RinexHeader();
+    for (auto &columns: sysColumns) columns.clear();
+    std::fill(hasObsTypes, hasObsTypes + 128, false);
+}
+
+// 从游标 pos 取出一行，去掉行尾的 '\r'，游标移动到下一行行首
+bool RinexObsMMapReader::nextLine(const char *&pos, const char *&lineBegin, const char *&lineEnd) const {
+    const char *end = mappedFile.end();
+    if (pos == NULL || pos >= end) return false;
+
+    lineBegin = pos;
+    const char *nl = static_cast<const char *>(memchr(pos, '\n', end - pos));
+    if (nl == NULL) {
+        lineEnd = end;
+        pos = end;
+    } else {
+        lineEnd = nl;
+        pos = nl + 1;
+    }
+    if (lineEnd > lineBegin && *(lineEnd - 1) == '\r') --lineEnd;
+    return true;
+}
+
+void RinexObsMMapReader::parseRinexHeader() {
+    const char *lb, *le, *fb, *fe;
+    string satSys;
+    int numObs = 0;
+    std::map<string, std::vector<string>> mapObsTypes;
+
+    while (true) {
+        if (!nextLine(pCur, lb, le)) {
+            FFStreamError e("RinexObsMMapReader: END OF HEADER not found in " + mappedFile.getFileName());
+            throw e;
+        }
+
+        if (debug)
+            cout << "parseRinexHeader:" << string(lb, le) << endl;
+
+        if (labelIs(lb, le, "END OF HEADER")) {
+            break;
+        } else if (labelIs(lb, le, "MARKER NAME")) {
+            fieldRange(lb, le, 0, 60, fb, fe);
+            string markerName(fb, fe);
+            std::replace(markerName.begin(), markerName.end(), ' ', '_');
+            rinexHeader.station = markerName;
+        } else if (labelIs(lb, le, "RINEX VERSION / TYPE")) {
+            fieldRange(lb, le, 0, 20, fb, fe);
+            double version = rinexStod(fb, fe);
+            if (version != 3.04) {
+                cerr << "only support rinex 3.04 version!" << endl;
+                exit(-1);
+            }
+            rinexHeader.version = version;
+        } else if (labelIs(lb, le, "APPROX POSITION XYZ")) {
+            for (int i = 0; i < 3; i++) {
+                fieldRange(lb, le, 14 * i, 14, fb, fe);
+                rinexHeader.antennaPosition[i] = rinexStod(fb, fe);
+            }
+        } else if (labelIs(lb, le, "SYS / # / OBS TYPES")) {
+            // 续行的系统标识为空，沿用上一行的系统和观测值个数
+            if (fieldChar(lb, le, 0) != ' ') {
+                satSys = string(1, lb[0]);
+                fieldRange(lb, le, 3, 3, fb, fe);
+                numObs = rinexStoi(fb, fe);
+            }
+
+            const int maxObsPerLine = 13;
+            std::vector<string> &types = mapObsTypes[satSys];
+            for (int i = 0; i < maxObsPerLine && types.size() < size_t(numObs); i++) {
+                fieldRange(lb, le, 4 * i + 7, 3, fb, fe);
+                string typeStr(fb, fe);
+                typeStr.resize(3, ' ');
+                types.push_back(typeStr);
+            }
+        }
+    }
+    rinexHeader.mapObsTypes = mapObsTypes;
+
+    compileObsColumns();
+    dataOffset = pCur - mappedFile.begin();
+    isHeaderRead = true;
+}
+
+void RinexObsMMapReader::setSelectedTypes(std::map<string, std::set<string>> &systemTypes) {
+    sysTypes = systemTypes;
+    compileObsColumns();
+}
+
+// 读完文件头或改变选择后，为 G/C 两个系统列出要解析的列并算好换算系数，解析历元时只需查表；
+// 未选择的列和频率未知的载波相位不在列表中
+void RinexObsMMapReader::compileObsColumns() {
+    for (auto &columns: sysColumns) columns.clear();
+    std::fill(hasObsTypes, hasObsTypes + 128, false);
+
+    for (const auto &sysEntry: rinexHeader.mapObsTypes) {
+        const string &sys = sysEntry.first;
+        if (sys != "G" && sys != "C") continue;
+        hasObsTypes[static_cast<unsigned char>(sys[0]) & 0x7f] = true;
+
+        auto itSys = sysTypes.find(sys);
+        if (itSys == sysTypes.end()) continue;
+
+        std::vector<ObsColumn> &columns = sysColumns[static_cast<unsigned char>(sys[0]) & 0x7f];
+        for (size_t i = 0; i < sysEntry.second.size(); i++) {
+            const string &typeStr = sysEntry.second[i];
+            if (itSys->second.find(typeStr) == itSys->second.end()) continue;
+
+            ObsColumn column;
+            column.index = int(i);
+            column.type = typeStr;
+            column.code = ObsCodeTable::intern(typeStr);
+            column.scale = obsScale(sys, typeStr);
+            if (column.scale == 0.0) continue;
+            columns.push_back(column);
+        }
+    }
+}
+
+double RinexObsMMapReader::obsScale(const string &sys, const string &typeStr) {
+    if (typeStr.size() < 2 || typeStr[0] != 'L') {
+        return 1.0;
+    }
+
+    // 载波相位，周 -> 米
+    int n;
+    if (typeStr[1] == 'A') {
+        n = 1;
+    } else {
+        n = typeStr[1] - '0';
+    }
+    return getWavelength(sys, n);
+}
+
+const RinexHeader &RinexObsMMapReader::getHeader() {
+    if (!isHeaderRead) {
+        parseRinexHeader();
+    }
+    return rinexHeader;
+}
+
+ObsData RinexObsMMapReader::parseRinexObs() {
+
+    if (!isHeaderRead) {
+        parseRinexHeader();
+    }
+
+    return decodeEpoch(pCur);
+}
+
+ObsData RinexObsMMapReader::parseEpochAt(uint64_t offset) const {
+    if (!isHeaderRead) {
+        InvalidRequest e("RinexObsMMapReader::parseEpochAt: header not parsed");
+        throw e;
+    }
+    if (offset >= mappedFile.size()) {
+        EndOfFile err("EOF encountered!");
+        throw err;
+    }
+
+    const char *pos = mappedFile.begin() + offset;
+    return decodeEpoch(pos);
+}
+
+ObsData RinexObsMMapReader::parseEpochAt(uint64_t offset, uint64_t &nextOffset) const {
+    if (!isHeaderRead) {
+        InvalidRequest e("RinexObsMMapReader::parseEpochAt: header not parsed");
+        throw e;
+    }
+    if (offset >= mappedFile.size()) {
+        EndOfFile err("EOF encountered!");
+        throw err;
+    }
+
+    const char *pos = mappedFile.begin() + offset;
+    ObsData obsData = decodeEpoch(pos);
+    nextOffset = pos - mappedFile.begin();
+    return obsData;
+}
+
+uint64_t RinexObsMMapReader::findEpochLine(uint64_t offset) const {
+    const char *begin = mappedFile.begin();
+    const char *end = mappedFile.end();
+    if (offset >= mappedFile.size()) return mappedFile.size();
+
+    // 从 offset 之后的第一个行首开始
+    const char *pos = begin + offset;
+    if (offset > 0 && *(pos - 1) != '\n') {
+        const char *nl = static_cast<const char *>(memchr(pos, '\n', end - pos));
+        if (nl == NULL) return mappedFile.size();
+        pos = nl + 1;
+    }
+
+    // 卫星数据行以系统标识开头，只有历元行以 "> " 开头
+    const char *lb, *le, *fb, *fe;
+    while (pos < end) {
+        const char *line = pos;
+        nextLine(pos, lb, le);
+        if (le - lb < 2 || lb[0] != '>' || lb[1] != ' ') continue;
+
+        fieldRange(lb, le, 31, 1, fb, fe);
+        int epochFlag = rinexStoi(fb, fe);
+        if (epochFlag < 2 || epochFlag > 5) {
+            // 数据历元必须有时间，头记录中碰巧以 "> " 开头的行不算
+            if (le - lb > 2 && isdigit(static_cast<unsigned char>(lb[2]))) {
+                return line - begin;
+            }
+            continue;
+        }
+
+        // 事件历元：跳过其后的头记录
+        fieldRange(lb, le, 32, 3, fb, fe);
+        int numLines = rinexStoi(fb, fe);
+        for (int i = 0; i < numLines && nextLine(pos, lb, le); ++i) {}
+    }
+    return mappedFile.size();
+}
+
+int RinexObsMMapReader::readEpochLine(const char *&pos, CommonTime &epoch) const {
+
+    const char *lb, *le, *fb, *fe;
+    while (true) {
+        if (!nextLine(pos, lb, le)) {
+            EndOfFile err("EOF encountered!");
+            throw err;
+        }
+
+        // 检查历元标记 ('>') 和随后的空格。
+        if (le - lb < 2 || lb[0] != '>' || lb[1] != ' ') {
+            FFStreamError e("Bad epoch line: >" + string(lb, le) + "<");
+            throw e;
+        }
+
+        fieldRange(lb, le, 31, 1, fb, fe);
+        int epochFlag = rinexStoi(fb, fe);
+        if (epochFlag < 0 || epochFlag > 6) {
+            FFStreamError e("Invalid epoch flag: " + std::to_string(epochFlag));
+            throw e;
+        }
+
+        epoch = parseTime(lb, le);
+
+        fieldRange(lb, le, 32, 3, fb, fe);
+        int numSats = rinexStoi(fb, fe);
+
+        // 事件历元：后面跟着 numSats 行头记录，整体跳过
+        if (epochFlag >= 2 && epochFlag <= 5) {
+            for (int i = 0; i < numSats; ++i) {
+                if (!nextLine(pos, lb, le)) {
+                    EndOfFile err("EOF encountered!");
+                    throw err;
+                }
+            }
+            continue;
+        }
+
+        return numSats;
+    }
+}
+
+char RinexObsMMapReader::readSatLine(const char *&pos, const char *&lb, const char *&le) const {
+    if (!nextLine(pos, lb, le)) {
+        EndOfFile err("EOF encountered!");
+        throw err;
+    }
+
+    // 获取 SV ID
+    const char *fb, *fe;
+    fieldRange(lb, le, 1, 2, fb, fe);
+    if (fe - fb != 2 ||
+        (!isdigit(static_cast<unsigned char>(fb[0])) && fb[0] != ' ') ||
+        !isdigit(static_cast<unsigned char>(fb[1]))) {
+        FFStreamError e("Bad satellite id: >" + string(lb, le) + "<");
+        throw e;
+    }
+    return lb[0];
+}
+
+ObsData RinexObsMMapReader::decodeEpoch(const char *&pos) const {
+
+    const char *lb, *le, *fb, *fe;
+    CommonTime currEpoch;
+    int numSats = readEpochLine(pos, currEpoch);
+
+    SatTypeValueMap stvData;
+    for (int isv = 0; isv < numSats; ++isv) {
+        char sysChar = readSatLine(pos, lb, le);
+
+        // 如果卫星系统不是GPS("G")也不是北斗("C")，则跳过
+        if (sysChar != 'G' && sysChar != 'C') {
+            continue;
+        }
+
+        if (!hasObsTypes[static_cast<unsigned char>(sysChar)]) {
+            FFStreamError e(string("no SYS / # / OBS TYPES for system ") + sysChar);
+            throw e;
+        }
+
+        // 没有选择的系统不需要解析
+        const std::vector<ObsColumn> &columns = sysColumns[static_cast<unsigned char>(sysChar)];
+        if (columns.empty()) {
+            continue;
+        }
+
+        // 只解析选中的列
+        TypeValueMap typeObs;
+        for (const auto &column: columns) {
+            fieldRange(lb, le, 3 + 16 * column.index, 14, fb, fe);
+            double data = rinexStod(fb, fe) * column.scale;
+
+            // 观测值异常
+            if (std::abs(data) == 0.0) {
+                continue;
+            }
+
+            typeObs[column.type] = data;
+        }
+
+        // 选中的观测值都没有时不插入
+        if (!typeObs.empty()) {
+            SatID sat;
+            sat.system = string(1, sysChar);
+            sat.id = rinexStoi(lb + 1, lb + 3);
+            stvData[sat] = std::move(typeObs);
+        }
+    }
+
+    ObsData obsData;
+    obsData.station = rinexHeader.station;
+    obsData.epoch = currEpoch;
+    obsData.satTypeValueData = std::move(stvData);
+    obsData.antennaPosition = rinexHeader.antennaPosition;
+
+    // 选择的观测值类型已经在解析时处理，不需要再调用 chooseObs
+
+    return obsData;
+}
+
+void RinexObsMMapReader::parseRinexObs(ObsEpoch &obsEpoch) {
+
+    if (!isHeaderRead) {
+        parseRinexHeader();
+    }
+
+    decodeEpoch(pCur, obsEpoch);
+}
+
+void RinexObsMMapReader::decodeEpoch(const char *&pos, ObsEpoch &obsEpoch) const {
+
+    const char *lb, *le, *fb, *fe;
+    CommonTime currEpoch;
+    int numSats = readEpochLine(pos, currEpoch);
+
+    obsEpoch.clear();
+    obsEpoch.station = rinexHeader.station;
+    obsEpoch.epoch = currEpoch;
+    obsEpoch.antennaPosition = rinexHeader.antennaPosition;
+
+    for (int isv = 0; isv < numSats; ++isv) {
+        char sysChar = readSatLine(pos, lb, le);
+
+        if (sysChar != 'G' && sysChar != 'C') {
+            continue;
+        }
+
+        if (!hasObsTypes[static_cast<unsigned char>(sysChar)]) {
+            FFStreamError e(string("no SYS / # / OBS TYPES for system ") + sysChar);
+            throw e;
+        }
+
+        const std::vector<ObsColumn> &columns = sysColumns[static_cast<unsigned char>(sysChar)];
+        if (columns.empty()) {
+            continue;
+        }
+
+        int row = obsEpoch.addSat(PackedSat(sysChar, rinexStoi(lb + 1, lb + 3)));
+        for (const auto &column: columns) {
+            size_t pos0 = 3 + 16 * column.index;
+            fieldRange(lb, le, pos0, 14, fb, fe);
+            double data = rinexStod(fb, fe) * column.scale;
+            if (std::abs(data) == 0.0) {
+                continue;
+            }
+            if (column.code < 0) {
+                InvalidRequest e("RinexObsMMapReader: too many observation types, " + column.type);
+                throw e;
+            }
+
+            // LLI 和信号强度各占一列，空白为 0
+            char lli = fieldChar(lb, le, pos0 + 14);
+            char snr = fieldChar(lb, le, pos0 + 15);
+            obsEpoch.set(row, column.code, data,
+                         isdigit(static_cast<unsigned char>(lli)) ? uint8_t(lli - '0') : 0,
+                         isdigit(static_cast<unsigned char>(snr)) ? uint8_t(snr - '0') : 0);
+        }
+
+        // 选中的观测值都没有时不保留
+        if (obsEpoch.obsMask(row) == 0) {
+            obsEpoch.eraseSat(row);
+        }
+    }
+}
+
+ObsData RinexObsMMapReader::parseRinexObs(CommonTime &syncEpoch) {
+
+    // 先读文件头，保证回退位置落在数据区
+    if (!isHeaderRead) {
+        parseRinexHeader();
+    }
+
+    // 有索引时二分查找，只解析目标历元
+    if (pEpochIndex != NULL) {
+        size_t i = pEpochIndex->lowerBound(syncEpoch);
+        if (i == pEpochIndex->size() ||
+            (*pEpochIndex)[i].epoch > (syncEpoch + 0.001)) {
+            SyncException e("RinexObsMMapReader::can't synchronize the obs!");
+            throw (e);
+        }
+        pCur = mappedFile.begin() + (*pEpochIndex)[i].offset;
+        return parseRinexObs();
+    }
+
+    const char *sp = pCur;
+    ObsData obsData;
+    while (true) {
+        if (pCur >= mappedFile.end()) {
+            break;
+        }
+
+        obsData = parseRinexObs();
+
+        // 首先寻找大于等于参考时刻的历元
+        if (obsData.epoch >= syncEpoch) {
+            break;
+        }
+    }
+
+    // 观测值超前了参考时刻，同步失败，恢复读取位置以便下一个历元再同步
+    if (obsData.epoch > (syncEpoch + 0.001)) {
+        pCur = sp;
+        SyncException e("RinexObsMMapReader::can't synchronize the obs!");
+        throw (e);
+    }
+
+    return obsData;
+}
+
+bool RinexObsMMapReader::seekEpoch(const CommonTime &epoch) {
+    if (pEpochIndex == NULL) {
+        InvalidRequest e("RinexObsMMapReader::seekEpoch: no epoch index");
+        throw e;
+    }
+    if (!isHeaderRead) {
+        parseRinexHeader();
+    }
+
+    size_t i = pEpochIndex->lowerBound(epoch);
+    if (i == pEpochIndex->size()) {
+        return false;
+    }
+    pCur = mappedFile.begin() + (*pEpochIndex)[i].offset;
+    return true;
+}
+
+std::vector<ObsData> RinexObsMMapReader::parseRinexObsRange(const CommonTime &t0, const CommonTime &t1) {
+    if (pEpochIndex == NULL) {
+        InvalidRequest e("RinexObsMMapReader::parseRinexObsRange: no epoch index");
+        throw e;
+    }
+    if (!isHeaderRead) {
+        parseRinexHeader();
+    }
+
+    size_t first, last;
+    pEpochIndex->range(t0, t1, first, last);
+
+    std::vector<ObsData> epochs;
+    epochs.reserve(last - first);
+    for (size_t i = first; i < last; i++) {
+        pCur = mappedFile.begin() + (*pEpochIndex)[i].offset;
+        epochs.push_back(parseRinexObs());
+    }
+    if (last < pEpochIndex->size()) {
+        pCur = mappedFile.begin() + (*pEpochIndex)[last].offset;
+    }
+    return epochs;
+}
+
+CommonTime RinexObsMMapReader::parseTime(const char *lb, const char *le) {
+
+    // check if the spaces are in the right place - an easy
+    // way to check if there's corruption in the file
+    static const int spacePos[] = {1, 6, 9, 12, 15, 18, 29, 30};
+    for (int pos: spacePos) {
+        if (fieldChar(lb, le, pos) != ' ') {
+            FFStreamError e("Invalid time format");
+            throw (e);
+        }
+    }
+
+    const char *fb, *fe;
+
+    // if there's no time, just return a bad time
+    fieldRange(lb, le, 2, 27, fb, fe);
+    if (isBlankField(fb, fe))
+        return BEGINNING_OF_TIME;
+
+    int year, month, day, hour, min;
+    double sec;
+
+    fieldRange(lb, le, 2, 4, fb, fe);
+    year = rinexStoi(fb, fe);
+    fieldRange(lb, le, 7, 2, fb, fe);
+    month = rinexStoi(fb, fe);
+    fieldRange(lb, le, 10, 2, fb, fe);
+    day = rinexStoi(fb, fe);
+    fieldRange(lb, le, 13, 2, fb, fe);
+    hour = rinexStoi(fb, fe);
+    fieldRange(lb, le, 16, 2, fb, fe);
+    min = rinexStoi(fb, fe);
+    fieldRange(lb, le, 19, 11, fb, fe);
+    sec = rinexStod(fb, fe);
+
+    // Real Rinex has epochs 'yy mm dd hr 59 60.0' surprisingly often.
+    double ds = 0;
+    if (sec >= 60.0) {
+        ds = sec;
+        sec = 0.0;
+    }
+
+    CommonTime ctime;
+    CivilTime cv = CivilTime(year, month, day, hour, min, sec);
+    ctime = CivilTime2CommonTime(cv);
+
+    if (ds != 0)
+        ctime = ctime + ds;
+
+    return ctime;
+}
+
+void RinexObsMMapReader::chooseObs(ObsData &obsData) const {
+    SatTypeValueMap filteredSatTypeValueData;
+
+    for (auto &satEntry: obsData.satTypeValueData) {
+        auto itSys = sysTypes.find(satEntry.first.system);
+        if (itSys == sysTypes.end()) continue;
+
+        const auto &allowedTypes = itSys->second;
+        TypeValueMap filteredTypeValueMap;
+        for (const auto &typeValueEntry: satEntry.second) {
+            if (allowedTypes.find(typeValueEntry.first) != allowedTypes.end()) {
+                filteredTypeValueMap.insert(typeValueEntry);
+            }
+        }
+
+        if (!filteredTypeValueMap.empty()) {
+            filteredSatTypeValueData[satEntry.first] = std::move(filteredTypeValueMap);
+        }
+    }
+
+    obsData.satTypeValueData = std::move(filteredSatTypeValueData);
+}
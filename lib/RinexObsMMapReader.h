@@ -0,0 +1,124 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_RINEXOBSMMAPREADER_H
+#define GNSSLAB_RINEXOBSMMAPREADER_H
+
+#include <vector>
+#include "GnssStruct.h"
+#include "MappedFile.h"
+#include "RinexObsIndex.h"
+#include "ObsEpoch.h"
+
+// 基于内存映射的 RINEX 3 观测值读取器
+//
+// 与 RinexObsReader 的接口和输出完全一致（同样只保留 G/C 卫星、载波相位换算为米、
+// 剔除零值，并按 setSelectedTypes 选择观测值），区别在于：
+//  - 文件整体映射到内存，用 [lineBegin, lineEnd) 指针游标逐行扫描，不再调用 getline；
+//  - 字段直接在字符区间上解析，不再 substr 出临时 string；
+//  - 每个系统的观测值类型和波长在读完文件头后只计算一次。
+// 事件历元（flag 2~5）后面的头记录行会被整体跳过，不会打断后续历元的解析。
+class RinexObsMMapReader {
+public:
+    RinexObsMMapReader();
+
+    explicit RinexObsMMapReader(const string &fileName);
+
+    // 映射观测值文件，失败时抛出 FileMissingException
+    void open(const string &fileName);
+
+    // 选择的观测值类型在读完文件头后编译成每个系统的列表，解析时不选的列直接跳过
+    void setSelectedTypes(std::map<string, std::set<string>> &systemTypes);
+
+    void parseRinexHeader();
+
+    ObsData parseRinexObs();
+
+    // 把下一个历元解析到按列存放的 obsEpoch 中，选择和剔除规则与 ObsData 相同，另外保留 LLI 和信号强度；
+    // obsEpoch 在历元间重复使用时解析过程不分配内存
+    void parseRinexObs(ObsEpoch &obsEpoch);
+
+    // 与 RinexObsReader::parseRinexObs(syncEpoch) 语义相同：
+    // 找到第一个不早于 syncEpoch 的历元，若超前 1ms 以上则恢复读取位置并抛出 SyncException
+    ObsData parseRinexObs(CommonTime &syncEpoch);
+
+    // 解析文件中偏移 offset 处的历元，不改变读取位置；
+    // 读完文件头后读取器的状态不再变化，多个线程可以同时调用本函数解析不同的历元
+    ObsData parseEpochAt(uint64_t offset) const;
+
+    // 同上，nextOffset 返回该历元之后的位置
+    ObsData parseEpochAt(uint64_t offset, uint64_t &nextOffset) const;
+
+    // offset 处或之后第一个数据历元行的偏移，offset 不在行首时从下一行开始找，事件历元和其后的头记录被跳过；
+    // 没有时返回文件大小。用于把数据区按字节切块后由多个线程各自找到块内的历元
+    uint64_t findEpochLine(uint64_t offset) const;
+
+    // 第一个数据历元的偏移（即 END OF HEADER 的下一行），读完文件头后有效
+    uint64_t getDataOffset() const { return dataOffset; }
+
+    void chooseObs(ObsData &obsData) const;
+
+    const RinexHeader &getHeader();
+
+    // 设置历元索引后，按时间定位直接跳到对应偏移，不再逐历元解析
+    void setEpochIndex(const RinexObsIndex *pIndex) { pEpochIndex = pIndex; };
+
+    // 把读取位置移到第一个不早于 epoch 的历元，没有这样的历元时返回 false；需要先设置历元索引
+    bool seekEpoch(const CommonTime &epoch);
+
+    // 读取 [t0, t1) 内的全部历元，读取位置停在 t1 之后的第一个历元；需要先设置历元索引
+    std::vector<ObsData> parseRinexObsRange(const CommonTime &t0, const CommonTime &t1);
+
+    // 观测值换算到米的系数：载波相位为波长（频率未知时为 0），其余为 1；只用于 G/C 系统
+    static double obsScale(const string &sys, const string &typeStr);
+
+    // 解析历元行 [lineBegin, lineEnd) 中的时间
+    static CommonTime parseTime(const char *lineBegin, const char *lineEnd);
+
+    // 已映射文件的字节数，用于吞吐量统计
+    size_t getFileSize() const { return mappedFile.size(); }
+
+    ~RinexObsMMapReader() {};
+
+private:
+    // 一个选中的观测值列：在卫星行中的序号、类型名、ObsCodeTable 中的编号（编号用完时为 -1）
+    // 以及换算到米的系数（非载波相位为 1）
+    struct ObsColumn {
+        int index;
+        string type;
+        int code;
+        double scale;
+    };
+
+    bool nextLine(const char *&pos, const char *&lineBegin, const char *&lineEnd) const;
+
+    // 从游标 pos 处解析一个数据历元（跳过事件历元），pos 移到下一个历元
+    ObsData decodeEpoch(const char *&pos) const;
+
+    void decodeEpoch(const char *&pos, ObsEpoch &obsEpoch) const;
+
+    // 读到下一个数据历元的历元行（事件历元和其后的头记录被跳过），返回卫星数
+    int readEpochLine(const char *&pos, CommonTime &epoch) const;
+
+    // 读取一行卫星观测值并检查卫星号，返回系统标识字符
+    char readSatLine(const char *&pos, const char *&lineBegin, const char *&lineEnd) const;
+
+    void compileObsColumns();
+
+    MappedFile mappedFile;
+    const char *pCur;
+    uint64_t dataOffset;
+    RinexHeader rinexHeader;
+    std::map<string, std::set<string>> sysTypes;
+    bool isHeaderRead;
+    const RinexObsIndex *pEpochIndex;
+
+    // 以系统标识字符（'G','C',...）直接索引的选中列，未选择的系统为空
+    std::vector<ObsColumn> sysColumns[128];
+
+    // 文件头中是否有该系统的观测值类型
+    bool hasObsTypes[128];
+};
+
+#endif //GNSSLAB_RINEXOBSMMAPREADER_H
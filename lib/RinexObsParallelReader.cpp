@@ -0,0 +1,194 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <algorithm>
+#include "RinexObsParallelReader.h"
+
+#define debug 0
+
+RinexObsParallelReader::RinexObsParallelReader()
+        : pEpochIndex(NULL), numThreads(0), chunkSize(64), chunkBytes(256 * 1024),
+          dataBegin(0), dataEnd(0), maxChunksInFlight(0),
+          firstChunk(0), nextChunk(0), numChunks(0), isStopping(false),
+          isStarted(false), currentPos(0) {
+}
+
+RinexObsParallelReader::RinexObsParallelReader(const string &fileName, int numThreads)
+        : RinexObsParallelReader() {
+    setNumThreads(numThreads);
+    open(fileName);
+}
+
+RinexObsParallelReader::~RinexObsParallelReader() {
+    stop();
+}
+
+void RinexObsParallelReader::open(const string &name) {
+    stop();
+
+    fileName = name;
+    reader.open(name);
+    reader.parseRinexHeader();
+
+    pending.clear();
+    current.clear();
+    currentError = std::exception_ptr();
+    currentPos = 0;
+    firstChunk = 0;
+    nextChunk = 0;
+    numChunks = 0;
+}
+
+void RinexObsParallelReader::setSelectedTypes(std::map<string, std::set<string>> &systemTypes) {
+    reader.setSelectedTypes(systemTypes);
+}
+
+void RinexObsParallelReader::setNumThreads(int n) {
+    numThreads = n;
+}
+
+void RinexObsParallelReader::setChunkSize(size_t epochs) {
+    chunkSize = std::max(epochs, size_t(1));
+}
+
+void RinexObsParallelReader::setChunkBytes(size_t bytes) {
+    chunkBytes = std::max(bytes, size_t(1));
+}
+
+void RinexObsParallelReader::setMaxChunksInFlight(size_t chunks) {
+    maxChunksInFlight = chunks;
+}
+
+void RinexObsParallelReader::start() {
+    if (numThreads <= 0) {
+        numThreads = std::max(int(std::thread::hardware_concurrency()), 1);
+    }
+    if (maxChunksInFlight == 0) {
+        maxChunksInFlight = 4 * size_t(numThreads);
+    }
+
+    if (pEpochIndex != NULL) {
+        numChunks = (pEpochIndex->size() + chunkSize - 1) / chunkSize;
+    } else {
+        dataBegin = reader.getDataOffset();
+        dataEnd = reader.getFileSize();
+        numChunks = (dataEnd - dataBegin + chunkBytes - 1) / chunkBytes;
+    }
+    firstChunk = 0;
+    nextChunk = 0;
+    isStopping = false;
+
+    if (debug)
+        cout << "RinexObsParallelReader: " << numChunks << " chunks, " << numThreads << " threads" << endl;
+
+    for (int i = 0; i < numThreads; i++) {
+        workers.push_back(std::thread(&RinexObsParallelReader::worker, this));
+    }
+    isStarted = true;
+}
+
+void RinexObsParallelReader::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        isStopping = true;
+    }
+    slotFree.notify_all();
+    for (auto &t: workers) {
+        t.join();
+    }
+    workers.clear();
+    isStarted = false;
+}
+
+void RinexObsParallelReader::worker() {
+    while (true) {
+        size_t k;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            slotFree.wait(lock, [this] {
+                return isStopping || nextChunk >= numChunks ||
+                       nextChunk - firstChunk < maxChunksInFlight;
+            });
+            if (isStopping || nextChunk >= numChunks) return;
+
+            k = nextChunk++;
+            pending.push_back(Chunk());
+        }
+
+        // 解码不需要加锁，读取器在文件头读完之后是只读的
+        std::vector<ObsData> epochs;
+        std::exception_ptr error;
+        try {
+            parseChunk(k, epochs);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            Chunk &chunk = pending[k - firstChunk];
+            chunk.epochs.swap(epochs);
+            chunk.error = error;
+            chunk.isDone = true;
+        }
+        chunkReady.notify_all();
+    }
+}
+
+void RinexObsParallelReader::parseChunk(size_t k, std::vector<ObsData> &epochs) const {
+    if (pEpochIndex != NULL) {
+        size_t first = k * chunkSize;
+        size_t last = std::min(first + chunkSize, pEpochIndex->size());
+        epochs.reserve(last - first);
+        for (size_t i = first; i < last; i++) {
+            epochs.push_back(reader.parseEpochAt((*pEpochIndex)[i].offset));
+        }
+        return;
+    }
+
+    // 起始位置落在 [begin, end) 内的历元属于这一块
+    uint64_t begin = dataBegin + k * chunkBytes;
+    uint64_t end = std::min(begin + chunkBytes, dataEnd);
+    uint64_t offset = reader.findEpochLine(begin);
+    while (offset < end) {
+        uint64_t next;
+        epochs.push_back(reader.parseEpochAt(offset, next));
+        offset = reader.findEpochLine(next);
+    }
+}
+
+ObsData RinexObsParallelReader::parseRinexObs() {
+    if (!isStarted) {
+        start();
+    }
+
+    while (currentPos >= current.size()) {
+        // 出错的块中，出错之前的历元已经正常返回，这里再把错误抛出
+        if (currentError) {
+            std::exception_ptr error = currentError;
+            currentError = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (firstChunk >= numChunks) {
+                EndOfFile err("EOF encountered!");
+                throw err;
+            }
+
+            chunkReady.wait(lock, [this] {
+                return !pending.empty() && pending.front().isDone;
+            });
+
+            current.swap(pending.front().epochs);
+            currentError = pending.front().error;
+            pending.pop_front();
+            firstChunk++;
+        }
+        slotFree.notify_all();
+        currentPos = 0;
+    }
+
+    return std::move(current[currentPos++]);
+}
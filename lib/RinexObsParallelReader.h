@@ -0,0 +1,120 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_RINEXOBSPARALLELREADER_H
+#define GNSSLAB_RINEXOBSPARALLELREADER_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include "GnssStruct.h"
+#include "RinexObsMMapReader.h"
+#include "RinexObsIndex.h"
+
+// 多线程分块解析 RINEX 3 观测值文件
+//
+// 读完文件头后，每个 '>' 历元记录都可以独立解析。本读取器把文件头之后的数据区按字节切成若干块
+// （每块 chunkBytes 字节），工作线程取到一块后用 RinexObsMMapReader::findEpochLine 找到块内的第一个历元，
+// 逐个解析起始位置落在块内的历元（最后一个历元可以越过块尾），块与块之间不重不漏；
+// 调用线程不需要先扫描整个文件，第一个块解析完就可以取到历元。
+// 设置了外部的历元索引（setEpochIndex）时，改为按索引中的历元切块（每块 chunkSize 个历元），按索引的顺序返回。
+// parseRinexObs() 按文件顺序逐个返回历元，读完后抛出 EndOfFile，用法与 RinexObsReader 相同。
+//
+// 同时在解码或等待取走的块数不超过 maxChunksInFlight，内存占用与文件大小无关。
+// 工作线程中的解析错误会在取到对应历元时在调用线程中重新抛出。
+// 解析出的 ObsData 节点来自 NodePool，每个线程有自己的节点缓存，工作线程之间不争用节点池的锁。
+class RinexObsParallelReader {
+public:
+    RinexObsParallelReader();
+
+    // numThreads 为 0 时使用全部硬件线程
+    explicit RinexObsParallelReader(const string &fileName, int numThreads = 0);
+
+    // 映射观测值文件并读取文件头，失败时抛出 FileMissingException / FFStreamError
+    void open(const string &fileName);
+
+    void setSelectedTypes(std::map<string, std::set<string>> &systemTypes);
+
+    // 以下设置需要在第一次 parseRinexObs 之前调用
+    void setNumThreads(int n);
+
+    // 按索引切块时每块的历元数
+    void setChunkSize(size_t epochs);
+
+    // 按字节切块时每块的字节数
+    void setChunkBytes(size_t bytes);
+
+    void setMaxChunksInFlight(size_t chunks);
+
+    // 使用外部已建立的历元索引，不设置时按字节切块，不需要索引
+    void setEpochIndex(const RinexObsIndex *pIndex) { pEpochIndex = pIndex; };
+
+    ObsData parseRinexObs();
+
+    const RinexHeader &getHeader() { return reader.getHeader(); }
+
+    size_t getFileSize() const { return reader.getFileSize(); }
+
+    int getNumThreads() const { return numThreads; }
+
+    ~RinexObsParallelReader();
+
+private:
+    struct Chunk {
+        Chunk() : isDone(false) {};
+
+        std::vector<ObsData> epochs;
+        std::exception_ptr error;
+        bool isDone;
+    };
+
+    // 不允许拷贝，工作线程持有 this
+    RinexObsParallelReader(const RinexObsParallelReader &);
+
+    RinexObsParallelReader &operator=(const RinexObsParallelReader &);
+
+    void start();
+
+    void stop();
+
+    void worker();
+
+    // 解析第 k 块
+    void parseChunk(size_t k, std::vector<ObsData> &epochs) const;
+
+    string fileName;
+    RinexObsMMapReader reader;
+    const RinexObsIndex *pEpochIndex;
+
+    int numThreads;
+    size_t chunkSize;
+    size_t chunkBytes;
+    uint64_t dataBegin;
+    uint64_t dataEnd;
+    size_t maxChunksInFlight;
+
+    // 以下成员由 mtx 保护
+    std::mutex mtx;
+    std::condition_variable chunkReady;
+    std::condition_variable slotFree;
+    std::deque<Chunk> pending;     // 从 firstChunk 开始、已经分配给工作线程的块
+    size_t firstChunk;             // pending.front() 的块序号
+    size_t nextChunk;              // 下一个待分配的块序号
+    size_t numChunks;
+    bool isStopping;
+
+    std::vector<std::thread> workers;
+    bool isStarted;
+
+    // 当前正在取走的块
+    std::vector<ObsData> current;
+    size_t currentPos;
+    std::exception_ptr currentError;
+};
+
+#endif //GNSSLAB_RINEXOBSPARALLELREADER_H
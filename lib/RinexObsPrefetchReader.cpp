@@ -0,0 +1,112 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include "RinexObsPrefetchReader.h"
+
+#define debug 0
+
+RinexObsPrefetchReader::RinexObsPrefetchReader()
+        : capacity(64), isStarted(false), isStopping(false), isFinished(false) {
+}
+
+RinexObsPrefetchReader::~RinexObsPrefetchReader() {
+    stop();
+}
+
+void RinexObsPrefetchReader::start() {
+    pRing.reset(new SpscRing<ObsData>(capacity));
+    isStopping.store(false);
+    isFinished.store(false);
+    error = std::exception_ptr();
+
+    prefetchThread = std::thread(&RinexObsPrefetchReader::worker, this);
+    isStarted = true;
+}
+
+void RinexObsPrefetchReader::stop() {
+    isStopping.store(true);
+    // 唤醒在满队列上等待的后台线程
+    if (pRing) {
+        pRing->close();
+    }
+    if (prefetchThread.joinable()) {
+        prefetchThread.join();
+    }
+    isStarted = false;
+}
+
+void RinexObsPrefetchReader::worker() {
+    try {
+        while (!isStopping.load(std::memory_order_relaxed)) {
+            ObsData obsData = reader.parseRinexObs();
+
+            // 队列满时等待主线程取走历元，stop() 关闭队列后返回 false
+            if (!pRing->push(obsData)) break;
+        }
+    } catch (EndOfFile &e) {
+        if (debug)
+            cout << "RinexObsPrefetchReader: EOF" << endl;
+    } catch (...) {
+        error = std::current_exception();
+    }
+    isFinished.store(true, std::memory_order_release);
+    // 唤醒在空队列上等待的主线程
+    pRing->close();
+}
+
+ObsData *RinexObsPrefetchReader::waitFront() {
+    if (!isStarted) {
+        start();
+    }
+
+    // 队列关闭之前入队的历元都会先取到，返回 NULL 时后台线程已经结束
+    ObsData *pObs = pRing->waitFront();
+    if (pObs != NULL) return pObs;
+
+    if (isFinished.load(std::memory_order_acquire) && error) {
+        std::exception_ptr e = error;
+        error = std::exception_ptr();
+        std::rethrow_exception(e);
+    }
+    return NULL;
+}
+
+ObsData RinexObsPrefetchReader::parseRinexObs() {
+    if (waitFront() == NULL) {
+        EndOfFile err("EOF encountered!");
+        throw err;
+    }
+
+    ObsData obsData;
+    pRing->tryPop(obsData);
+    return obsData;
+}
+
+ObsData RinexObsPrefetchReader::parseRinexObs(CommonTime &syncEpoch) {
+    ObsData *pObs;
+    while (true) {
+        pObs = waitFront();
+        if (pObs == NULL) {
+            SyncException e("RinexObsPrefetchReader::can't synchronize the obs!");
+            throw (e);
+        }
+
+        // 首先寻找大于等于参考时刻的历元
+        if (pObs->epoch >= syncEpoch) {
+            break;
+        }
+
+        ObsData skipped;
+        pRing->tryPop(skipped);
+    }
+
+    // 观测值超前了参考时刻，同步失败，该历元留在队列中以便下一个历元再同步
+    if (pObs->epoch > (syncEpoch + 0.001)) {
+        SyncException e("RinexObsPrefetchReader::can't synchronize the obs!");
+        throw (e);
+    }
+
+    ObsData obsData;
+    pRing->tryPop(obsData);
+    return obsData;
+}
@@ -0,0 +1,82 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_RINEXOBSPREFETCHREADER_H
+#define GNSSLAB_RINEXOBSPREFETCHREADER_H
+
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <exception>
+
+#include "GnssStruct.h"
+#include "RinexObsReader.h"
+#include "SpscRing.h"
+
+// 后台预读的观测值读取器
+//
+// 在 RTK 等处理循环中，解算线程交替地解析流动站/基准站文件和解算，I/O 与计算不能重叠。
+// 本读取器包装 RinexObsReader，第一次读取时启动一个后台线程，提前解析历元并放入
+// 容量有限的无锁环形队列（SpscRing），主循环只需取出已经解析好的历元：
+//  - 队列满时后台线程等待（背压），内存占用与文件大小无关；队列满或空时等待的一方短暂自旋后
+//    在条件变量上睡眠，不占用 CPU；
+//  - 文件读完后 parseRinexObs() 抛出 EndOfFile；
+//  - 后台线程中的解析错误在取完出错之前的历元后，在调用线程中重新抛出。
+// 接口与 RinexObsReader 相同，setFileStream/setSelectedTypes/setCapacity 需要在第一次读取之前调用。
+class RinexObsPrefetchReader {
+public:
+    RinexObsPrefetchReader();
+
+    void setFileStream(std::fstream *pStream) {
+        reader.setFileStream(pStream);
+    };
+
+    void setSelectedTypes(std::map<string, std::set<string>> &systemTypes) {
+        reader.setSelectedTypes(systemTypes);
+    };
+
+    // 队列中最多预读的历元数，取整到 2 的幂
+    void setCapacity(size_t epochs) {
+        capacity = epochs;
+    };
+
+    // 取出下一个历元，读完后抛出 EndOfFile
+    ObsData parseRinexObs();
+
+    // 与 RinexObsReader::parseRinexObs(syncEpoch) 语义相同：丢弃早于 syncEpoch 的历元，
+    // 若下一个历元超前 1ms 以上则把它留在队列中并抛出 SyncException；文件读完时也抛出 SyncException
+    ObsData parseRinexObs(CommonTime &syncEpoch);
+
+    ~RinexObsPrefetchReader();
+
+private:
+    // 不允许拷贝，后台线程持有 this
+    RinexObsPrefetchReader(const RinexObsPrefetchReader &);
+
+    RinexObsPrefetchReader &operator=(const RinexObsPrefetchReader &);
+
+    void start();
+
+    void stop();
+
+    void worker();
+
+    // 等待队首历元，文件读完时返回 NULL，后台线程出错时重新抛出错误
+    ObsData *waitFront();
+
+    RinexObsReader reader;
+    size_t capacity;
+
+    std::unique_ptr<SpscRing<ObsData>> pRing;
+    std::thread prefetchThread;
+    bool isStarted;
+
+    // isFinished 由后台线程在最后一个历元入队之后置位，error 在此之前写入，之后关闭队列
+    std::atomic<bool> isStopping;
+    std::atomic<bool> isFinished;
+    std::exception_ptr error;
+};
+
+#endif //GNSSLAB_RINEXOBSPREFETCHREADER_H
@@ -4,6 +4,7 @@
 #include "StringUtils.h"
 #include "RinexObsReader.h"
 #include "TimeConvert.h"
+#include "RinexField.h"
 
 #define debug 0
 void RinexObsReader::parseRinexHeader() {
@@ -71,8 +72,53 @@ void RinexObsReader::parseRinexHeader() {
             rinexHeader.mapObsTypes = mapObsTypes;
         }
     }
+
+    compileObsColumns();
 };
 
+void RinexObsReader::setSelectedTypes(std::map<string, std::set<string>>& systemTypes) {
+    sysTypes = systemTypes;
+    compileObsColumns();
+}
+
+// 把选择的观测值类型编译成每个系统要解析的列，同时算好载波相位的波长；
+// 频率未知的载波相位无法换算，也不解析
+void RinexObsReader::compileObsColumns() {
+    for (auto &columns: sysColumns) columns.clear();
+
+    for (const auto &sysEntry: rinexHeader.mapObsTypes) {
+        const string &sys = sysEntry.first;
+        if (sys != "G" && sys != "C") continue;
+
+        auto itSys = sysTypes.find(sys);
+        if (itSys == sysTypes.end()) continue;
+
+        std::vector<ObsColumn> &columns = sysColumns[static_cast<unsigned char>(sys[0]) & 0x7f];
+        for (size_t i = 0; i < sysEntry.second.size(); i++) {
+            const string &obsTypeStr = sysEntry.second[i];
+            if (itSys->second.find(obsTypeStr) == itSys->second.end()) continue;
+
+            ObsColumn column;
+            column.index = int(i);
+            column.type = obsTypeStr;
+            column.scale = 1.0;
+
+            // 载波相位，获取观测值频率，比如L1C，其频率为1
+            if (obsTypeStr[0] == 'L') {
+                int n;
+                if (obsTypeStr[1] == 'A') {
+                    n = 1;
+                } else {
+                    n = rinexStoi(obsTypeStr, 1, 1);
+                }
+                column.scale = getWavelength(sys, n);
+                if (column.scale == 0.0) continue;
+            }
+            columns.push_back(column);
+        }
+    }
+}
+
 ObsData RinexObsReader::parseRinexObs() {
 
     if (!isHeaderRead) {
@@ -101,7 +147,7 @@ ObsData RinexObsReader::parseRinexObs() {
         throw e;
     }
 
-    int epochFlag = safeStoi(line.substr(31, 1));
+    int epochFlag = rinexStoi(line, 31, 1);
     if (epochFlag < 0 || epochFlag > 6) {
         FFStreamError e("Invalid epoch flag: " + std::to_string(epochFlag));
         throw e;
@@ -112,7 +158,7 @@ ObsData RinexObsReader::parseRinexObs() {
         std::cout << " currEpoch" << currEpoch << std::endl;
     }*/
 
-    int numSats = safeStoi(line.substr(32, 3));
+    int numSats = rinexStoi(line, 32, 3);
 
     //if (debug) cout << numSats << endl;
 
@@ -150,64 +196,39 @@ ObsData RinexObsReader::parseRinexObs() {
 
             int size = rinexHeader.mapObsTypes.at(satIndex[isv].system).size();
 
+            // 没有选择的系统不需要解析
+            const std::vector<ObsColumn> &columns =
+                    sysColumns[static_cast<unsigned char>(sat.system[0]) & 0x7f];
+            if (columns.empty()) {
+                continue;
+            }
+
             // 有些文件没有观测值，后面就没有输出，这里用空格来替换，否则解析错误
             size_t minSize = 3 + 16 * size;
             if (line.size() < minSize) {
                 line += std::string(minSize - line.size(), ' ');
             }
 
-            // 获取数据 (# entries in ObsType map of maps from header)
+            // 只解析选中的列
             TypeValueMap typeObs;
-            TypeValueMap typeLLI;
-            TypeValueMap typeSSI;
-            for (int i = 0; i < size; ++i) {
-                size_t pos = 3 + 16 * i;
-                std::string str = line.substr(pos, 16);
-
-                // ObsType
-                std::string obsTypeStr = rinexHeader.mapObsTypes.at(sat.system)[i];
-
-                // 观测值
-                std::string tmpStr = str.substr(0, 14);
-
-                double data = safeStod(tmpStr);
-
-                // 载波相位
-                if (obsTypeStr[0] == 'L') {
-                    double wavelength = 0.0;
+            for (const auto &column: columns) {
+                size_t pos = 3 + 16 * column.index;
 
-                    // 获取观测值频率，比如L1C，其频率为1
-                    int n;
-                    if (obsTypeStr[1] == 'A') {
-                        n = 1;
-                    } else {
-                        n = safeStoi(obsTypeStr.substr(1, 1));
-                    }
-
-                    wavelength = getWavelength(sat.system, n);
-
-                    if (wavelength == 0.0) continue;
-
-                    /*if (debug) {
-                        std::cout << obsTypeStr << " wavelength"
-                                  << std::setprecision(12)
-                                  << wavelength << std::endl;
-                    }*/
-
-                    // 将周期转换为米
-                    data = data * wavelength;
-                }
+                // 观测值，载波相位由周换算为米
+                double data = rinexStod(line, pos, 14) * column.scale;
 
                 // 观测值异常
                 if (std::abs(data) == 0.0) {
                     continue;
                 }
 
-                typeObs[obsTypeStr] = data;
+                typeObs[column.type] = data;
             }
 
-            // 插入当前卫星的数据到 stvData
-            stvData[satIndex[isv]] = typeObs;
+            // 插入当前卫星的数据到 stvData，选中的观测值都没有时不插入
+            if (!typeObs.empty()) {
+                stvData[satIndex[isv]] = std::move(typeObs);
+            }
 
         }
     }
@@ -215,16 +236,110 @@ ObsData RinexObsReader::parseRinexObs() {
     ObsData obsData;
     obsData.station = rinexHeader.station;
     obsData.epoch = currEpoch;
-    obsData.satTypeValueData = stvData;
+    obsData.satTypeValueData = std::move(stvData);
     obsData.antennaPosition = rinexHeader.antennaPosition;
 
-    // choose observations you selected
-    chooseObs(obsData);
+    // 选择的观测值类型已经在解析时处理，不需要再调用 chooseObs
 
     return obsData;
 }
 
 
+ObsData RinexObsReader::parseRinexObs(CommonTime& syncEpoch) {
+
+    if (pEpochIndex != NULL) {
+        if (!isHeaderRead) {
+            parseRinexHeader();
+            isHeaderRead = true;
+        }
+
+        // 二分查找第一个不早于参考时刻的历元，同步失败时读取位置保持不变
+        size_t i = pEpochIndex->lowerBound(syncEpoch);
+        if (i == pEpochIndex->size() ||
+            (*pEpochIndex)[i].epoch > (syncEpoch + 0.001)) {
+            SyncException e("Rx3ObsData::can't synchronize the obs!");
+            throw(e);
+        }
+        pFileStream->clear();
+        pFileStream->seekg((*pEpochIndex)[i].offset);
+        return parseRinexObs();
+    }
+
+    // store current stream pos;
+    streampos sp( pFileStream->tellg() );
+    ObsData obsData;
+    while(true){
+        if( pFileStream->peek() == EOF ){
+            break;
+        }
+        // read a record from current strm;
+        obsData = parseRinexObs();
+
+        // 首先寻找大于等于参考时刻的历元
+        // 只要大于等于，就意味着时间是同步的或者是超过了给定参考时刻的
+        if(obsData.epoch >=syncEpoch)
+        {
+            break;
+        }
+    }
+    // 如果流动站的时刻大于给定的参考时刻+容许的误差，则说明流动站观测值超前了，
+    // 此时，同步失败，且要把流动站的流重置到文件开头，以实现下一个历元的同步。
+    if(obsData.epoch > (syncEpoch + 0.001) )
+    {
+        pFileStream->seekg( sp );
+        SyncException e("Rx3ObsData::can't synchronize the obs!");
+        throw(e);
+    }
+
+    return obsData;
+}
+
+bool RinexObsReader::seekEpoch(const CommonTime& epoch) {
+    if (pEpochIndex == NULL) {
+        InvalidRequest e("RinexObsReader::seekEpoch: no epoch index");
+        throw e;
+    }
+    if (!isHeaderRead) {
+        parseRinexHeader();
+        isHeaderRead = true;
+    }
+
+    size_t i = pEpochIndex->lowerBound(epoch);
+    if (i == pEpochIndex->size()) {
+        return false;
+    }
+    pFileStream->clear();
+    pFileStream->seekg((*pEpochIndex)[i].offset);
+    return true;
+}
+
+std::vector<ObsData> RinexObsReader::parseRinexObsRange(const CommonTime& t0, const CommonTime& t1) {
+    if (pEpochIndex == NULL) {
+        InvalidRequest e("RinexObsReader::parseRinexObsRange: no epoch index");
+        throw e;
+    }
+
+    size_t first, last;
+    pEpochIndex->range(t0, t1, first, last);
+
+    if (!isHeaderRead) {
+        parseRinexHeader();
+        isHeaderRead = true;
+    }
+
+    std::vector<ObsData> epochs;
+    epochs.reserve(last - first);
+    for (size_t i = first; i < last; i++) {
+        pFileStream->clear();
+        pFileStream->seekg((*pEpochIndex)[i].offset);
+        epochs.push_back(parseRinexObs());
+    }
+    if (last < pEpochIndex->size()) {
+        pFileStream->seekg((*pEpochIndex)[last].offset);
+    }
+    return epochs;
+}
+
 CommonTime RinexObsReader::parseTime(const string &line) {
 
     // check if the spaces are in the right place - an easy
@@ -243,12 +358,12 @@ CommonTime RinexObsReader::parseTime(const string &line) {
     int year, month, day, hour, min;
     double sec;
 
-    year = safeStoi(line.substr(2, 4));
-    month = safeStoi(line.substr(7, 2));
-    day = safeStoi(line.substr(10, 2));
-    hour = safeStoi(line.substr(13, 2));
-    min = safeStoi(line.substr(16, 2));
-    sec = safeStod(line.substr(19, 11));
+    year = rinexStoi(line, 2, 4);
+    month = rinexStoi(line, 7, 2);
+    day = rinexStoi(line, 10, 2);
+    hour = rinexStoi(line, 13, 2);
+    min = rinexStoi(line, 16, 2);
+    sec = rinexStod(line, 19, 11);
 
     // Real Rinex has epochs 'yy mm dd hr 59 60.0' surprisingly often.
     double ds = 0;
@@ -300,5 +415,5 @@ void RinexObsReader::chooseObs(ObsData &obsData) {
     }
 
     // Replace the original data with the filtered data
-    obsData.satTypeValueData.swap(filteredSatTypeValueData);
+    obsData.satTypeValueData = std::move(filteredSatTypeValueData);
 }
\ No newline at end of file
@@ -6,11 +6,12 @@
 #define GNSSLAB_RINEXOBSREADER_H
 #include <fstream>
 #include "GnssStruct.h"
+#include "RinexObsIndex.h"
 
 class RinexObsReader {
 public:
     RinexObsReader()
-    : pFileStream(NULL), isHeaderRead(false)
+    : pFileStream(NULL), isHeaderRead(false), pEpochIndex(NULL)
     {};
 
     void setFileStream(std::fstream* pStream)
@@ -18,45 +19,27 @@ public:
         pFileStream = pStream;
     };
 
-    void setSelectedTypes(std::map<string, std::set<string>>& systemTypes)
-    {
-        sysTypes = systemTypes;
-    };
+    // 选择的观测值类型在读完文件头后编译成每个系统的列表，解析时不选的列直接跳过
+    void setSelectedTypes(std::map<string, std::set<string>>& systemTypes);
 
     void parseRinexHeader();
     ObsData parseRinexObs();
 
-    ObsData parseRinexObs(CommonTime& syncEpoch)
+    // 找到第一个不早于 syncEpoch 的历元，若超前 1ms 以上则恢复读取位置并抛出 SyncException；
+    // 设置了历元索引时直接二分查找定位，不再逐历元解析
+    ObsData parseRinexObs(CommonTime& syncEpoch);
+
+    void setEpochIndex(const RinexObsIndex* pIndex)
     {
-        // store current stream pos;
-        streampos sp( pFileStream->tellg() );
-        ObsData obsData;
-        while(true){
-            if( pFileStream->peek() == EOF ){
-                break;
-            }
-            // read a record from current strm;
-            obsData = parseRinexObs();
-
-            // 首先寻找大于等于参考时刻的历元
-            // 只要大于等于，就意味着时间是同步的或者是超过了给定参考时刻的
-            if(obsData.epoch >=syncEpoch)
-            {
-                break;
-            }
-        }
-        // 如果流动站的时刻大于给定的参考时刻+容许的误差，则说明流动站观测值超前了，
-        // 此时，同步失败，且要把流动站的流重置到文件开头，以实现下一个历元的同步。
-        if(obsData.epoch > (syncEpoch + 0.001) )
-        {
-            pFileStream->seekg( sp );
-            SyncException e("Rx3ObsData::can't synchronize the obs!");
-            throw(e);
-        }
-
-        return obsData;
+        pEpochIndex = pIndex;
     };
 
+    // 把读取位置移到第一个不早于 epoch 的历元，没有这样的历元时返回 false；需要先设置历元索引
+    bool seekEpoch(const CommonTime& epoch);
+
+    // 读取 [t0, t1) 内的全部历元，读取位置停在 t1 之后的第一个历元；需要先设置历元索引
+    std::vector<ObsData> parseRinexObsRange(const CommonTime& t0, const CommonTime& t1);
+
     CommonTime parseTime(const string &line);
     void chooseObs(ObsData &obsData);
 
@@ -64,10 +47,23 @@ public:
     {};
 
 private:
+    // 一个选中的观测值列：在卫星行中的序号、类型名以及换算到米的系数（非载波相位为 1）
+    struct ObsColumn {
+        int index;
+        string type;
+        double scale;
+    };
+
+    void compileObsColumns();
+
     std::fstream* pFileStream;
     RinexHeader rinexHeader;
     std::map<string, std::set<string>> sysTypes;
     bool isHeaderRead;
+    const RinexObsIndex* pEpochIndex;
+
+    // 以系统标识字符（'G','C'）直接索引的选中列，未选择的系统为空
+    std::vector<ObsColumn> sysColumns[128];
 };
 
 
@@ -0,0 +1,400 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#include "SP3Store.h"
+#include "RinexField.h"
+#include "MappedFile.h"
+#include "TimeConvert.h"
+#include "Exception.h"
+
+#define debug 0
+
+static const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+// 历元与网格的偏差超过这个值（秒）时认为不在网格上
+static const double EPOCH_TOLERANCE = 1.0e-3;
+
+// SP3 中钟差不可用的标记值，微秒
+static const double BAD_CLOCK = 999999.0;
+
+// SP3 中的一条位置记录
+struct SP3Record {
+    CommonTime epoch;
+    PackedSat sat;
+    double pos[3];      // 米，缺失为 NaN
+    double clk;         // 秒，缺失为 NaN
+};
+
+struct SP3Store::FileData {
+    CommonTime firstEpoch;
+    double interval;
+    TimeSystem timeSys;
+    vector<SP3Record> records;
+};
+
+// 从 p 开始的一行，le 为行尾（不含换行符和 '\r'），返回下一行的开头
+static inline const char *nextLine(const char *p, const char *e, const char *&le) {
+    const char *nl = static_cast<const char *>(memchr(p, '\n', e - p));
+    le = (nl != NULL) ? nl : e;
+    if (le > p && le[-1] == '\r') --le;
+    return (nl != NULL) ? nl + 1 : e;
+}
+
+static inline double fieldStod(const char *lb, const char *le, size_t pos, size_t len) {
+    const char *fb, *fe;
+    fieldRange(lb, le, pos, len, fb, fe);
+    return rinexStod(fb, fe);
+}
+
+static inline int fieldStoi(const char *lb, const char *le, size_t pos, size_t len) {
+    const char *fb, *fe;
+    fieldRange(lb, le, pos, len, fb, fe);
+    return rinexStoi(fb, fe);
+}
+
+// 第一行和历元行中的时刻，年、月、日、时、分、秒分别在第 3、8、11、14、17、20 列起
+static CommonTime epochOf(const char *lb, const char *le, const TimeSystem &ts) {
+    CivilTime cvt(fieldStoi(lb, le, 3, 4), fieldStoi(lb, le, 8, 2), fieldStoi(lb, le, 11, 2),
+                  fieldStoi(lb, le, 14, 2), fieldStoi(lb, le, 17, 2), 0.0, ts);
+    CommonTime ct = CivilTime2CommonTime(cvt);
+    ct += fieldStod(lb, le, 20, 11);
+    return ct;
+}
+
+// %c 行中的时间系统；GAL、QZS 与 GPS 时只差整数周，按 GPS 处理
+static TimeSystem timeSystemOf(const string &str, const string &file) {
+    if (str == "GPS" || str == "GAL" || str == "QZS") return TimeSystem::GPS;
+    if (str == "BDT") return TimeSystem::BDT;
+    if (str == "UTC") return TimeSystem::UTC;
+    if (str == "TAI") return TimeSystem::TAI;
+    FFStreamError e("SP3Store: unsupported time system " + str + " in " + file);
+    throw (e);
+}
+
+static void parseFile(const string &file, SP3Store::FileData &data) {
+    MappedFile mapped;
+    mapped.open(file);
+
+    const char *p = mapped.begin();
+    const char *end = mapped.end();
+
+    const char *le;
+    const char *lb = p;
+    p = nextLine(p, end, le);
+    if (le - lb < 39 || lb[0] != '#' || (lb[1] != 'c' && lb[1] != 'd')) {
+        FFStreamError e("SP3Store: " + file + " is not an SP3-c/d file");
+        throw (e);
+    }
+    const char *firstLine = lb, *firstLineEnd = le;
+
+    lb = p;
+    p = nextLine(p, end, le);
+    if (le - lb < 38 || lb[0] != '#' || lb[1] != '#') {
+        FFStreamError e("SP3Store: missing ## line in " + file);
+        throw (e);
+    }
+    data.interval = fieldStod(lb, le, 24, 14);
+    if (!(data.interval > 0.0)) {
+        FFStreamError e("SP3Store: invalid epoch interval in " + file);
+        throw (e);
+    }
+
+    // 其余的头记录只用到第一个 %c 行中的时间系统
+    data.timeSys = TimeSystem::GPS;
+    bool hasTimeSys = false;
+    bool hasFirstEpoch = false;
+    CommonTime epoch;
+    while (p < end) {
+        lb = p;
+        p = nextLine(p, end, le);
+        if (le == lb) continue;
+
+        if (lb[0] == '*') {
+            if (!hasFirstEpoch) {
+                data.firstEpoch = epochOf(firstLine, firstLineEnd, data.timeSys);
+                hasFirstEpoch = true;
+            }
+            epoch = epochOf(lb, le, data.timeSys);
+        } else if (lb[0] == 'P') {
+            if (!hasFirstEpoch) {
+                FFStreamError e("SP3Store: position record before the first epoch in " + file);
+                throw (e);
+            }
+            char sysChar = fieldChar(lb, le, 1);
+            if (sysChar == ' ') sysChar = 'G';
+            int prn = fieldStoi(lb, le, 2, 2);
+            if (PackedSat::sysIndex(sysChar) < 0 || prn < 1 || prn > PackedSat::maxPrn) continue;
+
+            SP3Record rec;
+            rec.epoch = epoch;
+            rec.sat = PackedSat(sysChar, prn);
+            bool isZero = true;
+            for (int k = 0; k < 3; k++) {
+                rec.pos[k] = fieldStod(lb, le, 4 + 14 * k, 14) * 1000.0;
+                if (rec.pos[k] != 0.0) isZero = false;
+            }
+            if (isZero) {
+                rec.pos[0] = rec.pos[1] = rec.pos[2] = NaN;
+            }
+            const char *fb, *fe;
+            fieldRange(lb, le, 46, 14, fb, fe);
+            double clk = rinexStod(fb, fe, BAD_CLOCK);
+            rec.clk = (clk >= BAD_CLOCK) ? NaN : clk * 1.0e-6;
+            data.records.push_back(rec);
+        } else if (lb[0] == '%' && lb + 1 < le && lb[1] == 'c' && !hasTimeSys) {
+            const char *fb, *fe;
+            fieldRange(lb, le, 9, 3, fb, fe);
+            data.timeSys = timeSystemOf(string(fb, fe), file);
+            hasTimeSys = true;
+        } else if (le - lb >= 3 && memcmp(lb, "EOF", 3) == 0) {
+            break;
+        }
+        // +、++、%f、%i、/*、V、EP、EV 记录不使用
+    }
+
+    if (!hasFirstEpoch) {
+        FFStreamError e("SP3Store: no epoch in " + file);
+        throw (e);
+    }
+}
+
+SP3Store::SP3Store()
+        : interval(0.0), numEpochs(0), timeSys(TimeSystem::GPS), degree(0),
+          numWindowUpdates(0), numWeightUpdates(0) {
+    setDegree(9);
+}
+
+void SP3Store::loadFile(const string &file) {
+    FileData data;
+    parseFile(file, data);
+    merge(data);
+}
+
+void SP3Store::loadFiles(const vector<string> &files) {
+    for (const string &file: files) {
+        loadFile(file);
+    }
+}
+
+void SP3Store::merge(const FileData &file) {
+    // 先确定新网格并检查所有记录，出错时不修改已有的数据
+    CommonTime newFirst = file.firstEpoch;
+    double newInterval = file.interval;
+    long shift = 0;                     // 已有数据在新网格中的起点
+    if (numEpochs > 0) {
+        if (std::fabs(file.interval - interval) > EPOCH_TOLERANCE || file.timeSys != timeSys) {
+            FFStreamError e("SP3Store: epoch interval or time system differs from the loaded files");
+            throw (e);
+        }
+        newInterval = interval;
+        double offset = (file.firstEpoch - firstEpoch) / interval;
+        long n = std::lround(offset);
+        if (std::fabs(offset - n) * interval > EPOCH_TOLERANCE) {
+            FFStreamError e("SP3Store: epochs are not on the grid of the loaded files");
+            throw (e);
+        }
+        if (n < 0) {
+            shift = -n;
+        } else {
+            newFirst = firstEpoch;
+        }
+    }
+
+    long newNumEpochs = long(numEpochs) + shift;
+    vector<long> index(file.records.size());
+    for (size_t i = 0; i < file.records.size(); i++) {
+        double offset = (file.records[i].epoch - newFirst) / newInterval;
+        long n = std::lround(offset);
+        if (n < 0 || std::fabs(offset - n) * newInterval > EPOCH_TOLERANCE) {
+            FFStreamError e("SP3Store: epochs are not on the grid of the loaded files");
+            throw (e);
+        }
+        index[i] = n;
+        newNumEpochs = std::max(newNumEpochs, n + 1);
+    }
+
+    // 扩展已有卫星的数组
+    if (shift > 0 || size_t(newNumEpochs) > numEpochs) {
+        for (const SatID &sat: satList) {
+            SatData &d = satData[sat];
+            vector<double> pos(3 * newNumEpochs, NaN), clk(newNumEpochs, NaN);
+            std::copy(d.pos.begin(), d.pos.end(), pos.begin() + 3 * shift);
+            std::copy(d.clk.begin(), d.clk.end(), clk.begin() + shift);
+            d.pos.swap(pos);
+            d.clk.swap(clk);
+            d.window = Window();
+        }
+    }
+    firstEpoch = newFirst;
+    interval = newInterval;
+    numEpochs = size_t(newNumEpochs);
+    timeSys = file.timeSys;
+
+    for (size_t i = 0; i < file.records.size(); i++) {
+        const SP3Record &rec = file.records[i];
+        SatData *pData = satData.find(rec.sat);
+        if (pData == NULL) {
+            pData = &satData[rec.sat];
+            pData->pos.assign(3 * numEpochs, NaN);
+            pData->clk.assign(numEpochs, NaN);
+            satList.push_back(rec.sat.toSatID());
+        }
+        // 缺失的值不覆盖已有的数据
+        long n = index[i];
+        if (!std::isnan(rec.pos[0])) {
+            pData->pos[3 * n] = rec.pos[0];
+            pData->pos[3 * n + 1] = rec.pos[1];
+            pData->pos[3 * n + 2] = rec.pos[2];
+        }
+        if (!std::isnan(rec.clk)) {
+            pData->clk[n] = rec.clk;
+        }
+        pData->window = Window();
+    }
+
+    std::sort(satList.begin(), satList.end());
+
+    if (debug) {
+        cout << "SP3Store: " << satList.size() << " sats, " << numEpochs << " epochs from "
+             << firstEpoch << endl;
+    }
+}
+
+void SP3Store::setDegree(int n) {
+    if (n < 1 || n > MAX_DEGREE) {
+        InvalidRequest e("SP3Store: degree out of range");
+        throw (e);
+    }
+    degree = n;
+
+    // 节点 0..n 的重心权 1 / prod(j - k)
+    for (int j = 0; j <= n; j++) {
+        double prod = 1.0;
+        for (int k = 0; k <= n; k++) {
+            if (k != j) prod *= double(j - k);
+        }
+        baryWeight[j] = 1.0 / prod;
+    }
+    clearCache();
+}
+
+bool SP3Store::hasSat(const SatID &sat) const {
+    return satData.contains(PackedSat(sat));
+}
+
+void SP3Store::clearCache() {
+    for (const SatID &sat: satList) {
+        satData[sat].window = Window();
+    }
+}
+
+void SP3Store::computeWeights(double u, Window &w) const {
+    const int n = degree + 1;
+
+    // l_j(u) = w_j * prod(u - k, k != j)，用前缀积和后缀积以及它们的导数计算，
+    // 不除以 u - j，u 落在节点上或离节点很近时也不损失精度
+    double pre[MAX_POINTS], dPre[MAX_POINTS], suf[MAX_POINTS], dSuf[MAX_POINTS];
+    pre[0] = 1.0;
+    dPre[0] = 0.0;
+    for (int k = 0; k < n - 1; k++) {
+        pre[k + 1] = pre[k] * (u - double(k));
+        dPre[k + 1] = dPre[k] * (u - double(k)) + pre[k];
+    }
+    suf[n - 1] = 1.0;
+    dSuf[n - 1] = 0.0;
+    for (int k = n - 1; k > 0; k--) {
+        suf[k - 1] = suf[k] * (u - double(k));
+        dSuf[k - 1] = dSuf[k] * (u - double(k)) + suf[k];
+    }
+    for (int j = 0; j < n; j++) {
+        w.posWeight[j] = baryWeight[j] * pre[j] * suf[j];
+        w.velWeight[j] = baryWeight[j] * (dPre[j] * suf[j] + pre[j] * dSuf[j]);
+    }
+}
+
+Xvt SP3Store::getXvt(const SatID &sat, const CommonTime &t) {
+    PackedSat packedSat(sat);
+    SatData *pData = satData.find(packedSat);
+    if (pData == NULL) {
+        InvalidRequest e("SP3Store: no precise orbit for " + sat.toString());
+        throw (e);
+    }
+
+    const int n = degree + 1;
+    double x = (convertTimeSystem(t, timeSys) - firstEpoch) / interval;
+    if (numEpochs < size_t(n) || x < 0.0 || x > double(numEpochs - 1)) {
+        InvalidRequest e("SP3Store: epoch is out of the precise orbit span for " + sat.toString());
+        throw (e);
+    }
+
+    // 窗口取 x 两侧各 n/2 个点，靠近首尾时移向内侧
+    long i0 = long(std::floor(x));
+    long start = i0 - (n / 2 - 1);
+    if (start < 0) start = 0;
+    if (start > long(numEpochs) - n) start = long(numEpochs) - n;
+
+    Window &w = pData->window;
+    if (w.start != start) {
+        numWindowUpdates++;
+        w.start = start;
+        w.u = -1.0;
+        w.isValid = true;
+        const double *pos = &pData->pos[3 * start];
+        for (int j = 0; j < 3 * n; j++) {
+            if (std::isnan(pos[j])) {
+                w.isValid = false;
+                break;
+            }
+        }
+    }
+    if (!w.isValid) {
+        InvalidRequest e("SP3Store: missing precise orbit around the epoch for " + sat.toString());
+        throw (e);
+    }
+
+    double u = x - double(start);
+    if (u != w.u) {
+        numWeightUpdates++;
+        computeWeights(u, w);
+        w.u = u;
+    }
+
+    Xvt xvt;
+    const double *pos = &pData->pos[3 * start];
+    double px = 0.0, py = 0.0, pz = 0.0, vx = 0.0, vy = 0.0, vz = 0.0;
+    for (int j = 0; j < n; j++) {
+        double cp = w.posWeight[j], cv = w.velWeight[j];
+        px += cp * pos[3 * j];
+        py += cp * pos[3 * j + 1];
+        pz += cp * pos[3 * j + 2];
+        vx += cv * pos[3 * j];
+        vy += cv * pos[3 * j + 1];
+        vz += cv * pos[3 * j + 2];
+    }
+    xvt.x << px, py, pz;
+    xvt.v << vx / interval, vy / interval, vz / interval;
+
+    // 钟差在相邻两个历元之间线性插值
+    long k = std::min(i0, long(numEpochs) - 2);
+    double c0 = pData->clk[k], c1 = pData->clk[k + 1];
+    double f = x - double(k);
+    if (f == 0.0 && !std::isnan(c0) && std::isnan(c1) && k > 0) {
+        c1 = c0;
+        c0 = pData->clk[k - 1];
+        f = 1.0;
+    }
+    if (std::isnan(c0) || std::isnan(c1)) {
+        InvalidRequest e("SP3Store: missing precise clock around the epoch for " + sat.toString());
+        throw (e);
+    }
+    xvt.clkbias = c0 + f * (c1 - c0);
+    xvt.clkdrift = (c1 - c0) / interval;
+    xvt.relcorr = -2.0 * xvt.x.dot(xvt.v) / (C_MPS * C_MPS);
+
+    return xvt;
+}
@@ -0,0 +1,124 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_SP3STORE_H
+#define GNSSLAB_SP3STORE_H
+
+#include <string>
+#include <vector>
+
+#include "GnssStruct.h"
+#include "SatIndex.h"
+
+using namespace std;
+
+// SP3-c/d 精密星历的存储和插值
+//
+// 一个或多个（如连续多天的）SP3 文件读入后放在同一个等间隔的历元网格上，
+// 每颗卫星的位置按历元连续存放（x,y,z 相邻），钟差单独一个数组，缺少的值（位置 0.000000、钟差 999999.999999）记为 NaN。
+// 网格等间隔，查询时刻所在的历元由 (t - t0) / interval 直接算出，不需要查找。
+//
+// 位置用 degree+1 个点的 Lagrange 插值（默认 9 阶 10 个点，适用于 5~15 分钟间隔的产品），
+// 插值窗口取查询时刻两侧各一半的点，靠近数据首尾时整体移向内侧。
+// 等间隔节点的 Lagrange 基函数的分母只与点数有关，设置阶数时算好；每颗卫星缓存当前的窗口（起点和窗口内有无缺失）
+// 以及上一次查询时刻的位置、速度基函数权，同一窗口内的查询不再检查数据，同一时刻的重复查询
+// （SPP 迭代、多个测站）只做一次长度为 degree+1 的加权求和。
+// 速度由插值多项式求导得到，文件中的 V 记录不使用。
+// 钟差在相邻两个历元之间线性插值，钟漂取这两个历元的差分，相对论改正按 -2 r·v / c^2 计算。
+//
+// 用法：
+//      SP3Store sp3Store;
+//      sp3Store.loadFiles(sp3Files);
+//      spp.setSP3Store(&sp3Store);
+//
+// 插值的缓存不加锁，一个 SP3Store 只能在一个线程中查询。
+class SP3Store {
+public:
+    static const int MAX_DEGREE = 16;
+
+    SP3Store();
+
+    // 读入一个 SP3 文件并入已有的数据，同一卫星、同一历元以后读入的为准。
+    // 文件不存在时抛出 FileMissingException；格式错误，或采样间隔、时间系统与已有数据不一致、
+    // 历元不在已有的网格上时抛出 FFStreamError，这时不修改已有的数据
+    void loadFile(const string &file);
+
+    // 依次读入多个文件，出错时已经读入的文件保留
+    void loadFiles(const vector<string> &files);
+
+    // 插值阶数，1 到 MAX_DEGREE
+    void setDegree(int n);
+
+    int getDegree() const { return degree; };
+
+    // t 时刻的卫星位置、速度、钟差；没有该卫星、t 超出数据范围或插值用到的数据缺失时抛出 InvalidRequest
+    Xvt getXvt(const SatID &sat, const CommonTime &t);
+
+    bool hasSat(const SatID &sat) const;
+
+    const vector<SatID> &getSatList() const { return satList; };
+
+    size_t getNumEpochs() const { return numEpochs; };
+
+    double getInterval() const { return interval; };
+
+    CommonTime getFirstEpoch() const { return firstEpoch; };
+
+    CommonTime getLastEpoch() const { return firstEpoch + interval * double(numEpochs - 1); };
+
+    TimeSystem getTimeSystem() const { return timeSys; };
+
+    // 清除插值窗口和基函数权的缓存
+    void clearCache();
+
+    // 换窗口的次数和基函数权的计算次数
+    size_t getNumWindowUpdates() const { return numWindowUpdates; };
+
+    size_t getNumWeightUpdates() const { return numWeightUpdates; };
+
+    // 一个文件的解析结果，只在 SP3Store.cpp 中使用
+    struct FileData;
+
+private:
+    static const int MAX_POINTS = MAX_DEGREE + 1;
+
+    // 每颗卫星当前的插值窗口和上一次查询的基函数权
+    struct Window {
+        Window() : start(-1), isValid(false), u(-1.0) {};
+
+        long start;                   // 窗口第一个点的历元序号，-1 表示没有窗口
+        bool isValid;                 // 窗口内的位置都不缺失
+        double u;                     // 上一次查询时刻在窗口内的位置，以采样间隔为单位
+        double posWeight[MAX_POINTS];
+        double velWeight[MAX_POINTS]; // 乘以位置后为对 u 的导数
+    };
+
+    struct SatData {
+        vector<double> pos;           // 3 * numEpochs，米
+        vector<double> clk;           // numEpochs，秒
+        Window window;
+    };
+
+    // 把 file 并入网格
+    void merge(const FileData &file);
+
+    // 窗口内 u 处的基函数权
+    void computeWeights(double u, Window &w) const;
+
+    CommonTime firstEpoch;
+    double interval;
+    size_t numEpochs;
+    TimeSystem timeSys;
+
+    SatTable<SatData> satData;
+    vector<SatID> satList;
+
+    int degree;
+    double baryWeight[MAX_POINTS];    // 等间隔节点 0..degree 的 Lagrange 基函数分母的倒数
+
+    size_t numWindowUpdates;
+    size_t numWeightUpdates;
+};
+
+#endif //GNSSLAB_SP3STORE_H
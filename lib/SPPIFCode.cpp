@@ -4,10 +4,35 @@
 
 #include "SPPIFCode.h"
 #include "CoordConvert.h"
+#include "SignalCatalog.h"
 #include <Eigen/Eigen>
 
 #define debug 1
 
+namespace {
+
+    // computeSatPos 期间持有实时星历的快照，结束（包括抛出异常）时释放
+    class LiveSnapshotScope {
+    public:
+        LiveSnapshotScope(LiveEphStore* pStore, int reader, const LiveEphStore::Snapshot*& pSnap)
+                : pStore(pStore), reader(reader), pSnap(pSnap) {
+            if (pStore != NULL) pSnap = &pStore->acquire(reader);
+        }
+
+        ~LiveSnapshotScope() {
+            if (pStore != NULL) {
+                pSnap = NULL;
+                pStore->release(reader);
+            }
+        }
+
+    private:
+        LiveEphStore* pStore;
+        int reader;
+        const LiveEphStore::Snapshot*& pSnap;
+    };
+}
+
 void SPPIFCode::solve(ObsData &obsData) {
     //----------------------
     // 去掉通道号，C1W, C1C => C1;
@@ -45,6 +70,8 @@ void SPPIFCode::solve(ObsData &obsData) {
     xyz = obsData.antennaPosition;
     dxyz = {100, 100, 100};
 
+    designMatrix.setVariableRegistry(pRegistry != NULL ? pRegistry : &ownRegistry);
+
     int iter(0);
     while (true) {
 
@@ -95,7 +122,7 @@ void SPPIFCode::solve(ObsData &obsData) {
             // computeTropDealy();
         }
 
-        equSys = linearize(xyz, satXvtRecTime, satElevData, obsData);
+        linearize(xyz, satXvtRecTime, satElevData, obsData, designMatrix);
 
        /* if(debug)
             cout << "afte linearize:" << endl;*/
@@ -106,7 +133,7 @@ void SPPIFCode::solve(ObsData &obsData) {
         if(!isRover)
             break;
 
-        solverLsq.solve(equSys);
+        solverLsq.solve(designMatrix);
         dxyz = solverLsq.getdxyz();
 
         xyz += dxyz;
@@ -131,10 +158,13 @@ void SPPIFCode::solve(ObsData &obsData) {
 }
 
 
-std::map<SatID, Xvt> SPPIFCode::computeSatPos(ObsData &obsData) {
-    std::map<SatID, Xvt> satXvtData;
+SatXvtMap SPPIFCode::computeSatPos(ObsData &obsData) {
+    SatXvtMap satXvtData;
     SatIDSet satRejectedSet;//这里存储的是不要卫星号
     CommonTime time = obsData.epoch;
+
+    // 实时星历：这个历元的卫星都用同一个快照，解码线程中途发布的星历从下一个历元开始使用
+    LiveSnapshotScope liveScope(liveReader.store(), liveReader.id(), pLiveSnapshot);
   //  cout << "Time: " << time << endl;//todo:这里没问题
     // Loop through all the satellites
     for (auto stv: obsData.satTypeValueData) {
@@ -240,12 +270,26 @@ noexcept(false) {
 
     // 这里也可以用while循环来替换这里的迭代次数
     for (int i = 0; i < 2; i++) {
-        if (pEphStore != NULL) {
+        if (pSP3Store != NULL) {
+            xvt = pSP3Store->getXvt(sat, tt);
+        } else if (pSatCache != NULL) {
+            xvt = pSatCache->getXvt(sat, tt);
+        } else if (pOrbitInterp != NULL) {
+            xvt = pOrbitInterp->getXvt(sat, tt);
+        } else if (pLiveSnapshot != NULL) {
+            xvt = pLiveSnapshot->getXvt(sat, tt);
+        } else if (liveReader.store() != NULL) {
+            LiveEphStore::ReadGuard guard(*liveReader.store(), liveReader.id());
+            xvt = guard.get().getXvt(sat, tt);
+        } else if (pEphStore != NULL) {
             //todo：这里需要改变，已经到最底层了！！
             //todo：实时流这里有问题！！！！
             xvt = pEphStore->getXvt(sat, tt);
            // cout << "xvt: " << xvt << endl;
         }
+        if (pClockStore != NULL) {
+            pClockStore->getClock(sat, tt, xvt.clkbias, xvt.clkdrift);
+        }
         tt = transmit;
         tt -= (xvt.clkbias + xvt.relcorr);
     }
@@ -289,12 +333,14 @@ void SPPIFCode::computeIF(ObsData &obsData) {
         << "type2:"
         << ifPair.second << endl;
 
-        double f1 = getFreq(sys, ifPair.first);
-        double f2 = getFreq(sys, ifPair.second);
-        if(debug)
-        {
-            cout << "f1:" << f1 << "f2" << f2 << endl;
+        // IF 组合系数按频点编号查表
+        int b1 = SignalCatalog::bandId(sys, ifPair.first);
+        int b2 = SignalCatalog::bandId(sys, ifPair.second);
+        if (b1 < 0 || b2 < 0 || !SignalCatalog::pair(b1, b2).isValid) {
+            satRejectedSet.insert(stv.first);
+            continue;
         }
+        const SignalPair &ifCoef = SignalCatalog::pair(b1, b2);
 
         // 提取观测值
         // TypeID type1, type2;
@@ -303,7 +349,7 @@ void SPPIFCode::computeIF(ObsData &obsData) {
         try {
             value1 = stv.second.at(ifPair.first);
             value2 = stv.second.at(ifPair.second);
-            ifValue = (f1 * f1 * value1 - f2 * f2 * value2) / (f1 * f1 - f2 * f2);
+            ifValue = ifCoef.ifCoef1 * value1 + ifCoef.ifCoef2 * value2;
 
             /*if (debug) {
                 cout << "value1:" << value1 << endl;
@@ -327,10 +373,10 @@ void SPPIFCode::computeIF(ObsData &obsData) {
 
 };
 
-std::map<SatID, Xvt> SPPIFCode::earthRotation(Eigen::Vector3d &xyz,
-                                              std::map<SatID, Xvt> &satXvtTransTime) {
+SatXvtMap SPPIFCode::earthRotation(Eigen::Vector3d &xyz,
+                                              SatXvtMap &satXvtTransTime) {
 
-    std::map<SatID, Xvt> satXvtRecTime;
+    SatXvtMap satXvtRecTime;
     for(auto stv: satXvtTransTime) {
         SatID sat = stv.first;
         XYZ xyzSat(stv.second.x);
@@ -383,7 +429,7 @@ std::map<SatID, Xvt> SPPIFCode::earthRotation(Eigen::Vector3d &xyz,
 };
 
 void SPPIFCode::computeElevAzim(Eigen::Vector3d& xyz,
-                                std::map<SatID,Xvt> & satXvt,
+                                SatXvtMap & satXvt,
                                 SatValueMap& tempElevData,
                                 SatValueMap& tempAzimData
                                  )
@@ -408,13 +454,21 @@ void SPPIFCode::computeElevAzim(Eigen::Vector3d& xyz,
 };
 
 
-EquSys SPPIFCode::linearize(Eigen::Vector3d& xyz,
-                                  std::map<SatID,Xvt>& satXvtRecTime,
-                                  SatValueMap& satElevData,
-                                  ObsData &obsData) {
-    EquSys equSysTemp;
-    VariableSet varSetTemp;
-    for (auto stv: obsData.satTypeValueData) {
+void SPPIFCode::linearize(Eigen::Vector3d& xyz,
+                          SatXvtMap& satXvtRecTime,
+                          SatValueMap& satElevData,
+                          ObsData &obsData,
+                          DesignMatrix& design) {
+    VariableRegistry &registry = *design.getVariableRegistry();
+    design.clear();
+
+    // 首先定义所有可能的未知参数
+    int dx = registry.intern(Variable(obsData.station, Parameter::dX));
+    int dy = registry.intern(Variable(obsData.station, Parameter::dY));
+    int dz = registry.intern(Variable(obsData.station, Parameter::dZ));
+    int cdtGPS = registry.intern(Variable(obsData.station, Parameter::cdt));
+
+    for (const auto& stv: obsData.satTypeValueData) {
         SatID sat = stv.first;
 
         double elev = satElevData.at(sat);
@@ -459,14 +513,8 @@ EquSys SPPIFCode::linearize(Eigen::Vector3d& xyz,
         // todo
         // 请补充rhoDot，用于后续的单点测速
 
-        // 首先定义所有可能的未知参数
-        Variable dx(obsData.station, Parameter::dX);
-        Variable dy(obsData.station, Parameter::dY);
-        Variable dz(obsData.station, Parameter::dZ);
-        Variable cdtGPS(obsData.station, Parameter::cdt);
-
         // 对每个观测值，都需要存储对应的未知参数及其偏导数
-        for (auto tv: stv.second)
+        for (const auto& tv: stv.second)
         {
             if (sat.system=="G" && tv.first == "CC12" )
             {
@@ -485,11 +533,12 @@ EquSys SPPIFCode::linearize(Eigen::Vector3d& xyz,
                     cout << "slantTrop" << slantTrop << endl;
                 }
 
-                equSysTemp.obsEquData[equID].prefit = prefit;
-                equSysTemp.obsEquData[equID].varCoeffData[dx] = cosines[0];
-                equSysTemp.obsEquData[equID].varCoeffData[dy] = cosines[1];
-                equSysTemp.obsEquData[equID].varCoeffData[dz] = cosines[2];
-                equSysTemp.obsEquData[equID].varCoeffData[cdtGPS] = 1.0;
+                int row = design.addRow(equID);
+                design.setPrefit(row, prefit);
+                design.addCoeff(dx, cosines[0]);
+                design.addCoeff(dy, cosines[1]);
+                design.addCoeff(dz, cosines[2]);
+                design.addCoeff(cdtGPS, 1.0);
 
 
                 // Compute the weight according to elevation
@@ -502,17 +551,10 @@ EquSys SPPIFCode::linearize(Eigen::Vector3d& xyz,
                     weight = 1.0 / (sigIFCode * sigIFCode) * std::pow(std::sin(elevRad), 2);
                 }
 
-                equSysTemp.obsEquData[equID].weight = weight; // IF组合方差为1.0m
-
-                // 把当前观测方程未知参数插入到总体的未知参数
-                varSetTemp.insert(dx);
-                varSetTemp.insert(dy);
-                varSetTemp.insert(dz);
-                varSetTemp.insert(cdtGPS);
+                design.setWeight(row, weight); // IF组合方差为1.0m
             }
         }
     }
 
-    equSysTemp.varSet = varSetTemp;
-    return equSysTemp;
+    design.finish();
 };
\ No newline at end of file
@@ -7,13 +7,22 @@
 
 #include "GnssStruct.h"
 #include "SolverLSQ.h"
+#include "DesignMatrix.h"
+#include "VariableRegistry.h"
 #include "RinexNavStore.hpp"
+#include "SatStateCache.h"
+#include "OrbitInterpolator.h"
+#include "SP3Store.h"
+#include "RinexClockStore.h"
+#include "LiveEphStore.h"
 #include <Eigen/Eigen>
 
 class SPPIFCode {
 public:
     SPPIFCode()
-    : pEphStore(NULL), isRover(true), sigIFCode(1.0), cutOffElev(10)
+    : cutOffElev(10), isRover(true), sigIFCode(1.0),
+      pEphStore(NULL), pSatCache(NULL), pOrbitInterp(NULL), pSP3Store(NULL), pClockStore(NULL),
+      pLiveSnapshot(NULL), pRegistry(NULL)
     {}
 
     void setStationAsBase()
@@ -26,6 +35,45 @@ public:
         pEphStore = pStore;
     };
 
+    // 多个测站共享的卫星状态缓存，设置后卫星位置和钟差从缓存中取得
+    void setSatStateCache(SatStateCache* pCache)
+    {
+        pSatCache = pCache;
+    };
+
+    // 高采样率处理时用多项式插值代替逐历元的星历计算；同时设置了缓存时以缓存为准
+    void setOrbitInterpolator(OrbitInterpolator* pInterp)
+    {
+        pOrbitInterp = pInterp;
+    };
+
+    // 精密星历，设置后卫星位置和钟差都由 SP3 插值得到，不再使用广播星历、缓存和多项式插值
+    void setSP3Store(SP3Store* pStore)
+    {
+        pSP3Store = pStore;
+    };
+
+    // 精密钟差，设置后卫星钟差由钟差文件插值得到，替换轨道来源（SP3 或广播星历）给出的钟差
+    void setClockStore(RinexClockStore* pStore)
+    {
+        pClockStore = pStore;
+    };
+
+    // 实时解码的星历，设置后代替 RinexNavStore；每个历元取一个快照，这个历元的卫星都用它计算。
+    // 设置时占用 pStore 的一个读者槽（原来的槽归还），对象析构时归还；
+    // 求解对象在哪个线程中使用都可以，但不能同时在两个线程中使用，复制的对象另占一个槽
+    void setLiveEphStore(LiveEphStore* pStore)
+    {
+        liveReader.reset(pStore);
+    };
+
+    // 未知参数登记表，流动站和基准站使用同一个登记表时，差分可以直接按句柄进行；
+    // 没有设置时使用对象自己的登记表
+    void setVariableRegistry(VariableRegistry* pReg)
+    {
+        pRegistry = pReg;
+    };
+
     void setIFCodeTypes(std::map<string, std::pair<string, string>>& ifTypes)
     {
         ifCodeTypes = ifTypes;
@@ -33,28 +81,40 @@ public:
 
     void solve(ObsData &obsData);
 
-    std::map<SatID,Xvt> computeSatPos(ObsData &obsData);
+    SatXvtMap computeSatPos(ObsData &obsData);
     Xvt computeAtTransmitTime(const CommonTime& tr,
                               const double& pr,
                               const SatID& sat);
 
     void computeElevAzim(Eigen::Vector3d& xyz,
-                          std::map<SatID,Xvt> & satXvtTransTime,
+                          SatXvtMap & satXvtTransTime,
                           SatValueMap& tempElevData,
                           SatValueMap& tempAzimData);
 
     void convertObsType(ObsData &obsData);
     void computeIF(ObsData &obsData);
-    std::map<SatID,Xvt> earthRotation(Eigen::Vector3d& xyz,
-                                      std::map<SatID,Xvt> & satXvtTransTime);
-    EquSys linearize(Eigen::Vector3d& xyz,
-                     std::map<SatID,Xvt>& satXvtRecTime,
-                     SatValueMap& satElevData,
-                     ObsData& obsData);
+    SatXvtMap earthRotation(Eigen::Vector3d& xyz,
+                                      SatXvtMap & satXvtTransTime);
+    // 观测方程直接写入按行压缩的设计矩阵，供 solverLsq 使用
+    void linearize(Eigen::Vector3d& xyz,
+                   SatXvtMap& satXvtRecTime,
+                   SatValueMap& satElevData,
+                   ObsData& obsData,
+                   DesignMatrix& design);
 
     EquSys getEquSys()
     {
-        return equSys;
+        EquSys equSysTemp;
+        if(designMatrix.finished())
+        {
+            designMatrix.toEquSys(equSysTemp);
+        }
+        return equSysTemp;
+    };
+
+    const DesignMatrix& getDesignMatrix() const
+    {
+        return designMatrix;
     };
 
     //从给定的卫星数据中找到仰角最高的卫星，并返回该卫星的标识（SatID）
@@ -95,14 +155,14 @@ protected:
     double sigIFCode;
 
 
-    EquSys equSys;
+    DesignMatrix designMatrix;
     Result result;
 
     Vector3d xyz;
     Vector3d dxyz;
 
-    std::map<SatID,Xvt> satXvtTransTime;
-    std::map<SatID,Xvt> satXvtRecTime;
+    SatXvtMap satXvtTransTime;
+    SatXvtMap satXvtRecTime;
 
     SatValueMap  satElevData;
     SatValueMap  satAzimData;
@@ -111,6 +171,15 @@ protected:
     SolverLSQ  solverLsq;
 
     RinexNavStore* pEphStore;
+    SatStateCache* pSatCache;
+    OrbitInterpolator* pOrbitInterp;
+    SP3Store* pSP3Store;
+    RinexClockStore* pClockStore;
+    LiveEphStore::ReaderSlot liveReader;
+    const LiveEphStore::Snapshot* pLiveSnapshot;   // computeSatPos 期间的快照
+
+    VariableRegistry* pRegistry;
+    VariableRegistry ownRegistry;
 
     std::map<string, std::pair<string, string>> ifCodeTypes;
 
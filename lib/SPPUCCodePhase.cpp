@@ -4,6 +4,7 @@
 
 #include "SPPUCCodePhase.h"
 #include "StringUtils.h"
+#include "SignalCatalog.h"
 #define debug 1
 
 #define SIG_UC_CODE 0.3
@@ -71,6 +72,8 @@ void SPPUCCodePhase::solve(ObsData &obsData) {
    // cout << "xyz: " << xyz << endl;
     dxyz = {100, 100, 100};
 
+    designMatrix.setVariableRegistry(pRegistry != NULL ? pRegistry : &ownRegistry);
+
     int iter(0);
     while (true) {
 
@@ -131,7 +134,7 @@ void SPPUCCodePhase::solve(ObsData &obsData) {
             // computeTropDealy();
         }
 
-        equSys = linearize(xyz, satXvtRecTime, satElevData, obsData);
+        linearize(xyz, satXvtRecTime, satElevData, obsData, designMatrix);
 
        // if(debug)
          //   cout << "afte linearize:" << endl;
@@ -141,7 +144,7 @@ void SPPUCCodePhase::solve(ObsData &obsData) {
         if(!isRover)
             break;
 
-        solverLsq.solve(equSys);
+        solverLsq.solve(designMatrix);
         dxyz = solverLsq.getdxyz();
 
         xyz += dxyz;
@@ -198,13 +201,21 @@ void SPPUCCodePhase::checkDualCodeTypes(ObsData &obsData)  {
     }
 };
 
-EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
-                                 std::map<SatID,Xvt>& satXvtRecTime,
-                                 SatValueMap& satElevData,
-                                 ObsData &obsData) {
-    EquSys equSys;
-    VariableSet varSetTemp;
-    for (auto stv: obsData.satTypeValueData) {
+void SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
+                               SatXvtMap& satXvtRecTime,
+                               SatValueMap& satElevData,
+                               ObsData &obsData,
+                               DesignMatrix& design) {
+    VariableRegistry &registry = *design.getVariableRegistry();
+    design.clear();
+
+    // 首先定义所有可能的未知参数
+    int dx = registry.intern(Variable(obsData.station, Parameter::dX));
+    int dy = registry.intern(Variable(obsData.station, Parameter::dY));
+    int dz = registry.intern(Variable(obsData.station, Parameter::dZ));
+    int cdtGPS = registry.intern(Variable(obsData.station, Parameter::cdt));
+
+    for (const auto& stv: obsData.satTypeValueData) {
         SatID sat = stv.first;
 
         double elev = satElevData.at(sat);
@@ -253,34 +264,30 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
         // todo
         // 请补充rhoDot，用于后续的单点测速
 
-        // 首先定义所有可能的未知参数
-        Variable dx(obsData.station, Parameter::dX);
-        Variable dy(obsData.station, Parameter::dY);
-        Variable dz(obsData.station, Parameter::dZ);
-        Variable cdtGPS(obsData.station, Parameter::cdt);
         // 把当前观测方程未知参数插入到总体的未知参数
-        varSetTemp.insert(dx);
-        varSetTemp.insert(dy);
-        varSetTemp.insert(dz);
-        varSetTemp.insert(cdtGPS);
+        design.addColumn(dx);
+        design.addColumn(dy);
+        design.addColumn(dz);
+        design.addColumn(cdtGPS);
 
         // 对每个观测值，都需要存储对应的未知参数及其偏导数
-        for (auto tv: stv.second)
+        for (const auto& tv: stv.second)
         {
             if (sat.system == "C" && SYS == "C")
             {
                 // 电离层所有频率估计的都是第一频率的伪距的电离层延迟
-                Variable ionoC1G(obsData.station,
-                                 sat,
-                                 Parameter::iono,
-                                 ObsID(sat.system, "C2"));
+                int ionoC1G = registry.intern(Variable(obsData.station,
+                                                       sat,
+                                                       Parameter::iono,
+                                                       ObsID(sat.system, "C2")));
 
                 // 把ionoC1G插入到观测方程
-                varSetTemp.insert(ionoC1G);
+                design.addColumn(ionoC1G);
 
-                double gamma = getGamma(sat.system, "C2", "C7");
+                double gamma = SignalCatalog::pair(SignalCatalog::bandId('C', '2'),
+                                                  SignalCatalog::bandId('C', '7')).gamma;
 
-                varSetTemp.insert(ionoC1G);
+                design.addColumn(ionoC1G);
 
                 if (tv.first == "C2" )
                 {
@@ -304,12 +311,13 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                              << endl;
                     }*/
 
-                    equSys.obsEquData[equID].prefit = prefit;
-                    equSys.obsEquData[equID].varCoeffData[dx] = cosines[0];
-                    equSys.obsEquData[equID].varCoeffData[dy] = cosines[1];
-                    equSys.obsEquData[equID].varCoeffData[dz] = cosines[2];
-                    equSys.obsEquData[equID].varCoeffData[cdtGPS] = 1.0;
-                    equSys.obsEquData[equID].varCoeffData[ionoC1G] = 1.0;
+                    int row = design.addRow(equID);
+                    design.setPrefit(row, prefit);
+                    design.addCoeff(dx, cosines[0]);
+                    design.addCoeff(dy, cosines[1]);
+                    design.addCoeff(dz, cosines[2]);
+                    design.addCoeff(cdtGPS, 1.0);
+                    design.addCoeff(ionoC1G, 1.0);
 
                     // Compute the weight according to elevation
                     double weight;
@@ -321,7 +329,7 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                         weight = 1.0 / (SIG_UC_CODE * SIG_UC_CODE) * std::pow(std::sin(elevRad), 2);
                     }
 
-                    equSys.obsEquData[equID].weight = weight; // IF组合方差为1.0m
+                    design.setWeight(row, weight); // IF组合方差为1.0m
 
 
                 }
@@ -348,12 +356,13 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                              << endl;
                     }*/
 
-                    equSys.obsEquData[equID].prefit = prefit;
-                    equSys.obsEquData[equID].varCoeffData[dx] = cosines[0];
-                    equSys.obsEquData[equID].varCoeffData[dy] = cosines[1];
-                    equSys.obsEquData[equID].varCoeffData[dz] = cosines[2];
-                    equSys.obsEquData[equID].varCoeffData[cdtGPS] = 1.0;
-                    equSys.obsEquData[equID].varCoeffData[ionoC1G] = gamma;
+                    int row = design.addRow(equID);
+                    design.setPrefit(row, prefit);
+                    design.addCoeff(dx, cosines[0]);
+                    design.addCoeff(dy, cosines[1]);
+                    design.addCoeff(dz, cosines[2]);
+                    design.addCoeff(cdtGPS, 1.0);
+                    design.addCoeff(ionoC1G, gamma);
 
                     // Compute the weight according to elevation
                     double weight;
@@ -365,7 +374,7 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                         weight = 1.0 / (SIG_UC_CODE * SIG_UC_CODE) * std::pow(std::sin(elevRad), 2);
                     }
 
-                    equSys.obsEquData[equID].weight = weight; // IF组合方差为1.0m
+                    design.setWeight(row, weight); // IF组合方差为1.0m
 
 
                 }
@@ -393,24 +402,25 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                     }*/
 
                     //>>>> 定义未知系数变量和系数值
-                    equSys.obsEquData[equID].prefit = prefit;
-                    equSys.obsEquData[equID].varCoeffData[dx] = cosines[0];
-                    equSys.obsEquData[equID].varCoeffData[dy] = cosines[1];
-                    equSys.obsEquData[equID].varCoeffData[dz] = cosines[2];
-                    equSys.obsEquData[equID].varCoeffData[cdtGPS] = 1.0;
-                    equSys.obsEquData[equID].varCoeffData[ionoC1G] = -1.0;
+                    int row = design.addRow(equID);
+                    design.setPrefit(row, prefit);
+                    design.addCoeff(dx, cosines[0]);
+                    design.addCoeff(dy, cosines[1]);
+                    design.addCoeff(dz, cosines[2]);
+                    design.addCoeff(cdtGPS, 1.0);
+                    design.addCoeff(ionoC1G, -1.0);
 
                     // 定义模糊度变量
-                    Variable ambL1G(obsData.station,
-                                     sat,
-                                     Parameter::ambiguity,
-                                     ObsID(sat.system, tv.first));
+                    int ambL1G = registry.intern(Variable(obsData.station,
+                                                          sat,
+                                                          Parameter::ambiguity,
+                                                          ObsID(sat.system, tv.first)));
 
                     // 将模糊度变量存储到全体变量列表中
-                    varSetTemp.insert(ambL1G);
+                    design.addColumn(ambL1G);
 
-                    double wavelength = getWavelength(sat.system, safeStoi(tv.first.substr(1,1)));
-                    equSys.obsEquData[equID].varCoeffData[ambL1G] = wavelength;
+                    double wavelength = SignalCatalog::wavelength(SignalCatalog::bandId(sat.system, tv.first));
+                    design.addCoeff(ambL1G, wavelength);
 
 
                     // Compute the weight according to elevation
@@ -422,7 +432,7 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                     {
                         weight = 1.0 / (SIG_UC_PHASE * SIG_UC_PHASE) * std::pow(std::sin(elevRad), 2);
                     }
-                    equSys.obsEquData[equID].weight = weight;
+                    design.setWeight(row, weight);
 
 
                 }
@@ -434,7 +444,8 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                     double prefit;
                     double computedObs = (rho - clkBias - relCorr + slantTrop) ;
                     prefit = tv.second - computedObs;
-                    equSys.obsEquData[equID].prefit = prefit;
+                    int row = design.addRow(equID);
+                    design.setPrefit(row, prefit);
 
                    /* if(debug)
                     {
@@ -452,23 +463,23 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                     //>>>> 定义未知系数变量和系数值
 
 
-                    equSys.obsEquData[equID].varCoeffData[dx] = cosines[0];
-                    equSys.obsEquData[equID].varCoeffData[dy] = cosines[1];
-                    equSys.obsEquData[equID].varCoeffData[dz] = cosines[2];
-                    equSys.obsEquData[equID].varCoeffData[cdtGPS] = 1.0;
-                    equSys.obsEquData[equID].varCoeffData[ionoC1G] = -gamma;
+                    design.addCoeff(dx, cosines[0]);
+                    design.addCoeff(dy, cosines[1]);
+                    design.addCoeff(dz, cosines[2]);
+                    design.addCoeff(cdtGPS, 1.0);
+                    design.addCoeff(ionoC1G, -gamma);
 
                     // 定义模糊度变量
-                    Variable ambL2G(obsData.station,
-                                    sat,
-                                    Parameter::ambiguity,
-                                    ObsID(sat.system, tv.first));
+                    int ambL2G = registry.intern(Variable(obsData.station,
+                                                          sat,
+                                                          Parameter::ambiguity,
+                                                          ObsID(sat.system, tv.first)));
 
                     // 将模糊度变量存储到全体变量列表中
-                    varSetTemp.insert(ambL2G);
+                    design.addColumn(ambL2G);
 
-                    double wavelength = getWavelength(sat.system, safeStoi(tv.first.substr(1,1)));
-                    equSys.obsEquData[equID].varCoeffData[ambL2G] = wavelength;
+                    double wavelength = SignalCatalog::wavelength(SignalCatalog::bandId(sat.system, tv.first));
+                    design.addCoeff(ambL2G, wavelength);
 
                     // Compute the weight according to elevation
                     double weight;
@@ -479,24 +490,25 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                     {
                         weight = 1.0 / (SIG_UC_PHASE * SIG_UC_PHASE) * std::pow(std::sin(elevRad), 2);
                     }
-                    equSys.obsEquData[equID].weight = weight;
+                    design.setWeight(row, weight);
 
                 }
             }
             if(sat.system=="G" && SYS == "G")
             {
                 // 电离层所有频率估计的都是第一频率的伪距的电离层延迟
-                Variable ionoC1G(obsData.station,
-                                 sat,
-                                 Parameter::iono,
-                                 ObsID(sat.system, "C1"));
+                int ionoC1G = registry.intern(Variable(obsData.station,
+                                                       sat,
+                                                       Parameter::iono,
+                                                       ObsID(sat.system, "C1")));
 
                 // 把ionoC1G插入到观测方程
-                varSetTemp.insert(ionoC1G);
+                design.addColumn(ionoC1G);
 
-                double gamma = getGamma(sat.system, "C1", "C2");
+                double gamma = SignalCatalog::pair(SignalCatalog::bandId('G', '1'),
+                                                  SignalCatalog::bandId('G', '2')).gamma;
 
-                varSetTemp.insert(ionoC1G);
+                design.addColumn(ionoC1G);
 
                 if (tv.first == "C1" )
                 {
@@ -520,12 +532,13 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                              << endl;
                     }*/
 
-                    equSys.obsEquData[equID].prefit = prefit;
-                    equSys.obsEquData[equID].varCoeffData[dx] = cosines[0];
-                    equSys.obsEquData[equID].varCoeffData[dy] = cosines[1];
-                    equSys.obsEquData[equID].varCoeffData[dz] = cosines[2];
-                    equSys.obsEquData[equID].varCoeffData[cdtGPS] = 1.0;
-                    equSys.obsEquData[equID].varCoeffData[ionoC1G] = 1.0;
+                    int row = design.addRow(equID);
+                    design.setPrefit(row, prefit);
+                    design.addCoeff(dx, cosines[0]);
+                    design.addCoeff(dy, cosines[1]);
+                    design.addCoeff(dz, cosines[2]);
+                    design.addCoeff(cdtGPS, 1.0);
+                    design.addCoeff(ionoC1G, 1.0);
 
                     // Compute the weight according to elevation
                     double weight;
@@ -537,7 +550,7 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                         weight = 1.0 / (SIG_UC_CODE * SIG_UC_CODE) * std::pow(std::sin(elevRad), 2);
                     }
 
-                    equSys.obsEquData[equID].weight = weight; // IF组合方差为1.0m
+                    design.setWeight(row, weight); // IF组合方差为1.0m
 
 
                 }
@@ -563,12 +576,13 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                              << endl;
                     }*/
 
-                    equSys.obsEquData[equID].prefit = prefit;
-                    equSys.obsEquData[equID].varCoeffData[dx] = cosines[0];
-                    equSys.obsEquData[equID].varCoeffData[dy] = cosines[1];
-                    equSys.obsEquData[equID].varCoeffData[dz] = cosines[2];
-                    equSys.obsEquData[equID].varCoeffData[cdtGPS] = 1.0;
-                    equSys.obsEquData[equID].varCoeffData[ionoC1G] = gamma;
+                    int row = design.addRow(equID);
+                    design.setPrefit(row, prefit);
+                    design.addCoeff(dx, cosines[0]);
+                    design.addCoeff(dy, cosines[1]);
+                    design.addCoeff(dz, cosines[2]);
+                    design.addCoeff(cdtGPS, 1.0);
+                    design.addCoeff(ionoC1G, gamma);
 
                     // Compute the weight according to elevation
                     double weight;
@@ -580,7 +594,7 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                         weight = 1.0 / (SIG_UC_CODE * SIG_UC_CODE) * std::pow(std::sin(elevRad), 2);
                     }
 
-                    equSys.obsEquData[equID].weight = weight; // IF组合方差为1.0m
+                    design.setWeight(row, weight); // IF组合方差为1.0m
 
 
                 }
@@ -607,24 +621,25 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                     }*/
 
                     //>>>> 定义未知系数变量和系数值
-                    equSys.obsEquData[equID].prefit = prefit;
-                    equSys.obsEquData[equID].varCoeffData[dx] = cosines[0];
-                    equSys.obsEquData[equID].varCoeffData[dy] = cosines[1];
-                    equSys.obsEquData[equID].varCoeffData[dz] = cosines[2];
-                    equSys.obsEquData[equID].varCoeffData[cdtGPS] = 1.0;
-                    equSys.obsEquData[equID].varCoeffData[ionoC1G] = -1.0;
+                    int row = design.addRow(equID);
+                    design.setPrefit(row, prefit);
+                    design.addCoeff(dx, cosines[0]);
+                    design.addCoeff(dy, cosines[1]);
+                    design.addCoeff(dz, cosines[2]);
+                    design.addCoeff(cdtGPS, 1.0);
+                    design.addCoeff(ionoC1G, -1.0);
 
                     // 定义模糊度变量
-                    Variable ambL1G(obsData.station,
-                                     sat,
-                                     Parameter::ambiguity,
-                                     ObsID(sat.system, tv.first));
+                    int ambL1G = registry.intern(Variable(obsData.station,
+                                                          sat,
+                                                          Parameter::ambiguity,
+                                                          ObsID(sat.system, tv.first)));
 
                     // 将模糊度变量存储到全体变量列表中
-                    varSetTemp.insert(ambL1G);
+                    design.addColumn(ambL1G);
 
-                    double wavelength = getWavelength(sat.system, safeStoi(tv.first.substr(1,1)));
-                    equSys.obsEquData[equID].varCoeffData[ambL1G] = wavelength;
+                    double wavelength = SignalCatalog::wavelength(SignalCatalog::bandId(sat.system, tv.first));
+                    design.addCoeff(ambL1G, wavelength);
 
 
                     // Compute the weight according to elevation
@@ -636,7 +651,7 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                     {
                         weight = 1.0 / (SIG_UC_PHASE * SIG_UC_PHASE) * std::pow(std::sin(elevRad), 2);
                     }
-                    equSys.obsEquData[equID].weight = weight;
+                    design.setWeight(row, weight);
 
 
                 }
@@ -648,7 +663,8 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                     double prefit;
                     double computedObs = (rho - clkBias - relCorr + slantTrop) ;
                     prefit = tv.second - computedObs;
-                    equSys.obsEquData[equID].prefit = prefit;
+                    int row = design.addRow(equID);
+                    design.setPrefit(row, prefit);
 
                    /* if(debug)
                     {
@@ -666,23 +682,23 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                     //>>>> 定义未知系数变量和系数值
 
 
-                    equSys.obsEquData[equID].varCoeffData[dx] = cosines[0];
-                    equSys.obsEquData[equID].varCoeffData[dy] = cosines[1];
-                    equSys.obsEquData[equID].varCoeffData[dz] = cosines[2];
-                    equSys.obsEquData[equID].varCoeffData[cdtGPS] = 1.0;
-                    equSys.obsEquData[equID].varCoeffData[ionoC1G] = -gamma;
+                    design.addCoeff(dx, cosines[0]);
+                    design.addCoeff(dy, cosines[1]);
+                    design.addCoeff(dz, cosines[2]);
+                    design.addCoeff(cdtGPS, 1.0);
+                    design.addCoeff(ionoC1G, -gamma);
 
                     // 定义模糊度变量
-                    Variable ambL2G(obsData.station,
-                                    sat,
-                                    Parameter::ambiguity,
-                                    ObsID(sat.system, tv.first));
+                    int ambL2G = registry.intern(Variable(obsData.station,
+                                                          sat,
+                                                          Parameter::ambiguity,
+                                                          ObsID(sat.system, tv.first)));
 
                     // 将模糊度变量存储到全体变量列表中
-                    varSetTemp.insert(ambL2G);
+                    design.addColumn(ambL2G);
 
-                    double wavelength = getWavelength(sat.system, safeStoi(tv.first.substr(1,1)));
-                    equSys.obsEquData[equID].varCoeffData[ambL2G] = wavelength;
+                    double wavelength = SignalCatalog::wavelength(SignalCatalog::bandId(sat.system, tv.first));
+                    design.addCoeff(ambL2G, wavelength);
 
                     // Compute the weight according to elevation
                     double weight;
@@ -693,14 +709,12 @@ EquSys SPPUCCodePhase::linearize(Eigen::Vector3d& xyz,
                     {
                         weight = 1.0 / (SIG_UC_PHASE * SIG_UC_PHASE) * std::pow(std::sin(elevRad), 2);
                     }
-                    equSys.obsEquData[equID].weight = weight;
+                    design.setWeight(row, weight);
 
                 }
             }
 
         }
     }
-    equSys.varSet = varSetTemp;
-
-    return equSys;
+    design.finish();
 };
\ No newline at end of file
@@ -11,10 +11,11 @@ public:
     SPPUCCodePhase()
     {};
 
-    EquSys linearize(Eigen::Vector3d& xyz,
-                     std::map<SatID,Xvt>& satXvtRecTime,
-                     SatValueMap& satElevData,
-                     ObsData& obsData);
+    void linearize(Eigen::Vector3d& xyz,
+                   SatXvtMap& satXvtRecTime,
+                   SatValueMap& satElevData,
+                   ObsData& obsData,
+                   DesignMatrix& design);
 
     void solve(ObsData &obsData);
 
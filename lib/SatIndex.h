@@ -0,0 +1,217 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_SATINDEX_H
+#define GNSSLAB_SATINDEX_H
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <stdint.h>
+
+#include "GnssStruct.h"
+#include "Exception.h"
+
+// 紧凑的卫星标识和按卫星直接索引的表
+//
+// SatID 用 string 保存系统，std::map<SatID, ...> 的每次比较都是一次字符串比较。
+// PackedSat 把系统和 PRN 压缩在 16 位整数中：高 8 位为系统序号加 1，低 8 位为 PRN，0 表示无效。
+// 每颗卫星还有一个 0..numSats-1 的连续序号 ordinal()，SatTable<T> 用它直接索引，
+// 查找、插入都是数组访问，不需要比较和分配内存。
+//
+// 系统序号按系统字符的字母顺序排列（C E G I J R S），PackedSat 的大小顺序与 SatID 相同，
+// 遍历 SatTable 的顺序与遍历 std::map<SatID, ...> 的顺序一致。
+// 每个系统最多 maxPrn 颗卫星，PRN 从 1 开始；SBAS 使用 RINEX 中的两位 PRN（PRN - 100）。
+class PackedSat {
+public:
+    enum SatSys {
+        BDS = 0, Galileo, GPS, IRNSS, QZSS, GLONASS, SBAS,
+        numSys
+    };
+
+    static const int maxPrn = 64;
+    static const size_t numSats = size_t(numSys) * maxPrn;
+
+    PackedSat() : value(0) {};
+
+    // 系统字符（'G','C',...）和 PRN，系统未知或 PRN 超出范围时抛出 InvalidRequest
+    PackedSat(char sysChar, int prn) {
+        int s = sysIndex(sysChar);
+        if (s < 0 || prn < 1 || prn > maxPrn) {
+            InvalidRequest e(string("PackedSat: invalid satellite ") + sysChar + std::to_string(prn));
+            throw e;
+        }
+        value = uint16_t(((s + 1) << 8) | prn);
+    }
+
+    explicit PackedSat(const SatID &sat)
+            : PackedSat(sat.system.empty() ? ' ' : sat.system[0], sat.id) {};
+
+    // 由连续序号还原
+    static PackedSat fromOrdinal(size_t i) {
+        PackedSat sat;
+        sat.value = uint16_t(((i / maxPrn + 1) << 8) | (i % maxPrn + 1));
+        return sat;
+    }
+
+    bool isValid() const { return value != 0; }
+
+    SatSys sys() const { return SatSys((value >> 8) - 1); }
+
+    char sysChar() const { return sysChars()[(value >> 8) - 1]; }
+
+    int prn() const { return value & 0xff; }
+
+    // 0..numSats-1 的连续序号，无效的卫星（默认构造）抛出 InvalidRequest
+    size_t ordinal() const {
+        if (value == 0) {
+            InvalidRequest e("PackedSat: ordinal of an invalid satellite");
+            throw e;
+        }
+        return size_t((value >> 8) - 1) * maxPrn + (value & 0xff) - 1;
+    }
+
+    uint16_t packed() const { return value; }
+
+    SatID toSatID() const {
+        SatID sat;
+        sat.system = string(1, sysChar());
+        sat.id = prn();
+        return sat;
+    }
+
+    bool operator==(const PackedSat &other) const { return value == other.value; }
+
+    bool operator!=(const PackedSat &other) const { return value != other.value; }
+
+    bool operator<(const PackedSat &other) const { return value < other.value; }
+
+    // 系统字符对应的序号，未知系统返回 -1
+    static int sysIndex(char sysChar) {
+        switch (sysChar) {
+            case 'C': return BDS;
+            case 'E': return Galileo;
+            case 'G': return GPS;
+            case 'I': return IRNSS;
+            case 'J': return QZSS;
+            case 'R': return GLONASS;
+            case 'S': return SBAS;
+            default: return -1;
+        }
+    }
+
+    static const char *sysChars() { return "CEGIJRS"; }
+
+private:
+    uint16_t value;
+};
+
+inline ostream &operator<<(ostream &os, const PackedSat &sat) {
+    os << sat.sysChar() << std::setw(2) << std::setfill('0') << sat.prn() << std::setfill(' ');
+    return os;
+}
+
+// 按卫星直接索引的表，可以替代热点路径中的 std::map<SatID, T>
+//
+// 所有卫星的存储在构造时一次分配好，operator[] 与 std::map 相同：卫星不存在时插入默认值，
+// 卫星无效时抛出 InvalidRequest；find/contains 对无效的卫星返回不存在。
+// 遍历时按 PackedSat 的顺序跳过不存在的卫星，iterator::sat() 给出当前卫星。
+template<class T>
+class SatTable {
+public:
+    SatTable() : values(PackedSat::numSats), isPresent(PackedSat::numSats, 0), count(0) {};
+
+    T &operator[](const PackedSat &sat) {
+        size_t i = sat.ordinal();
+        if (!isPresent[i]) {
+            isPresent[i] = 1;
+            count++;
+        }
+        return values[i];
+    }
+
+    T &operator[](const SatID &sat) {
+        return operator[](PackedSat(sat));
+    }
+
+    // 卫星不存在或无效时返回 NULL
+    T *find(const PackedSat &sat) {
+        if (!sat.isValid()) return NULL;
+        size_t i = sat.ordinal();
+        return isPresent[i] ? &values[i] : NULL;
+    }
+
+    const T *find(const PackedSat &sat) const {
+        if (!sat.isValid()) return NULL;
+        size_t i = sat.ordinal();
+        return isPresent[i] ? &values[i] : NULL;
+    }
+
+    bool contains(const PackedSat &sat) const {
+        return sat.isValid() && isPresent[sat.ordinal()] != 0;
+    }
+
+    // 删除后该卫星的值恢复为默认值；卫星无效时什么也不做
+    void erase(const PackedSat &sat) {
+        if (!sat.isValid()) return;
+        size_t i = sat.ordinal();
+        if (isPresent[i]) {
+            isPresent[i] = 0;
+            values[i] = T();
+            count--;
+        }
+    }
+
+    void clear() {
+        for (size_t i = 0; i < values.size(); i++) {
+            if (isPresent[i]) values[i] = T();
+        }
+        std::fill(isPresent.begin(), isPresent.end(), 0);
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    class iterator {
+    public:
+        iterator(SatTable *pTable, size_t i) : pTable(pTable), i(i) { skip(); };
+
+        T &operator*() const { return pTable->values[i]; }
+
+        T *operator->() const { return &pTable->values[i]; }
+
+        PackedSat sat() const { return PackedSat::fromOrdinal(i); }
+
+        iterator &operator++() {
+            ++i;
+            skip();
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const { return i == other.i; }
+
+        bool operator!=(const iterator &other) const { return i != other.i; }
+
+    private:
+        void skip() {
+            while (i < pTable->values.size() && !pTable->isPresent[i]) ++i;
+        }
+
+        SatTable *pTable;
+        size_t i;
+    };
+
+    iterator begin() { return iterator(this, 0); }
+
+    iterator end() { return iterator(this, values.size()); }
+
+private:
+    std::vector<T> values;
+    std::vector<unsigned char> isPresent;
+    size_t count;
+};
+
+#endif //GNSSLAB_SATINDEX_H
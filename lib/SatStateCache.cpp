@@ -0,0 +1,41 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <cmath>
+#include "SatStateCache.h"
+#include "Exception.h"
+
+#define debug 0
+
+Xvt SatStateCache::getXvt(const SatID &sat, const CommonTime &t) {
+    if (pEphStore == NULL) {
+        InvalidRequest e("SatStateCache: RinexNavStore is not set");
+        throw (e);
+    }
+
+    PackedSat packedSat(sat);
+    Entry *pEntry = entries.find(packedSat);
+    if (pEntry != NULL) {
+        double dt = t - pEntry->time;
+        if (std::fabs(dt) <= window) {
+            hits++;
+            Xvt xvt = pEntry->xvt;
+            if (dt != 0.0) {
+                xvt.x += xvt.v * dt;
+                xvt.clkbias += xvt.clkdrift * dt;
+            }
+            return xvt;
+        }
+    }
+
+    misses++;
+    Xvt xvt = pEphStore->getXvt(sat, t);
+    Entry &entry = entries[packedSat];
+    entry.time = t;
+    entry.xvt = xvt;
+    return xvt;
+}
+
+void SatStateCache::clear() {
+    entries.clear();
+}
@@ -0,0 +1,75 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_SATSTATECACHE_H
+#define GNSSLAB_SATSTATECACHE_H
+
+#include "GnssStruct.h"
+#include "SatIndex.h"
+#include "RinexNavStore.hpp"
+
+// 多个测站共享的卫星位置、速度和钟差缓存
+//
+// SPPIFCode::computeAtTransmitTime 每颗卫星每个历元迭代两次计算信号发射时刻的卫星状态，
+// RTK 中流动站和基准站又对同一批卫星在几乎相同的发射时刻各算一遍。
+// 这里按卫星保存最近一次由星历计算的状态：
+//  - 查找时刻与缓存时刻相差不超过 window 秒时，用速度和钟漂从缓存的状态线性外推，不再计算轨道；
+//  - 否则由 RinexNavStore::getXvt 计算，并替换该卫星的缓存。
+// window 为 0 时只有时刻完全相同才命中。默认 10 毫秒的窗口足以覆盖各测站发射时刻之差和卫星钟差迭代的改正，
+// 外推后的位置与直接计算相差在 1 毫米以内（见 exam-9.17），对差分定位没有影响。
+//
+// 用法：
+//      SatStateCache satCache(&navStore);
+//      sppRover.setSatStateCache(&satCache);
+//      sppBase.setSatStateCache(&satCache);
+//
+// 缓存不加锁，共享它的测站要在同一个线程中处理。
+class SatStateCache {
+public:
+    explicit SatStateCache(RinexNavStore *pStore = NULL)
+            : pEphStore(pStore), window(0.01), hits(0), misses(0) {};
+
+    void setRinexNavStore(RinexNavStore *pStore) {
+        pEphStore = pStore;
+        clear();
+    };
+
+    // 外推窗口，秒
+    void setWindow(double seconds) {
+        window = seconds;
+    };
+
+    double getWindow() const { return window; };
+
+    // t 时刻的卫星状态；没有可用星历时与 RinexNavStore::getXvt 相同，抛出 InvalidRequest
+    Xvt getXvt(const SatID &sat, const CommonTime &t);
+
+    // 清除缓存的状态，计数不变
+    void clear();
+
+    size_t numHits() const { return hits; };
+
+    size_t numMisses() const { return misses; };
+
+    void resetCounters() {
+        hits = 0;
+        misses = 0;
+    };
+
+private:
+    struct Entry {
+        CommonTime time;
+        Xvt xvt;
+    };
+
+    RinexNavStore *pEphStore;
+    double window;
+
+    SatTable<Entry> entries;
+
+    size_t hits;
+    size_t misses;
+};
+
+#endif //GNSSLAB_SATSTATECACHE_H
@@ -0,0 +1,207 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_SIGNALCATALOG_H
+#define GNSSLAB_SIGNALCATALOG_H
+
+#include <string>
+
+using namespace std;
+
+// 编译期确定的 GNSS 信号表
+//
+// 按 RINEX 3.05/4.00 列出各系统的频点（观测值类型的第二个字符）和跟踪模式（第三个字符），
+// 频点编成从 0 开始的连续整数：
+//  - bandId(sys, band)：频点编号，给出频率、波长；
+//  - pair(b1, b2)：同一系统两个频点的组合系数（IF、MW、GF）和 gamma，编译期算好，运行时只查表；
+//  - isObsType(sys, "C1C")：观测值类型是否在表中。
+// 观测值类型本身的编号只有 ObsCodeTable 一套，ObsCodeTable::band(code, sys) 给出类型对应的频点编号。
+// 这些函数都是 constexpr，系统和类型是字面量时编号在编译期得到，循环中不再比较字符串。
+// GPS 的波长沿用 Const.h 中的取值，其余频点的波长为 C_MPS / f，与 getWavelength/getFreq 的结果逐位相同。
+// GLONASS FDMA 频点（R1、R2）的频率与频道号有关，表中为 k=0 的频率，用 glonassFreq 计算实际频率，
+// 组合系数对 R1/R2 没有意义。
+
+// 一个频点
+struct SignalBand {
+    char sys;           ///< 系统标识字符
+    char band;          ///< 观测值类型的第二个字符
+    double freq;        ///< 频率 (Hz)
+    double freqStep;    ///< GLONASS FDMA 的频道间隔 (Hz)，其余为 0
+    double wavelength;  ///< 波长 (m)
+    const char *attrs;  ///< 跟踪模式（观测值类型的第三个字符）
+};
+
+// 同一系统两个频点的组合系数，观测值均以米为单位
+struct SignalPair {
+    bool isValid;         ///< 两个频点属于同一系统且频率不同
+    double gamma;         ///< f1^2 / f2^2
+    double ifCoef1;       ///< IF = ifCoef1 * P1 + ifCoef2 * P2
+    double ifCoef2;
+    double mwPhase1;      ///< MW = mwPhase1 * L1 + mwPhase2 * L2 + mwCode1 * P1 + mwCode2 * P2
+    double mwPhase2;
+    double mwCode1;
+    double mwCode2;
+    double mwWavelength;  ///< 宽巷波长 C / (f1 - f2)
+    double gfIono;        ///< GF = L1 - L2 中第一频率电离层延迟的系数 gamma - 1
+};
+
+namespace signal_catalog_detail {
+
+    constexpr double cMps = 2.99792458e8;
+
+    constexpr SignalBand bandTable[] = {
+            // GPS
+            {'G', '1', 1575.42e6, 0.0, 0.190293672798, "CSLXPWYMN"},
+            {'G', '2', 1227.60e6, 0.0, 0.244210213425, "CDSLXPWYMN"},
+            {'G', '5', 1176.45e6, 0.0, 0.254828048791, "IQX"},
+            // GLONASS
+            {'R', '1', 1602.000e6, 0.5625e6, cMps / 1602.000e6, "CP"},
+            {'R', '2', 1246.000e6, 0.4375e6, cMps / 1246.000e6, "CP"},
+            {'R', '3', 1202.025e6, 0.0, cMps / 1202.025e6, "IQX"},
+            {'R', '4', 1600.995e6, 0.0, cMps / 1600.995e6, "ABX"},
+            {'R', '6', 1248.060e6, 0.0, cMps / 1248.060e6, "ABX"},
+            // Galileo
+            {'E', '1', 1575.420e6, 0.0, cMps / 1575.420e6, "ABCXZ"},
+            {'E', '5', 1176.450e6, 0.0, cMps / 1176.450e6, "IQX"},
+            {'E', '7', 1207.140e6, 0.0, cMps / 1207.140e6, "IQX"},
+            {'E', '8', 1191.795e6, 0.0, cMps / 1191.795e6, "IQX"},
+            {'E', '6', 1278.750e6, 0.0, cMps / 1278.750e6, "ABCXZ"},
+            // BDS
+            {'C', '2', 1561.098e6, 0.0, cMps / 1561.098e6, "IQX"},
+            {'C', '1', 1575.420e6, 0.0, cMps / 1575.420e6, "DPXSLZ"},
+            {'C', '5', 1176.450e6, 0.0, cMps / 1176.450e6, "DPX"},
+            {'C', '7', 1207.140e6, 0.0, cMps / 1207.140e6, "IQXDPZ"},
+            {'C', '8', 1191.795e6, 0.0, cMps / 1191.795e6, "DPX"},
+            {'C', '6', 1268.520e6, 0.0, cMps / 1268.520e6, "IQXDPZ"},
+            // QZSS
+            {'J', '1', 1575.42e6, 0.0, cMps / 1575.42e6, "CSLXZEB"},
+            {'J', '2', 1227.60e6, 0.0, cMps / 1227.60e6, "SLX"},
+            {'J', '5', 1176.45e6, 0.0, cMps / 1176.45e6, "IQXDPZ"},
+            {'J', '6', 1278.75e6, 0.0, cMps / 1278.75e6, "SLXEZ"},
+            // NavIC/IRNSS
+            {'I', '5', 1176.450e6, 0.0, cMps / 1176.450e6, "ABCX"},
+            {'I', '9', 2492.028e6, 0.0, cMps / 2492.028e6, "ABCX"},
+            {'I', '1', 1575.420e6, 0.0, cMps / 1575.420e6, "DPX"},
+            // SBAS
+            {'S', '1', 1575.42e6, 0.0, cMps / 1575.42e6, "C"},
+            {'S', '5', 1176.45e6, 0.0, cMps / 1176.45e6, "IQX"},
+    };
+
+    constexpr int numBands = sizeof(bandTable) / sizeof(bandTable[0]);
+
+    // 观测值种类：伪距、载波相位、多普勒、信号强度
+    constexpr char obsTypes[] = "CLDS";
+
+    constexpr int indexOf(const char *s, char c) {
+        for (int i = 0; s[i] != '\0'; i++) {
+            if (s[i] == c) return i;
+        }
+        return -1;
+    }
+
+    // 以系统标识字符和频点数字直接索引的频点编号，-1 表示没有该频点
+    struct BandIndex {
+        signed char ids[128][10];
+
+        constexpr BandIndex() : ids() {
+            for (int s = 0; s < 128; s++) {
+                for (int n = 0; n < 10; n++) {
+                    ids[s][n] = -1;
+                }
+            }
+            for (int i = 0; i < numBands; i++) {
+                ids[bandTable[i].sys & 0x7f][bandTable[i].band - '0'] = static_cast<signed char>(i);
+            }
+        }
+    };
+
+    constexpr BandIndex bandIndex;
+
+    constexpr SignalPair makePair(int b1, int b2) {
+        SignalPair p{};
+        const SignalBand &s1 = bandTable[b1];
+        const SignalBand &s2 = bandTable[b2];
+        if (s1.sys != s2.sys || s1.freq == s2.freq) {
+            return p;
+        }
+        double f1 = s1.freq, f2 = s2.freq;
+        p.isValid = true;
+        p.gamma = (f1 * f1) / (f2 * f2);
+        p.ifCoef1 = f1 * f1 / (f1 * f1 - f2 * f2);
+        p.ifCoef2 = -f2 * f2 / (f1 * f1 - f2 * f2);
+        p.mwPhase1 = f1 / (f1 - f2);
+        p.mwPhase2 = -f2 / (f1 - f2);
+        p.mwCode1 = -f1 / (f1 + f2);
+        p.mwCode2 = -f2 / (f1 + f2);
+        p.mwWavelength = cMps / (f1 - f2);
+        p.gfIono = p.gamma - 1.0;
+        return p;
+    }
+
+    struct PairTable {
+        SignalPair pairs[numBands][numBands];
+
+        constexpr PairTable() : pairs() {
+            for (int i = 0; i < numBands; i++) {
+                for (int j = 0; j < numBands; j++) {
+                    pairs[i][j] = makePair(i, j);
+                }
+            }
+        }
+    };
+
+    constexpr PairTable pairTable;
+}
+
+class SignalCatalog {
+public:
+    static constexpr int numBands() { return signal_catalog_detail::numBands; }
+
+    // 频点编号，没有该频点时返回 -1
+    static constexpr int bandId(char sys, char band) {
+        return (band >= '0' && band <= '9')
+               ? signal_catalog_detail::bandIndex.ids[sys & 0x7f][band - '0'] : -1;
+    }
+
+    // 由系统和 "L1"、"C2" 或 "L1C" 这样的类型名得到频点编号
+    static int bandId(const string &sys, const string &type) {
+        if (sys.empty() || type.size() < 2) return -1;
+        return bandId(sys[0], type[1]);
+    }
+
+    static constexpr const SignalBand &band(int b) {
+        return signal_catalog_detail::bandTable[b];
+    }
+
+    static constexpr double freq(int b) {
+        return signal_catalog_detail::bandTable[b].freq;
+    }
+
+    static constexpr double wavelength(int b) {
+        return signal_catalog_detail::bandTable[b].wavelength;
+    }
+
+    // GLONASS FDMA 频点在频道号 k 上的频率，其余频点与 k 无关
+    static constexpr double glonassFreq(int b, int k) {
+        return signal_catalog_detail::bandTable[b].freq + k * signal_catalog_detail::bandTable[b].freqStep;
+    }
+
+    // 两个频点的组合系数，不是同一系统的两个不同频点时 isValid 为 false
+    static constexpr const SignalPair &pair(int b1, int b2) {
+        return signal_catalog_detail::pairTable.pairs[b1][b2];
+    }
+
+    // 观测值类型（种类、频点、跟踪模式）是否在表中
+    static constexpr bool isObsType(char sys, char type, char band, char attr) {
+        return bandId(sys, band) >= 0 &&
+               signal_catalog_detail::indexOf(signal_catalog_detail::obsTypes, type) >= 0 &&
+               signal_catalog_detail::indexOf(signal_catalog_detail::bandTable[bandId(sys, band)].attrs, attr) >= 0;
+    }
+
+    static bool isObsType(char sys, const string &type) {
+        return type.size() == 3 && isObsType(sys, type[0], type[1], type[2]);
+    }
+};
+
+#endif //GNSSLAB_SIGNALCATALOG_H
@@ -268,6 +268,181 @@ noexcept(false)
 
 }  // End of method 'SolverKalman::Process()'
 
+void SolverKalman::solve(IndexedEquSys &equSys, const VariableTable<double> &csData)
+noexcept(false)
+{
+    const VariableRegistry &registry = *equSys.pRegistry;
+
+    currentVars = equSys.varSet;
+    predictHandles(registry, csData);
+
+    //==================================================
+    // 测量更新
+    //==================================================
+    int numUnk = currentVars.size();
+    int numObs = equSys.obsEquData.size();
+
+    VectorXd prefit = VectorXd::Zero(numObs);
+    MatrixXd hMatrix = MatrixXd::Zero(numObs, numUnk);
+    MatrixXd wMatrix = MatrixXd::Zero(numObs, numObs);
+
+    int iobs(0);
+    for (const auto &ed: equSys.obsEquData) {
+        prefit(iobs) = ed.second.prefit;
+        for (const auto &vc: ed.second.varCoeffs) {
+            int indexUnk = currentIndexOf[vc.first];
+            if (indexUnk < 0) {
+                InvalidSolver e("SolverKalman: coefficient of a variable not in varSet");
+                throw(e);
+            }
+            hMatrix(iobs, indexUnk) = vc.second;
+        }
+        wMatrix(iobs, iobs) = ed.second.weight;
+        iobs++;
+    }
+
+    kalmanFilter.MeasUpdate(prefit, hMatrix, wMatrix);
+    postfitResidual = kalmanFilter.postfitResidual;
+
+    storeHandleSolution(registry);
+}
+
+void SolverKalman::solve(const DesignMatrix &design, const VariableTable<double> &csData)
+noexcept(false)
+{
+    if (!design.finished()) {
+        InvalidSolver e("SolverKalman: DesignMatrix::finish() has not been called");
+        throw(e);
+    }
+    const VariableRegistry &registry = *design.getVariableRegistry();
+
+    currentVars = design.columns();
+    predictHandles(registry, csData);
+
+    //==================================================
+    // 测量更新
+    //==================================================
+    MatrixXd normalMatrix;
+    VectorXd normalVector;
+    design.normalEquation(normalMatrix, normalVector);
+    kalmanFilter.MeasUpdateNormal(normalMatrix, normalVector);
+
+    design.residual(kalmanFilter.xhat, postfitResidual);
+    kalmanFilter.postfitResidual = postfitResidual;
+
+    storeHandleSolution(registry);
+}
+
+void SolverKalman::predictHandles(const VariableRegistry &registry, const VariableTable<double> &csData)
+{
+    //==================================================
+    // 时间更新
+    //==================================================
+    int numUnk = currentVars.size();
+
+    currentIndexOf.assign(registry.size(), -1);
+    for (int i = 0; i < numUnk; i++) {
+        currentIndexOf[currentVars[i]] = i;
+    }
+
+    // 上一历元没有的句柄（包括上一历元之后才登记的）位置为 -1
+    oldIndexOf.resize(registry.size(), -1);
+
+    if( firstTime )
+    {
+        xhat = VectorXd::Zero(numUnk);
+        P = MatrixXd::Zero(numUnk, numUnk);
+        for (int i = 0; i < numUnk; i++) {
+            P(i, i) = 9.0E+10;
+        }
+
+        firstTime = false;
+    }
+    else
+    {
+        VectorXd currentState = VectorXd::Zero(numUnk);
+        MatrixXd currentCov = MatrixXd::Zero(numUnk, numUnk);
+
+        // 参数按规范顺序排列，只需要处理 j > i 的协方差
+        for (int i = 0; i < numUnk; i++) {
+            int oldIndex = oldIndexOf[currentVars[i]];
+            if (oldIndex < 0) {
+                currentCov(i, i) = 9.0E+10;
+                continue;
+            }
+
+            currentState(i) = solution(oldIndex);
+            currentCov(i, i) = covMatrix(oldIndex, oldIndex);
+            for (int j = i + 1; j < numUnk; j++) {
+                int oldIndex2 = oldIndexOf[currentVars[j]];
+                if (oldIndex2 >= 0) {
+                    currentCov(i, j) = covMatrix(oldIndex, oldIndex2);
+                    currentCov(j, i) = covMatrix(oldIndex, oldIndex2);
+                }
+            }
+        }
+
+        xhat = currentState;
+        P = currentCov;
+    }
+
+    MatrixXd phiMatrix = MatrixXd::Zero(numUnk, numUnk);
+    MatrixXd qMatrix = MatrixXd::Zero(numUnk, numUnk);
+
+    // 根据变量的随机模型构建状态转移矩阵和噪声矩阵
+    for (int i = 0; i < numUnk; i++) {
+        const Parameter &type = registry.paraType(currentVars[i]);
+        if (type == Parameter::dX || type == Parameter::dY || type == Parameter::dZ) {
+            phiMatrix(i, i) = 0.0;
+            qMatrix(i, i) = 1.0E+4;
+        } else if (type == Parameter::cdt) {
+            phiMatrix(i, i) = 0.0;
+            qMatrix(i, i) = 9.0E+10;
+        } else if (type == Parameter::ambiguity) {
+            const double *pFlag = csData.find(currentVars[i]);
+            if (pFlag != NULL && *pFlag) {
+                // 周跳,重置参数
+                phiMatrix(i, i) = 0.0;
+                qMatrix(i, i) = 9.0E+10;
+            } else {
+                // 常数模型
+                phiMatrix(i, i) = 1.0;
+                qMatrix(i, i) = 0.0;
+            }
+        }
+    }
+
+    kalmanFilter.Reset(xhat, P);
+    kalmanFilter.TimeUpdate(phiMatrix, qMatrix);
+}
+
+void SolverKalman::storeHandleSolution(const VariableRegistry &registry)
+{
+    int numUnk = currentVars.size();
+
+    solution = kalmanFilter.xhat;
+    covMatrix = kalmanFilter.P;
+
+    // 坐标参数是各自类型中的第一个
+    const Parameter::ParameterName xyzTypes[] = {Parameter::dX, Parameter::dY, Parameter::dZ};
+    for (int k = 0; k < 3; k++) {
+        int i = 0;
+        while (i < numUnk && registry.paraType(currentVars[i]) != Parameter(xyzTypes[k])) {
+            i++;
+        }
+        if (i == numUnk) {
+            InvalidRequest e("SolverKalman::Type not found in state vector.");
+            throw (e);
+        }
+        dxyz[k] = solution(i);
+    }
+
+    // 保存当前参数的位置，供下一个历元使用
+    oldIndexOf.swap(currentIndexOf);
+
+    return;
+}
+
 void SolverKalman::createIndex(const VariableSet &varSet ){
     int index(0);
     for (auto var: varSet) {
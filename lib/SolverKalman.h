@@ -8,6 +8,8 @@
 #include <Eigen/Eigen>
 #include "GnssStruct.h"
 #include "KalmanFilter.h"
+#include "VariableRegistry.h"
+#include "DesignMatrix.h"
 
 using namespace Eigen;
 
@@ -24,6 +26,14 @@ public:
     SolverKalman() : firstTime(true) {};
 
     virtual void solve(EquSys &equSys, VariableDataMap& csData);
+
+    // 以变量句柄表示的方程系统和周跳标志，结果与 solve(EquSys&, VariableDataMap&) 相同；
+    // 前后历元参数的对应和协方差的重排都按句柄直接索引。同一个对象只使用其中一种接口。
+    virtual void solve(IndexedEquSys &equSys, const VariableTable<double>& csData);
+
+    // 按行压缩的设计矩阵，测量更新使用由非零系数累加的法方程，不再构建稠密的 H 和 W 矩阵；
+    // 与上面的句柄接口可以混用（参数的对应关系相同）
+    virtual void solve(const DesignMatrix &design, const VariableTable<double>& csData);
     void createIndex(const VariableSet &varSet );
 
     int getIndex(const VariableSet &varSet, const Variable &thisVar);
@@ -62,8 +72,17 @@ private:
     VariableIntMap currentIndexData;
     VariableIntMap oldIndexData;
 
+    // 句柄接口：当前和上一历元的参数，以及句柄 -> 状态向量中的位置（-1 表示没有）
+    std::vector<int> currentVars;
+    std::vector<int> currentIndexOf;
+    std::vector<int> oldIndexOf;
+
     KalmanFilter kalmanFilter;
 
+    // 句柄接口共用：由 currentVars 完成时间更新，以及测量更新后保存结果
+    void predictHandles(const VariableRegistry &registry, const VariableTable<double>& csData);
+    void storeHandleSolution(const VariableRegistry &registry);
+
 };
 
 
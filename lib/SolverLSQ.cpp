@@ -90,6 +90,99 @@ void SolverLSQ::solve(EquSys &equSys) {
 
 }
 
+void SolverLSQ::solve(IndexedEquSys &equSys) {
+
+    const VariableRegistry &registry = *equSys.pRegistry;
+    const std::vector<int> &varSet = equSys.varSet;
+    int numUnk = varSet.size();
+    int numObs = equSys.obsEquData.size();
+
+    columnOf.assign(registry.size(), -1);
+    for (int i = 0; i < numUnk; i++) {
+        columnOf[varSet[i]] = i;
+    }
+
+    VectorXd prefit = VectorXd::Zero(numObs);
+    MatrixXd hMatrix = MatrixXd::Zero(numObs, numUnk);
+    MatrixXd wMatrix = MatrixXd::Zero(numObs, numObs);
+
+    int iobs(0);
+    for (const auto &ed: equSys.obsEquData) {
+        prefit(iobs) = ed.second.prefit;
+
+        for (const auto &vc: ed.second.varCoeffs) {
+            int indexUnk = columnOf[vc.first];
+            if (indexUnk < 0) {
+                InvalidSolver e("SolverLSQ: coefficient of a variable not in varSet");
+                throw (e);
+            }
+            hMatrix(iobs, indexUnk) = vc.second;
+        }
+        wMatrix(iobs, iobs) = ed.second.weight;
+
+        iobs++;
+    }
+
+    MatrixXd hT = hMatrix.transpose();
+
+    try {
+        covMatrix = hT * wMatrix * hMatrix;
+        covMatrix = covMatrix.inverse();
+    }
+    catch (...) {
+        InvalidSolver e("Unable to invert matrix covMatrix");
+        throw (e);
+    }
+
+    state = covMatrix * hT * wMatrix * prefit;
+
+    // 坐标参数是各自类型中的第一个
+    const Parameter::ParameterName xyzTypes[] = {Parameter::dX, Parameter::dY, Parameter::dZ};
+    for (int k = 0; k < 3; k++) {
+        int i = 0;
+        while (i < numUnk && registry.paraType(varSet[i]) != Parameter(xyzTypes[k])) {
+            i++;
+        }
+        if (i == numUnk) {
+            InvalidRequest e("SolverLSQ::Type not found in state vector.");
+            throw (e);
+        }
+        dxyz[k] = state(i);
+    }
+}
+
+void SolverLSQ::solve(const DesignMatrix &design) {
+
+    if (!design.finished()) {
+        InvalidSolver e("SolverLSQ: DesignMatrix::finish() has not been called");
+        throw (e);
+    }
+
+    MatrixXd normalMatrix;
+    VectorXd normalVector;
+    design.normalEquation(normalMatrix, normalVector);
+
+    try {
+        covMatrix = normalMatrix.inverse();
+    }
+    catch (...) {
+        InvalidSolver e("Unable to invert matrix covMatrix");
+        throw (e);
+    }
+
+    state = covMatrix * normalVector;
+
+    const Parameter::ParameterName xyzTypes[] = {Parameter::dX, Parameter::dY, Parameter::dZ};
+    for (int k = 0; k < 3; k++) {
+        int i = design.firstColumn(Parameter(xyzTypes[k]));
+        if (i < 0) {
+            InvalidRequest e("SolverLSQ::Type not found in state vector.");
+            throw (e);
+        }
+        dxyz[k] = state(i);
+    }
+}
+
 int SolverLSQ::getIndex(const VariableSet &varSet, const Variable &thisVar) {
     int index(0);
     for (auto var: varSet) {
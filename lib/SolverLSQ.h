@@ -12,6 +12,8 @@
 
 #include <Eigen/Eigen>
 #include "GnssStruct.h"
+#include "VariableRegistry.h"
+#include "DesignMatrix.h"
 
 using namespace Eigen;
 
@@ -29,6 +31,14 @@ public:
     SolverLSQ() {};
 
     virtual void solve(EquSys &equSys);
+
+    // 以变量句柄表示的方程系统，参数按规范顺序排列，结果与 solve(EquSys&) 相同；
+    // 参数在设计矩阵中的列号按句柄直接索引，不再逐个比较 Variable
+    virtual void solve(IndexedEquSys &equSys);
+
+    // 按行压缩的设计矩阵，法方程由非零系数直接累加，不再构建稠密的 H 和 W 矩阵
+    virtual void solve(const DesignMatrix &design);
+
     int getIndex(const VariableSet &varSet, const Variable &thisVar);
     double getSolution(const Parameter &type,
                        VariableSet &currentUnkSet,
@@ -55,6 +65,9 @@ private:
     MatrixXd covMatrix;
     Vector3d dxyz;
     VariableSet currentUnkSet;
+
+    // 句柄 -> 列号，-1 表示不是当前的未知参数
+    std::vector<int> columnOf;
 }; // End of class 'SolverLSQ'
 
 
@@ -0,0 +1,156 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_SPSCRING_H
+#define GNSSLAB_SPSCRING_H
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+// 单生产者、单消费者的无锁环形队列
+//
+// 容量在构造时取整到 2 的幂。写入位置 tail 只由生产者修改，读取位置 head 只由消费者修改，
+// 两者都单调递增，用 release/acquire 保证元素内容在位置更新之前可见，不需要互斥锁。
+// tryPush/tryPop 不阻塞，队列满或空时返回 false，由调用者决定等待的方式。
+//
+// push/waitFront 是阻塞的版本：队列满（空）时先让出几次时间片，仍未就绪就在条件变量上睡眠。
+// 睡眠的一方先置位 producerWaiting/consumerWaiting，另一方在入队（出队）之后检查这个标志，
+// 只有对方睡着时才加锁唤醒，所以只在空变非空、满变非满且对方在等待时才有加锁的开销。
+// 标志和位置之间用 seq_cst 栅栏排序，不会丢失唤醒。close() 唤醒两边，之后 push 返回 false，
+// waitFront 在取完剩下的元素后返回 NULL。
+template<class T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity = 64)
+            : head(0), tail(0), producerWaiting(false), consumerWaiting(false), closed(false) {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        slots.resize(n);
+        mask = n - 1;
+    }
+
+    // 生产者调用，队列满时返回 false，value 保持不变
+    bool tryPush(T &value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) return false;
+        slots[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        wake(consumerWaiting, notEmpty);
+        return true;
+    }
+
+    // 消费者调用，队列空时返回 false
+    bool tryPop(T &value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        value = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        wake(producerWaiting, notFull);
+        return true;
+    }
+
+    // 生产者调用，队列满时等待；队列已经 close 时返回 false，value 保持不变
+    bool push(T &value) {
+        if (closed.load(std::memory_order_relaxed)) return false;
+        while (!tryPush(value)) {
+            if (!wait(producerWaiting, notFull, [this]() { return !isFull(); })) return false;
+        }
+        return true;
+    }
+
+    // 消费者调用，队列空时等待队首元素；队列已经 close 且为空时返回 NULL
+    T *waitFront() {
+        T *pFront;
+        while ((pFront = front()) == NULL) {
+            if (!wait(consumerWaiting, notEmpty, [this]() { return !isEmpty(); })) return front();
+        }
+        return pFront;
+    }
+
+    // 任一方调用：不再入队，唤醒正在等待的生产者和消费者
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(waitMutex);
+            closed.store(true);
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    bool isClosed() const { return closed.load(); }
+
+    // 消费者调用，取队首元素但不出队，队列空时返回 NULL
+    T *front() {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return NULL;
+        return &slots[h & mask];
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    // 自旋的次数，超过后在条件变量上睡眠
+    static const int SPIN_COUNT = 64;
+
+    bool isEmpty() const {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+
+    bool isFull() const {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) > mask;
+    }
+
+    // 等待 ready() 成立：先自旋，再置位 waiting 后睡眠；队列 close 时返回 false
+    template<class Ready>
+    bool wait(std::atomic<bool> &waiting, std::condition_variable &cv, Ready ready) {
+        for (int spins = 0; spins < SPIN_COUNT; spins++) {
+            if (ready()) return true;
+            if (closed.load(std::memory_order_relaxed)) return false;
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(waitMutex);
+        waiting.store(true, std::memory_order_relaxed);
+        // 与 wake 中的栅栏配对：要么这里看到对方更新的位置，要么对方看到 waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!ready() && !closed.load(std::memory_order_relaxed)) {
+            cv.wait(lock);
+        }
+        waiting.store(false, std::memory_order_relaxed);
+        return !closed.load(std::memory_order_relaxed);
+    }
+
+    // 更新位置之后调用，对方在睡眠时唤醒它
+    void wake(std::atomic<bool> &waiting, std::condition_variable &cv) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!waiting.load(std::memory_order_relaxed)) return;
+        {
+            std::lock_guard<std::mutex> lock(waitMutex);
+        }
+        cv.notify_one();
+    }
+
+    // 不允许拷贝
+    SpscRing(const SpscRing &);
+
+    SpscRing &operator=(const SpscRing &);
+
+    std::vector<T> slots;
+    size_t mask;
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+
+    std::mutex waitMutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::atomic<bool> producerWaiting;
+    std::atomic<bool> consumerWaiting;
+    std::atomic<bool> closed;
+};
+
+#endif //GNSSLAB_SPSCRING_H
@@ -1,7 +1,7 @@
 
 #include <cmath>
-#include <map>
 #include "TimeConvert.h"
+#include "LeapSecondTable.h"
 #include "TimeStruct.h"
 #include "Const.h"
 
@@ -10,63 +10,13 @@
 
 using namespace std;
 
-// 在给定的历史记录中查找跳秒
+// 在跳秒表中查找跳秒，跳秒表只建立一次，见 LeapSecondTable
 double getLeapSeconds(const CommonTime &ct) {
-
-    std::map<double, double> leapData;
-
-    // mjd;
-    //
-    leapData[41317.0] = 10;
-    leapData[41499.0] = 11;
-    leapData[41683.0] = 12;
-    leapData[42048.0] = 13;
-    leapData[42413.0] = 14;
-    leapData[42778.0] = 15;
-    leapData[43144.0] = 16;
-    leapData[43509.0] = 17;
-    leapData[43874.0] = 18;
-    leapData[44239.0] = 19;
-    leapData[44786.0] = 20;
-    leapData[45151.0] = 21;
-    leapData[45516.0] = 22;
-    leapData[46247.0] = 23;
-    leapData[47161.0] = 24;
-    leapData[47892.0] = 25;
-    leapData[48257.0] = 26;
-    leapData[48804.0] = 27;
-    leapData[49169.0] = 28;
-    leapData[49534.0] = 29;
-    leapData[50083.0] = 30;
-    leapData[50630.0] = 31;
-    leapData[51179.0] = 32;
-    leapData[53736.0] = 33;
-    leapData[54832.0] = 34;
-    leapData[56109.0] = 35;
-    leapData[57204.0] = 36;
-    leapData[57754.0] = 37;
-
-    double mjd_ct = ct.m_day;
-
-    // 1972.1.1
-    if (mjd_ct < 41317.0) {
-        InvalidRequest e("Time MUST be greater than 1972 for leapSec!");
-        throw (e);
-    }
-
-    double leapSec;
-
-    //  循环所有的跳秒记录
-    for (auto ld: leapData) {
-        if (ld.first <= mjd_ct)
-            leapSec = ld.second;
-    }
-
-    return leapSec;
+    return LeapSecondTable::instance().getLeapSeconds(ct.m_day);
 }
 
-// 时间系统转换
-CommonTime convertTimeSystem(
+// 从 ct 所在的时间系统到 outTS 的时间差（秒）
+static double timeSystemOffset(
         const CommonTime &ct,
         const TimeSystem &outTS) {
 
@@ -74,10 +24,6 @@ CommonTime convertTimeSystem(
 
     double dt(0.0);
 
-    // identity
-    if (inTS == outTS)
-        return ct;
-
     if (inTS == TimeSystem::GPS)         // GAL -> TAI
         dt = 19.;
     else if (inTS == TimeSystem::UTC)    // GLO -> TAI
@@ -104,7 +50,49 @@ CommonTime convertTimeSystem(
         throw (e);
     }
 
-    return ct + dt;
+    return dt;
+}
+
+// 时间系统转换
+CommonTime convertTimeSystem(
+        const CommonTime &ct,
+        const TimeSystem &outTS) {
+
+    // identity
+    if (ct.m_timeSystem == outTS)
+        return ct;
+
+    return ct + timeSystemOffset(ct, outTS);
+}
+
+// 批量转换：相邻历元的时间系统相同、且两端都不是 UTC 时，时间差只算一次
+void convertTimeSystem(
+        const std::vector<CommonTime> &cts,
+        const TimeSystem &outTS,
+        std::vector<CommonTime> &out) {
+
+    out.resize(cts.size());
+
+    bool hasDt = false;
+    TimeSystem lastTS;
+    double dt(0.0);
+    for (size_t i = 0; i < cts.size(); i++) {
+        const CommonTime &ct = cts[i];
+        if (ct.m_timeSystem == outTS) {
+            out[i] = ct;
+            continue;
+        }
+        if (ct.m_timeSystem == TimeSystem::UTC || outTS == TimeSystem::UTC) {
+            out[i] = ct + timeSystemOffset(ct, outTS);
+            continue;
+        }
+        if (!hasDt || ct.m_timeSystem != lastTS) {
+            dt = timeSystemOffset(ct, outTS);
+            lastTS = ct.m_timeSystem;
+            hasDt = true;
+        }
+        out[i] = ct + dt;
+    }
 }
 
 //
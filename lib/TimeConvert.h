@@ -3,6 +3,8 @@
 //////////////////////////////////////////////
 #pragma once
 
+#include <vector>
+
 #include "TimeStruct.h"
 
 // 读取跳秒
@@ -13,6 +15,12 @@ CommonTime convertTimeSystem(
         const CommonTime &ct,
         const TimeSystem &targetSys);
 
+// 批量时间系统转换，out[i] = convertTimeSystem(cts[i], targetSys)
+void convertTimeSystem(
+        const std::vector<CommonTime> &cts,
+        const TimeSystem &targetSys,
+        std::vector<CommonTime> &out);
+
 /**
  * convert from "Julian day" (= JD + 0.5)to calendar day.
  */
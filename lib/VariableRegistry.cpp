@@ -0,0 +1,119 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+#include <algorithm>
+#include "VariableRegistry.h"
+
+#define debug 0
+
+int VariableRegistry::intern(const Variable &var) {
+    auto it = handleOf.lower_bound(var);
+    if (it != handleOf.end() && !(var < it->first)) {
+        return it->second;
+    }
+
+    int h = int(variables.size());
+    it = handleOf.insert(it, std::make_pair(var, h));
+    variables.push_back(&it->first);
+    paraTypes.push_back(var.getParaType());
+    strippedOf.push_back(-1);
+    isRankDirty = true;
+    return h;
+}
+
+int VariableRegistry::find(const Variable &var) const {
+    auto it = handleOf.find(var);
+    return it == handleOf.end() ? -1 : it->second;
+}
+
+void VariableRegistry::refreshRanks() const {
+    ranks.resize(variables.size());
+    int i = 0;
+    for (const auto &vh: handleOf) {
+        ranks[vh.second] = i++;
+    }
+    isRankDirty = false;
+}
+
+void VariableRegistry::sortCanonical(std::vector<int> &handles) const {
+    if (isRankDirty) refreshRanks();
+    std::sort(handles.begin(), handles.end(),
+              [this](int a, int b) { return ranks[a] < ranks[b]; });
+    handles.erase(std::unique(handles.begin(), handles.end()), handles.end());
+}
+
+int VariableRegistry::withoutStation(int h) {
+    if (strippedOf[h] < 0) {
+        Variable var = variable(h);
+        var.station = std::string("");
+        int s = intern(var);
+        strippedOf[h] = s;
+    }
+    return strippedOf[h];
+}
+
+int VariableRegistry::withStation(int h, const string &station) {
+    if (variable(h).station == station) {
+        return h;
+    }
+    Variable var = variable(h);
+    var.station = station;
+    return intern(var);
+}
+
+void indexEquSys(const EquSys &equSys, VariableRegistry &registry, IndexedEquSys &indexedEquSys) {
+    indexedEquSys.station = equSys.station;
+    indexedEquSys.pRegistry = &registry;
+    indexedEquSys.obsEquData.clear();
+    for (const auto &ed: equSys.obsEquData) {
+        IndexedEquData &data = indexedEquSys.obsEquData[ed.first];
+        data.station = ed.second.station;
+        data.prefit = ed.second.prefit;
+        data.weight = ed.second.weight;
+        data.varCoeffs.reserve(ed.second.varCoeffData.size());
+        for (const auto &vc: ed.second.varCoeffData) {
+            data.varCoeffs.push_back(std::make_pair(registry.intern(vc.first), vc.second));
+        }
+    }
+
+    indexedEquSys.varSet.clear();
+    for (const auto &var: equSys.varSet) {
+        indexedEquSys.varSet.push_back(registry.intern(var));
+    }
+    registry.sortCanonical(indexedEquSys.varSet);
+}
+
+void restoreEquSys(const IndexedEquSys &indexedEquSys, EquSys &equSys) {
+    const VariableRegistry &registry = *indexedEquSys.pRegistry;
+    equSys.station = indexedEquSys.station;
+    equSys.obsEquData.clear();
+    for (const auto &ed: indexedEquSys.obsEquData) {
+        EquData &data = equSys.obsEquData[ed.first];
+        data.station = ed.second.station;
+        data.prefit = ed.second.prefit;
+        data.weight = ed.second.weight;
+        for (const auto &vc: ed.second.varCoeffs) {
+            data.varCoeffData[registry.variable(vc.first)] = vc.second;
+        }
+    }
+
+    equSys.varSet.clear();
+    for (int h: indexedEquSys.varSet) {
+        equSys.varSet.insert(equSys.varSet.end(), registry.variable(h));
+    }
+}
+
+void indexVariableData(const VariableDataMap &dataMap, VariableRegistry &registry, VariableTable<double> &table) {
+    table.clear();
+    for (const auto &vd: dataMap) {
+        table[registry.intern(vd.first)] = vd.second;
+    }
+}
+
+void restoreVariableData(const VariableTable<double> &table, const VariableRegistry &registry,
+                         VariableDataMap &dataMap) {
+    dataMap.clear();
+    for (int h: table.keys()) {
+        dataMap[registry.variable(h)] = *table.find(h);
+    }
+}
@@ -0,0 +1,168 @@
+//
+// Created by shjzh on 2026/10/17.
+//
+
+#ifndef GNSSLAB_VARIABLEREGISTRY_H
+#define GNSSLAB_VARIABLEREGISTRY_H
+
+#include <vector>
+#include <map>
+#include <utility>
+
+#include "GnssStruct.h"
+
+// 未知参数的登记表：每个不同的 Variable 只保存一次，并分配一个整数句柄
+//
+// Variable 由测站名、卫星、ObsID 和参数类型组成，比较大小要做一串字符串比较，
+// VariableSet/VariableDataMap 的每次查找、SolverKalman 中的索引和协方差重排都要反复比较。
+// 登记后，估计模块只处理整数句柄：
+//  - 句柄从 0 开始连续分配，登记表存在期间不会改变，可以直接作为数组下标（见 VariableTable）；
+//  - rank(h) 给出句柄在全部已登记变量中的规范顺序，与 Variable::operator< 相同，
+//    按 rank 排序得到的参数顺序与 VariableSet 的遍历顺序一致，解算结果逐位相同；
+//  - 参数类型单独缓存，判断参数类型不需要取出 Variable。
+// 登记表不加锁，同一个登记表只在一个线程中使用。
+class VariableRegistry {
+public:
+    VariableRegistry() : isRankDirty(false) {};
+
+    // 返回变量的句柄，没有登记过时登记并分配新句柄
+    int intern(const Variable &var);
+
+    // 返回变量的句柄，没有登记过时返回 -1
+    int find(const Variable &var) const;
+
+    const Variable &variable(int h) const { return *variables[h]; }
+
+    const Parameter &paraType(int h) const { return paraTypes[h]; }
+
+    size_t size() const { return variables.size(); }
+
+    // 规范顺序中的位置，新登记变量后会重新计算
+    int rank(int h) const {
+        if (isRankDirty) refreshRanks();
+        return ranks[h];
+    }
+
+    bool less(int a, int b) const { return rank(a) < rank(b); }
+
+    // 按规范顺序排序并去掉重复的句柄
+    void sortCanonical(std::vector<int> &handles) const;
+
+    // 去掉测站名后的变量（用于流动站与基准站的周跳标志匹配）
+    int withoutStation(int h);
+
+    // 换成指定测站名后的变量
+    int withStation(int h, const string &station);
+
+private:
+    void refreshRanks() const;
+
+    // 变量只在 map 的节点中保存一份，variables 指向节点中的键，插入新变量时不会失效
+    std::map<Variable, int> handleOf;
+    std::vector<const Variable *> variables;
+    std::vector<Parameter> paraTypes;
+    std::vector<int> strippedOf;
+
+    mutable std::vector<int> ranks;
+    mutable bool isRankDirty;
+};
+
+// 以变量句柄直接索引的表，替代估计模块中的 VariableDataMap
+//
+// operator[] 与 std::map 相同：句柄不存在时插入默认值。keys() 按插入顺序给出已有的句柄。
+template<class T>
+class VariableTable {
+public:
+    VariableTable() {};
+
+    T &operator[](int h) {
+        if (size_t(h) >= values.size()) {
+            values.resize(h + 1);
+            isPresent.resize(h + 1, 0);
+        }
+        if (!isPresent[h]) {
+            isPresent[h] = 1;
+            handles.push_back(h);
+        }
+        return values[h];
+    }
+
+    // 句柄不存在时返回 NULL
+    const T *find(int h) const {
+        return (size_t(h) < values.size() && isPresent[h]) ? &values[h] : NULL;
+    }
+
+    bool contains(int h) const {
+        return size_t(h) < values.size() && isPresent[h];
+    }
+
+    void clear() {
+        for (int h: handles) {
+            values[h] = T();
+            isPresent[h] = 0;
+        }
+        handles.clear();
+    }
+
+    size_t size() const { return handles.size(); }
+
+    bool empty() const { return handles.empty(); }
+
+    const std::vector<int> &keys() const { return handles; }
+
+private:
+    std::vector<T> values;
+    std::vector<unsigned char> isPresent;
+    std::vector<int> handles;
+};
+
+// 以变量句柄表示的观测方程
+struct IndexedEquData {
+    IndexedEquData() : prefit(0.0), weight(0.0) {};
+
+    // 设置系数，句柄已有时覆盖
+    void setCoeff(int h, double coeff) {
+        for (auto &vc: varCoeffs) {
+            if (vc.first == h) {
+                vc.second = coeff;
+                return;
+            }
+        }
+        varCoeffs.push_back(std::make_pair(h, coeff));
+    }
+
+    // 句柄的系数，没有时返回 NULL
+    const double *findCoeff(int h) const {
+        for (const auto &vc: varCoeffs) {
+            if (vc.first == h) return &vc.second;
+        }
+        return NULL;
+    }
+
+    string station;
+    double prefit;
+    std::vector<std::pair<int, double>> varCoeffs;
+    double weight;
+};
+
+// 以变量句柄表示的方程系统，与 EquSys 一一对应；varSet 按规范顺序排列
+struct IndexedEquSys {
+    IndexedEquSys() : pRegistry(NULL) {};
+
+    string station;
+    std::map<EquID, IndexedEquData> obsEquData;
+    std::vector<int> varSet;
+    VariableRegistry *pRegistry;
+};
+
+// EquSys 与 IndexedEquSys、VariableDataMap 与 VariableTable 之间的转换，变量登记到 registry 中
+void indexEquSys(const EquSys &equSys, VariableRegistry &registry, IndexedEquSys &indexedEquSys);
+
+void restoreEquSys(const IndexedEquSys &indexedEquSys, EquSys &equSys);
+
+void indexVariableData(const VariableDataMap &dataMap, VariableRegistry &registry, VariableTable<double> &table);
+
+void restoreVariableData(const VariableTable<double> &table, const VariableRegistry &registry,
+                         VariableDataMap &dataMap);
+
+#endif //GNSSLAB_VARIABLEREGISTRY_H